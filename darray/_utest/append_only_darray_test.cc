@@ -0,0 +1,213 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#include "append_only_darray.hpp"
+#include "gtest.h"
+
+#include <atomic>
+#include <cstdint>
+#include <expected>
+#include <future>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+using CppPlay::append_only_darray;
+
+//=============================================================================
+// Helper Classes and Functions
+//=============================================================================
+// carries a check value derived from writer and sequence, so a reader seeing
+// a partly constructed element fails the check
+struct StressRecord {
+  std::uint32_t m_writer;
+  std::uint32_t m_sequence;
+  std::uint64_t m_check;
+
+  StressRecord(const std::uint32_t writer, const std::uint32_t sequence)
+      : m_writer{writer}, m_sequence{sequence},
+        m_check{check_of(writer, sequence)} {}
+  static constexpr auto check_of(const std::uint32_t writer,
+                                 const std::uint32_t sequence)
+      -> std::uint64_t {
+    return ((static_cast<std::uint64_t>(writer) << 32) | sequence) *
+           0x9E3779B97F4A7C15ull;
+  }
+  [[nodiscard]] auto is_valid() const -> bool {
+    return check_of(m_writer, m_sequence) == m_check;
+  }
+};
+
+// fails any allocation of more than LIMIT objects
+template <typename T, size_t LIMIT> struct LimitedAllocator {
+  using value_type = T;
+  template <typename U> struct rebind {
+    using other = LimitedAllocator<U, LIMIT>;
+  };
+  LimitedAllocator() = default;
+  template <typename U>
+  LimitedAllocator(const LimitedAllocator<U, LIMIT> &) noexcept {}
+  auto allocate(const size_t count) -> T * {
+    if (count > LIMIT) {
+      throw std::bad_alloc{};
+    }
+    return std::allocator<T>{}.allocate(count);
+  }
+  void deallocate(T *const p_memory, const size_t count) noexcept {
+    std::allocator<T>{}.deallocate(p_memory, count);
+  }
+  template <typename U>
+  auto operator==(const LimitedAllocator<U, LIMIT> &) const noexcept -> bool {
+    return true;
+  }
+};
+
+//=============================================================================
+// Tests
+//=============================================================================
+TEST(appendOnlyDarray, singleThread) {
+  append_only_darray<std::string, 4> darray_obj{};
+  EXPECT_TRUE(darray_obj.is_empty().value());
+  EXPECT_FALSE(darray_obj.at(0).has_value());
+
+  // spans several segments, 4, 8, 16...
+  for (int value = 0; value < 1000; value++) {
+    EXPECT_EQ((size_t)value,
+              darray_obj.push_back(std::to_string(value)).value());
+  }
+  EXPECT_EQ((size_t)1000, darray_obj.size().value());
+  EXPECT_EQ((size_t)1000, darray_obj.reserved());
+  EXPECT_FALSE(darray_obj.is_empty().value());
+
+  // elements never move
+  const std::string *p_first = darray_obj.at(0).value();
+  for (int value = 1000; value < 5000; value++) {
+    EXPECT_TRUE(darray_obj.push_back(std::to_string(value)).has_value());
+  }
+  EXPECT_EQ(p_first, darray_obj.at(0).value());
+
+  for (int value = 0; value < 5000; value++) {
+    EXPECT_EQ(std::to_string(value), darray_obj[value]);
+  }
+  EXPECT_EQ("4999", *darray_obj.at(4999).value());
+  EXPECT_FALSE(darray_obj.at(5000).has_value());
+
+  size_t count = 0;
+  darray_obj.for_each([&count](const std::string &value) {
+    EXPECT_EQ(std::to_string(count++), value);
+  });
+  EXPECT_EQ((size_t)5000, count);
+}
+
+TEST(appendOnlyDarray, concurrentReadersWriters) {
+  constexpr std::uint32_t WRITER_COUNT = 4;
+  constexpr std::uint32_t READER_COUNT = 4;
+  constexpr std::uint32_t WRITE_LIMIT = 50000;
+
+  append_only_darray<StressRecord, 2> darray_obj{};
+  std::atomic<bool> writing{true};
+
+  auto write = [&](const std::uint32_t writer) {
+    for (std::uint32_t sequence = 0; sequence < WRITE_LIMIT; sequence++) {
+      EXPECT_TRUE(darray_obj.push_back(StressRecord{writer, sequence})
+                      .has_value());
+    }
+  };
+
+  // readers see a growing, never shrinking, prefix of fully constructed
+  // elements, and each writer's elements in its own order
+  auto read = [&]() {
+    size_t last_size = 0;
+    size_t checked = 0;
+    while (writing.load() || (checked < last_size)) {
+      const size_t size = darray_obj.size().value();
+      EXPECT_GE(size, last_size);
+      last_size = size;
+      std::vector<std::int64_t> last_sequence(WRITER_COUNT, -1);
+      for (size_t idx = 0; idx < size; idx++) {
+        const StressRecord &record = darray_obj[idx];
+        ASSERT_TRUE(record.is_valid());
+        ASSERT_LT(record.m_writer, WRITER_COUNT);
+        EXPECT_GT(static_cast<std::int64_t>(record.m_sequence),
+                  last_sequence[record.m_writer]);
+        last_sequence[record.m_writer] = record.m_sequence;
+      }
+      checked = size;
+    }
+  };
+
+  std::vector<std::future<void>> readers{};
+  for (std::uint32_t reader = 0; reader < READER_COUNT; reader++) {
+    readers.push_back(std::async(std::launch::async, read));
+  }
+  std::vector<std::future<void>> writers{};
+  for (std::uint32_t writer = 0; writer < WRITER_COUNT; writer++) {
+    writers.push_back(std::async(std::launch::async, write, writer));
+  }
+  for (auto &writer : writers) {
+    writer.wait();
+  }
+  writing.store(false);
+  for (auto &reader : readers) {
+    reader.wait();
+  }
+
+  // everything written was committed, exactly once
+  ASSERT_EQ((size_t)(WRITER_COUNT * WRITE_LIMIT), darray_obj.size().value());
+  std::vector<std::vector<bool>> seen(WRITER_COUNT,
+                                      std::vector<bool>(WRITE_LIMIT, false));
+  darray_obj.for_each([&seen](const StressRecord &record) {
+    EXPECT_FALSE(seen[record.m_writer][record.m_sequence]);
+    seen[record.m_writer][record.m_sequence] = true;
+  });
+  for (const auto &writer_seen : seen) {
+    for (const bool was_seen : writer_seen) {
+      EXPECT_TRUE(was_seen);
+    }
+  }
+}
+
+TEST(appendOnlyDarray, failedSegment) {
+  // segments of 2, 4 and 8 slots allocate, 16 and beyond fail
+  append_only_darray<int, 2, LimitedAllocator<int, 8>> darray_obj{};
+  for (int value = 0; value < 14; value++) {
+    EXPECT_EQ((size_t)value, darray_obj.push_back(value).value());
+  }
+  for (int value = 14; value < 20; value++) {
+    EXPECT_FALSE(darray_obj.push_back(value).has_value());
+  }
+
+  // abandoned elements are committed, so don't hold back the watermark, but
+  // can't be read
+  EXPECT_EQ((size_t)20, darray_obj.size().value());
+  EXPECT_EQ(13, *darray_obj.at(13).value());
+  EXPECT_FALSE(darray_obj.at(14).has_value());
+  int count = 0;
+  darray_obj.for_each([&count](const int &value) { EXPECT_EQ(count++, value); });
+  EXPECT_EQ(14, count);
+}
@@ -0,0 +1,187 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#include "arena_allocator.hpp"
+#include "darray.hpp"
+#include "gtest.h"
+
+#include <cstdint>
+#include <expected>
+#include <memory_resource>
+
+using CppPlay::arena_allocator;
+using CppPlay::darray;
+using CppPlay::error;
+using CppPlay::monotonic_arena;
+using CppPlay::GrowthPolicyDouble;
+using CppPlay::ThreadProtectionDisabled;
+
+using std::expected;
+using std::unexpected;
+
+//=============================================================================
+// Helper Classes and Functions
+//=============================================================================
+template <typename T>
+using arena_darray = darray<T, ThreadProtectionDisabled<T>,
+                            GrowthPolicyDouble<T>, arena_allocator<T>>;
+
+template <typename T>
+using pmr_darray = darray<T, ThreadProtectionDisabled<T>, GrowthPolicyDouble<T>,
+                          std::pmr::polymorphic_allocator<T>>;
+
+template <typename T>
+auto is_within_arena(const monotonic_arena &arena, const T *p_element) -> bool {
+  // arena is the only allocator in use by the test, so any reserved memory
+  // counts as arena memory, check alignment as a sanity check on the bump
+  return (arena.bytes_reserved() > 0) &&
+         (0 == (reinterpret_cast<std::uintptr_t>(p_element) % alignof(T)));
+}
+
+//=============================================================================
+// Tests
+//=============================================================================
+TEST(monotonicArena, allocateAlignment) {
+  monotonic_arena arena{64};
+
+  void *p_char = arena.allocate(1, 1);
+  void *p_double = arena.allocate(sizeof(double), alignof(double));
+  void *p_big = arena.allocate(1000, 64); // larger than the first block
+  EXPECT_NE(nullptr, p_char);
+  EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(p_double) % alignof(double));
+  EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(p_big) % 64);
+  EXPECT_GE(arena.bytes_reserved(), (size_t)1000);
+
+  // deallocation is a no-op, memory is kept until reset or release
+  const size_t reserved = arena.bytes_reserved();
+  arena.deallocate(p_big, 1000, 64);
+  EXPECT_EQ(reserved, arena.bytes_reserved());
+}
+
+TEST(monotonicArena, resetRelease) {
+  monotonic_arena arena{64};
+  for (int idx = 0; idx < 100; idx++) {
+    EXPECT_NE(nullptr, arena.allocate(48, 8));
+  }
+  const size_t reserved = arena.bytes_reserved();
+  EXPECT_GE(reserved, (size_t)(100 * 48));
+
+  // reset keeps only the largest block
+  arena.reset();
+  EXPECT_LT(arena.bytes_reserved(), reserved);
+  EXPECT_GT(arena.bytes_reserved(), (size_t)0);
+  const size_t kept = arena.bytes_reserved();
+  void *p_first = arena.allocate(8, 8);
+  arena.reset();
+  EXPECT_EQ(p_first, arena.allocate(8, 8));
+  EXPECT_EQ(kept, arena.bytes_reserved());
+
+  arena.release();
+  EXPECT_EQ((size_t)0, arena.bytes_reserved());
+  EXPECT_NE(nullptr, arena.allocate(8, 8));
+}
+
+TEST(arenaAllocator, darrayStoreExtract) {
+  monotonic_arena arena{};
+
+  arena_darray<int> darray_obj =
+      arena_darray<int>::builder{arena_allocator<int>{arena}}
+          .capacity(2)
+          .build();
+  EXPECT_EQ(arena_allocator<int>{arena}, darray_obj.get_allocator());
+
+  for (int value = 0; value < 100; value++) {
+    EXPECT_TRUE(darray_obj.push_back(value).has_value());
+  }
+  EXPECT_TRUE(darray_obj.insert(-1, 50).has_value());
+  EXPECT_TRUE(is_within_arena(arena, &(*darray_obj.begin())));
+  EXPECT_EQ(-1, darray_obj[50]);
+  EXPECT_EQ(-1, darray_obj.extract(50).value());
+  for (int value = 99; value >= 0; value--) {
+    EXPECT_EQ(value, darray_obj.pop_back().value());
+  }
+  EXPECT_EQ((size_t)2, darray_obj.pod().capacity());
+}
+
+TEST(arenaAllocator, darrayCopyMove) {
+  monotonic_arena arena{};
+  monotonic_arena arena_2{};
+
+  arena_darray<std::string> darray_obj{arena_allocator<std::string>{arena}};
+  for (int value = 0; value < 20; value++) {
+    EXPECT_TRUE(darray_obj.push_back(std::to_string(value)).has_value());
+  }
+
+  // copy keeps the allocator (select_on_container_copy_construction default)
+  arena_darray<std::string> copy{darray_obj};
+  EXPECT_EQ(darray_obj.get_allocator(), copy.get_allocator());
+  EXPECT_EQ((size_t)20, copy.pod().size());
+  EXPECT_EQ("19", copy[19]);
+
+  // copy assignment doesn't propagate the allocator
+  arena_darray<std::string> assigned{arena_allocator<std::string>{arena_2}};
+  assigned = darray_obj;
+  EXPECT_EQ(arena_allocator<std::string>{arena_2}, assigned.get_allocator());
+  EXPECT_EQ("7", assigned[7]);
+
+  // move takes the buffer, leaving an empty but usable darray
+  arena_darray<std::string> moved{std::move(darray_obj)};
+  EXPECT_EQ((size_t)20, moved.pod().size());
+  EXPECT_EQ("0", moved[0]);
+  EXPECT_EQ((size_t)0, darray_obj.pod().size());
+  EXPECT_EQ((size_t)0, darray_obj.pod().capacity());
+  EXPECT_TRUE(darray_obj.push_back(std::string{"again"}).has_value());
+  EXPECT_EQ("again", darray_obj[0]);
+
+  // move assignment propagates the arena allocator
+  assigned = std::move(moved);
+  EXPECT_EQ(arena_allocator<std::string>{arena}, assigned.get_allocator());
+  EXPECT_EQ("19", assigned[19]);
+}
+
+TEST(arenaAllocator, darrayPolymorphicAllocator) {
+  monotonic_arena arena{};
+
+  pmr_darray<int> darray_obj{std::pmr::polymorphic_allocator<int>{&arena}};
+  for (int value = 0; value < 100; value++) {
+    EXPECT_TRUE(darray_obj.push_back(value).has_value());
+  }
+  EXPECT_EQ(&arena, darray_obj.get_allocator().resource());
+  EXPECT_GT(arena.bytes_reserved(), 100 * sizeof(int));
+
+  // polymorphic_allocator doesn't propagate, so a copy uses the default
+  // resource and a move assignment between resources transfers elements
+  pmr_darray<int> copy{darray_obj};
+  EXPECT_EQ(std::pmr::get_default_resource(), copy.get_allocator().resource());
+  EXPECT_EQ(99, copy[99]);
+
+  copy = std::move(darray_obj);
+  EXPECT_EQ(std::pmr::get_default_resource(), copy.get_allocator().resource());
+  EXPECT_EQ((size_t)100, copy.pod().size());
+  EXPECT_EQ(42, copy[42]);
+  EXPECT_EQ((size_t)0, darray_obj.pod().size());
+}
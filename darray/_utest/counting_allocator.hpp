@@ -0,0 +1,55 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#pragma once
+
+
+#include <cstddef> // size_t
+#include <memory>
+
+// internal linkage, each test file counts its own allocations
+namespace {
+
+// std::allocator counting its allocations
+template <typename T> struct counting_allocator {
+  using value_type = T;
+  static inline size_t s_allocations = 0;
+  counting_allocator() = default;
+  template <typename U>
+  constexpr counting_allocator(const counting_allocator<U> &) noexcept {}
+  auto allocate(const size_t count) -> T * {
+    s_allocations++;
+    return std::allocator<T>{}.allocate(count);
+  }
+  auto deallocate(T *const p_data, const size_t count) noexcept -> void {
+    std::allocator<T>{}.deallocate(p_data, count);
+  }
+  friend bool operator==(const counting_allocator &,
+                         const counting_allocator &) = default;
+};
+
+} // namespace
@@ -0,0 +1,204 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#include "cow_darray.hpp"
+#include "gtest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+using CppPlay::cow_darray;
+using CppPlay::ThreadProtectionEnabled;
+
+//=============================================================================
+// Helper Classes and Functions
+//=============================================================================
+template <typename Darray>
+static auto iota_cow(Darray &darray_obj, const int first, const int last)
+    -> void {
+  for (int value = first; value < last; value++) {
+    EXPECT_TRUE(darray_obj.push_back(value).has_value());
+  }
+}
+
+template <typename View>
+static auto holds_iota(const View &view, const int count) -> bool {
+  std::vector<int> expected_values(static_cast<size_t>(count));
+  std::iota(expected_values.begin(), expected_values.end(), 0);
+  return std::ranges::equal(expected_values, view);
+}
+
+//=============================================================================
+// Tests
+//=============================================================================
+TEST(cowDarray, copiesShareUntilChanged) {
+  cow_darray<std::string> darray_obj{};
+  for (int value = 0; value < 20; value++) {
+    EXPECT_TRUE(darray_obj.push_back(std::to_string(value)).has_value());
+  }
+  EXPECT_FALSE(darray_obj.is_shared());
+
+  // a copy shares the elements
+  cow_darray<std::string> copy{darray_obj};
+  EXPECT_TRUE(darray_obj.is_shared());
+  EXPECT_EQ(darray_obj.begin(), copy.begin());
+
+  // the first change detaches the changed darray only
+  EXPECT_TRUE(copy.replace(3, "three").has_value());
+  EXPECT_NE(darray_obj.begin(), copy.begin());
+  EXPECT_FALSE(darray_obj.is_shared());
+  EXPECT_FALSE(copy.is_shared());
+  EXPECT_EQ("3", darray_obj[3]);
+  EXPECT_EQ("three", copy[3]);
+  EXPECT_FALSE(copy.replace(20, "twenty").has_value());
+
+  // every mutation of a shared buffer leaves the other holder unchanged
+  cow_darray<std::string> popped{darray_obj};
+  EXPECT_EQ("19", popped.pop_back().value());
+  cow_darray<std::string> extracted{darray_obj};
+  EXPECT_EQ("0", extracted.extract(0).value());
+  cow_darray<std::string> inserted{darray_obj};
+  EXPECT_EQ((size_t)21, inserted.insert(std::string{"new"}, 5).value());
+  cow_darray<std::string> cleared{darray_obj};
+  EXPECT_TRUE(cleared.clear().has_value());
+  EXPECT_TRUE(cleared.pod().is_empty());
+  EXPECT_EQ((size_t)20, darray_obj.pod().size());
+  EXPECT_EQ("19", darray_obj[19]);
+  EXPECT_EQ("0", darray_obj[0]);
+  EXPECT_EQ("5", darray_obj[5]);
+  EXPECT_EQ((size_t)19, popped.pod().size());
+  EXPECT_EQ("1", extracted[0]);
+  EXPECT_EQ("new", inserted[5]);
+
+  // assignment shares, moves hand the buffer over
+  popped = darray_obj;
+  EXPECT_EQ(darray_obj.begin(), popped.begin());
+  cow_darray<std::string> moved{std::move(popped)};
+  EXPECT_EQ(darray_obj.begin(), moved.begin());
+  EXPECT_TRUE(darray_obj.is_shared());
+}
+
+TEST(cowDarray, snapshotsStayConsistent) {
+  cow_darray<int> darray_obj = cow_darray<int>::builder{}.capacity(64).build();
+  iota_cow(darray_obj, 0, 10);
+  const auto first = darray_obj.snapshot();
+  EXPECT_TRUE(darray_obj.is_shared());
+
+  // the only writer appends in place while there is room, the snapshot keeps
+  // its own size
+  const int *const p_buffer = darray_obj.begin();
+  iota_cow(darray_obj, 10, 64);
+  EXPECT_EQ(p_buffer, darray_obj.begin());
+  EXPECT_EQ((size_t)10, first.size());
+  EXPECT_TRUE(holds_iota(first, 10));
+
+  // growth past the capacity copies, the snapshot keeps the old buffer
+  const auto second = darray_obj.snapshot();
+  iota_cow(darray_obj, 64, 1000);
+  EXPECT_NE(p_buffer, darray_obj.begin());
+  EXPECT_TRUE(holds_iota(darray_obj, 1000));
+  EXPECT_TRUE(holds_iota(first, 10));
+  EXPECT_TRUE(holds_iota(second, 64));
+  EXPECT_EQ(p_buffer, second.begin());
+  EXPECT_EQ(63, *second.at(63).value());
+  EXPECT_FALSE(second.at(64).has_value());
+  EXPECT_EQ((size_t)64, second.as_span().size());
+
+  // changing an element under a snapshot copies
+  const auto third = darray_obj.snapshot();
+  EXPECT_TRUE(darray_obj.replace(0, -1).has_value());
+  EXPECT_EQ(0, third[0]);
+  EXPECT_EQ(-1, darray_obj[0]);
+
+  // a second writer never appends in place, both darrays stay independent
+  cow_darray<int> other{darray_obj};
+  EXPECT_TRUE(darray_obj.push_back(1000).has_value());
+  EXPECT_TRUE(other.push_back(-1000).has_value());
+  EXPECT_EQ(1000, darray_obj[1000]);
+  EXPECT_EQ(-1000, other[1000]);
+  EXPECT_TRUE(cow_darray<int>::snapshot_type{}.is_empty());
+}
+
+TEST(cowDarray, snapshotsHoldTheBuffer) {
+  // copies and assignments of a snapshot hold the buffer, moves hand it over,
+  // the last one let go makes changes in place again
+  cow_darray<int> darray_obj{};
+  iota_cow(darray_obj, 0, 8);
+  const int *const p_buffer = darray_obj.begin();
+  {
+    auto first = darray_obj.snapshot();
+    cow_darray<int>::snapshot_type copy{first};
+    cow_darray<int>::snapshot_type assigned{};
+    assigned = copy;
+    cow_darray<int>::snapshot_type moved{std::move(first)};
+    EXPECT_TRUE(first.is_empty());
+    copy = std::move(moved);
+    EXPECT_TRUE(holds_iota(copy, 8));
+    assigned = cow_darray<int>::snapshot_type{};
+    EXPECT_TRUE(darray_obj.is_shared());
+  }
+  EXPECT_FALSE(darray_obj.is_shared());
+  EXPECT_TRUE(darray_obj.replace(0, -1).has_value());
+  EXPECT_EQ(p_buffer, darray_obj.begin());
+}
+
+TEST(cowDarray, concurrentSnapshots) {
+  // a writer appending under thread protection, readers scanning snapshots
+  // without locks
+  using Darray = cow_darray<int, ThreadProtectionEnabled<int>>;
+  Darray darray_obj = Darray::builder{}.capacity(16).build();
+  constexpr int COUNT = 200'000;
+  std::atomic<bool> done{false};
+  std::atomic<int> failures{0};
+
+  std::vector<std::thread> readers{};
+  for (int reader = 0; reader < 3; reader++) {
+    readers.emplace_back([&]() {
+      size_t last_size = 0;
+      while (!done.load()) {
+        const auto view = darray_obj.snapshot();
+        if ((view.size() < last_size) ||
+            ((0 != view.size()) &&
+             (view[view.size() - 1] != static_cast<int>(view.size() - 1)))) {
+          failures++;
+        }
+        last_size = view.size();
+      }
+    });
+  }
+  iota_cow(darray_obj, 0, COUNT);
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(0, failures.load());
+  EXPECT_TRUE(holds_iota(darray_obj.snapshot(), COUNT));
+}
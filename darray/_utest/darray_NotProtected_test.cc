@@ -29,9 +29,18 @@
 #include "gtest.h"
 
 #include <algorithm>
+#include <cstring>
 #include <expected>
+#include <forward_list>
 #include <iterator>
+#include <memory>
+#include <numeric>
+#include <vector>
 #include <optional>
+#include <ranges>
+#include <span>
+#include <sstream>
+#include <string>
 
 using CppPlay::darray;
 using CppPlay::error;
@@ -97,6 +106,54 @@ void PrintTo(const MoveOnlyObject &m, std::ostream *os) {
   *os << m.m_guts << std::endl;
 }
 
+// owns its guts through a pointer, so can be relocated by copying its bytes
+// even though it isn't trivially copyable
+class RelocatableObject {
+public:
+  std::unique_ptr<string> m_guts;
+  RelocatableObject()
+      : m_guts{std::make_unique<string>("RelocatableObjectDefaultGuts")} {};
+  explicit RelocatableObject(string guts)
+      : m_guts{std::make_unique<string>(guts)} {};
+  RelocatableObject(RelocatableObject &&other) = default;
+  RelocatableObject &operator=(RelocatableObject &&other) = default;
+  bool operator==(const RelocatableObject &other) const {
+    return *other.m_guts == *m_guts;
+  };
+};
+void PrintTo(const RelocatableObject &m, std::ostream *os) {
+  *os << *m.m_guts << std::endl;
+}
+template <>
+struct CppPlay::is_trivially_relocatable<RelocatableObject> : std::true_type {
+};
+static_assert(!std::is_trivially_copyable_v<RelocatableObject>);
+static_assert(CppPlay::is_trivially_relocatable_v<RelocatableObject>);
+static_assert(CppPlay::is_trivially_relocatable_v<unsigned int>);
+static_assert(!CppPlay::is_trivially_relocatable_v<CopyOnlyObject>);
+
+// not default constructible, counts live instances so tests can check only
+// elements (not spare capacity) are constructed
+class CountedObject {
+public:
+  static inline int s_live_count = 0;
+  int m_value;
+  explicit CountedObject(int value) : m_value{value} { s_live_count++; };
+  CountedObject(const CountedObject &other) : m_value{other.m_value} {
+    s_live_count++;
+  };
+  CountedObject(CountedObject &&other) noexcept : m_value{other.m_value} {
+    s_live_count++;
+  };
+  CountedObject &operator=(const CountedObject &other) = default;
+  CountedObject &operator=(CountedObject &&other) = default;
+  ~CountedObject() { s_live_count--; };
+  bool operator==(const CountedObject &other) const {
+    return other.m_value == m_value;
+  };
+};
+static_assert(!std::is_default_constructible_v<CountedObject>);
+
 template <typename T, typename U> struct TestSpecPushBack {
   darray<T> &darray_obj;
   optional<darray<T> *> p_darray_obj_2_optional;
@@ -305,6 +362,29 @@ auto tester_extract(size_t index_to_erase, darray<T> &darray_obj,
       });
 };
 
+// push_back/pop_back across a capacity boundary, returns the capacities seen
+// after each call
+template <typename GrowthPolicy>
+auto oscillate_capacities(const size_t initial_capacity, const size_t fill,
+                          const unsigned int cycles) -> std::vector<size_t> {
+  using DArray =
+      darray<unsigned int, CppPlay::ThreadProtectionDisabled<unsigned int>,
+             GrowthPolicy>;
+  DArray darray_obj =
+      typename DArray::builder{}.capacity(initial_capacity).build();
+  std::vector<size_t> capacities{};
+  for (unsigned int value = 0; value < fill; value++) {
+    EXPECT_TRUE(darray_obj.push_back(value).has_value());
+  }
+  for (unsigned int cycle = 0; cycle < cycles; cycle++) {
+    EXPECT_TRUE(darray_obj.push_back(cycle).has_value());
+    capacities.push_back(darray_obj.pod().capacity());
+    EXPECT_EQ(cycle, darray_obj.pop_back().value());
+    capacities.push_back(darray_obj.pod().capacity());
+  }
+  return capacities;
+}
+
 //=============================================================================
 // Tests
 //=============================================================================
@@ -909,6 +989,532 @@ TEST(darray, extractClearMove) {
                });
 }
 
+TEST(darray, extractClearRelocatable) {
+
+  darray<RelocatableObject> darray_obj =
+      darray<RelocatableObject>::builder{}.capacity(2).build();
+
+  auto insert_at_0 = [&]() -> expected<void, error> {
+    RelocatableObject expected_values[] = {RelocatableObject{"2"}};
+    return tester_insert(0, darray_obj, RelocatableObject{"2"}, 1, 2,
+                         span{expected_values, sizeof(expected_values) /
+                                                   sizeof(RelocatableObject)});
+  };
+  auto insert_at_zero_again = [&]() -> expected<void, error> {
+    RelocatableObject expected_values[] = {RelocatableObject{"1"},
+                                           RelocatableObject{"2"}};
+    return tester_insert(0, darray_obj, RelocatableObject{"1"}, 2, 2,
+                         span{expected_values, sizeof(expected_values) /
+                                                   sizeof(RelocatableObject)});
+  };
+  auto insert_at_last = [&]() -> expected<void, error> {
+    RelocatableObject expected_values[] = {
+        RelocatableObject{"1"}, RelocatableObject{"2"}, RelocatableObject{"4"}};
+    return tester_insert(darray_obj.pod().size(), darray_obj,
+                         RelocatableObject{"4"}, 3, 4,
+                         span{expected_values, sizeof(expected_values) /
+                                                   sizeof(RelocatableObject)});
+  };
+  auto insert_at_second_last = [&]() -> expected<void, error> {
+    RelocatableObject expected_values[] = {
+        RelocatableObject{"1"}, RelocatableObject{"2"}, RelocatableObject{"3"},
+        RelocatableObject{"4"}};
+    return tester_insert(darray_obj.pod().size() - 1, darray_obj,
+                         RelocatableObject{"3"}, 4, 4,
+                         span{expected_values, sizeof(expected_values) /
+                                                   sizeof(RelocatableObject)});
+  };
+  auto insert_at_first_resized = [&]() -> expected<void, error> {
+    RelocatableObject expected_values[] = {
+        RelocatableObject{"0"}, RelocatableObject{"1"}, RelocatableObject{"2"},
+        RelocatableObject{"3"}, RelocatableObject{"4"}};
+    return tester_insert(0, darray_obj, RelocatableObject{"0"}, 5, 8,
+                         span{expected_values, sizeof(expected_values) /
+                                                   sizeof(RelocatableObject)});
+  };
+
+  auto extract_second_element = [&]() -> expected<void, error> {
+    RelocatableObject expected_values[] = {
+        RelocatableObject{"0"}, RelocatableObject{"2"}, RelocatableObject{"3"},
+        RelocatableObject{"4"}};
+    return tester_extract(1, darray_obj, RelocatableObject{"1"}, 4, 4,
+                          span{expected_values, sizeof(expected_values) /
+                                                    sizeof(RelocatableObject)});
+  };
+  auto extract_first_element = [&]() -> expected<void, error> {
+    RelocatableObject expected_values[] = {
+        RelocatableObject{"2"}, RelocatableObject{"3"}, RelocatableObject{"4"}};
+    return tester_extract(0, darray_obj, RelocatableObject{"0"}, 3, 4,
+                          span{expected_values, sizeof(expected_values) /
+                                                    sizeof(RelocatableObject)});
+  };
+  auto pop_back = [&]() -> expected<void, error> {
+    RelocatableObject expected_values[] = {RelocatableObject{"2"},
+                                           RelocatableObject{"3"}};
+    return tester_pop_back(darray_obj, RelocatableObject{"4"}, 2, 2,
+                           span{expected_values, sizeof(expected_values) /
+                                                     sizeof(RelocatableObject)});
+  };
+  auto clear = [&]() -> expected<void, error> {
+    return darray_obj.clear()
+        .and_then([&]() -> expected<void, error> {
+          EXPECT_EQ((size_t)0, darray_obj.pod().size());
+          EXPECT_EQ((size_t)2, darray_obj.pod().capacity());
+          return {};
+        })
+        .or_else([](error err) -> expected<void, error> {
+          ADD_FAILURE_AT(__FILE__, __LINE__);
+          return unexpected{err};
+        });
+  };
+
+  auto _ = insert_at_0()
+               .and_then(insert_at_zero_again)
+               .and_then(insert_at_last)
+               .and_then(insert_at_second_last)
+               .and_then(insert_at_first_resized)
+               .and_then(extract_second_element)
+               .and_then(extract_first_element)
+               .and_then(pop_back)
+               .and_then(clear)
+               .or_else([](error err) -> expected<void, error> {
+                 ADD_FAILURE_AT(__FILE__, __LINE__);
+                 return unexpected{err};
+               });
+}
+
+TEST(darray, insertExtractTriviallyCopyable) {
+
+  darray<unsigned int> darray_obj =
+      darray<unsigned int>::builder{}.capacity(2).build();
+  darray<unsigned int> darray_obj_2 =
+      darray<unsigned int>::builder{}.capacity(2).build();
+
+  // insert into the middle, through several resizes, then extract from the
+  // middle, through several resizes, comparing against a reference array
+  constexpr unsigned int ELEMENT_COUNT = 100;
+  unsigned int reference[ELEMENT_COUNT];
+  size_t reference_size = 0;
+  for (unsigned int value = 0; value < ELEMENT_COUNT; value++) {
+    const size_t index = reference_size / 2;
+    std::copy_backward(&reference[index], &reference[reference_size],
+                       &reference[reference_size + 1]);
+    reference[index] = value;
+    reference_size++;
+    EXPECT_EQ(reference_size, darray_obj.insert(value, index).value());
+    EXPECT_EQ(reference_size, darray_obj_2.push_back(value).value());
+  }
+  for (size_t idx = 0; idx < reference_size; idx++) {
+    EXPECT_EQ(reference[idx], darray_obj[idx]);
+    EXPECT_EQ(idx, darray_obj_2[idx]);
+  }
+
+  while (reference_size > 0) {
+    const size_t index = reference_size / 3;
+    EXPECT_EQ(reference[index], darray_obj.extract(index).value());
+    std::copy(&reference[index + 1], &reference[reference_size],
+              &reference[index]);
+    reference_size--;
+    EXPECT_EQ(reference_size, darray_obj.pod().size());
+    for (size_t idx = 0; idx < reference_size; idx++) {
+      EXPECT_EQ(reference[idx], darray_obj[idx]);
+    }
+  }
+  EXPECT_EQ((size_t)2, darray_obj.pod().capacity());
+}
+
+TEST(darray, liveElementsOnly) {
+
+  CountedObject::s_live_count = 0;
+  {
+    darray<CountedObject> darray_obj =
+        darray<CountedObject>::builder{}.capacity(100).build();
+    EXPECT_EQ(0, CountedObject::s_live_count);
+
+    for (int value = 0; value < 300; value++) {
+      EXPECT_TRUE(darray_obj.push_back(CountedObject{value}).has_value());
+      EXPECT_EQ(value + 1, CountedObject::s_live_count);
+    }
+    EXPECT_TRUE(darray_obj.insert(CountedObject{-1}, 150).has_value());
+    EXPECT_EQ(301, CountedObject::s_live_count);
+    EXPECT_EQ(CountedObject{-1}, darray_obj[150]);
+    EXPECT_EQ(CountedObject{150}, darray_obj[151]);
+
+    EXPECT_EQ(CountedObject{-1}, darray_obj.extract(150).value());
+    EXPECT_EQ(300, CountedObject::s_live_count);
+    EXPECT_EQ(CountedObject{299}, darray_obj.pop_back().value());
+    EXPECT_EQ(299, CountedObject::s_live_count);
+
+    {
+      darray<CountedObject> copy{darray_obj};
+      EXPECT_EQ(598, CountedObject::s_live_count);
+      EXPECT_EQ(CountedObject{298}, copy[298]);
+    }
+    EXPECT_EQ(299, CountedObject::s_live_count);
+
+    EXPECT_TRUE(darray_obj.clear().has_value());
+    EXPECT_EQ(0, CountedObject::s_live_count);
+    EXPECT_EQ((size_t)100, darray_obj.pod().capacity());
+
+    for (int value = 0; value < 10; value++) {
+      EXPECT_TRUE(darray_obj.push_back(CountedObject{value}).has_value());
+    }
+    EXPECT_EQ(10, CountedObject::s_live_count);
+  }
+  // destruction only destroys live elements
+  EXPECT_EQ(0, CountedObject::s_live_count);
+}
+
+TEST(darray, growthPolicy) {
+
+  using CppPlay::GrowthPolicyDouble;
+  using CppPlay::GrowthPolicyHysteresis;
+  using CppPlay::GrowthPolicyOneAndHalf;
+  using CppPlay::GrowthPolicyPageGranular;
+
+  // policies on their own
+  static_assert(16 == GrowthPolicyDouble<int>::grow(8));
+  static_assert(8 == GrowthPolicyDouble<int>::shrink(8, 16));
+  static_assert(16 == GrowthPolicyDouble<int>::shrink(9, 16));
+  static_assert(12 == GrowthPolicyOneAndHalf<int>::grow(8));
+  static_assert(12 == GrowthPolicyOneAndHalf<int>::shrink(9, 18));
+  static_assert(1024 == GrowthPolicyPageGranular<int>::grow(8));
+  static_assert(2048 == GrowthPolicyPageGranular<int>::grow(1024));
+  static_assert(1024 == GrowthPolicyPageGranular<int>::shrink(512, 2048));
+  static_assert(16 == GrowthPolicyHysteresis<int>::grow(8));
+  static_assert(16 == GrowthPolicyHysteresis<int>::shrink(5, 16));
+  static_assert(8 == GrowthPolicyHysteresis<int>::shrink(4, 16));
+
+  // darray built with 4, filled to 16 (capacity 16), oscillating across the
+  // boundary reallocates every call with double/halve...
+  const auto doubled = oscillate_capacities<GrowthPolicyDouble<unsigned int>>(
+      4, 16, 3);
+  EXPECT_EQ((std::vector<size_t>{32, 16, 32, 16, 32, 16}), doubled);
+
+  // ...but keeps the grown buffer with hysteresis
+  const auto hysteresis =
+      oscillate_capacities<GrowthPolicyHysteresis<unsigned int>>(4, 16, 3);
+  EXPECT_EQ((std::vector<size_t>{32, 32, 32, 32, 32, 32}), hysteresis);
+
+  // 1.5x growth from 4: 4 -> 6 -> 9 -> 13 -> 19
+  const auto one_and_half =
+      oscillate_capacities<GrowthPolicyOneAndHalf<unsigned int>>(4, 13, 1);
+  EXPECT_EQ((std::vector<size_t>{19, 19}), one_and_half);
+
+  // page granular capacities are whole pages of elements
+  const auto paged =
+      oscillate_capacities<GrowthPolicyPageGranular<unsigned int>>(4, 4, 1);
+  EXPECT_EQ((std::vector<size_t>{1024, 1024}), paged);
+
+  // never shrinks below the built capacity, nor below size
+  using DArray =
+      darray<unsigned int, CppPlay::ThreadProtectionDisabled<unsigned int>,
+             GrowthPolicyHysteresis<unsigned int>>;
+  DArray darray_obj = DArray::builder{}.capacity(4).build();
+  for (unsigned int value = 0; value < 64; value++) {
+    EXPECT_TRUE(darray_obj.push_back(value).has_value());
+  }
+  EXPECT_EQ((size_t)64, darray_obj.pod().capacity());
+  for (unsigned int value = 64; value > 0; value--) {
+    EXPECT_EQ(value - 1, darray_obj.pop_back().value());
+    EXPECT_LE(darray_obj.pod().size(), darray_obj.pod().capacity());
+    EXPECT_LE((size_t)4, darray_obj.pod().capacity());
+  }
+  EXPECT_EQ((size_t)4, darray_obj.pod().capacity());
+  for (unsigned int value = 0; value < 64; value++) {
+    EXPECT_TRUE(darray_obj.push_back(value).has_value());
+  }
+  while (darray_obj.pod().size() > 1) {
+    EXPECT_TRUE(darray_obj.extract(0).has_value());
+  }
+  EXPECT_EQ((size_t)4, darray_obj.pod().capacity());
+}
+
+TEST(darray, insertAppendRange) {
+
+  darray<unsigned int> darray_obj =
+      darray<unsigned int>::builder{}.capacity(2).build();
+
+  // grows once, straight to the capacity the growth policy would reach
+  std::vector<unsigned int> source(1000);
+  std::iota(source.begin(), source.end(), 0u);
+  EXPECT_EQ((size_t)1000, darray_obj.append_range(source).value());
+  EXPECT_EQ((size_t)1024, darray_obj.pod().capacity());
+  EXPECT_EQ(999u, darray_obj[999]);
+
+  // insert in the middle, from an iterator pair, shifts the tail once
+  const unsigned int middle[] = {5000, 5001, 5002};
+  EXPECT_EQ((size_t)1003,
+            darray_obj.insert_range(10, std::begin(middle), std::end(middle))
+                .value());
+  EXPECT_EQ(9u, darray_obj[9]);
+  EXPECT_EQ(5000u, darray_obj[10]);
+  EXPECT_EQ(5002u, darray_obj[12]);
+  EXPECT_EQ(10u, darray_obj[13]);
+  EXPECT_EQ(999u, darray_obj[1002]);
+
+  // forward range of unknown size, and a single pass range, at the front
+  std::forward_list<unsigned int> forward{7, 8};
+  EXPECT_EQ((size_t)1005, darray_obj.insert_range(0, forward).value());
+  std::istringstream stream{"40 41 42"};
+  EXPECT_EQ((size_t)1008,
+            darray_obj
+                .insert_range(0, std::ranges::istream_view<unsigned int>{stream})
+                .value());
+  EXPECT_EQ(40u, darray_obj[0]);
+  EXPECT_EQ(42u, darray_obj[2]);
+  EXPECT_EQ(7u, darray_obj[3]);
+  EXPECT_EQ(0u, darray_obj[5]);
+
+  // empty range and out of range index
+  EXPECT_EQ((size_t)1008,
+            darray_obj.append_range(std::vector<unsigned int>{}).value());
+  EXPECT_FALSE(darray_obj.insert_range(1009, source).has_value());
+  EXPECT_EQ((size_t)1008, darray_obj.pod().size());
+
+  // move only elements, through move iterators
+  darray<MoveOnlyObject> move_only =
+      darray<MoveOnlyObject>::builder{}.capacity(2).build();
+  std::vector<MoveOnlyObject> objects{};
+  for (int value = 0; value < 5; value++) {
+    objects.push_back(MoveOnlyObject{std::to_string(value)});
+  }
+  EXPECT_TRUE(move_only.push_back(MoveOnlyObject{"-1"}).has_value());
+  EXPECT_EQ((size_t)6, move_only
+                           .insert_range(0, std::make_move_iterator(objects.begin()),
+                                         std::make_move_iterator(objects.end()))
+                           .value());
+  EXPECT_EQ(MoveOnlyObject{"4"}, move_only[4]);
+  EXPECT_EQ(MoveOnlyObject{"-1"}, move_only[5]);
+
+  // only live elements are constructed
+  CountedObject::s_live_count = 0;
+  {
+    darray<CountedObject> counted =
+        darray<CountedObject>::builder{}.capacity(4).build();
+    std::vector<CountedObject> copies(10, CountedObject{1});
+    EXPECT_EQ(10, CountedObject::s_live_count);
+    EXPECT_TRUE(counted.append_range(copies).has_value());
+    EXPECT_TRUE(counted.insert_range(5, copies).has_value());
+    EXPECT_EQ(30, CountedObject::s_live_count);
+    EXPECT_EQ((size_t)20, counted.pod().size());
+  }
+  EXPECT_EQ(0, CountedObject::s_live_count);
+}
+
+TEST(darray, insertRangeSelf) {
+
+  darray<std::string> darray_obj =
+      darray<std::string>::builder{}.capacity(4).build();
+  for (const char *const p_value : {"a", "b", "c", "d"}) {
+    EXPECT_TRUE(darray_obj.push_back(std::string{p_value}).has_value());
+  }
+
+  // appending itself when full, growing frees the source buffer
+  EXPECT_EQ((size_t)8, darray_obj.append_range(darray_obj).value());
+  EXPECT_EQ("abcdabcd", std::accumulate(darray_obj.begin(), darray_obj.end(),
+                                        std::string{}));
+
+  // inserting part of itself within capacity, shifting moves the source
+  EXPECT_TRUE(darray_obj.pop_back().has_value());
+  EXPECT_TRUE(darray_obj.pop_back().has_value());
+  EXPECT_EQ((size_t)8,
+            darray_obj.insert_range(0, darray_obj.as_span().subspan(1, 2))
+                .value());
+  EXPECT_EQ((size_t)8, darray_obj.pod().capacity());
+  EXPECT_EQ("bcabcdab", std::accumulate(darray_obj.begin(), darray_obj.end(),
+                                        std::string{}));
+
+  // a non contiguous view of itself, in the middle
+  EXPECT_EQ((size_t)16,
+            darray_obj.insert_range(4, darray_obj | std::views::reverse)
+                .value());
+  EXPECT_EQ("bcabbadcbacbcdab",
+            std::accumulate(darray_obj.begin(), darray_obj.end(),
+                            std::string{}));
+}
+
+TEST(darray, appendWith) {
+
+  darray<unsigned int> darray_obj =
+      darray<unsigned int>::builder{}.capacity(8).build();
+  EXPECT_TRUE(darray_obj.push_back(7u).has_value());
+
+  // writer constructs fewer than offered, spare capacity fits, no growth
+  EXPECT_EQ((size_t)4, darray_obj
+                           .append_with(6,
+                                        [](unsigned int *p_spare) -> size_t {
+                                          for (unsigned int idx = 0; idx < 3;
+                                               idx++) {
+                                            std::construct_at(&p_spare[idx],
+                                                              idx * 10);
+                                          }
+                                          return 3;
+                                        })
+                           .value());
+  EXPECT_EQ((size_t)8, darray_obj.pod().capacity());
+  EXPECT_EQ(7u, darray_obj[0]);
+  EXPECT_EQ(20u, darray_obj[3]);
+
+  // grows once, elements already stored are kept
+  EXPECT_EQ((size_t)4, darray_obj
+                           .append_with(100,
+                                        [](unsigned int *) -> size_t {
+                                          return 0;
+                                        })
+                           .value());
+  EXPECT_EQ((size_t)128, darray_obj.pod().capacity());
+  EXPECT_EQ(10u, darray_obj[2]);
+
+  // a writer claiming more than it was given room for is an error
+  EXPECT_FALSE(darray_obj
+                   .append_with(2,
+                                [](unsigned int *p_spare) -> size_t {
+                                  std::construct_at(&p_spare[0], 1u);
+                                  std::construct_at(&p_spare[1], 2u);
+                                  return 3;
+                                })
+                   .has_value());
+  EXPECT_EQ((size_t)4, darray_obj.pod().size());
+
+  // only what the writer constructed is destroyed
+  CountedObject::s_live_count = 0;
+  {
+    darray<CountedObject> counted =
+        darray<CountedObject>::builder{}.capacity(2).build();
+    EXPECT_EQ((size_t)2, counted
+                             .append_with(10,
+                                          [](CountedObject *p_spare) -> size_t {
+                                            std::construct_at(&p_spare[0], 1);
+                                            std::construct_at(&p_spare[1], 2);
+                                            return 2;
+                                          })
+                             .value());
+    EXPECT_EQ(2, CountedObject::s_live_count);
+  }
+  EXPECT_EQ(0, CountedObject::s_live_count);
+}
+
+TEST(darray, dataSpanBytes) {
+
+  darray<unsigned int> darray_obj =
+      darray<unsigned int>::builder{}.capacity(8).build();
+  EXPECT_TRUE(darray_obj.as_span().empty());
+  EXPECT_TRUE(darray_obj.as_bytes().empty());
+  EXPECT_TRUE(darray_obj.append_range(std::vector<unsigned int>{1, 2, 3})
+                  .has_value());
+
+  // views of the live elements over the darray's own buffer
+  EXPECT_EQ(&darray_obj[0], darray_obj.data());
+  const std::span<unsigned int> elements = darray_obj.as_span();
+  EXPECT_EQ((size_t)3, elements.size());
+  EXPECT_EQ(darray_obj.data(), elements.data());
+  elements[1] = 20;
+  EXPECT_EQ(20u, darray_obj[1]);
+
+  const std::span<const std::byte> bytes = darray_obj.as_bytes();
+  EXPECT_EQ(3 * sizeof(unsigned int), bytes.size());
+  unsigned int first = 0;
+  std::memcpy(&first, bytes.data(), sizeof(first));
+  EXPECT_EQ(1u, first);
+}
+
+TEST(darray, eraseRangeIfSwapRemove) {
+
+  darray<unsigned int> darray_obj =
+      darray<unsigned int>::builder{}.capacity(2).build();
+  std::vector<unsigned int> source(1024);
+  std::iota(source.begin(), source.end(), 0u);
+  EXPECT_TRUE(darray_obj.append_range(source).has_value());
+  EXPECT_EQ((size_t)1024, darray_obj.pod().capacity());
+
+  // invalid ranges leave the darray untouched, an empty range is a no-op
+  EXPECT_FALSE(darray_obj.erase_range(10, 5).has_value());
+  EXPECT_FALSE(darray_obj.erase_range(0, 1025).has_value());
+  EXPECT_EQ((size_t)1024, darray_obj.erase_range(7, 7).value());
+  EXPECT_EQ((size_t)1024, darray_obj.pod().capacity());
+
+  // tail shifted once, shrinks straight to the capacity the growth policy
+  // would reach
+  EXPECT_EQ((size_t)24, darray_obj.erase_range(10, 1010).value());
+  EXPECT_EQ((size_t)32, darray_obj.pod().capacity());
+  EXPECT_EQ(9u, darray_obj[9]);
+  EXPECT_EQ(1010u, darray_obj[10]);
+  EXPECT_EQ(1023u, darray_obj[23]);
+
+  // order kept for the remaining elements
+  EXPECT_EQ((size_t)12,
+            darray_obj.erase_if([](unsigned int value) { return value & 1; })
+                .value());
+  EXPECT_EQ((size_t)12, darray_obj.pod().size());
+  EXPECT_EQ((size_t)16, darray_obj.pod().capacity());
+  EXPECT_EQ(0u, darray_obj[0]);
+  EXPECT_EQ(8u, darray_obj[4]);
+  EXPECT_EQ(1010u, darray_obj[5]);
+  EXPECT_EQ(1022u, darray_obj[11]);
+  EXPECT_EQ((size_t)0,
+            darray_obj.erase_if([](unsigned int value) { return value & 1; })
+                .value());
+
+  // last element takes the place of the removed one
+  EXPECT_EQ(0u, darray_obj.swap_remove(0).value());
+  EXPECT_EQ(1022u, darray_obj[0]);
+  EXPECT_EQ(2u, darray_obj[1]);
+  EXPECT_EQ(1020u, darray_obj.swap_remove(10).value());
+  EXPECT_EQ((size_t)10, darray_obj.pod().size());
+  EXPECT_FALSE(darray_obj.swap_remove(10).has_value());
+
+  // everything erased, back to original capacity
+  EXPECT_EQ((size_t)10, darray_obj.erase_if([](unsigned int) { return true; })
+                            .value());
+  EXPECT_EQ((size_t)0, darray_obj.pod().size());
+  EXPECT_EQ((size_t)2, darray_obj.pod().capacity());
+
+  // move only elements
+  darray<MoveOnlyObject> move_only =
+      darray<MoveOnlyObject>::builder{}.capacity(2).build();
+  for (int value = 0; value < 8; value++) {
+    EXPECT_TRUE(
+        move_only.push_back(MoveOnlyObject{std::to_string(value)}).has_value());
+  }
+  EXPECT_EQ((size_t)5, move_only.erase_range(1, 4).value());
+  EXPECT_EQ(MoveOnlyObject{"0"}, move_only[0]);
+  EXPECT_EQ(MoveOnlyObject{"4"}, move_only[1]);
+  EXPECT_EQ((size_t)2, move_only
+                           .erase_if([](const MoveOnlyObject &object) {
+                             return object == MoveOnlyObject{"4"} ||
+                                    object == MoveOnlyObject{"6"};
+                           })
+                           .value());
+  EXPECT_EQ(MoveOnlyObject{"0"}, move_only.swap_remove(0).value());
+  EXPECT_EQ(MoveOnlyObject{"7"}, move_only[0]);
+  EXPECT_EQ(MoveOnlyObject{"5"}, move_only[1]);
+
+  // only live elements remain constructed
+  CountedObject::s_live_count = 0;
+  {
+    darray<CountedObject> counted =
+        darray<CountedObject>::builder{}.capacity(4).build();
+    for (int value = 0; value < 100; value++) {
+      EXPECT_TRUE(counted.push_back(CountedObject{value}).has_value());
+    }
+    EXPECT_EQ(100, CountedObject::s_live_count);
+    EXPECT_EQ((size_t)80, counted.erase_range(10, 30).value());
+    EXPECT_EQ(80, CountedObject::s_live_count);
+    EXPECT_EQ((size_t)40,
+              counted
+                  .erase_if([](const CountedObject &object) {
+                    return object.m_value % 2;
+                  })
+                  .value());
+    EXPECT_EQ(40, CountedObject::s_live_count);
+    EXPECT_EQ(30, counted.swap_remove(5).value().m_value);
+    EXPECT_EQ(39, CountedObject::s_live_count);
+    EXPECT_EQ(98, counted[5].m_value);
+  }
+  EXPECT_EQ(0, CountedObject::s_live_count);
+}
+
 static_assert(std::contiguous_iterator<darray<int>::iterator>);
 static_assert(std::contiguous_iterator<darray<CopyOnlyObject>::iterator>);
 static_assert(std::contiguous_iterator<darray<MoveOnlyObject>::iterator>);
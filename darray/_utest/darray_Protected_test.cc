@@ -28,8 +28,11 @@
 #include "darray.hpp"
 #include "gtest.h"
 
+#include <atomic>
 #include <expected>
 #include <future>
+#include <thread>
+#include <vector>
 
 using CppPlay::darray;
 using std::string;
@@ -37,6 +40,62 @@ using std::string;
 //=============================================================================
 // Helper Classes and Functions
 //=============================================================================
+// writers push_back and pop_back while readers check metadata and elements
+// are always consistent
+template <template <typename> typename ThreadProtection>
+auto concurrent_readers_writers() -> void {
+  constexpr int READER_COUNT = 4;
+  constexpr int WRITE_LIMIT = 2000;
+
+  using DArray = darray<int, ThreadProtection<int>>;
+  DArray darray_obj = typename DArray::builder{}.capacity(2).build();
+  EXPECT_TRUE(darray_obj.push_back(-1).has_value());
+  std::atomic<bool> writing{true};
+
+  auto write = [&]() {
+    for (int idx = 0; idx < WRITE_LIMIT; idx++) {
+      EXPECT_TRUE(darray_obj.push_back(idx).has_value());
+      if (0 == (idx % 3)) {
+        EXPECT_TRUE(darray_obj.pop_back().has_value());
+      }
+    }
+  };
+  auto read = [&]() {
+    while (writing.load()) {
+      const size_t size = darray_obj.pod().size();
+      const size_t capacity = darray_obj.pod().capacity();
+      EXPECT_GE(size, (size_t)1);
+      EXPECT_LE(size, (size_t)(WRITE_LIMIT * 2));
+      EXPECT_GE(capacity, (size_t)2);
+      EXPECT_FALSE(darray_obj.is_empty().value());
+      // returned iterators/references aren't protected, so only the lookup
+      // is checked, not the element
+      EXPECT_TRUE(darray_obj.at(0).has_value());
+      EXPECT_FALSE(darray_obj.at(WRITE_LIMIT * 2).has_value());
+      // give writers a look in, shared_mutex may prefer readers
+      std::this_thread::yield();
+    }
+  };
+
+  std::vector<std::future<void>> readers{};
+  for (int reader = 0; reader < READER_COUNT; reader++) {
+    readers.push_back(std::async(std::launch::async, read));
+  }
+  auto writer_1 = std::async(std::launch::async, write);
+  auto writer_2 = std::async(std::launch::async, write);
+  writer_1.wait();
+  writer_2.wait();
+  writing.store(false);
+  for (auto &reader : readers) {
+    reader.wait();
+  }
+
+  // each writer pops a third of what it pushes
+  const size_t expected_size = 1 + (2 * (WRITE_LIMIT - ((WRITE_LIMIT + 2) / 3)));
+  EXPECT_EQ(expected_size, darray_obj.pod().size());
+  EXPECT_EQ(expected_size, darray_obj.size().value());
+  EXPECT_LE(darray_obj.pod().size(), darray_obj.capacity().value());
+}
 
 //=============================================================================
 // Tests
@@ -67,3 +126,105 @@ TEST(darrayProtected, test) {
 
   EXPECT_EQ(ADD_LIMIT * 3, darray_obj.size());
 }
+
+TEST(darrayProtected, copyMove) {
+
+  using DArray = darray<int, CppPlay::ThreadProtectionEnabled<int>>;
+  DArray darray_obj = DArray::builder{}.capacity(2).build();
+  for (int idx = 0; idx < 100; idx++) {
+    EXPECT_TRUE(darray_obj.push_back(idx).has_value());
+  }
+
+  // both darrays are locked while copying or moving
+  DArray copy{darray_obj};
+  EXPECT_EQ((size_t)100, copy.pod().size());
+  EXPECT_EQ(99, copy[99]);
+
+  DArray moved{std::move(copy)};
+  EXPECT_EQ((size_t)100, moved.pod().size());
+  EXPECT_EQ((size_t)0, copy.pod().size());
+
+  copy = moved;
+  EXPECT_EQ(42, copy[42]);
+  darray_obj = std::move(moved);
+  EXPECT_EQ(7, darray_obj[7]);
+}
+
+TEST(darrayProtected, concurrentReadersWriters) {
+  concurrent_readers_writers<CppPlay::ThreadProtectionEnabled>();
+  concurrent_readers_writers<CppPlay::ThreadProtectionSharedRead>();
+  concurrent_readers_writers<CppPlay::ThreadProtectionSharedReadSeqlock>();
+}
+
+static_assert(CppPlay::shared_read_protection<
+              CppPlay::ThreadProtectionSharedRead<int>>);
+static_assert(!CppPlay::shared_read_protection<
+              CppPlay::ThreadProtectionEnabled<int>>);
+static_assert(CppPlay::seqlock_metadata_protection<
+              CppPlay::ThreadProtectionSharedReadSeqlock<int>>);
+static_assert(!CppPlay::seqlock_metadata_protection<
+              CppPlay::ThreadProtectionSharedRead<int>>);
+// disabled thread protection still costs nothing
+static_assert(sizeof(darray<int>) ==
+              sizeof(darray<int, CppPlay::ThreadProtectionDisabled<int>>));
+static_assert(sizeof(darray<int>) <
+              sizeof(darray<int, CppPlay::ThreadProtectionEnabled<int>>));
+
+TEST(darrayProtected, sharedReadCopyMove) {
+
+  using DArray = darray<int, CppPlay::ThreadProtectionSharedReadSeqlock<int>>;
+  DArray darray_obj = DArray::builder{}.capacity(4).build();
+  EXPECT_EQ((size_t)4, darray_obj.pod().capacity());
+  EXPECT_TRUE(darray_obj.pod().is_empty());
+  for (int idx = 0; idx < 100; idx++) {
+    EXPECT_TRUE(darray_obj.push_back(idx).has_value());
+  }
+  EXPECT_EQ((size_t)100, darray_obj.pod().size());
+  EXPECT_EQ((size_t)128, darray_obj.pod().capacity());
+
+  // metadata of both darrays is published by copy and move
+  DArray copy{darray_obj};
+  EXPECT_EQ((size_t)100, copy.pod().size());
+  DArray moved{std::move(copy)};
+  EXPECT_EQ((size_t)100, moved.pod().size());
+  EXPECT_EQ((size_t)0, copy.pod().size());
+  EXPECT_EQ((size_t)0, copy.pod().capacity());
+  EXPECT_TRUE(darray_obj.clear().has_value());
+  EXPECT_EQ((size_t)0, darray_obj.size().value());
+  EXPECT_EQ((size_t)4, darray_obj.capacity().value());
+}
+
+TEST(darrayProtected, appendRangeLocksOnce) {
+
+  constexpr int THREAD_COUNT = 4;
+  constexpr int BATCH_COUNT = 50;
+  constexpr int BATCH_SIZE = 100;
+
+  using DArray = darray<int, CppPlay::ThreadProtectionEnabled<int>>;
+  DArray darray_obj = DArray::builder{}.capacity(2).build();
+
+  // each batch holds its thread number, as a batch is appended under one lock
+  // batches are never interleaved
+  auto append = [&](const int thread) {
+    const std::vector<int> batch(BATCH_SIZE, thread);
+    for (int idx = 0; idx < BATCH_COUNT; idx++) {
+      EXPECT_TRUE(darray_obj.append_range(batch).has_value());
+    }
+  };
+  std::vector<std::future<void>> appenders{};
+  for (int thread = 0; thread < THREAD_COUNT; thread++) {
+    appenders.push_back(std::async(std::launch::async, append, thread));
+  }
+  for (auto &appender : appenders) {
+    appender.wait();
+  }
+
+  ASSERT_EQ((size_t)(THREAD_COUNT * BATCH_COUNT * BATCH_SIZE),
+            darray_obj.pod().size());
+  for (size_t batch = 0; batch < (THREAD_COUNT * BATCH_COUNT); batch++) {
+    const int thread = darray_obj[batch * BATCH_SIZE];
+    for (size_t idx = 1; idx < BATCH_SIZE; idx++) {
+      EXPECT_EQ(thread, darray_obj[(batch * BATCH_SIZE) + idx]);
+    }
+  }
+}
@@ -0,0 +1,259 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#include "darray_heap.hpp"
+#include "gtest.h"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+using CppPlay::darray_heap;
+
+//=============================================================================
+// Helper Classes and Functions
+//=============================================================================
+// pushes, pops, push_pops and a bulk heapify give the std::priority_queue
+// order
+template <size_t D, typename Compare> static auto pop_like_std() -> void {
+  using Heap = darray_heap<int, Compare, D>;
+  std::mt19937 generator{42};
+  std::uniform_int_distribution<int> distribution{-500, 500};
+
+  Heap heap_obj{};
+  std::priority_queue<int, std::vector<int>, Compare> reference;
+  for (size_t idx = 0; idx < 3000; idx++) {
+    const int value = distribution(generator);
+    if ((idx % 5) == 4) {
+      reference.push(value);
+      const int expected_top = reference.top();
+      reference.pop();
+      EXPECT_EQ(expected_top, heap_obj.push_pop(value).value());
+    } else if ((idx % 7) == 6) {
+      EXPECT_EQ(reference.top(), heap_obj.pop().value());
+      reference.pop();
+    } else {
+      reference.push(value);
+      EXPECT_EQ(reference.size(), heap_obj.push(value).value());
+    }
+    EXPECT_EQ(reference.top(), heap_obj.top().value().get());
+  }
+
+  std::vector<int> bulk(5000);
+  for (int &value : bulk) {
+    value = distribution(generator);
+    reference.push(value);
+  }
+  EXPECT_EQ(reference.size(), heap_obj.heapify(bulk).value());
+  while (!reference.empty()) {
+    EXPECT_EQ(reference.top(), heap_obj.pop().value());
+    reference.pop();
+  }
+  EXPECT_TRUE(heap_obj.pod().is_empty());
+  EXPECT_FALSE(heap_obj.pop().has_value());
+  EXPECT_FALSE(heap_obj.top().has_value());
+}
+
+//=============================================================================
+// Tests
+//=============================================================================
+TEST(darrayHeap, arities) {
+  pop_like_std<2, std::less<int>>();
+  pop_like_std<3, std::less<int>>();
+  pop_like_std<4, std::less<int>>();
+  pop_like_std<8, std::less<int>>();
+  pop_like_std<4, std::greater<int>>();
+  pop_like_std<8, std::greater<int>>();
+}
+
+TEST(darrayHeap, strings) {
+  darray_heap<std::string, std::greater<>, 4> heap_obj =
+      darray_heap<std::string, std::greater<>, 4>::builder{}
+          .capacity(100)
+          .build();
+  EXPECT_EQ((size_t)100, heap_obj.pod().capacity());
+  const std::vector<std::string> words{"pear", "apple", "fig", "kiwi",
+                                       "banana", "cherry"};
+  EXPECT_EQ((size_t)6, heap_obj.heapify(words).value());
+  EXPECT_EQ((size_t)7, heap_obj.push(std::string{"date"}).value());
+  EXPECT_EQ("apple", heap_obj.push_pop("zucchini").value());
+  EXPECT_EQ("aaa", heap_obj.push_pop("aaa").value());
+  for (const char *const expected_word :
+       {"banana", "cherry", "date", "fig", "kiwi", "pear", "zucchini"}) {
+    EXPECT_EQ(expected_word, heap_obj.pop().value());
+  }
+}
+
+TEST(darrayHeap, handles) {
+  using Heap =
+      darray_heap<int, std::greater<int>, 4, CppPlay::HeapHandlesEnabled>;
+  Heap heap_obj{};
+  std::vector<Heap::handle_type> handles;
+  for (int value = 0; value < 100; value++) {
+    handles.push_back(heap_obj.push(1000 + value).value());
+  }
+  EXPECT_EQ(1000, heap_obj.top().value().get());
+  EXPECT_EQ(1050, heap_obj.at(handles[50]).value().get());
+
+  // decrease-key moves towards the top only
+  EXPECT_TRUE(heap_obj.decrease_key(handles[70], 5).has_value());
+  EXPECT_EQ(5, heap_obj.top().value().get());
+  EXPECT_FALSE(heap_obj.decrease_key(handles[70], 6).has_value());
+  EXPECT_EQ(5, heap_obj.at(handles[70]).value().get());
+
+  // update moves either way
+  EXPECT_TRUE(heap_obj.update(handles[70], 5000).has_value());
+  EXPECT_TRUE(heap_obj.update(handles[99], 1).has_value());
+  EXPECT_EQ(1, heap_obj.pop().value());
+  EXPECT_FALSE(heap_obj.contains(handles[99]));
+  EXPECT_FALSE(heap_obj.update(handles[99], 1).has_value());
+
+  // popped handles are reused, every handle still finds its element
+  const Heap::handle_type reused = heap_obj.push(7).value();
+  EXPECT_EQ(handles[99], reused);
+  for (int value = 0; value < 99; value++) {
+    const int expected_value = (value == 70) ? 5000 : (1000 + value);
+    EXPECT_EQ(expected_value, heap_obj.at(handles[value]).value().get());
+  }
+
+  // pops follow the updated values
+  std::vector<int> popped;
+  while (!heap_obj.pod().is_empty()) {
+    popped.push_back(heap_obj.pop().value());
+  }
+  EXPECT_TRUE(std::is_sorted(popped.begin(), popped.end()));
+  EXPECT_EQ(7, popped.front());
+  EXPECT_EQ(5000, popped.back());
+  EXPECT_FALSE(heap_obj.contains(handles[0]));
+}
+
+TEST(darrayHeap, handlesHeapify) {
+  // bulk loaded elements get consecutive handles, after the pushed ones
+  using Heap =
+      darray_heap<int, std::greater<int>, 4, CppPlay::HeapHandlesEnabled>;
+  Heap heap_obj{};
+  EXPECT_EQ((size_t)0, heap_obj.push(50).value());
+  EXPECT_EQ((size_t)1, heap_obj.push(60).value());
+  std::vector<int> bulk(1000);
+  std::iota(bulk.begin(), bulk.end(), 100);
+  std::ranges::reverse(bulk);
+  const Heap::handle_type first = heap_obj.heapify(bulk).value();
+  EXPECT_EQ((size_t)2, first);
+  EXPECT_EQ((size_t)1002, heap_obj.pod().size());
+  for (size_t idx = 0; idx < bulk.size(); idx++) {
+    EXPECT_EQ(bulk[idx], heap_obj.at(first + idx).value().get());
+  }
+
+  // the handles re-prioritize their elements
+  EXPECT_TRUE(heap_obj.decrease_key(first + 10, 1).has_value());
+  EXPECT_TRUE(heap_obj.update(0, 5000).has_value());
+  EXPECT_EQ((size_t)1002, heap_obj.heapify(std::vector<int>{}).value());
+  std::vector<int> popped;
+  while (!heap_obj.pod().is_empty()) {
+    popped.push_back(heap_obj.pop().value());
+  }
+  EXPECT_TRUE(std::is_sorted(popped.begin(), popped.end()));
+  EXPECT_EQ(1, popped.front());
+  EXPECT_EQ(5000, popped.back());
+}
+
+TEST(darrayHeap, handlesShortestPaths) {
+  // dijkstra on a grid with decrease-key, against one without (lazy
+  // deletion in a std::priority_queue)
+  constexpr size_t side = 60;
+  constexpr size_t vertices = side * side;
+  std::mt19937 generator{42};
+  std::uniform_int_distribution<int> distribution{1, 9};
+  std::vector<int> weights(vertices);
+  for (int &weight : weights) {
+    weight = distribution(generator);
+  }
+  const auto neighbours = [&](const size_t vertex) {
+    std::vector<size_t> result;
+    if ((vertex % side) > 0) {
+      result.push_back(vertex - 1);
+    }
+    if ((vertex % side) < (side - 1)) {
+      result.push_back(vertex + 1);
+    }
+    if (vertex >= side) {
+      result.push_back(vertex - side);
+    }
+    if (vertex < (vertices - side)) {
+      result.push_back(vertex + side);
+    }
+    return result;
+  };
+
+  using Entry = std::pair<int, size_t>;
+  std::vector<int> expected_distances(vertices, -1);
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<>> lazy;
+  lazy.push({0, 0});
+  while (!lazy.empty()) {
+    const auto [distance, vertex] = lazy.top();
+    lazy.pop();
+    if (expected_distances[vertex] >= 0) {
+      continue;
+    }
+    expected_distances[vertex] = distance;
+    for (const size_t next : neighbours(vertex)) {
+      lazy.push({distance + weights[next], next});
+    }
+  }
+
+  using Heap =
+      darray_heap<Entry, std::greater<>, 4, CppPlay::HeapHandlesEnabled>;
+  Heap heap_obj{};
+  std::vector<Heap::handle_type> handle_of(vertices);
+  std::vector<int> distances(vertices, -1);
+  std::vector<bool> queued(vertices, false);
+  handle_of[0] = heap_obj.push(Entry{0, 0}).value();
+  queued[0] = true;
+  while (!heap_obj.pod().is_empty()) {
+    const auto [distance, vertex] = heap_obj.pop().value();
+    distances[vertex] = distance;
+    for (const size_t next : neighbours(vertex)) {
+      const Entry candidate{distance + weights[next], next};
+      if (distances[next] >= 0) {
+        // popped, its handle may already belong to another vertex
+        continue;
+      }
+      if (!queued[next]) {
+        handle_of[next] = heap_obj.push(candidate).value();
+        queued[next] = true;
+      } else if (candidate < heap_obj.at(handle_of[next]).value().get()) {
+        EXPECT_TRUE(
+            heap_obj.decrease_key(handle_of[next], candidate).has_value());
+      }
+    }
+  }
+  EXPECT_EQ(expected_distances, distances);
+}
@@ -0,0 +1,205 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#include "darray_io.hpp"
+#include "gtest.h"
+#include "temp_file.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <expected>
+#include <fcntl.h>
+#include <filesystem>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using CppPlay::darray;
+
+//=============================================================================
+// Helper Classes and Functions
+//=============================================================================
+namespace {
+// temp file open for reading and writing, closed when the test ends
+class OpenTempFile {
+  TempFile m_file;
+  int m_fd;
+
+public:
+  explicit OpenTempFile(const std::string &name)
+      : m_file{name},
+        m_fd{open(m_file.path().c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644)} {}
+  ~OpenTempFile() { close(m_fd); }
+  OpenTempFile(const OpenTempFile &) = delete;
+  auto operator=(const OpenTempFile &) -> OpenTempFile & = delete;
+
+  [[nodiscard]] auto fd() const -> int { return m_fd; }
+  [[nodiscard]] auto bytes() const -> std::vector<std::byte> {
+    std::vector<std::byte> contents(std::filesystem::file_size(m_file.path()));
+    EXPECT_EQ(static_cast<ssize_t>(contents.size()),
+              pread(m_fd, contents.data(), contents.size(), 0));
+    return contents;
+  }
+};
+} // namespace
+
+template <typename T>
+static auto iota_darray(const size_t count, const T first) -> darray<T> {
+  darray<T> darray_obj = typename darray<T>::builder{}.capacity(count).build();
+  for (size_t idx = 0; idx < count; idx++) {
+    EXPECT_TRUE(darray_obj.push_back(static_cast<T>(first + idx)).has_value());
+  }
+  return darray_obj;
+}
+
+// bytes of every buffer in order
+template <typename... R>
+static auto concatenated(const R &...buffers) -> std::vector<std::byte> {
+  std::vector<std::byte> contents{};
+  (contents.insert(contents.end(), std::as_bytes(std::span{buffers}).begin(),
+                   std::as_bytes(std::span{buffers}).end()),
+   ...);
+  return contents;
+}
+
+//=============================================================================
+// Tests
+//=============================================================================
+TEST(darrayIo, writeBuffers) {
+  const OpenTempFile file{"darrayIo.writeBuffers"};
+  const auto longs = iota_darray<std::uint64_t>(1000, 0);
+  const auto chars = iota_darray<char>(7, 'a');
+  const std::vector<std::uint16_t> shorts{1, 2, 3};
+
+  // mixed buffer types, in order, in one call
+  EXPECT_EQ(8000U + 7 + 6,
+            CppPlay::write_buffers(file.fd(), longs, chars, shorts).value());
+  EXPECT_EQ(concatenated(longs.as_span(), chars.as_span(), shorts),
+            file.bytes());
+
+  // positional writes leave the file position alone
+  EXPECT_EQ(7U, CppPlay::pwrite_buffers(file.fd(), 0, chars).value());
+  EXPECT_EQ(6U, CppPlay::write_buffers(file.fd(), shorts).value());
+  auto expected_bytes = concatenated(chars.as_span(), longs.as_span(),
+                                     chars.as_span(), shorts, shorts);
+  expected_bytes.erase(expected_bytes.begin() + 7,
+                       expected_bytes.begin() + 14);
+  EXPECT_EQ(expected_bytes, file.bytes());
+}
+
+TEST(darrayIo, writeBufferList) {
+  const OpenTempFile file{"darrayIo.writeBufferList"};
+  // more buffers than one writev takes, empty ones among them
+  darray<darray<std::uint32_t>> buffers{};
+  std::vector<std::byte> expected_bytes{};
+  for (std::uint32_t idx = 0; idx < 3000; idx++) {
+    EXPECT_TRUE(buffers.push_back(iota_darray<std::uint32_t>(idx % 5, idx))
+                    .has_value());
+    const auto bytes = buffers[idx].as_bytes();
+    expected_bytes.insert(expected_bytes.end(), bytes.begin(), bytes.end());
+  }
+  EXPECT_EQ(expected_bytes.size(),
+            CppPlay::write_buffer_list(file.fd(), buffers).value());
+  EXPECT_EQ(expected_bytes, file.bytes());
+  EXPECT_EQ(expected_bytes.size(),
+            CppPlay::pwrite_buffer_list(file.fd(), 4, buffers).value());
+  std::vector<std::byte> shifted(expected_bytes.begin(),
+                                 expected_bytes.begin() + 4);
+  shifted.insert(shifted.end(), expected_bytes.begin(), expected_bytes.end());
+  expected_bytes = shifted;
+  EXPECT_EQ(expected_bytes, file.bytes());
+
+  // failures are reported
+  EXPECT_FALSE(CppPlay::write_buffer_list(-1, buffers).has_value());
+  EXPECT_FALSE(CppPlay::write_buffers(-1, buffers[1]).has_value());
+}
+
+TEST(darrayIo, readAppend) {
+  const OpenTempFile file{"darrayIo.readAppend"};
+  const auto source = iota_darray<std::uint64_t>(10'000, 0);
+  EXPECT_TRUE(CppPlay::write_buffers(file.fd(), source).has_value());
+
+  // sequential reads into preallocated spare capacity never grow it
+  EXPECT_EQ(0, lseek(file.fd(), 0, SEEK_SET));
+  auto loaded = darray<std::uint64_t>::builder{}.capacity(10'000).build();
+  while (loaded.pod().size() < 10'000) {
+    const size_t spare = loaded.pod().capacity() - loaded.pod().size();
+    ASSERT_LT((size_t)0, CppPlay::read_append(file.fd(), loaded,
+                                              std::min<size_t>(3000, spare))
+                             .value());
+  }
+  EXPECT_EQ((size_t)10'000, loaded.pod().capacity());
+  EXPECT_TRUE(std::ranges::equal(source, loaded));
+  // 0 at the end of the file
+  EXPECT_EQ((size_t)0, CppPlay::read_append(file.fd(), loaded, 10).value());
+  EXPECT_EQ((size_t)10'000, loaded.pod().size());
+
+  // positional reads, then an element cut short by the end of the file
+  auto tail = darray<std::uint64_t>::builder{}.capacity(0).build();
+  EXPECT_EQ((size_t)5, CppPlay::pread_append(file.fd(), 9995 * 8, tail, 100)
+                           .value());
+  EXPECT_EQ(9995U, tail[0]);
+  // whole elements before an element cut short are kept
+  EXPECT_FALSE(CppPlay::pread_append(file.fd(), 9995 * 8 + 3, tail, 100)
+                   .has_value());
+  EXPECT_EQ((size_t)9, tail.pod().size());
+  EXPECT_FALSE(CppPlay::read_append(-1, tail, 1).has_value());
+}
+
+TEST(darrayIo, pipe) {
+  int fds[2];
+  ASSERT_EQ(0, pipe(fds));
+
+  // more than the pipe holds, the writer's writev resumes after partial writes
+  // while the reader gets elements split across reads
+  const auto first = iota_darray<std::uint32_t>(100'000, 0);
+  const auto second = iota_darray<std::uint32_t>(100'000, 100'000);
+  std::thread writer{[&]() {
+    EXPECT_EQ(800'000U, CppPlay::write_buffers(fds[1], first, second).value());
+    const std::array<std::uint8_t, 3> odd{1, 2, 3};
+    EXPECT_TRUE(CppPlay::write_buffers(fds[1], odd).has_value());
+    close(fds[1]);
+  }};
+
+  auto loaded = darray<std::uint32_t>::builder{}.capacity(0).build();
+  std::expected<size_t, CppPlay::error> got{0};
+  do {
+    got = CppPlay::read_append(fds[0], loaded, 4096);
+  } while (got.has_value() && (0 != got.value()));
+  writer.join();
+  close(fds[0]);
+
+  // the 3 trailing bytes are not an element, every whole one is kept
+  EXPECT_FALSE(got.has_value());
+  ASSERT_EQ((size_t)200'000, loaded.pod().size());
+  for (std::uint32_t idx = 0; idx < 200'000; idx++) {
+    ASSERT_EQ(idx, loaded[idx]);
+  }
+}
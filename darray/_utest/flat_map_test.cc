@@ -0,0 +1,212 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#include "flat_map.hpp"
+#include "gtest.h"
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using CppPlay::flat_map;
+using CppPlay::flat_set;
+
+//=============================================================================
+// Helper Classes and Functions
+//=============================================================================
+namespace {
+// converts to a mapped string, or throws part way through building a range
+struct ThrowingString {
+  const char *m_p_value;
+  explicit operator std::string() const {
+    [[unlikely]] if (nullptr == m_p_value) {
+      throw std::runtime_error{"no value"};
+    }
+    return std::string{m_p_value};
+  }
+};
+} // namespace
+
+// lookups of every key and of the gaps between them match std::set, in the
+// sorted and the frozen layout
+static auto lookups_like_std(const flat_set<int> &set_obj,
+                             const std::set<int> &reference) -> void {
+  EXPECT_TRUE(std::ranges::equal(reference, set_obj));
+  for (int key = -1; key <= ((*reference.rbegin()) + 1); key++) {
+    EXPECT_EQ(reference.contains(key), set_obj.contains(key));
+    const auto expected_bound = reference.lower_bound(key);
+    const auto bound = set_obj.lower_bound(key);
+    if (expected_bound == reference.end()) {
+      EXPECT_TRUE(bound == set_obj.end());
+    } else {
+      ASSERT_FALSE(bound == set_obj.end());
+      EXPECT_EQ(*expected_bound, *bound);
+    }
+    EXPECT_EQ(reference.contains(key), set_obj.find(key) != set_obj.end());
+  }
+}
+
+//=============================================================================
+// Tests
+//=============================================================================
+TEST(flatSet, layouts) {
+  // every size up to a few full levels, the last level of the Eytzinger tree
+  // filled to every degree
+  std::mt19937 generator{42};
+  std::uniform_int_distribution<int> distribution{0, 300};
+  for (size_t count = 1; count < 70; count++) {
+    std::vector<int> keys(count);
+    for (int &key : keys) {
+      key = distribution(generator) * 2;
+    }
+    const std::set<int> reference(keys.begin(), keys.end());
+
+    flat_set<int> set_obj{};
+    EXPECT_EQ(reference.size(), set_obj.assign(keys).value());
+    lookups_like_std(set_obj, reference);
+
+    EXPECT_TRUE(set_obj.freeze().has_value());
+    EXPECT_TRUE(set_obj.is_frozen());
+    lookups_like_std(set_obj, reference);
+
+    EXPECT_TRUE(set_obj.thaw().has_value());
+    EXPECT_FALSE(set_obj.is_frozen());
+    lookups_like_std(set_obj, reference);
+  }
+
+  // empty
+  flat_set<int> empty_set{};
+  EXPECT_TRUE(empty_set.freeze().has_value());
+  EXPECT_FALSE(empty_set.contains(0));
+  EXPECT_TRUE(empty_set.begin() == empty_set.end());
+  EXPECT_TRUE(empty_set.lower_bound(0) == empty_set.end());
+}
+
+TEST(flatSet, modify) {
+  flat_set<int> set_obj{};
+  EXPECT_EQ((size_t)4, set_obj.assign(std::vector<int>{9, 3, 5, 3, 1}).value());
+
+  EXPECT_TRUE(set_obj.insert(4).value());
+  EXPECT_FALSE(set_obj.insert(5).value());
+  EXPECT_TRUE(set_obj.erase(3).value());
+  EXPECT_FALSE(set_obj.erase(3).value());
+  EXPECT_TRUE(std::ranges::equal(std::vector<int>{1, 4, 5, 9}, set_obj));
+
+  // batch merge, duplicates of present keys and within the batch ignored
+  EXPECT_EQ((size_t)4,
+            set_obj.insert_sorted(std::vector<int>{0, 2, 2, 4, 10, 11}).value());
+  EXPECT_TRUE(std::ranges::equal(std::vector<int>{0, 1, 2, 4, 5, 9, 10, 11},
+                                 set_obj));
+  EXPECT_FALSE(set_obj.insert_sorted(std::vector<int>{3, 1}).has_value());
+  EXPECT_EQ((size_t)8, set_obj.pod().size());
+
+  // frozen tables refuse changes
+  EXPECT_TRUE(set_obj.freeze().has_value());
+  EXPECT_FALSE(set_obj.insert(3).has_value());
+  EXPECT_FALSE(set_obj.erase(1).has_value());
+  EXPECT_FALSE(set_obj.insert_sorted(std::vector<int>{3}).has_value());
+  EXPECT_FALSE(set_obj.assign(std::vector<int>{3}).has_value());
+  EXPECT_TRUE(set_obj.contains(9));
+  EXPECT_TRUE(set_obj.thaw().has_value());
+  EXPECT_TRUE(set_obj.insert(3).value());
+
+  EXPECT_TRUE(set_obj.clear().has_value());
+  EXPECT_TRUE(set_obj.pod().is_empty());
+}
+
+TEST(flatSet, stringsCompare) {
+  flat_set<std::string, std::greater<>> set_obj{};
+  EXPECT_EQ((size_t)5, set_obj
+                           .assign(std::vector<std::string>{
+                               "fig", "apple", "pear", "kiwi", "date"})
+                           .value());
+  EXPECT_TRUE(set_obj.freeze().has_value());
+  EXPECT_TRUE(std::ranges::equal(
+      std::vector<std::string>{"pear", "kiwi", "fig", "date", "apple"},
+      set_obj));
+  EXPECT_EQ("date", *set_obj.lower_bound("e"));
+  EXPECT_TRUE(set_obj.contains("kiwi"));
+  EXPECT_FALSE(set_obj.contains("lime"));
+}
+
+TEST(flatMap, values) {
+  using Map = flat_map<int, std::string>;
+  Map map_obj = Map::builder{}.capacity(16).build();
+  EXPECT_EQ((size_t)16, map_obj.pod().capacity());
+
+  // the first of equal keys is kept
+  const std::vector<std::pair<int, std::string>> unsorted{
+      {30, "thirty"}, {10, "ten"}, {20, "twenty"}, {10, "TEN"}};
+  EXPECT_EQ((size_t)3, map_obj.assign(unsorted).value());
+  EXPECT_EQ("ten", map_obj.at(10).value().get());
+
+  EXPECT_TRUE(map_obj.insert(25, "twenty five").value());
+  EXPECT_FALSE(map_obj.insert(25, "other").value());
+  EXPECT_EQ((size_t)2,
+            map_obj
+                .insert_sorted(std::vector<std::pair<int, std::string>>{
+                    {5, "five"}, {20, "TWENTY"}, {40, "forty"}})
+                .value());
+  EXPECT_TRUE(map_obj.erase(30).value());
+
+  // a failed merge leaves every existing element in place
+  EXPECT_FALSE(map_obj
+                   .insert_sorted(std::vector<std::pair<int, ThrowingString>>{
+                       {1, {"one"}}, {7, {nullptr}}})
+                   .has_value());
+  EXPECT_EQ((size_t)5, map_obj.pod().size());
+  EXPECT_EQ("five", map_obj.at(5).value().get());
+  EXPECT_EQ("forty", map_obj.at(40).value().get());
+  EXPECT_FALSE(map_obj.at(1).has_value());
+
+  // values follow their keys through both layouts
+  const std::vector<std::pair<int, std::string>> expected_elements{
+      {5, "five"}, {10, "ten"}, {20, "twenty"}, {25, "twenty five"},
+      {40, "forty"}};
+  for (const bool frozen : {false, true, false}) {
+    EXPECT_TRUE((frozen ? map_obj.freeze() : map_obj.thaw()).has_value());
+    std::vector<std::pair<int, std::string>> elements;
+    for (const auto [key, value] : map_obj) {
+      elements.emplace_back(key, value);
+    }
+    EXPECT_EQ(expected_elements, elements);
+    for (const auto &[key, value] : expected_elements) {
+      EXPECT_EQ(value, map_obj.at(key).value().get());
+    }
+    EXPECT_FALSE(map_obj.at(30).has_value());
+    EXPECT_EQ(25, (*map_obj.lower_bound(21)).first);
+  }
+
+  // mapped values are mutable in place
+  map_obj.at(40).value().get() = "FORTY";
+  EXPECT_EQ("FORTY", (*map_obj.find(40)).second);
+}
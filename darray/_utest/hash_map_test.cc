@@ -0,0 +1,225 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#include "hash_map.hpp"
+#include "gtest.h"
+
+#include <cstddef>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+using CppPlay::hash_map;
+
+//=============================================================================
+// Helper Classes and Functions
+//=============================================================================
+// every key hashes to the same slot, all of them share one probe run
+struct ConstantHash {
+  auto operator()(const int /*key*/) const noexcept -> size_t { return 7; }
+};
+
+// std::string keys looked up by std::string_view or const char *
+struct StringHash {
+  using is_transparent = void;
+  auto operator()(const std::string_view key) const noexcept -> size_t {
+    return std::hash<std::string_view>{}(key);
+  }
+};
+
+// elements of map_obj are those of reference
+template <typename Map>
+static auto same_as_std(const Map &map_obj,
+                        const std::unordered_map<int, int> &reference)
+    -> void {
+  EXPECT_EQ(reference.size(), map_obj.pod().size());
+  size_t visited = 0;
+  for (const auto [key, value] : map_obj) {
+    ASSERT_TRUE(reference.contains(key));
+    EXPECT_EQ(reference.at(key), value);
+    visited++;
+  }
+  EXPECT_EQ(reference.size(), visited);
+  for (const auto &[key, value] : reference) {
+    ASSERT_TRUE(map_obj.at(key).has_value());
+    EXPECT_EQ(value, map_obj.at(key).value().get());
+  }
+}
+
+// random inserts, assigns and erases over a small key range, so probe runs
+// collide and erases shift elements back
+template <typename Map> static auto random_ops(Map &map_obj) -> void {
+  std::unordered_map<int, int> reference;
+  std::mt19937 generator{42};
+  std::uniform_int_distribution<int> key_distribution{0, 2000};
+  std::uniform_int_distribution<int> op_distribution{0, 3};
+  for (int step = 0; step < 20000; step++) {
+    const int key = key_distribution(generator);
+    switch (op_distribution(generator)) {
+    case 0:
+      EXPECT_EQ(reference.emplace(key, step).second,
+                map_obj.insert(key, step).value());
+      break;
+    case 1:
+      EXPECT_EQ(reference.insert_or_assign(key, step).second,
+                map_obj.insert_or_assign(key, step).value());
+      break;
+    case 2:
+      EXPECT_EQ(reference.erase(key) == 1, map_obj.erase(key).value());
+      break;
+    default:
+      EXPECT_EQ(reference.contains(key), map_obj.contains(key));
+      break;
+    }
+    if (0 == (step % 2500)) {
+      same_as_std(map_obj, reference);
+    }
+  }
+  same_as_std(map_obj, reference);
+}
+
+//=============================================================================
+// Tests
+//=============================================================================
+TEST(hashMap, randomOps) {
+  hash_map<int, int> map_obj{};
+  random_ops(map_obj);
+
+  // every key collides, a single probe run wrapping around the table
+  hash_map<int, int, ConstantHash> collide_obj{};
+  random_ops(collide_obj);
+}
+
+TEST(hashMap, eraseShiftsBack) {
+  // a full probe run, erasing from its front, middle and back keeps every
+  // remaining key reachable
+  hash_map<int, int, ConstantHash> map_obj =
+      hash_map<int, int, ConstantHash>::builder{}.capacity(0).build();
+  for (int key = 0; key < 14; key++) {
+    EXPECT_TRUE(map_obj.insert(key, key * 10).value());
+  }
+  for (const int erased : {0, 7, 13, 1}) {
+    EXPECT_TRUE(map_obj.erase(erased).value());
+    EXPECT_FALSE(map_obj.contains(erased));
+    for (int key = 0; key < 14; key++) {
+      if (map_obj.contains(key)) {
+        EXPECT_EQ(key * 10, map_obj.at(key).value().get());
+      }
+    }
+  }
+  EXPECT_EQ((size_t)10, map_obj.pod().size());
+  EXPECT_FALSE(map_obj.erase(0).value());
+}
+
+TEST(hashMap, reserveAndGrowth) {
+  using Map = hash_map<int, std::string>;
+  Map map_obj = Map::builder{}.capacity(100).build();
+  EXPECT_LE((size_t)100, map_obj.pod().capacity());
+  EXPECT_TRUE(map_obj.pod().is_empty());
+
+  // reserve sizes once, the inserts do not grow the table
+  EXPECT_TRUE(map_obj.reserve(5000).has_value());
+  const size_t reserved = map_obj.pod().capacity();
+  EXPECT_LE((size_t)5000, reserved);
+  for (int key = 0; key < 5000; key++) {
+    EXPECT_TRUE(map_obj.insert(key, std::to_string(key)).value());
+  }
+  EXPECT_EQ(reserved, map_obj.pod().capacity());
+  EXPECT_TRUE(map_obj.reserve(10).has_value());
+  EXPECT_EQ(reserved, map_obj.pod().capacity());
+
+  // growth past the reserve keeps every element
+  for (int key = 5000; key < 20000; key++) {
+    EXPECT_TRUE(map_obj.insert(key, std::to_string(key)).value());
+  }
+  EXPECT_LT(reserved, map_obj.pod().capacity());
+  for (int key = 0; key < 20000; key += 7) {
+    EXPECT_EQ(std::to_string(key), map_obj.at(key).value().get());
+  }
+  EXPECT_FALSE(map_obj.at(20000).has_value());
+
+  // clear keeps the table
+  const size_t grown = map_obj.pod().capacity();
+  EXPECT_TRUE(map_obj.clear().has_value());
+  EXPECT_TRUE(map_obj.pod().is_empty());
+  EXPECT_EQ(grown, map_obj.pod().capacity());
+  EXPECT_TRUE(map_obj.begin() == map_obj.end());
+  EXPECT_TRUE(map_obj.insert(1, "one").value());
+}
+
+TEST(hashMap, heterogeneousLookup) {
+  using Map = hash_map<std::string, int, StringHash, std::equal_to<>>;
+  Map map_obj{};
+  EXPECT_TRUE(map_obj.insert("apple", 1).value());
+  EXPECT_TRUE(map_obj.insert(std::string{"pear"}, 2).value());
+  EXPECT_TRUE(map_obj.insert_or_assign(std::string_view{"fig"}, 3).value());
+
+  // no std::string is built for the lookups
+  const std::string_view pear{"pear"};
+  EXPECT_TRUE(map_obj.contains(pear));
+  EXPECT_FALSE(map_obj.contains(std::string_view{"kiwi"}));
+  EXPECT_EQ(3, map_obj.at("fig").value().get());
+  EXPECT_EQ(2, (*map_obj.find(pear)).second);
+  EXPECT_TRUE(map_obj.find("kiwi") == map_obj.end());
+  EXPECT_TRUE(map_obj.erase(pear).value());
+  EXPECT_FALSE(map_obj.contains(std::string{"pear"}));
+
+  // mapped values are mutable in place
+  (*map_obj.find("apple")).second = 10;
+  EXPECT_EQ(10, map_obj.at(std::string{"apple"}).value().get());
+}
+
+TEST(hashMap, copyMove) {
+  using Map = hash_map<int, std::string>;
+  Map map_obj{};
+  for (int key = 0; key < 100; key++) {
+    EXPECT_TRUE(map_obj.insert(key, std::to_string(key)).value());
+  }
+
+  Map copy{map_obj};
+  EXPECT_TRUE(copy.erase(5).value());
+  EXPECT_TRUE(map_obj.contains(5));
+  EXPECT_EQ((size_t)99, copy.pod().size());
+  copy = map_obj;
+  EXPECT_EQ("5", copy.at(5).value().get());
+
+  // moved from maps are empty and usable
+  Map moved{std::move(map_obj)};
+  EXPECT_EQ((size_t)100, moved.pod().size());
+  EXPECT_TRUE(map_obj.pod().is_empty()); // NOLINT(bugprone-use-after-move)
+  EXPECT_FALSE(map_obj.contains(5));
+  EXPECT_FALSE(map_obj.erase(5).value());
+  EXPECT_TRUE(map_obj.begin() == map_obj.end());
+  EXPECT_TRUE(map_obj.insert(5, "five").value());
+  EXPECT_EQ("five", map_obj.at(5).value().get());
+
+  copy = std::move(moved);
+  EXPECT_EQ("99", copy.at(99).value().get());
+}
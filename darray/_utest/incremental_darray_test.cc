@@ -0,0 +1,172 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#include "incremental_darray.hpp"
+#include "gtest.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+using CppPlay::GrowthPolicyDouble;
+using CppPlay::GrowthPolicyOneAndHalf;
+using CppPlay::incremental_darray;
+using CppPlay::ThreadProtectionDisabled;
+
+//=============================================================================
+// Helper Classes and Functions
+//=============================================================================
+// elements in index order through at(), [] and for_each() all agree
+template <typename Darray>
+static auto incremental_values(const Darray &darray_obj)
+    -> std::vector<typename Darray::value_type> {
+  std::vector<typename Darray::value_type> by_index{};
+  for (size_t idx = 0; idx < darray_obj.pod().size(); idx++) {
+    EXPECT_EQ(*darray_obj.at(idx).value(), darray_obj[idx]);
+    by_index.push_back(darray_obj[idx]);
+  }
+  std::vector<typename Darray::value_type> visited{};
+  darray_obj.for_each([&](const auto &value) { visited.push_back(value); });
+  EXPECT_EQ(by_index, visited);
+  EXPECT_FALSE(darray_obj.at(darray_obj.pod().size()).has_value());
+  return by_index;
+}
+
+// push count values, growth never starts while a migration is unfinished
+template <typename Darray>
+static auto push_incremental(Darray &darray_obj, const int count) -> void {
+  std::vector<int> expected_values{};
+  for (int value = 0; value < count; value++) {
+    if (darray_obj.pod().size() == darray_obj.pod().capacity()) {
+      EXPECT_FALSE(darray_obj.is_migrating());
+    }
+    EXPECT_EQ((size_t)value, darray_obj.push_back(value).value());
+    expected_values.push_back(value);
+    if (0 == (value % 97)) {
+      EXPECT_EQ(expected_values, incremental_values(darray_obj));
+    }
+  }
+  EXPECT_EQ(expected_values, incremental_values(darray_obj));
+}
+
+//=============================================================================
+// Tests
+//=============================================================================
+TEST(incrementalDarray, migratesWithinGrowth) {
+  incremental_darray<int> doubling{};
+  push_incremental(doubling, 5000);
+
+  // 1.5x growth leaves room for fewer appends than elements to migrate
+  incremental_darray<int, ThreadProtectionDisabled<int>,
+                     GrowthPolicyOneAndHalf<int>, std::allocator<int>, 1>
+      one_and_half{};
+  push_incremental(one_and_half, 5000);
+
+  // a large migration is spread over the following appends
+  incremental_darray<int> large =
+      incremental_darray<int>::builder{}.capacity(1024).build();
+  for (int value = 0; value < 1025; value++) {
+    EXPECT_TRUE(large.push_back(value).has_value());
+  }
+  EXPECT_TRUE(large.is_migrating());
+  EXPECT_EQ((size_t)2048, large.pod().capacity());
+  for (int value = 1025; value < 1056; value++) {
+    EXPECT_TRUE(large.push_back(value).has_value());
+  }
+  EXPECT_FALSE(large.is_migrating());
+  EXPECT_EQ(1055, large[1055]);
+  EXPECT_EQ(0, large[0]);
+
+  // migrating megabytes releases the old buffer's pages as it goes
+  for (int value = 1056; value < (1 << 21) + 1; value++) {
+    EXPECT_EQ((size_t)value, large.push_back(value).value());
+    if ((1 << 20) == value) {
+      EXPECT_TRUE(large.is_migrating());
+      EXPECT_EQ(value, *large.at((size_t)value).value());
+      EXPECT_EQ(value - 1, large[(size_t)value - 1]);
+    }
+  }
+  int expected_value = 0;
+  large.for_each([&](const int value) { EXPECT_EQ(expected_value++, value); });
+  EXPECT_EQ((1 << 21) + 1, expected_value);
+}
+
+TEST(incrementalDarray, popsAndMovesWhileMigrating) {
+  incremental_darray<std::string, ThreadProtectionDisabled<std::string>,
+                     GrowthPolicyDouble<std::string>,
+                     std::allocator<std::string>, 4>
+      darray_obj = decltype(darray_obj)::builder{}.capacity(64).build();
+  std::vector<std::string> expected_values{};
+  for (int value = 0; value < 66; value++) {
+    expected_values.push_back(std::to_string(value) + " long enough for heap");
+    EXPECT_TRUE(darray_obj.push_back(expected_values.back()).has_value());
+  }
+  EXPECT_TRUE(darray_obj.is_migrating());
+  EXPECT_EQ(expected_values, incremental_values(darray_obj));
+
+  // pop back through the appends into elements awaiting migration
+  for (int pops = 0; pops < 10; pops++) {
+    EXPECT_EQ(expected_values.back(), darray_obj.pop_back().value());
+    expected_values.pop_back();
+    EXPECT_EQ(expected_values, incremental_values(darray_obj));
+  }
+  EXPECT_TRUE(darray_obj.is_migrating());
+
+  // a moved darray carries the migration over
+  auto moved{std::move(darray_obj)};
+  EXPECT_TRUE(moved.is_migrating());
+  EXPECT_TRUE(darray_obj.pod().is_empty());
+  EXPECT_EQ(expected_values, incremental_values(moved));
+  for (int value = 0; value < 20; value++) {
+    expected_values.push_back(std::to_string(value));
+    EXPECT_TRUE(moved.push_back(expected_values.back()).has_value());
+  }
+  EXPECT_FALSE(moved.is_migrating());
+  EXPECT_EQ(expected_values, incremental_values(moved));
+
+  // popping every element ends a migration
+  darray_obj = std::move(moved);
+  EXPECT_EQ(expected_values, incremental_values(darray_obj));
+  while (false == darray_obj.is_migrating()) {
+    EXPECT_TRUE(darray_obj.push_back(std::string{"grow"}).has_value());
+  }
+  for (size_t size = darray_obj.pod().size(); size > 0; size--) {
+    EXPECT_TRUE(darray_obj.pop_back().has_value());
+  }
+  EXPECT_FALSE(darray_obj.is_migrating());
+  EXPECT_FALSE(darray_obj.pop_back().has_value());
+
+  // clear mid migration releases the old buffer, the darray stays usable
+  for (int value = 0; value < 200; value++) {
+    EXPECT_TRUE(darray_obj.push_back(std::to_string(value)).has_value());
+  }
+  EXPECT_TRUE(darray_obj.clear().has_value());
+  EXPECT_FALSE(darray_obj.is_migrating());
+  EXPECT_TRUE(darray_obj.pod().is_empty());
+  EXPECT_TRUE(darray_obj.push_back(std::string{"after clear"}).has_value());
+  EXPECT_EQ("after clear", darray_obj[0]);
+}
@@ -0,0 +1,60 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#pragma once
+
+
+#include <string>
+#include <utility>
+
+// internal linkage, each test file counts its own live elements
+namespace {
+
+// string element counting its live objects, to check only live elements are
+// constructed and every one is destroyed
+class LiveString {
+public:
+  static inline int s_live_count = 0;
+  std::string m_value;
+  explicit LiveString(std::string value) : m_value{std::move(value)} {
+    s_live_count++;
+  };
+  LiveString(const LiveString &other) : m_value{other.m_value} {
+    s_live_count++;
+  };
+  LiveString(LiveString &&other) noexcept : m_value{std::move(other.m_value)} {
+    s_live_count++;
+  };
+  LiveString &operator=(const LiveString &other) = default;
+  LiveString &operator=(LiveString &&other) = default;
+  ~LiveString() { s_live_count--; };
+  bool operator==(const LiveString &other) const {
+    return other.m_value == m_value;
+  };
+};
+
+} // namespace
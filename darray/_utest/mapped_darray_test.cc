@@ -0,0 +1,206 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#include "mapped_darray.hpp"
+#include "gtest.h"
+#include "temp_file.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <ranges>
+#include <string>
+#include <utility>
+#include <vector>
+
+using CppPlay::mapped_darray;
+
+//=============================================================================
+// Helper Classes and Functions
+//=============================================================================
+namespace {
+struct Record {
+  std::uint64_t m_id;
+  double m_value;
+  auto operator==(const Record &) const -> bool = default;
+};
+} // namespace
+
+template <typename T>
+static auto open_mapped(const TempFile &file, const size_t capacity = 16)
+    -> mapped_darray<T> {
+  return typename mapped_darray<T>::builder{}
+      .path(file.path())
+      .capacity(capacity)
+      .build()
+      .value();
+}
+
+//=============================================================================
+// Tests
+//=============================================================================
+TEST(mappedDarray, reopen) {
+  const TempFile file{"mappedDarray.reopen"};
+  std::vector<Record> expected_elements{};
+  {
+    auto mapped = open_mapped<Record>(file);
+    EXPECT_TRUE(mapped.pod().is_empty());
+    EXPECT_EQ((size_t)16, mapped.pod().capacity());
+    for (std::uint64_t id = 0; id < 10; id++) {
+      expected_elements.push_back(Record{id, static_cast<double>(id) / 2});
+      EXPECT_EQ(id + 1, mapped.push_back(expected_elements.back()).value());
+    }
+    EXPECT_TRUE(mapped.sync().has_value());
+  }
+
+  // contents are there as soon as the file is mapped, capacity included
+  {
+    auto mapped = open_mapped<Record>(file, 4);
+    EXPECT_EQ((size_t)10, mapped.pod().size());
+    EXPECT_EQ((size_t)16, mapped.pod().capacity());
+    EXPECT_TRUE(std::ranges::equal(expected_elements, mapped));
+    EXPECT_EQ((Record{9, 4.5}), mapped.pop_back().value());
+    expected_elements.pop_back();
+    mapped[0].m_value = 100;
+    expected_elements[0].m_value = 100;
+  }
+
+  // unsynced changes still reach the file, a larger capacity grows it
+  auto mapped = open_mapped<Record>(file, 64);
+  EXPECT_EQ((size_t)64, mapped.pod().capacity());
+  EXPECT_TRUE(std::ranges::equal(expected_elements, mapped));
+  EXPECT_EQ(100, (*mapped.at(0).value()).m_value);
+  EXPECT_FALSE(mapped.at(9).has_value());
+  EXPECT_TRUE(mapped.clear().has_value());
+  EXPECT_TRUE(mapped.pod().is_empty());
+  EXPECT_TRUE(mapped.begin() == mapped.end());
+  EXPECT_FALSE(mapped.pop_back().has_value());
+}
+
+TEST(mappedDarray, growth) {
+  const TempFile file{"mappedDarray.growth"};
+  {
+    // doubling across many remaps, a bulk append grows once
+    auto mapped = open_mapped<std::uint64_t>(file, 0);
+    for (std::uint64_t value = 0; value < 100'000; value++) {
+      ASSERT_TRUE(mapped.push_back(value).has_value());
+    }
+    std::vector<std::uint64_t> tail(50'000);
+    std::iota(tail.begin(), tail.end(), 100'000);
+    EXPECT_EQ((size_t)150'000, mapped.append_range(tail).value());
+    EXPECT_EQ((size_t)150'003,
+              mapped.append_with(3, [](std::uint64_t *const p_spare) {
+                p_spare[0] = 150'000;
+                p_spare[1] = 150'001;
+                p_spare[2] = 150'002;
+                return size_t{3};
+              }).value());
+    EXPECT_FALSE(mapped.append_with(1, [](std::uint64_t *const p_spare) {
+                  p_spare[0] = 0;
+                  return size_t{2};
+                }).has_value());
+    EXPECT_EQ((size_t)150'003, mapped.pod().size());
+    EXPECT_TRUE(mapped.reserve(1'000'000).has_value());
+    EXPECT_EQ((size_t)1'000'000, mapped.pod().capacity());
+    EXPECT_TRUE(mapped.sync().has_value());
+  }
+  EXPECT_EQ(4096 + (1'000'000 * sizeof(std::uint64_t)),
+            std::filesystem::file_size(file.path()));
+
+  auto mapped = open_mapped<std::uint64_t>(file);
+  ASSERT_EQ((size_t)150'003, mapped.pod().size());
+  for (size_t idx = 0; idx < 150'003; idx++) {
+    ASSERT_EQ(idx, mapped[idx]);
+  }
+
+  // moved from darrays give their file up
+  mapped_darray<std::uint64_t> moved{std::move(mapped)};
+  EXPECT_EQ((size_t)150'003, moved.pod().size());
+  mapped = std::move(moved);
+  EXPECT_EQ((size_t)150'004, mapped.push_back(7).value());
+}
+
+TEST(mappedDarray, selfAliasing) {
+  // elements of the mapping itself are read before growth remaps it
+  const TempFile file{"mappedDarray.selfAliasing"};
+  const Record seven{7, 0.5};
+  const Record nine{9, 1.5};
+  auto mapped = open_mapped<Record>(file, 1);
+  EXPECT_TRUE(mapped.push_back(seven).has_value());
+  for (size_t count = 1; count < 20'000; count++) {
+    ASSERT_EQ(count + 1, mapped.push_back(mapped[0]).value());
+  }
+  mapped[19'999] = nine;
+
+  // contiguous, then a forward range, each growing the mapping
+  EXPECT_EQ((size_t)40'000, mapped.append_range(mapped).value());
+  EXPECT_EQ((size_t)80'000,
+            mapped.append_range(mapped | std::views::reverse).value());
+  EXPECT_EQ(nine, mapped[39'999]);
+  EXPECT_EQ(nine, mapped[40'000]);
+  EXPECT_EQ(seven, mapped[40'001]);
+  EXPECT_EQ(nine, mapped[60'000]);
+  EXPECT_EQ(seven, mapped[79'999]);
+  size_t nines = 0;
+  for (size_t idx = 0; idx < mapped.pod().size(); idx++) {
+    nines += static_cast<size_t>(nine == mapped[idx]);
+  }
+  EXPECT_EQ((size_t)4, nines);
+}
+
+TEST(mappedDarray, invalidFiles) {
+  const TempFile file{"mappedDarray.invalid"};
+  {
+    auto mapped = open_mapped<std::uint64_t>(file);
+    EXPECT_TRUE(mapped.push_back(1).has_value());
+  }
+  // elements of another size
+  EXPECT_FALSE(
+      mapped_darray<std::uint32_t>::builder{}.path(file.path()).build());
+
+  // not a mapped darray file
+  {
+    std::ofstream out{file.path(), std::ios::binary | std::ios::trunc};
+    out << std::string(8192, 'x');
+  }
+  EXPECT_FALSE(
+      mapped_darray<std::uint64_t>::builder{}.path(file.path()).build());
+
+  // too short for a header
+  {
+    std::ofstream out{file.path(), std::ios::binary | std::ios::trunc};
+    out << "short";
+  }
+  EXPECT_FALSE(
+      mapped_darray<std::uint64_t>::builder{}.path(file.path()).build());
+
+  // missing directory
+  EXPECT_FALSE(mapped_darray<std::uint64_t>::builder{}
+                   .path("/nonexistent/dir/file.darray")
+                   .build());
+}
@@ -0,0 +1,174 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#include "gtest.h"
+#include "parallel_sort.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using CppPlay::darray;
+using CppPlay::task_pool;
+
+//=============================================================================
+// Helper Classes and Functions
+//=============================================================================
+namespace {
+// move only, and no default constructor
+class SortKey {
+  int m_value;
+
+public:
+  explicit SortKey(const int value) : m_value{value} {}
+  SortKey(const SortKey &) = delete;
+  auto operator=(const SortKey &) -> SortKey & = delete;
+  SortKey(SortKey &&) noexcept = default;
+  auto operator=(SortKey &&) noexcept -> SortKey & = default;
+  ~SortKey() = default;
+  auto operator<=>(const SortKey &) const = default;
+  [[nodiscard]] auto value() const -> int { return m_value; }
+};
+
+size_t s_sort_allocated_bytes = 0;
+// std::allocator that counts the bytes it hands out
+template <typename T> struct SortCountingAllocator {
+  using value_type = T;
+  SortCountingAllocator() = default;
+  template <typename U>
+  explicit SortCountingAllocator(const SortCountingAllocator<U> & /*other*/) {}
+  auto allocate(const size_t count) -> T * {
+    s_sort_allocated_bytes += count * sizeof(T);
+    return std::allocator<T>{}.allocate(count);
+  }
+  auto deallocate(T *const p_value, const size_t count) -> void {
+    std::allocator<T>{}.deallocate(p_value, count);
+  }
+  friend auto operator==(const SortCountingAllocator &,
+                         const SortCountingAllocator &) -> bool = default;
+};
+} // namespace
+
+// parallel_sort over darray::iterator gives the std::sort order, for sizes
+// below and above the sequential grain, with 1 to 8 threads
+template <template <typename> typename ThreadProtection>
+static auto sort_like_std() -> void {
+  using DArray = darray<int, ThreadProtection<int>>;
+  std::mt19937 generator{42};
+  std::uniform_int_distribution<int> distribution{-1000, 1000};
+  for (const size_t threads : {size_t{1}, size_t{2}, size_t{3}, size_t{8}}) {
+    task_pool pool{threads};
+    for (const size_t count : {size_t{0}, size_t{1}, size_t{1000},
+                               size_t{100000}, size_t{300001}}) {
+      DArray darray_obj = typename DArray::builder{}.capacity(count).build();
+      std::vector<int> expected_values;
+      for (size_t idx = 0; idx < count; idx++) {
+        const int value = distribution(generator);
+        EXPECT_TRUE(darray_obj.push_back(value).has_value());
+        expected_values.push_back(value);
+      }
+      std::sort(expected_values.begin(), expected_values.end());
+
+      EXPECT_TRUE(CppPlay::parallel_sort(pool, darray_obj.begin(),
+                                         darray_obj.end())
+                      .has_value());
+      EXPECT_TRUE(std::equal(darray_obj.begin(), darray_obj.end(),
+                             expected_values.begin(), expected_values.end()));
+    }
+  }
+}
+
+//=============================================================================
+// Tests
+//=============================================================================
+TEST(parallelSort, threadProtectionDisabled) {
+  sort_like_std<CppPlay::ThreadProtectionDisabled>();
+}
+
+TEST(parallelSort, threadProtectionEnabled) {
+  sort_like_std<CppPlay::ThreadProtectionEnabled>();
+}
+
+TEST(parallelSort, comparatorStrings) {
+  task_pool pool{4};
+  darray<std::string> darray_obj{};
+  std::vector<std::string> expected_values;
+  for (size_t idx = 0; idx < 100000; idx++) {
+    std::string value = std::to_string((idx * 7919) % 100003);
+    expected_values.push_back(value);
+    EXPECT_TRUE(darray_obj.push_back(std::move(value)).has_value());
+  }
+  std::sort(expected_values.begin(), expected_values.end(),
+            std::greater<>{});
+
+  // range overload, descending
+  EXPECT_TRUE(
+      CppPlay::parallel_sort(pool, darray_obj, std::greater<>{}).has_value());
+  EXPECT_TRUE(std::equal(darray_obj.begin(), darray_obj.end(),
+                         expected_values.begin(), expected_values.end()));
+}
+
+TEST(parallelSort, comparatorThrows) {
+  task_pool pool{4};
+  std::vector<int> values(100000);
+  for (size_t idx = 0; idx < values.size(); idx++) {
+    values[idx] = static_cast<int>(values.size() - idx);
+  }
+  const auto result = CppPlay::parallel_sort(
+      pool, values, [](const int left, const int right) {
+        if ((left == 1) || (right == 1)) {
+          throw std::runtime_error{"cannot compare"};
+        }
+        return left < right;
+      });
+  ASSERT_FALSE(result.has_value());
+  EXPECT_EQ(std::string{"cannot compare"}, result.error().message());
+}
+
+TEST(parallelSort, scratchFromDarrayAllocator) {
+  task_pool pool{4};
+  using DArray = darray<SortKey, CppPlay::ThreadProtectionDisabled<SortKey>,
+                        CppPlay::GrowthPolicyDouble<SortKey>,
+                        SortCountingAllocator<SortKey>>;
+  const int count = 100000;
+  DArray darray_obj =
+      DArray::builder{}.capacity(static_cast<size_t>(count)).build();
+  for (int idx = 0; idx < count; idx++) {
+    EXPECT_TRUE(darray_obj.push_back(SortKey{(idx * 7919) % count}).has_value());
+  }
+
+  const size_t allocated_bytes = s_sort_allocated_bytes;
+  EXPECT_TRUE(CppPlay::parallel_sort(pool, darray_obj).has_value());
+  EXPECT_EQ(allocated_bytes + (count * sizeof(SortKey)),
+            s_sort_allocated_bytes);
+  for (int idx = 0; idx < count; idx++) {
+    EXPECT_EQ(idx, darray_obj[static_cast<size_t>(idx)].value());
+  }
+}
@@ -0,0 +1,148 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#include "counting_allocator.hpp"
+#include "gtest.h"
+#include "radix_sort.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+
+using CppPlay::darray;
+
+//=============================================================================
+// Helper Classes and Functions
+//=============================================================================
+// radix_sort gives the std::sort order, on the stable_sort path and the
+// radix path, with full range keys and keys sharing their high digits
+// (skipped passes)
+template <typename K> static auto sort_like_std() -> void {
+  std::mt19937_64 generator{42};
+  for (const size_t count :
+       {size_t{0}, size_t{1}, size_t{100}, size_t{1000}, size_t{100000}}) {
+    for (const bool narrow : {false, true}) {
+      darray<K> darray_obj{};
+      std::vector<K> expected_values;
+      for (size_t idx = 0; idx < count; idx++) {
+        auto bits = generator();
+        if (narrow) {
+          bits %= 200;
+        }
+        K value{};
+        if constexpr (std::is_floating_point_v<K>) {
+          value = static_cast<K>(static_cast<std::int64_t>(bits)) /
+                  static_cast<K>(1 << 20);
+        } else {
+          value = static_cast<K>(bits);
+        }
+        EXPECT_TRUE(darray_obj.push_back(value).has_value());
+        expected_values.push_back(value);
+      }
+      std::sort(expected_values.begin(), expected_values.end());
+
+      EXPECT_TRUE(CppPlay::radix_sort(darray_obj).has_value());
+      EXPECT_TRUE(std::equal(darray_obj.begin(), darray_obj.end(),
+                             expected_values.begin(), expected_values.end()));
+    }
+  }
+}
+
+struct record {
+  std::int32_t m_key;
+  std::uint32_t m_sequence;
+};
+
+//=============================================================================
+// Tests
+//=============================================================================
+TEST(radixSort, keyTypes) {
+  sort_like_std<std::uint8_t>();
+  sort_like_std<std::int8_t>();
+  sort_like_std<std::uint16_t>();
+  sort_like_std<std::int16_t>();
+  sort_like_std<unsigned int>();
+  sort_like_std<int>();
+  sort_like_std<std::uint64_t>();
+  sort_like_std<std::int64_t>();
+  sort_like_std<float>();
+  sort_like_std<double>();
+}
+
+TEST(radixSort, floatSpecialValues) {
+  constexpr double infinity = std::numeric_limits<double>::infinity();
+  constexpr double denormal = std::numeric_limits<double>::denorm_min();
+  darray<double> darray_obj{};
+  for (size_t idx = 0; idx < 100; idx++) {
+    for (const double value : {1.5, -1.5, 0.0, -0.0, infinity, -infinity,
+                               denormal, -denormal, -1e300, 1e300}) {
+      EXPECT_TRUE(darray_obj.push_back(value).has_value());
+    }
+  }
+  EXPECT_TRUE(CppPlay::radix_sort(darray_obj).has_value());
+  EXPECT_TRUE(std::is_sorted(darray_obj.begin(), darray_obj.end()));
+  EXPECT_EQ(-infinity, darray_obj[0]);
+  EXPECT_EQ(infinity, darray_obj[999]);
+  // -0.0 before 0.0
+  EXPECT_TRUE(std::signbit(darray_obj[450]));
+  EXPECT_FALSE(std::signbit(darray_obj[550]));
+}
+
+TEST(radixSort, keyExtractorStable) {
+  using DArray = darray<record, CppPlay::ThreadProtectionEnabled<record>,
+                        CppPlay::GrowthPolicyDouble<record>,
+                        counting_allocator<record>>;
+  DArray darray_obj{};
+  std::mt19937 generator{42};
+  std::uniform_int_distribution<std::int32_t> distribution{-50, 50};
+  for (std::uint32_t sequence = 0; sequence < 10000; sequence++) {
+    EXPECT_TRUE(
+        darray_obj.push_back(record{distribution(generator), sequence})
+            .has_value());
+  }
+
+  // the buffer comes from the darray's allocator
+  counting_allocator<record>::s_allocations = 0;
+  EXPECT_TRUE(CppPlay::radix_sort(darray_obj, [](const record &value) {
+                return value.m_key;
+              }).has_value());
+  EXPECT_EQ((size_t)1, counting_allocator<record>::s_allocations);
+
+  // equal keys keep their order
+  EXPECT_TRUE(std::is_sorted(darray_obj.begin(), darray_obj.end(),
+                             [](const record &left, const record &right) {
+                               return (left.m_key < right.m_key) ||
+                                      ((left.m_key == right.m_key) &&
+                                       (left.m_sequence < right.m_sequence));
+                             }));
+  EXPECT_EQ(-50, darray_obj[0].m_key);
+  EXPECT_EQ(50, darray_obj[9999].m_key);
+}
@@ -0,0 +1,184 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#include "darray.hpp"
+#include "gtest.h"
+#include "remap_allocator.hpp"
+
+#include <cstdint>
+#include <expected>
+#include <string>
+
+using CppPlay::darray;
+using CppPlay::GrowthPolicyDouble;
+using CppPlay::remap_allocator;
+using CppPlay::ThreadProtectionDisabled;
+
+//=============================================================================
+// Helper Classes and Functions
+//=============================================================================
+// small threshold so tests exercise the mapped path without large buffers
+static constexpr size_t TEST_MMAP_THRESHOLD = 4096;
+
+template <typename T>
+using test_remap_allocator = remap_allocator<T, TEST_MMAP_THRESHOLD>;
+
+template <typename T>
+using remap_darray = darray<T, ThreadProtectionDisabled<T>,
+                            GrowthPolicyDouble<T>, test_remap_allocator<T>>;
+
+static_assert(CppPlay::reallocating_allocator<test_remap_allocator<int>>);
+static_assert(!CppPlay::reallocating_allocator<std::allocator<int>>);
+
+//=============================================================================
+// Tests
+//=============================================================================
+TEST(remapAllocator, reallocateKeepsContents) {
+  test_remap_allocator<std::uint32_t> allocator{};
+
+  // heap (realloc), crossing into mapped, mapped (mremap), then back to heap
+  size_t count = 16;
+  std::uint32_t *p_buffer = allocator.allocate(count);
+  for (size_t idx = 0; idx < count; idx++) {
+    p_buffer[idx] = static_cast<std::uint32_t>(idx);
+  }
+  for (const size_t new_count : {size_t{64}, size_t{4096}, size_t{1 << 16}}) {
+    p_buffer = allocator.reallocate(p_buffer, count, new_count);
+    ASSERT_NE(nullptr, p_buffer);
+    for (size_t idx = 0; idx < count; idx++) {
+      EXPECT_EQ(idx, p_buffer[idx]);
+    }
+    for (size_t idx = count; idx < new_count; idx++) {
+      p_buffer[idx] = static_cast<std::uint32_t>(idx);
+    }
+    count = new_count;
+  }
+  p_buffer = allocator.reallocate(p_buffer, count, 32);
+  for (size_t idx = 0; idx < 32; idx++) {
+    EXPECT_EQ(idx, p_buffer[idx]);
+  }
+  allocator.deallocate(p_buffer, 32);
+
+  // zero capacity is still a buffer
+  std::uint32_t *p_empty = allocator.allocate(0);
+  EXPECT_NE(nullptr, p_empty);
+  allocator.deallocate(p_empty, 0);
+}
+
+TEST(remapAllocator, darrayGrowInPlace) {
+  remap_darray<std::uint32_t> darray_obj =
+      remap_darray<std::uint32_t>::builder{}.capacity(2).build();
+
+  // grows through the heap and mapped ranges in place
+  constexpr std::uint32_t ELEMENT_COUNT = 100'000;
+  for (std::uint32_t value = 0; value < ELEMENT_COUNT; value++) {
+    EXPECT_EQ(value + 1, darray_obj.push_back(value).value());
+  }
+  EXPECT_EQ((size_t)(1 << 17), darray_obj.pod().capacity());
+  for (std::uint32_t value = 0; value < ELEMENT_COUNT; value++) {
+    EXPECT_EQ(value, darray_obj[value]);
+  }
+
+  // insert at capacity grows in place then shifts within the buffer
+  while (darray_obj.pod().size() < darray_obj.pod().capacity()) {
+    EXPECT_TRUE(darray_obj.push_back(0u).has_value());
+  }
+  EXPECT_TRUE(darray_obj.insert(42u, 7).has_value());
+  EXPECT_EQ((size_t)(1 << 18), darray_obj.pod().capacity());
+  EXPECT_EQ(6u, darray_obj[6]);
+  EXPECT_EQ(42u, darray_obj[7]);
+  EXPECT_EQ(7u, darray_obj[8]);
+  EXPECT_EQ(42u, darray_obj.extract(7).value());
+  EXPECT_EQ(7u, darray_obj[7]);
+
+  // shrinking, copy and move use the regular paths
+  remap_darray<std::uint32_t> copy{darray_obj};
+  while (darray_obj.pod().size() > 0) {
+    EXPECT_TRUE(darray_obj.pop_back().has_value());
+  }
+  EXPECT_EQ((size_t)2, darray_obj.pod().capacity());
+  EXPECT_EQ(99'999u, copy[99'999]);
+
+  remap_darray<std::uint32_t> moved{std::move(copy)};
+  EXPECT_EQ((size_t)0, copy.pod().capacity());
+  EXPECT_TRUE(copy.push_back(1u).has_value());
+  EXPECT_EQ(1u, copy[0]);
+  EXPECT_EQ(12'345u, moved[12'345]);
+}
+
+TEST(remapAllocator, darrayNotRelocatable) {
+  // elements that can't be relocated by their bytes are transferred to a new
+  // buffer as usual
+  static_assert(!CppPlay::is_trivially_relocatable_v<std::string>);
+  remap_darray<std::string> darray_obj =
+      remap_darray<std::string>::builder{}.capacity(2).build();
+  for (int value = 0; value < 1000; value++) {
+    EXPECT_TRUE(darray_obj.push_back(std::to_string(value)).has_value());
+  }
+  EXPECT_TRUE(darray_obj.insert(std::string{"mid"}, 500).has_value());
+  EXPECT_EQ("mid", darray_obj.extract(500).value());
+  for (int value = 999; value >= 0; value--) {
+    EXPECT_EQ(std::to_string(value), darray_obj.pop_back().value());
+  }
+}
+
+TEST(remapAllocator, darraySelfAliasing) {
+  // an element of the darray itself is read before the buffer it lives in
+  // is reallocated (realloc, mremap) or shifted
+  remap_darray<long> darray_obj =
+      remap_darray<long>::builder{}.capacity(1).build();
+  EXPECT_TRUE(darray_obj.push_back(7L).has_value());
+  for (size_t count = 1; count < 5000; count++) {
+    ASSERT_EQ(count + 1, darray_obj.push_back(darray_obj[0]).value());
+  }
+  for (size_t idx = 0; idx < darray_obj.pod().size(); idx++) {
+    ASSERT_EQ(7L, darray_obj[idx]);
+  }
+  darray_obj[darray_obj.pod().size() - 1] = 9L;
+  while (darray_obj.pod().size() < darray_obj.pod().capacity()) {
+    EXPECT_TRUE(darray_obj.push_back(8L).has_value());
+  }
+  const size_t last = darray_obj.pod().size() - 1;
+  EXPECT_TRUE(darray_obj.insert(darray_obj[4999], 0).has_value());
+  EXPECT_EQ(9L, darray_obj[0]);
+  EXPECT_EQ(8L, darray_obj[last + 1]);
+  EXPECT_TRUE(darray_obj.insert(darray_obj[2], 1).has_value());
+  EXPECT_EQ(7L, darray_obj[1]);
+
+  // transferred elements are moved from before the new one is stored
+  remap_darray<std::string> strings =
+      remap_darray<std::string>::builder{}.capacity(1).build();
+  EXPECT_TRUE(strings.push_back(std::string(40, 'a')).has_value());
+  for (size_t count = 1; count < 100; count++) {
+    ASSERT_TRUE(strings.push_back(strings[count - 1]).has_value());
+  }
+  EXPECT_TRUE(strings.insert(strings[0], 0).has_value());
+  EXPECT_TRUE(strings.insert(strings[3], 1).has_value());
+  for (size_t idx = 0; idx < strings.pod().size(); idx++) {
+    EXPECT_EQ(std::string(40, 'a'), strings[idx]);
+  }
+}
@@ -0,0 +1,272 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#include "set_algorithm.hpp"
+#include "gtest.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using CppPlay::darray;
+namespace simd = CppPlay::simd;
+
+//=============================================================================
+// Helper Classes and Functions
+//=============================================================================
+// count distinct sorted values below limit
+template <typename T>
+static auto sorted_values(std::mt19937 &generator, const size_t count,
+                          const T limit) -> std::vector<T> {
+  std::uniform_int_distribution<T> distribution{0, limit};
+  std::vector<T> values{};
+  while (values.size() < count) {
+    for (size_t idx = values.size(); idx < count; idx++) {
+      values.push_back(distribution(generator));
+    }
+    std::ranges::sort(values);
+    values.erase(std::ranges::unique(values).begin(), values.end());
+  }
+  return values;
+}
+
+template <typename T>
+static auto contents(const darray<T> &darray_obj) -> std::vector<T> {
+  return {darray_obj.begin(), darray_obj.end()};
+}
+
+// every operation appends what the std algorithm writes
+template <typename T, typename Compare = std::less<T>>
+static auto matches_std(const std::vector<T> &left,
+                        const std::vector<T> &right, Compare comp = {})
+    -> void {
+  std::vector<T> expected_result{};
+  darray<T> out = typename darray<T>::builder{}.build();
+
+  std::ranges::merge(left, right, std::back_inserter(expected_result), comp);
+  EXPECT_EQ(expected_result.size(),
+            CppPlay::merge(left, right, out, comp).value());
+  EXPECT_EQ(expected_result, contents(out));
+
+  expected_result.clear();
+  EXPECT_TRUE(out.clear().has_value());
+  std::ranges::set_union(left, right, std::back_inserter(expected_result),
+                         comp);
+  EXPECT_EQ(expected_result.size(),
+            CppPlay::set_union(left, right, out, comp).value());
+  EXPECT_EQ(expected_result, contents(out));
+
+  expected_result.clear();
+  EXPECT_TRUE(out.clear().has_value());
+  std::ranges::set_difference(left, right,
+                              std::back_inserter(expected_result), comp);
+  EXPECT_EQ(expected_result.size(),
+            CppPlay::set_difference(left, right, out, comp).value());
+  EXPECT_EQ(expected_result, contents(out));
+
+  expected_result.clear();
+  std::ranges::set_intersection(left, right,
+                                std::back_inserter(expected_result), comp);
+  for (const simd::level level : {simd::level::SCALAR, simd::level::SSE2,
+                                  simd::level::AVX2, simd::level::AVX512}) {
+    EXPECT_TRUE(out.clear().has_value());
+    EXPECT_EQ(expected_result.size(),
+              CppPlay::set_intersection(left, right, out, comp, level).value());
+    EXPECT_EQ(expected_result, contents(out));
+  }
+}
+
+//=============================================================================
+// Tests
+//=============================================================================
+TEST(setAlgorithm, matchesStd) {
+  // even sizes walk (and use every vector width), skewed sizes gallop from
+  // either side, overlap from none to dense
+  std::mt19937 generator{42};
+  const std::pair<size_t, size_t> sizes[] = {
+      {0, 0},     {0, 100},  {100, 0},    {1, 1},      {7, 9},
+      {100, 100}, {333, 77}, {1000, 1000}, {10, 10000}, {10000, 10},
+      {3, 50000}, {50000, 1}};
+  for (const auto &[left_count, right_count] : sizes) {
+    for (const std::uint32_t limit : {2000u, 20000u, 1000000u}) {
+      const size_t largest = std::max(left_count, right_count);
+      const auto bounded = std::max<std::uint32_t>(
+          limit, static_cast<std::uint32_t>(largest * 2));
+      matches_std(sorted_values(generator, left_count, bounded),
+                  sorted_values(generator, right_count, bounded));
+    }
+  }
+
+  // signed keys take the vector path, 64-bit keys do not
+  std::vector<std::int32_t> negative{-5, -3, -1, 0, 2, 4, 6, 8, 10, 12, 14};
+  std::vector<std::int32_t> mixed{-4, -3, 0, 1, 2, 3, 4, 5, 12, 13, 14, 15};
+  matches_std(negative, mixed);
+  matches_std(sorted_values<std::uint64_t>(generator, 5000, 20000),
+              sorted_values<std::uint64_t>(generator, 3000, 20000));
+
+  // the short range runs past the end of the long one
+  std::vector<std::uint32_t> keys(1000);
+  std::iota(keys.begin(), keys.end(), 0u);
+  const std::vector<std::uint32_t> beyond{5, 998, 2000, 3000, 4000};
+  matches_std(keys, beyond);
+  matches_std(beyond, keys);
+}
+
+TEST(setAlgorithm, duplicatesCompare) {
+  // multisets keep the std multiplicities, walked and galloped
+  std::mt19937 generator{7};
+  std::uniform_int_distribution<std::int64_t> distribution{0, 50};
+  std::vector<std::int64_t> many(5000);
+  std::vector<std::int64_t> few(40);
+  for (auto &value : many) {
+    value = distribution(generator);
+  }
+  for (auto &value : few) {
+    value = distribution(generator);
+  }
+  std::ranges::sort(many);
+  std::ranges::sort(few);
+  matches_std(many, few);
+  matches_std(few, many);
+  matches_std(std::vector<std::int64_t>(many.begin(), many.begin() + 40),
+              few);
+
+  // 32-bit multisets are walked at every level, the default included, into
+  // exactly the shorter range's room
+  std::uniform_int_distribution<std::uint32_t> narrow{0, 20};
+  std::vector<std::uint32_t> left_keys(300);
+  std::vector<std::uint32_t> right_keys(200);
+  for (auto &value : left_keys) {
+    value = narrow(generator);
+  }
+  for (auto &value : right_keys) {
+    value = narrow(generator);
+  }
+  std::ranges::sort(left_keys);
+  std::ranges::sort(right_keys);
+  matches_std(left_keys, right_keys);
+  std::vector<std::uint32_t> expected_keys{};
+  std::ranges::set_intersection(left_keys, right_keys,
+                                std::back_inserter(expected_keys));
+  darray<std::uint32_t> exact =
+      darray<std::uint32_t>::builder{}.capacity(right_keys.size()).build();
+  EXPECT_EQ(expected_keys.size(),
+            CppPlay::set_intersection(left_keys, right_keys, exact).value());
+  EXPECT_EQ(expected_keys, contents(exact));
+  EXPECT_EQ(right_keys.size(), exact.pod().capacity());
+
+  // descending strings, std::greater
+  const std::vector<std::string> left{"pear", "kiwi", "kiwi", "fig", "apple"};
+  const std::vector<std::string> right{"plum", "kiwi", "grape", "fig"};
+  matches_std(left, right, std::greater<>{});
+}
+
+TEST(setAlgorithm, stableAndPreallocated) {
+  // of equal elements left's come first, or are the ones kept
+  using pair_t = std::pair<int, char>;
+  const auto by_first = [](const pair_t &lhs, const pair_t &rhs) {
+    return lhs.first < rhs.first;
+  };
+  const std::vector<pair_t> left{{1, 'l'}, {3, 'l'}, {5, 'l'}};
+  const std::vector<pair_t> right{{1, 'r'}, {2, 'r'}, {5, 'r'}};
+  darray<pair_t> out = darray<pair_t>::builder{}.build();
+  EXPECT_EQ((size_t)6, CppPlay::merge(left, right, out, by_first).value());
+  EXPECT_EQ((std::vector<pair_t>{{1, 'l'}, {1, 'r'}, {2, 'r'}, {3, 'l'},
+                                 {5, 'l'}, {5, 'r'}}),
+            contents(out));
+  EXPECT_TRUE(out.clear().has_value());
+  EXPECT_EQ((size_t)2,
+            CppPlay::set_intersection(right, left, out, by_first).value());
+  EXPECT_EQ((std::vector<pair_t>{{1, 'r'}, {5, 'r'}}), contents(out));
+
+  // results are appended, a darray with room for the largest result does not
+  // grow
+  darray<std::uint32_t> postings =
+      darray<std::uint32_t>::builder{}.capacity(16).build();
+  EXPECT_TRUE(postings.push_back(99u).has_value());
+  const std::vector<std::uint32_t> first{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  const std::vector<std::uint32_t> second{2, 4, 6, 8, 10, 12, 14, 16};
+  EXPECT_EQ((size_t)5,
+            CppPlay::set_intersection(first, second, postings).value());
+  EXPECT_EQ((size_t)5,
+            CppPlay::set_difference(first, second, postings).value());
+  EXPECT_EQ((size_t)16, postings.pod().capacity());
+  EXPECT_EQ((std::vector<std::uint32_t>{99, 2, 4, 6, 8, 10, 1, 3, 5, 7, 9}),
+            contents(postings));
+}
+
+TEST(setAlgorithm, kWayMerge) {
+  std::mt19937 generator{3};
+  for (const size_t input_count : {0, 1, 2, 3, 8, 33}) {
+    std::vector<std::vector<std::uint32_t>> inputs{};
+    std::vector<std::uint32_t> expected_result{};
+    for (size_t input = 0; input < input_count; input++) {
+      // some inputs empty, values repeat across inputs
+      inputs.push_back(sorted_values<std::uint32_t>(
+          generator, (0 == (input % 3)) ? 0 : (input * 37), 3000));
+      expected_result.insert(expected_result.end(), inputs.back().begin(),
+                             inputs.back().end());
+    }
+    std::ranges::sort(expected_result);
+
+    darray<std::uint32_t> out = darray<std::uint32_t>::builder{}.build();
+    EXPECT_EQ(expected_result.size(),
+              CppPlay::k_way_merge(inputs, out).value());
+    EXPECT_EQ(expected_result, contents(out));
+  }
+
+  // of equal elements those of earlier inputs first
+  using pair_t = std::pair<int, int>;
+  const std::vector<std::vector<pair_t>> inputs{
+      {{1, 0}, {4, 0}, {4, 0}},
+      {{1, 1}, {2, 1}, {4, 1}},
+      {{0, 2}, {1, 2}, {4, 2}, {9, 2}}};
+  darray<pair_t> out = darray<pair_t>::builder{}.build();
+  EXPECT_EQ((size_t)10,
+            CppPlay::k_way_merge(inputs, out,
+                                 [](const pair_t &lhs, const pair_t &rhs) {
+                                   return lhs.first < rhs.first;
+                                 })
+                .value());
+  EXPECT_EQ((std::vector<pair_t>{{0, 2},
+                                 {1, 0},
+                                 {1, 1},
+                                 {1, 2},
+                                 {2, 1},
+                                 {4, 0},
+                                 {4, 0},
+                                 {4, 1},
+                                 {4, 2},
+                                 {9, 2}}),
+            contents(out));
+}
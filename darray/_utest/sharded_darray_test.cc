@@ -0,0 +1,114 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#include "gtest.h"
+#include "sharded_darray.hpp"
+
+#include <algorithm>
+#include <expected>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+using CppPlay::sharded_darray;
+
+//=============================================================================
+// Helper Classes and Functions
+//=============================================================================
+
+//=============================================================================
+// Tests
+//=============================================================================
+TEST(shardedDarray, singleThread) {
+  sharded_darray<int> sharded =
+      sharded_darray<int>::builder{}.shards(4).capacity(2).build();
+  EXPECT_EQ((size_t)4, sharded.shard_count());
+  EXPECT_LT(sharded.shard_index(), (size_t)4);
+
+  // a single thread always appends to the same shard, so order is kept
+  for (int value = 0; value < 100; value++) {
+    EXPECT_EQ((size_t)(value + 1), sharded.push_back(value).value());
+  }
+  EXPECT_EQ((size_t)100, sharded.size().value());
+
+  auto flat = sharded.flatten();
+  ASSERT_TRUE(flat.has_value());
+  EXPECT_EQ((size_t)100, flat.value().pod().size());
+  for (int value = 0; value < 100; value++) {
+    EXPECT_EQ(value, flat.value()[value]);
+  }
+  EXPECT_EQ((size_t)100, sharded.size().value());
+
+  int sum = 0;
+  sharded.for_each([&sum](const int &value) { sum += value; });
+  EXPECT_EQ(4950, sum);
+}
+
+TEST(shardedDarray, multipleProducers) {
+  constexpr int THREAD_COUNT = 8;
+  constexpr int ADD_LIMIT = 10000;
+
+  sharded_darray<std::string> sharded =
+      sharded_darray<std::string>::builder{}.shards(4).build();
+
+  auto produce = [&](const int thread) {
+    for (int idx = 0; idx < ADD_LIMIT; idx++) {
+      EXPECT_TRUE(
+          sharded.push_back(std::to_string((thread * ADD_LIMIT) + idx))
+              .has_value());
+    }
+  };
+  std::vector<std::future<void>> producers{};
+  for (int thread = 0; thread < THREAD_COUNT; thread++) {
+    producers.push_back(std::async(std::launch::async, produce, thread));
+  }
+  // size can be read while producing
+  EXPECT_LE(sharded.size().value(), (size_t)(THREAD_COUNT * ADD_LIMIT));
+  for (auto &producer : producers) {
+    producer.wait();
+  }
+  EXPECT_EQ((size_t)(THREAD_COUNT * ADD_LIMIT), sharded.size().value());
+
+  // every element appears exactly once
+  auto drained = sharded.drain();
+  ASSERT_TRUE(drained.has_value());
+  EXPECT_EQ((size_t)0, sharded.size().value());
+  std::vector<int> values{};
+  for (const std::string &value : drained.value()) {
+    values.push_back(std::stoi(value));
+  }
+  std::ranges::sort(values);
+  ASSERT_EQ((size_t)(THREAD_COUNT * ADD_LIMIT), values.size());
+  for (int idx = 0; idx < THREAD_COUNT * ADD_LIMIT; idx++) {
+    EXPECT_EQ(idx, values[idx]);
+  }
+
+  // usable after draining
+  EXPECT_EQ((size_t)1, sharded.push_back(std::string{"again"}).value());
+  EXPECT_EQ((size_t)1, sharded.size().value());
+}
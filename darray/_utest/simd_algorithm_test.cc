@@ -0,0 +1,153 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#include "gtest.h"
+#include "simd_algorithm.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <span>
+#include <vector>
+
+using CppPlay::darray;
+namespace simd = CppPlay::simd;
+
+//=============================================================================
+// Helper Classes and Functions
+//=============================================================================
+static constexpr simd::level s_levels[] = {simd::level::SCALAR,
+                                           simd::level::SSE2,
+                                           simd::level::AVX2,
+                                           simd::level::AVX512};
+
+// every kernel at every level the cpu supports agrees with the standard
+// algorithms, for lengths covering partial vectors and several min/max blocks
+// values are small integers, so floating point sums are exact in any order
+template <typename T> static auto check_kernels() -> void {
+  std::mt19937 generator{42};
+  std::uniform_int_distribution<int> distribution{0, 100};
+  for (const size_t count : {size_t{0}, size_t{1}, size_t{7}, size_t{63},
+                             size_t{130}, size_t{4097}, size_t{20000}}) {
+    std::vector<T> values(count);
+    std::vector<T> weights(count);
+    for (size_t idx = 0; idx < count; idx++) {
+      values[idx] = static_cast<T>(distribution(generator));
+      weights[idx] = static_cast<T>(distribution(generator) % 3);
+    }
+    if (count > 100) {
+      // extremes late in the range, past the first block
+      values[count - 3] = static_cast<T>(101);
+      values[count - 2] = static_cast<T>(101);
+      values[count - 50] = static_cast<T>(-1);
+    }
+    const std::span<const T> view{values};
+
+    for (const simd::level requested : s_levels) {
+      if (requested > simd::supported_level()) {
+        continue;
+      }
+      for (const T needle : {static_cast<T>(0), static_cast<T>(50),
+                             static_cast<T>(101), static_cast<T>(102)}) {
+        EXPECT_EQ(static_cast<size_t>(std::ranges::find(values, needle) -
+                                      values.begin()),
+                  simd::find(view, needle, requested));
+        EXPECT_EQ(static_cast<size_t>(std::ranges::count(values, needle)),
+                  simd::count(values, needle, requested));
+      }
+
+      EXPECT_EQ(
+          std::accumulate(values.begin(), values.end(), simd::sum_type<T>{}),
+          simd::sum(values, requested));
+      // products are widened before they are summed
+      EXPECT_EQ(std::transform_reduce(
+                    values.begin(), values.end(), weights.begin(),
+                    simd::sum_type<T>{}, std::plus<>{},
+                    [](const T value, const T weight) {
+                      return static_cast<simd::sum_type<T>>(value) *
+                             static_cast<simd::sum_type<T>>(weight);
+                    }),
+                simd::dot(values, weights, requested).value());
+
+      if (0 == count) {
+        EXPECT_FALSE(simd::min_element(values, requested).has_value());
+        EXPECT_FALSE(simd::max_element(values, requested).has_value());
+        continue;
+      }
+      const auto min = std::ranges::min_element(values);
+      EXPECT_EQ((simd::indexed_value<T>{
+                    *min, static_cast<size_t>(min - values.begin())}),
+                simd::min_element(values, requested).value());
+      const auto max = std::ranges::max_element(values);
+      EXPECT_EQ((simd::indexed_value<T>{
+                    *max, static_cast<size_t>(max - values.begin())}),
+                simd::max_element(values, requested).value());
+    }
+  }
+}
+
+//=============================================================================
+// Tests
+//=============================================================================
+TEST(simdAlgorithm, kernelsAgree) {
+  check_kernels<std::int8_t>();
+  check_kernels<std::uint8_t>();
+  check_kernels<std::int16_t>();
+  check_kernels<std::uint32_t>();
+  check_kernels<std::int32_t>();
+  check_kernels<std::int64_t>();
+  check_kernels<float>();
+  check_kernels<double>();
+  check_kernels<long double>();
+}
+
+TEST(simdAlgorithm, darrayRange) {
+  darray<unsigned int> darray_obj{};
+  for (unsigned int value = 0; value < 1000; value++) {
+    EXPECT_TRUE(darray_obj.push_back(value % 10).has_value());
+  }
+  EXPECT_EQ((size_t)13, simd::find(darray_obj, 3u) + 10);
+  EXPECT_EQ((size_t)100, simd::count(darray_obj, 9u));
+  EXPECT_EQ((std::uint64_t)4500, simd::sum(darray_obj));
+  EXPECT_EQ((simd::indexed_value<unsigned int>{9u, 9}),
+            simd::max_element(darray_obj).value());
+  EXPECT_EQ((simd::indexed_value<unsigned int>{0u, 0}),
+            simd::min_element(darray_obj).value());
+  EXPECT_EQ((std::uint64_t)28500, simd::dot(darray_obj, darray_obj).value());
+
+  // lengths differ
+  const std::vector<unsigned int> shorter(999, 1u);
+  EXPECT_FALSE(simd::dot(darray_obj, shorter).has_value());
+
+  // large unsigned sums do not wrap in the element type
+  const std::vector<std::uint8_t> bytes(100000, 255);
+  EXPECT_EQ((std::uint64_t)25500000, simd::sum(bytes));
+  EXPECT_EQ((size_t)100000, simd::count(bytes, std::uint8_t{255}));
+}
@@ -0,0 +1,159 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#include "counting_allocator.hpp"
+#include "gtest.h"
+#include "live_string.hpp"
+#include "small_darray.hpp"
+
+#include <algorithm>
+#include <expected>
+#include <iterator>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+using CppPlay::small_darray;
+
+//=============================================================================
+// Tests
+//=============================================================================
+TEST(smallDarray, inlineThenSpill) {
+  using SmallDArray = small_darray<int, 4, CppPlay::GrowthPolicyDouble<int>,
+                                   counting_allocator<int>>;
+  counting_allocator<int>::s_allocations = 0;
+
+  SmallDArray small{};
+  EXPECT_TRUE(small.is_inline());
+  EXPECT_EQ((size_t)4, small.pod().capacity());
+  EXPECT_TRUE(small.pod().is_empty());
+
+  // first N elements stay inside the object
+  for (int value = 0; value < 4; value++) {
+    EXPECT_EQ((size_t)(value + 1), small.push_back(value).value());
+  }
+  EXPECT_TRUE(small.is_inline());
+  EXPECT_EQ((size_t)0, counting_allocator<int>::s_allocations);
+
+  // overflow spills to the heap once, grown by the growth policy
+  EXPECT_EQ((size_t)5, small.push_back(4).value());
+  EXPECT_FALSE(small.is_inline());
+  EXPECT_EQ((size_t)8, small.pod().capacity());
+  EXPECT_EQ((size_t)1, counting_allocator<int>::s_allocations);
+  EXPECT_EQ((size_t)6, small.insert(100, 0).value());
+  EXPECT_EQ((size_t)7, small.insert(200, 6).value());
+  EXPECT_FALSE(small.insert(300, 8).has_value());
+
+  std::vector<int> values{};
+  std::copy(small.begin(), small.end(), std::back_inserter(values));
+  EXPECT_EQ((std::vector<int>{100, 0, 1, 2, 3, 4, 200}), values);
+  EXPECT_EQ(200, *(small.at(6).value()));
+  EXPECT_FALSE(small.at(7).has_value());
+
+  // shrinking back to a size that fits returns inside the object
+  EXPECT_EQ(100, small.extract(0).value());
+  EXPECT_EQ(200, small.pop_back().value());
+  EXPECT_EQ((size_t)5, small.pod().size());
+  EXPECT_FALSE(small.is_inline());
+  EXPECT_EQ(4, small.pop_back().value());
+  EXPECT_TRUE(small.is_inline());
+  EXPECT_EQ((size_t)4, small.pod().capacity());
+  EXPECT_EQ(3, small[3]);
+  EXPECT_FALSE(small.extract(4).has_value());
+
+  EXPECT_TRUE(small.clear().has_value());
+  EXPECT_TRUE(small.pod().is_empty());
+  EXPECT_FALSE(small.pop_back().has_value());
+  EXPECT_EQ((size_t)1, counting_allocator<int>::s_allocations);
+
+  // builder reserves on the heap only beyond the inline capacity
+  SmallDArray reserved = SmallDArray::builder{}.capacity(3).build();
+  EXPECT_TRUE(reserved.is_inline());
+  SmallDArray heap = SmallDArray::builder{}.capacity(16).build();
+  EXPECT_FALSE(heap.is_inline());
+  EXPECT_EQ((size_t)16, heap.pod().capacity());
+}
+
+TEST(smallDarray, copyMove) {
+  LiveString::s_live_count = 0;
+  {
+    small_darray<LiveString, 2> inline_obj{};
+    EXPECT_TRUE(inline_obj.push_back(LiveString{"a"}).has_value());
+    EXPECT_TRUE(inline_obj.push_back(LiveString{"b"}).has_value());
+    small_darray<LiveString, 2> heap_obj{inline_obj};
+    EXPECT_TRUE(heap_obj.push_back(LiveString{"c"}).has_value());
+    EXPECT_EQ(5, LiveString::s_live_count);
+
+    // inline elements are relocated, heap buffers are taken
+    small_darray<LiveString, 2> moved_inline{std::move(inline_obj)};
+    EXPECT_TRUE(moved_inline.is_inline());
+    EXPECT_TRUE(inline_obj.pod().is_empty());
+    EXPECT_EQ(LiveString{"b"}, moved_inline[1]);
+    small_darray<LiveString, 2> moved_heap{std::move(heap_obj)};
+    EXPECT_FALSE(moved_heap.is_inline());
+    EXPECT_TRUE(heap_obj.is_inline());
+    EXPECT_EQ(LiveString{"c"}, moved_heap[2]);
+    EXPECT_EQ(5, LiveString::s_live_count);
+
+    // assignment between inline and heap
+    inline_obj = moved_heap;
+    EXPECT_EQ((size_t)3, inline_obj.pod().size());
+    EXPECT_EQ(8, LiveString::s_live_count);
+    moved_heap = std::move(moved_inline);
+    EXPECT_TRUE(moved_heap.is_inline());
+    EXPECT_EQ((size_t)2, moved_heap.pod().size());
+    EXPECT_EQ(5, LiveString::s_live_count);
+    moved_heap = moved_heap;
+    EXPECT_EQ(LiveString{"a"}, moved_heap[0]);
+
+    // elements shift in place, inline and on the heap
+    EXPECT_TRUE(moved_heap.insert(LiveString{"z"}, 1).has_value());
+    EXPECT_EQ(LiveString{"z"}, moved_heap[1]);
+    EXPECT_EQ(LiveString{"b"}, moved_heap[2]);
+    EXPECT_EQ(LiveString{"a"}, moved_heap.extract(0).value());
+    EXPECT_EQ(LiveString{"z"}, moved_heap[0]);
+  }
+  EXPECT_EQ(0, LiveString::s_live_count);
+}
+
+TEST(smallDarray, relocatable) {
+  small_darray<unsigned int, 8> small{};
+  std::vector<unsigned int> expected(100);
+  std::iota(expected.begin(), expected.end(), 0u);
+  for (const unsigned int value : expected) {
+    EXPECT_TRUE(small.push_back(value).has_value());
+  }
+  EXPECT_EQ((size_t)128, small.pod().capacity());
+  EXPECT_TRUE(std::equal(small.begin(), small.end(), expected.begin()));
+  std::sort(small.begin(), small.end(), std::greater<>{});
+  EXPECT_EQ(99u, small[0]);
+  while (!small.pod().is_empty()) {
+    EXPECT_TRUE(small.pop_back().has_value());
+  }
+  EXPECT_TRUE(small.is_inline());
+}
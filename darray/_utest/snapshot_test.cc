@@ -0,0 +1,210 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#include "snapshot.hpp"
+#include "gtest.h"
+#include "temp_file.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using CppPlay::darray;
+using CppPlay::load_snapshot;
+using CppPlay::save_snapshot;
+using CppPlay::string_serializer;
+
+//=============================================================================
+// Helper Classes and Functions
+//=============================================================================
+namespace {
+struct Sample {
+  std::uint32_t m_sensor;
+  float m_reading;
+  std::uint64_t m_time;
+  auto operator==(const Sample &) const -> bool = default;
+};
+} // namespace
+
+// flip one byte of the file at offset
+static auto corrupt(const TempFile &file, const std::streamoff offset)
+    -> void {
+  std::fstream stream{file.path(),
+                      std::ios::in | std::ios::out | std::ios::binary};
+  stream.seekg(offset);
+  const char original = static_cast<char>(stream.get());
+  stream.seekp(offset);
+  stream.put(static_cast<char>(~original));
+}
+
+static auto truncate(const TempFile &file, const std::uintmax_t bytes) -> void {
+  std::filesystem::resize_file(file.path(), bytes);
+}
+
+// replace the 64-bit header field at offset
+static auto overwrite(const TempFile &file, const std::streamoff offset,
+                      const std::uint64_t value) -> void {
+  std::fstream stream{file.path(),
+                      std::ios::in | std::ios::out | std::ios::binary};
+  stream.seekp(offset);
+  stream.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+//=============================================================================
+// Tests
+//=============================================================================
+TEST(snapshot, trivialRoundTrip) {
+  const TempFile file{"snapshot.trivial"};
+  auto source = darray<Sample>::builder{}.capacity(4).build();
+  for (std::uint32_t idx = 0; idx < 10'000; idx++) {
+    EXPECT_TRUE(source
+                    .push_back(Sample{idx % 7, static_cast<float>(idx) / 3,
+                                      std::uint64_t{idx} * 1000})
+                    .has_value());
+  }
+  // chunks that do not divide the payload or the elements
+  const size_t file_bytes = save_snapshot(source, file.path(), 1000).value();
+  EXPECT_EQ(file_bytes, std::filesystem::file_size(file.path()));
+  EXPECT_FALSE(std::filesystem::exists(file.path() + ".partial"));
+
+  // loaded into preallocated capacity without growing, appended after the
+  // existing elements
+  auto loaded = darray<Sample>::builder{}.capacity(10'001).build();
+  EXPECT_TRUE(loaded.push_back(Sample{99, 0, 0}).has_value());
+  EXPECT_EQ((size_t)10'000, load_snapshot(file.path(), loaded, 777).value());
+  EXPECT_EQ((size_t)10'001, loaded.pod().capacity());
+  EXPECT_EQ((size_t)10'001, loaded.pod().size());
+  EXPECT_EQ((Sample{99, 0, 0}), loaded[0]);
+  EXPECT_TRUE(std::equal(source.begin(), source.end(), loaded.begin() + 1));
+
+  // empty darrays round trip, a save replaces the file
+  const auto empty = darray<Sample>::builder{}.build();
+  EXPECT_TRUE(save_snapshot(empty, file.path()).has_value());
+  EXPECT_EQ((size_t)0, load_snapshot(file.path(), loaded).value());
+  EXPECT_EQ((size_t)10'001, loaded.pod().size());
+}
+
+TEST(snapshot, serializedRoundTrip) {
+  const TempFile file{"snapshot.serialized"};
+  auto source = darray<std::string>::builder{}.build();
+  for (size_t idx = 0; idx < 2000; idx++) {
+    EXPECT_TRUE(source.push_back(std::string(idx % 50, 'a' + (idx % 26)))
+                    .has_value());
+  }
+  // records larger than the staging chunk, and empty records
+  EXPECT_TRUE(source.push_back(std::string(5000, 'z')).has_value());
+  EXPECT_TRUE(source.push_back(std::string{}).has_value());
+
+  const string_serializer<std::string> serializer{};
+  for (const size_t chunk : {size_t{1}, size_t{64}, size_t{1} << 20}) {
+    EXPECT_TRUE(save_snapshot(source, file.path(), serializer, chunk));
+    auto loaded = darray<std::string>::builder{}.build();
+    EXPECT_EQ(source.pod().size(),
+              load_snapshot(file.path(), loaded, serializer, chunk).value());
+    EXPECT_TRUE(std::equal(source.begin(), source.end(), loaded.begin(),
+                           loaded.end()));
+  }
+
+  // serialized and trivially copyable snapshots are not interchangeable
+  auto bytes = darray<char>::builder{}.build();
+  EXPECT_FALSE(load_snapshot(file.path(), bytes).has_value());
+}
+
+TEST(snapshot, invalidFiles) {
+  const TempFile file{"snapshot.invalid"};
+  auto source = darray<std::uint64_t>::builder{}.build();
+  for (std::uint64_t value = 0; value < 1000; value++) {
+    EXPECT_TRUE(source.push_back(value).has_value());
+  }
+  auto loaded = darray<std::uint64_t>::builder{}.build();
+  const auto load_fails = [&]() {
+    EXPECT_FALSE(load_snapshot(file.path(), loaded, 100).has_value());
+    EXPECT_TRUE(loaded.pod().is_empty());
+  };
+
+  // a payload byte changed, nothing is appended
+  EXPECT_TRUE(save_snapshot(source, file.path()).has_value());
+  corrupt(file, 40 + 4321);
+  load_fails();
+
+  // payload cut short
+  EXPECT_TRUE(save_snapshot(source, file.path()).has_value());
+  truncate(file, 40 + 4000);
+  load_fails();
+
+  // header cut short, header changed, another element size
+  truncate(file, 20);
+  load_fails();
+  EXPECT_TRUE(save_snapshot(source, file.path()).has_value());
+  corrupt(file, 0);
+  load_fails();
+  EXPECT_TRUE(save_snapshot(source, file.path()).has_value());
+  auto narrow = darray<std::uint32_t>::builder{}.build();
+  EXPECT_FALSE(load_snapshot(file.path(), narrow).has_value());
+
+  // a count and payload size (consistent with each other) larger than the
+  // file is refused before the destination grows
+  const size_t capacity = loaded.pod().capacity();
+  overwrite(file, 16, std::uint64_t{1} << 40);
+  overwrite(file, 24, std::uint64_t{8} << 40);
+  load_fails();
+  EXPECT_EQ(capacity, loaded.pod().capacity());
+
+  // serialized records cut short or changed
+  auto strings = darray<std::string>::builder{}.build();
+  for (int idx = 0; idx < 100; idx++) {
+    EXPECT_TRUE(strings.push_back(std::to_string(idx)).has_value());
+  }
+  const string_serializer<std::string> serializer{};
+  auto loaded_strings = darray<std::string>::builder{}.build();
+  EXPECT_TRUE(save_snapshot(strings, file.path(), serializer).has_value());
+  truncate(file, std::filesystem::file_size(file.path()) - 1);
+  EXPECT_FALSE(load_snapshot(file.path(), loaded_strings, serializer, 16));
+  EXPECT_TRUE(save_snapshot(strings, file.path(), serializer).has_value());
+  corrupt(file, 40 + 2);
+  EXPECT_FALSE(load_snapshot(file.path(), loaded_strings, serializer, 16));
+  EXPECT_TRUE(loaded_strings.pod().is_empty());
+
+  // missing files and directories
+  EXPECT_FALSE(load_snapshot("/nonexistent/file.snapshot", loaded));
+  EXPECT_FALSE(save_snapshot(source, "/nonexistent/dir/file.snapshot"));
+}
+
+TEST(snapshot, checksum) {
+  // CRC-32C check value, continued across calls, hardware and table paths
+  const std::string check{"123456789"};
+  const auto *const p_bytes = reinterpret_cast<const std::byte *>(check.data());
+  EXPECT_EQ(0xE3069283U, CppPlay::detail::crc32c(0, p_bytes, check.size()));
+  EXPECT_EQ(0xE3069283U,
+            CppPlay::detail::crc32c(CppPlay::detail::crc32c(0, p_bytes, 4),
+                                    &p_bytes[4], check.size() - 4));
+  EXPECT_EQ(0xE3069283U,
+            ~CppPlay::detail::crc32c_scalar(~0U, p_bytes, check.size()));
+  EXPECT_EQ(0U, CppPlay::detail::crc32c(0, p_bytes, 0));
+}
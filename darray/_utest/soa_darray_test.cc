@@ -0,0 +1,126 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#include "gtest.h"
+#include "soa_darray.hpp"
+
+#include <algorithm>
+#include <expected>
+#include <iterator>
+#include <numeric>
+#include <ranges>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using CppPlay::soa_darray;
+
+//=============================================================================
+// Helper Classes and Functions
+//=============================================================================
+using Particles = soa_darray<float, int, std::string>;
+static_assert(std::random_access_iterator<Particles::iterator>);
+static_assert(std::ranges::random_access_range<Particles>);
+
+//=============================================================================
+// Tests
+//=============================================================================
+TEST(soaDarray, columns) {
+  Particles particles = Particles::builder{}.capacity(2).build();
+  EXPECT_TRUE(particles.pod().is_empty());
+  EXPECT_TRUE(particles.column<0>().empty());
+
+  for (int value = 0; value < 10; value++) {
+    EXPECT_EQ((size_t)(value + 1),
+              particles
+                  .push_back(static_cast<float>(value) / 2, value,
+                             std::to_string(value))
+                  .value());
+  }
+  EXPECT_EQ((size_t)11,
+            particles.push_back(Particles::value_type{9.5f, 10, "10"}).value());
+  const Particles::value_type record{10.0f, 11, "11"};
+  EXPECT_EQ((size_t)12, particles.push_back(record).value());
+  EXPECT_EQ((size_t)16, particles.pod().capacity());
+
+  // one contiguous column per field
+  const std::span<int> ints = particles.column<1>();
+  EXPECT_EQ((size_t)12, ints.size());
+  EXPECT_EQ(66, std::accumulate(ints.begin(), ints.end(), 0));
+  const std::span<float> floats = particles.column<0>();
+  EXPECT_EQ(1.5f, floats[3]);
+  EXPECT_EQ(&floats[0] + 11, &floats[11]);
+  EXPECT_EQ("7", particles.column<2>()[7]);
+
+  // writes through a column are seen through records
+  ints[0] = 100;
+  EXPECT_EQ(100, std::get<1>(particles[0]));
+  std::get<2>(particles[1]) = "one";
+  EXPECT_EQ("one", particles.column<2>()[1]);
+}
+
+TEST(soaDarray, iteratorExtract) {
+  Particles particles{};
+  for (int value = 0; value < 5; value++) {
+    EXPECT_TRUE(particles
+                    .push_back(static_cast<float>(value), value * 10,
+                               std::to_string(value))
+                    .has_value());
+  }
+
+  // proxy references, records are tuples of references to the fields
+  int sum = 0;
+  for (auto [x, count, name] : particles) {
+    sum += count;
+    x += 1.0f;
+  }
+  EXPECT_EQ(100, sum);
+  EXPECT_EQ(1.0f, particles.column<0>()[0]);
+  auto found = std::ranges::find_if(
+      particles, [](const auto &record) { return "3" == std::get<2>(record); });
+  EXPECT_EQ(3, found - particles.begin());
+  EXPECT_EQ(30, std::get<1>(*found));
+  EXPECT_EQ(40, std::get<1>(particles.begin()[4]));
+  EXPECT_EQ("4", std::get<2>(*(particles.end() - 1)));
+  EXPECT_FALSE(particles.at(5).has_value());
+  EXPECT_EQ(20, std::get<1>(particles.at(2).value()));
+
+  // whole records extracted from every column
+  EXPECT_EQ((Particles::value_type{2.0f, 10, "1"}),
+            particles.extract(1).value());
+  EXPECT_EQ((Particles::value_type{5.0f, 40, "4"}), particles.pop_back().value());
+  EXPECT_EQ((size_t)3, particles.pod().size());
+  EXPECT_EQ("2", particles.column<2>()[1]);
+  EXPECT_EQ((size_t)3, particles.column<1>().size());
+  EXPECT_FALSE(particles.extract(3).has_value());
+
+  Particles copy{particles};
+  EXPECT_TRUE(particles.clear().has_value());
+  EXPECT_FALSE(particles.pop_back().has_value());
+  EXPECT_EQ((size_t)3, copy.pod().size());
+  EXPECT_EQ("3", copy.column<2>()[2]);
+}
@@ -0,0 +1,240 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#include "gtest.h"
+#include "live_string.hpp"
+#include "static_darray.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <expected>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+using CppPlay::static_darray;
+
+//=============================================================================
+// Helper Classes and Functions
+//=============================================================================
+
+// lookup table built in constant evaluation, primes below limit
+template <size_t CAPACITY>
+consteval auto primes_below(const unsigned int limit)
+    -> static_darray<unsigned int, CAPACITY> {
+  static_darray<unsigned int, CAPACITY> primes{};
+  for (unsigned int candidate = 2; candidate < limit; candidate++) {
+    if (std::none_of(primes.begin(), primes.end(), [&](unsigned int prime) {
+          return 0 == (candidate % prime);
+        })) {
+      if (!primes.push_back(candidate).has_value()) {
+        break;
+      }
+    }
+  }
+  return primes;
+}
+constexpr static_darray<unsigned int, 16> s_primes = primes_below<16>(50);
+static_assert(15 == s_primes.pod().size());
+static_assert(47 == s_primes[14]);
+
+// non-trivial literal type, store, shift and extract in constant evaluation
+struct Point {
+  int m_x;
+  int m_y;
+  constexpr Point(int x, int y) : m_x{x}, m_y{y} {}
+  constexpr Point(const Point &) = default;
+  constexpr Point(Point &&other) noexcept : m_x{other.m_x}, m_y{other.m_y} {
+    other.m_x = 0;
+    other.m_y = 0;
+  }
+  constexpr ~Point() {}
+  constexpr bool operator==(const Point &) const = default;
+};
+consteval auto shuffle_points() -> int {
+  static_darray<Point, 4> points{};
+  points.push_back(Point{1, 2});
+  points.push_back(Point{3, 4});
+  points.insert(Point{5, 6}, 0);
+  const Point extracted = points.extract(1).value();
+  static_darray<Point, 4> copy{points};
+  static_darray<Point, 4> moved{std::move(copy)};
+  return extracted.m_x * 100 + moved[0].m_x * 10 + moved[1].m_y;
+}
+static_assert(154 == shuffle_points());
+
+// overflow is an error, not growth, also in constant evaluation
+consteval auto overflow_is_error() -> bool {
+  static_darray<int, 2> values{};
+  return values.push_back(1).has_value() && values.push_back(2).has_value() &&
+         !values.push_back(3).has_value() && !values.insert(3, 0).has_value() &&
+         (2 == values.pod().size());
+}
+static_assert(overflow_is_error());
+
+// heap allocations counted while s_count_allocations is set, the global
+// allocation functions are replaced for the whole test binary
+namespace {
+bool s_count_allocations = false;
+size_t s_allocations = 0;
+} // namespace
+
+auto operator new(const size_t size) -> void * {
+  s_allocations += static_cast<size_t>(s_count_allocations);
+  [[likely]] if (void *const p_memory = std::malloc(0 == size ? 1 : size)) {
+    return p_memory;
+  }
+  throw std::bad_alloc{};
+}
+auto operator new[](const size_t size) -> void * {
+  return ::operator new(size);
+}
+auto operator new(const size_t size, const std::nothrow_t & /*tag*/) noexcept
+    -> void * {
+  try {
+    return ::operator new(size);
+  } catch (std::bad_alloc &) {
+    return nullptr;
+  }
+}
+auto operator new[](const size_t size, const std::nothrow_t &tag) noexcept
+    -> void * {
+  return ::operator new(size, tag);
+}
+auto operator delete(void *const p_memory) noexcept -> void {
+  std::free(p_memory);
+}
+auto operator delete[](void *const p_memory) noexcept -> void {
+  std::free(p_memory);
+}
+auto operator delete(void *const p_memory, const size_t /*size*/) noexcept
+    -> void {
+  std::free(p_memory);
+}
+auto operator delete[](void *const p_memory, const size_t /*size*/) noexcept
+    -> void {
+  std::free(p_memory);
+}
+auto operator delete(void *const p_memory,
+                     const std::nothrow_t & /*tag*/) noexcept -> void {
+  std::free(p_memory);
+}
+auto operator delete[](void *const p_memory,
+                       const std::nothrow_t & /*tag*/) noexcept -> void {
+  std::free(p_memory);
+}
+
+//=============================================================================
+// Tests
+//=============================================================================
+TEST(staticDarray, constantEvaluation) {
+  const std::vector<unsigned int> primes{s_primes.begin(), s_primes.end()};
+  EXPECT_EQ((std::vector<unsigned int>{2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31,
+                                       37, 41, 43, 47}),
+            primes);
+  EXPECT_EQ((size_t)16, s_primes.capacity().value());
+}
+
+TEST(staticDarray, storeExtract) {
+  static_darray<unsigned int, 4> values{};
+  EXPECT_TRUE(values.is_empty().value());
+  EXPECT_FALSE(values.pop_back().has_value());
+  EXPECT_EQ((size_t)1, values.push_back(1u).value());
+  EXPECT_EQ((size_t)2, values.push_back(3u).value());
+  EXPECT_EQ((size_t)3, values.insert(2u, 1).value());
+  EXPECT_EQ((size_t)4, values.insert(0u, 0).value());
+  EXPECT_FALSE(values.push_back(4u).has_value());
+  EXPECT_FALSE(values.insert(4u, 5).has_value());
+  EXPECT_EQ((size_t)4, values.size().value());
+  for (unsigned int idx = 0; idx < 4; idx++) {
+    EXPECT_EQ(idx, values[idx]);
+    EXPECT_EQ(idx, *(values.at(idx).value()));
+  }
+  EXPECT_FALSE(values.at(4).has_value());
+
+  EXPECT_EQ(1u, values.extract(1).value());
+  EXPECT_EQ(3u, values.pop_back().value());
+  EXPECT_FALSE(values.extract(2).has_value());
+  EXPECT_EQ(2u, values[1]);
+  EXPECT_TRUE(values.clear().has_value());
+  EXPECT_TRUE(values.pod().is_empty());
+}
+
+TEST(staticDarray, liveElements) {
+  LiveString::s_live_count = 0;
+  {
+    static_darray<LiveString, 3> strings{};
+    EXPECT_TRUE(strings.push_back(LiveString{"b"}).has_value());
+    EXPECT_TRUE(strings.insert(LiveString{"a"}, 0).has_value());
+    EXPECT_EQ(2, LiveString::s_live_count);
+    EXPECT_EQ(LiveString{"a"}, strings[0]);
+
+    static_darray<LiveString, 3> copy{strings};
+    EXPECT_EQ(4, LiveString::s_live_count);
+    static_darray<LiveString, 3> moved{std::move(copy)};
+    EXPECT_TRUE(copy.pod().is_empty());
+    EXPECT_EQ(4, LiveString::s_live_count);
+    copy = moved;
+    EXPECT_EQ(6, LiveString::s_live_count);
+    moved = std::move(strings);
+    EXPECT_EQ(4, LiveString::s_live_count);
+    EXPECT_EQ(LiveString{"b"}, moved[1]);
+
+    EXPECT_EQ(LiveString{"a"}, moved.extract(0).value());
+    EXPECT_EQ(3, LiveString::s_live_count);
+    EXPECT_EQ(LiveString{"b"}, moved[0]);
+  }
+  EXPECT_EQ(0, LiveString::s_live_count);
+}
+
+TEST(staticDarray, errorsDoNotAllocate) {
+  // overflow and underflow are reported from fixed storage, the messages are
+  // only copied when read
+  static_darray<unsigned int, 2> values{};
+  EXPECT_TRUE(values.push_back(1u).has_value());
+  EXPECT_TRUE(values.push_back(2u).has_value());
+  s_allocations = 0;
+  s_count_allocations = true;
+  const std::expected<size_t, CppPlay::error> overflow = values.push_back(3u);
+  const bool overflowed = !overflow.has_value() &&
+                          !values.insert(3u, 0).has_value() &&
+                          !values.insert(3u, 5).has_value() &&
+                          !values.at(2).has_value();
+  EXPECT_TRUE(values.clear().has_value());
+  const std::expected<unsigned int, CppPlay::error> underflow = values.pop_back();
+  const bool underflowed = !underflow.has_value() &&
+                           !values.extract(0).has_value();
+  s_count_allocations = false;
+  EXPECT_TRUE(overflowed);
+  EXPECT_TRUE(underflowed);
+  EXPECT_EQ((size_t)0, s_allocations);
+  EXPECT_EQ(std::string{"Cannot store, static capacity exceeded"},
+            overflow.error().message());
+  EXPECT_EQ(std::string{"No elements to pop"}, underflow.error().message());
+}
@@ -0,0 +1,113 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#include "gtest.h"
+#include "task_pool.hpp"
+
+#include <atomic>
+#include <expected>
+#include <stdexcept>
+#include <string>
+
+using CppPlay::task_pool;
+
+//=============================================================================
+// Helper Classes and Functions
+//=============================================================================
+// sum of [first, last) split in tasks down to single elements
+static auto fork_join_sum(task_pool &pool, const size_t first,
+                          const size_t last, std::atomic<size_t> &total)
+    -> void {
+  if ((last - first) == 1) {
+    total.fetch_add(first);
+    return;
+  }
+  const size_t middle = first + ((last - first) / 2);
+  task_pool::group group_obj;
+  EXPECT_TRUE(pool.submit(group_obj, [&pool, first, middle, &total]() {
+                    fork_join_sum(pool, first, middle, total);
+                  }).has_value());
+  fork_join_sum(pool, middle, last, total);
+  EXPECT_TRUE(pool.wait(group_obj).has_value());
+}
+
+//=============================================================================
+// Tests
+//=============================================================================
+TEST(taskPool, submitWait) {
+  task_pool pool{4};
+  EXPECT_EQ((size_t)4, pool.thread_count());
+
+  std::atomic<size_t> counter{0};
+  task_pool::group group_obj;
+  for (size_t idx = 0; idx < 1000; idx++) {
+    EXPECT_TRUE(
+        pool.submit(group_obj, [&counter]() { counter.fetch_add(1); })
+            .has_value());
+  }
+  EXPECT_TRUE(pool.wait(group_obj).has_value());
+  EXPECT_EQ((size_t)1000, counter.load());
+
+  // waiting on a completed or empty group returns at once
+  EXPECT_TRUE(pool.wait(group_obj).has_value());
+  task_pool::group empty_group;
+  EXPECT_TRUE(pool.wait(empty_group).has_value());
+}
+
+TEST(taskPool, nestedForkJoin) {
+  // nested waits run tasks instead of blocking, even with a single thread
+  for (const size_t threads : {size_t{1}, size_t{2}, size_t{8}}) {
+    task_pool pool{threads};
+    std::atomic<size_t> total{0};
+    fork_join_sum(pool, 0, 10000, total);
+    EXPECT_EQ((size_t)(10000 * 9999 / 2), total.load());
+  }
+}
+
+TEST(taskPool, exceptions) {
+  task_pool pool{3};
+  task_pool::group group_obj;
+  std::atomic<size_t> counter{0};
+  EXPECT_TRUE(pool.submit(group_obj, []() {
+                    throw std::runtime_error{"task failed"};
+                  }).has_value());
+  for (size_t idx = 0; idx < 100; idx++) {
+    EXPECT_TRUE(
+        pool.submit(group_obj, [&counter]() { counter.fetch_add(1); })
+            .has_value());
+  }
+  const std::expected<void, CppPlay::error> result = pool.wait(group_obj);
+  ASSERT_FALSE(result.has_value());
+  EXPECT_EQ(std::string{"task failed"}, result.error().message());
+  // other tasks of the group still run
+  EXPECT_EQ((size_t)100, counter.load());
+
+  // groups do not share errors
+  task_pool::group other_group;
+  EXPECT_TRUE(pool.submit(other_group, []() {}).has_value());
+  EXPECT_TRUE(pool.wait(other_group).has_value());
+}
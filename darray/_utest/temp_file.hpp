@@ -0,0 +1,52 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#pragma once
+
+
+#include <filesystem>
+#include <string>
+
+#include <unistd.h>
+
+// file in the temp directory, removed when the test ends
+// name is unique per test, the process id keeps concurrent runs apart
+class TempFile {
+  std::filesystem::path m_path;
+
+public:
+  explicit TempFile(const std::string &name)
+      : m_path{std::filesystem::temp_directory_path() /
+               (name + "." + std::to_string(getpid()) + ".tmp")} {
+    std::filesystem::remove(m_path);
+  }
+  ~TempFile() { std::filesystem::remove(m_path); }
+  TempFile(const TempFile &) = delete;
+  auto operator=(const TempFile &) -> TempFile & = delete;
+
+  [[nodiscard]] auto path() const -> std::string { return m_path.string(); }
+};
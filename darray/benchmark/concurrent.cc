@@ -0,0 +1,282 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#include <benchmark/benchmark.h>
+#include "append_only_darray.hpp"
+#include "darray.hpp"
+#include "parallel_sort.hpp"
+#include "radix_sort.hpp"
+#include "sharded_darray.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <random>
+
+//
+// multi-producer push_back, producers scale from 1 to 16 threads
+// every thread appends to one shared container, thread 0 creates it before
+// the (barrier synchronized) loop starts and destroys it after the loop ends
+//
+using DArrayMutex = CppPlay::darray<unsigned int,CppPlay::ThreadProtectionEnabled<unsigned int>>;
+using DArraySharded = CppPlay::sharded_darray<unsigned int>;
+
+static std::optional<DArrayMutex> s_darray_mutex{};
+static std::optional<DArraySharded> s_darray_sharded{};
+
+static void BM_darray_mutex_producers(benchmark::State& state) {
+  if ( 0 == state.thread_index() ) {
+    s_darray_mutex.emplace(DArrayMutex::builder{}.capacity(1024).build());
+  }
+  unsigned int value = 0;
+  for ( auto _ : state ) {
+    benchmark::DoNotOptimize(s_darray_mutex->push_back(value++));
+  }
+  state.SetItemsProcessed(state.iterations());
+  if ( 0 == state.thread_index() ) {
+    s_darray_mutex.reset();
+  }
+}
+BENCHMARK(BM_darray_mutex_producers)->ThreadRange(1, 16)->UseRealTime();
+
+static void BM_darray_sharded_producers(benchmark::State& state) {
+  if ( 0 == state.thread_index() ) {
+    s_darray_sharded.emplace(DArraySharded::builder{}.shards(16).capacity(1024).build());
+  }
+  unsigned int value = 0;
+  for ( auto _ : state ) {
+    benchmark::DoNotOptimize(s_darray_sharded->push_back(value++));
+  }
+  state.SetItemsProcessed(state.iterations());
+  if ( 0 == state.thread_index() ) {
+    s_darray_sharded.reset();
+  }
+}
+BENCHMARK(BM_darray_sharded_producers)->ThreadRange(1, 16)->UseRealTime();
+
+// produce then merge, the cost of flattening shards into one darray
+static void BM_darray_sharded_produce_drain(benchmark::State& state) {
+  const unsigned int count = static_cast<unsigned int>(state.range(0));
+  for ( auto _ : state ) {
+    DArraySharded sharded = DArraySharded::builder{}.shards(16).build();
+    for ( unsigned int idx=0 ; idx<count ; idx++ ) {
+      sharded.push_back(idx); // ignore return value
+    }
+    benchmark::DoNotOptimize(sharded.drain());
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_darray_sharded_produce_drain)->Arg(1<<16)->Arg(1<<20);
+
+
+//
+// lock-free append-only, producers scale from 1 to 16 threads
+//
+using DArrayAppendOnly = CppPlay::append_only_darray<unsigned int>;
+
+static std::unique_ptr<DArrayAppendOnly> s_darray_append_only{};
+
+static void BM_darray_append_only_producers(benchmark::State& state) {
+  if ( 0 == state.thread_index() ) {
+    s_darray_append_only = std::make_unique<DArrayAppendOnly>();
+  }
+  unsigned int value = 0;
+  for ( auto _ : state ) {
+    benchmark::DoNotOptimize(s_darray_append_only->push_back(value++));
+  }
+  state.SetItemsProcessed(state.iterations());
+  if ( 0 == state.thread_index() ) {
+    s_darray_append_only.reset();
+  }
+}
+BENCHMARK(BM_darray_append_only_producers)->ThreadRange(1, 16)->UseRealTime();
+
+//
+// one writer appending while the other threads read the newest element
+// items are reads (or writes for thread 0)
+//
+static void BM_darray_mutex_writer_readers(benchmark::State& state) {
+  if ( 0 == state.thread_index() ) {
+    s_darray_mutex.emplace(DArrayMutex::builder{}.capacity(1024).build());
+    s_darray_mutex->push_back(0u); // ignore return value
+  }
+  unsigned int value = 0;
+  for ( auto _ : state ) {
+    if ( 0 == state.thread_index() ) {
+      benchmark::DoNotOptimize(s_darray_mutex->push_back(value++));
+    } else {
+      // size then index, each locked separately, the darray only grows
+      benchmark::DoNotOptimize((*s_darray_mutex)[s_darray_mutex->pod().size() - 1]);
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+  if ( 0 == state.thread_index() ) {
+    s_darray_mutex.reset();
+  }
+}
+BENCHMARK(BM_darray_mutex_writer_readers)->ThreadRange(2, 16)->UseRealTime();
+
+static void BM_darray_append_only_writer_readers(benchmark::State& state) {
+  if ( 0 == state.thread_index() ) {
+    s_darray_append_only = std::make_unique<DArrayAppendOnly>();
+    s_darray_append_only->push_back(0u); // ignore return value
+  }
+  unsigned int value = 0;
+  for ( auto _ : state ) {
+    if ( 0 == state.thread_index() ) {
+      benchmark::DoNotOptimize(s_darray_append_only->push_back(value++));
+    } else {
+      benchmark::DoNotOptimize((*s_darray_append_only)[s_darray_append_only->size().value() - 1]);
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+  if ( 0 == state.thread_index() ) {
+    s_darray_append_only.reset();
+  }
+}
+BENCHMARK(BM_darray_append_only_writer_readers)->ThreadRange(2, 16)->UseRealTime();
+
+
+//
+// readers only, metadata and element reads scale from 1 to 16 threads
+//
+template <typename DArray>
+static std::optional<DArray> s_darray_readers{};
+
+template <template <typename> typename ThreadProtection>
+static void BM_darray_readers_size(benchmark::State& state) {
+  using DArray = CppPlay::darray<unsigned int,ThreadProtection<unsigned int>>;
+  if ( 0 == state.thread_index() ) {
+    s_darray_readers<DArray>.emplace(typename DArray::builder{}.capacity(1024).build());
+    for ( unsigned int idx=0 ; idx<1000 ; idx++ ) {
+      s_darray_readers<DArray>->push_back(idx); // ignore return value
+    }
+  }
+  for ( auto _ : state ) {
+    benchmark::DoNotOptimize(s_darray_readers<DArray>->pod().size());
+    benchmark::DoNotOptimize(s_darray_readers<DArray>->pod().capacity());
+  }
+  state.SetItemsProcessed(state.iterations() * 2);
+  if ( 0 == state.thread_index() ) {
+    s_darray_readers<DArray>.reset();
+  }
+}
+BENCHMARK_TEMPLATE(BM_darray_readers_size, CppPlay::ThreadProtectionEnabled)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_darray_readers_size, CppPlay::ThreadProtectionSharedRead)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_darray_readers_size, CppPlay::ThreadProtectionSharedReadSeqlock)->ThreadRange(1, 16)->UseRealTime();
+
+template <template <typename> typename ThreadProtection>
+static void BM_darray_readers_index(benchmark::State& state) {
+  using DArray = CppPlay::darray<unsigned int,ThreadProtection<unsigned int>>;
+  if ( 0 == state.thread_index() ) {
+    s_darray_readers<DArray>.emplace(typename DArray::builder{}.capacity(1024).build());
+    for ( unsigned int idx=0 ; idx<1000 ; idx++ ) {
+      s_darray_readers<DArray>->push_back(idx); // ignore return value
+    }
+  }
+  size_t idx = static_cast<size_t>(state.thread_index());
+  for ( auto _ : state ) {
+    benchmark::DoNotOptimize((*s_darray_readers<DArray>)[idx]);
+    idx = (idx + 7) % 1000;
+  }
+  state.SetItemsProcessed(state.iterations());
+  if ( 0 == state.thread_index() ) {
+    s_darray_readers<DArray>.reset();
+  }
+}
+BENCHMARK_TEMPLATE(BM_darray_readers_index, CppPlay::ThreadProtectionEnabled)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_darray_readers_index, CppPlay::ThreadProtectionSharedRead)->ThreadRange(1, 16)->UseRealTime();
+
+//
+// sort of random unsigned keys in a darray, 1M to 100M elements, std::sort
+// on one core against parallel_sort with a pool of 1 to 32 threads (the pool
+// is created outside the loop) and radix_sort, the copy of the unsorted
+// input is not timed
+//
+template <typename T>
+static auto random_darray(const size_t count) -> CppPlay::darray<T> {
+  CppPlay::darray<T> darray_obj = typename CppPlay::darray<T>::builder{}.capacity(count).build();
+  std::mt19937_64 generator{42};
+  for ( size_t idx=0 ; idx<count ; idx++ ) {
+    darray_obj.push_back(static_cast<T>(generator())); // ignore return value
+  }
+  return darray_obj;
+}
+
+template <typename T>
+static void BM_darray_std_sort(benchmark::State& state) {
+  const auto count = static_cast<size_t>(state.range(0));
+  const CppPlay::darray<T> unsorted = random_darray<T>(count);
+  CppPlay::darray<T> darray_obj = random_darray<T>(count);
+  for ( auto _ : state ) {
+    state.PauseTiming();
+    std::copy(unsorted.begin(), unsorted.end(), darray_obj.begin());
+    state.ResumeTiming();
+    std::sort(darray_obj.begin(), darray_obj.end());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_darray_std_sort, unsigned int)->Arg(1<<20)->Arg(10'000'000)->Arg(100'000'000)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_darray_std_sort, std::uint64_t)->Arg(1<<20)->Arg(10'000'000)->Arg(100'000'000)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+template <typename T>
+static void BM_darray_parallel_sort(benchmark::State& state) {
+  const auto count = static_cast<size_t>(state.range(0));
+  CppPlay::task_pool pool{static_cast<size_t>(state.range(1))};
+  const CppPlay::darray<T> unsorted = random_darray<T>(count);
+  CppPlay::darray<T> darray_obj = random_darray<T>(count);
+  for ( auto _ : state ) {
+    state.PauseTiming();
+    std::copy(unsorted.begin(), unsorted.end(), darray_obj.begin());
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(CppPlay::parallel_sort(pool, darray_obj.begin(), darray_obj.end()));
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_darray_parallel_sort, unsigned int)->ArgsProduct({{1<<20, 10'000'000, 100'000'000}, {1, 2, 4, 8, 16, 32}})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_darray_parallel_sort, std::uint64_t)->ArgsProduct({{1<<20, 10'000'000, 100'000'000}, {1, 2, 4, 8, 16, 32}})->Unit(benchmark::kMillisecond)->UseRealTime();
+
+template <typename T>
+static void BM_darray_radix_sort(benchmark::State& state) {
+  const auto count = static_cast<size_t>(state.range(0));
+  const CppPlay::darray<T> unsorted = random_darray<T>(count);
+  CppPlay::darray<T> darray_obj = random_darray<T>(count);
+  for ( auto _ : state ) {
+    state.PauseTiming();
+    std::copy(unsorted.begin(), unsorted.end(), darray_obj.begin());
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(CppPlay::radix_sort(darray_obj));
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_darray_radix_sort, unsigned int)->Arg(1<<20)->Arg(10'000'000)->Arg(100'000'000)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_darray_radix_sort, std::uint64_t)->Arg(1<<20)->Arg(10'000'000)->Arg(100'000'000)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_darray_radix_sort, float)->Arg(1<<20)->Arg(10'000'000)->Arg(100'000'000)->Unit(benchmark::kMillisecond)->UseRealTime();
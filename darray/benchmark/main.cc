@@ -26,10 +26,41 @@
  */
 
 #include <benchmark/benchmark.h>
+#include "arena_allocator.hpp"
+#include "cow_darray.hpp"
 #include "darray.hpp"
+#include "darray_io.hpp"
+#include "darray_heap.hpp"
+#include "flat_map.hpp"
+#include "hash_map.hpp"
+#include "incremental_darray.hpp"
+#include "mapped_darray.hpp"
+#include "remap_allocator.hpp"
+#include "set_algorithm.hpp"
+#include "simd_algorithm.hpp"
+#include "snapshot.hpp"
+#include "soa_darray.hpp"
+#include "small_darray.hpp"
+#include "static_darray.hpp"
 
+#include <memory_resource>
 #include <vector>
 #include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <algorithm>
+#include <numeric>
+#include <optional>
+#include <queue>
+#include <set>
+#include <span>
+#include <unordered_map>
+#include <random>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
 
 //
 // push_back
@@ -171,3 +202,1491 @@ static void BM_vec_insert_at_mid(benchmark::State& state) {
 }
 BENCHMARK(BM_vec_insert_at_mid);
 
+
+
+//
+// relocation, bulk (memcpy/memmove) vs element-wise transfer
+//
+// same layout as unsigned int, but opted out of relocation so transfers take
+// the element-wise path
+struct ElementwiseUInt {
+  unsigned int value;
+};
+template <> struct CppPlay::is_trivially_relocatable<ElementwiseUInt> : std::false_type {};
+
+template <typename T>
+static void BM_darray_growth(benchmark::State& state) {
+  const unsigned int count = static_cast<unsigned int>(state.range(0));
+  for ( auto _ : state ) {
+    CppPlay::darray<T> darray_obj = typename CppPlay::darray<T>::builder{}.capacity(8).build();
+    for ( unsigned int idx=0 ; idx<count ; idx++ ) {
+      darray_obj.push_back(T{idx}); // ignore return value
+    }
+    benchmark::DoNotOptimize(darray_obj.begin());
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK_TEMPLATE(BM_darray_growth, unsigned int)->Arg(1<<16)->Arg(1<<22);
+BENCHMARK_TEMPLATE(BM_darray_growth, ElementwiseUInt)->Arg(1<<16)->Arg(1<<22);
+
+template <typename T>
+static void BM_darray_insert_extract_mid_large(benchmark::State& state) {
+  const unsigned int count = static_cast<unsigned int>(state.range(0));
+  CppPlay::darray<T> darray_obj = typename CppPlay::darray<T>::builder{}.capacity(count*2).build();
+  for ( unsigned int idx=0 ; idx<count ; idx++ ) {
+    darray_obj.push_back(T{idx}); // ignore return value
+  }
+  for ( auto _ : state ) {
+    // shift right then left, size (and so capacity) stays put
+    darray_obj.insert(T{0},count/2); // ignore return value
+    benchmark::DoNotOptimize(darray_obj.extract(count/2));
+  }
+  state.SetBytesProcessed(state.iterations() * count * sizeof(T));
+}
+BENCHMARK_TEMPLATE(BM_darray_insert_extract_mid_large, unsigned int)->Arg(1<<16)->Arg(1<<22);
+BENCHMARK_TEMPLATE(BM_darray_insert_extract_mid_large, ElementwiseUInt)->Arg(1<<16)->Arg(1<<22);
+
+
+//
+// storage, spare capacity is raw memory so is never constructed
+//
+static void BM_darray_reserve_large(benchmark::State& state) {
+  const size_t capacity = static_cast<size_t>(state.range(0));
+  for ( auto _ : state ) {
+    CppPlay::darray<unsigned int> darray_obj = CppPlay::darray<unsigned int>::builder{}.capacity(capacity).build();
+    benchmark::DoNotOptimize(darray_obj.begin());
+  }
+}
+BENCHMARK(BM_darray_reserve_large)->Arg(1<<16)->Arg(1<<24);
+
+static void BM_vec_growth(benchmark::State& state) {
+  const unsigned int count = static_cast<unsigned int>(state.range(0));
+  for ( auto _ : state ) {
+    std::vector<unsigned int> vec{};
+    vec.reserve(8);
+    for ( unsigned int idx=0 ; idx<count ; idx++ ) {
+      vec.push_back(idx);
+    }
+    benchmark::DoNotOptimize(vec.data());
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_vec_growth)->Arg(1<<16)->Arg(1<<22);
+
+// 100M element growth, single pass
+BENCHMARK_TEMPLATE(BM_darray_growth, unsigned int)->Arg(100'000'000)->Iterations(1)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_vec_growth)->Arg(100'000'000)->Iterations(1)->Unit(benchmark::kMillisecond);
+
+
+//
+// allocator, per request cycle of many short lived darrays
+// construct, fill and destroy REQUEST_DARRAY_COUNT darrays per iteration
+//
+static constexpr unsigned int REQUEST_DARRAY_COUNT = 1000;
+
+template <typename DArray, typename Allocator>
+static void request_cycle(std::vector<DArray>& darrays, const Allocator& allocator, unsigned int fill) {
+  for ( unsigned int count=0 ; count<REQUEST_DARRAY_COUNT ; count++ ) {
+    darrays.push_back(typename DArray::builder{allocator}.build());
+    for ( unsigned int idx=0 ; idx<fill ; idx++ ) {
+      darrays.back().push_back(idx); // ignore return value
+    }
+  }
+  benchmark::DoNotOptimize(darrays.data());
+  darrays.clear();
+}
+
+static void BM_darray_request_cycle_heap(benchmark::State& state) {
+  using DArray = CppPlay::darray<unsigned int>;
+  std::vector<DArray> darrays{};
+  darrays.reserve(REQUEST_DARRAY_COUNT);
+  for ( auto _ : state ) {
+    request_cycle(darrays, std::allocator<unsigned int>{}, static_cast<unsigned int>(state.range(0)));
+  }
+  state.SetItemsProcessed(state.iterations() * REQUEST_DARRAY_COUNT);
+}
+BENCHMARK(BM_darray_request_cycle_heap)->Arg(4)->Arg(16)->Arg(256);
+
+static void BM_darray_request_cycle_arena(benchmark::State& state) {
+  using DArray = CppPlay::darray<unsigned int,CppPlay::ThreadProtectionDisabled<unsigned int>,CppPlay::GrowthPolicyDouble<unsigned int>,CppPlay::arena_allocator<unsigned int>>;
+  CppPlay::monotonic_arena arena{};
+  std::vector<DArray> darrays{};
+  darrays.reserve(REQUEST_DARRAY_COUNT);
+  for ( auto _ : state ) {
+    request_cycle(darrays, CppPlay::arena_allocator<unsigned int>{arena}, static_cast<unsigned int>(state.range(0)));
+    arena.reset(); // free the whole request in one go
+  }
+  state.SetItemsProcessed(state.iterations() * REQUEST_DARRAY_COUNT);
+}
+BENCHMARK(BM_darray_request_cycle_arena)->Arg(4)->Arg(16)->Arg(256);
+
+static void BM_darray_request_cycle_arena_pmr(benchmark::State& state) {
+  using DArray = CppPlay::darray<unsigned int,CppPlay::ThreadProtectionDisabled<unsigned int>,CppPlay::GrowthPolicyDouble<unsigned int>,std::pmr::polymorphic_allocator<unsigned int>>;
+  CppPlay::monotonic_arena arena{};
+  std::vector<DArray> darrays{};
+  darrays.reserve(REQUEST_DARRAY_COUNT);
+  for ( auto _ : state ) {
+    request_cycle(darrays, std::pmr::polymorphic_allocator<unsigned int>{&arena}, static_cast<unsigned int>(state.range(0)));
+    arena.reset(); // free the whole request in one go
+  }
+  state.SetItemsProcessed(state.iterations() * REQUEST_DARRAY_COUNT);
+}
+BENCHMARK(BM_darray_request_cycle_arena_pmr)->Arg(4)->Arg(16)->Arg(256);
+
+
+//
+// growth policy, push_back/pop_back oscillating across a capacity boundary
+// counts buffer allocations and peak buffer bytes through the allocator, peak
+// RSS of the whole process is reported as max_rss_kb
+//
+struct allocation_counters {
+  static inline size_t s_allocations = 0;
+  static inline size_t s_bytes = 0;
+  static inline size_t s_peak_bytes = 0;
+  static void reset() { s_allocations = 0; s_bytes = 0; s_peak_bytes = 0; }
+};
+
+template <typename T>
+struct counting_allocator {
+  using value_type = T;
+  counting_allocator() = default;
+  template <typename U> counting_allocator(const counting_allocator<U>&) noexcept {}
+  auto allocate(size_t count) -> T* {
+    allocation_counters::s_allocations++;
+    allocation_counters::s_bytes += count * sizeof(T);
+    allocation_counters::s_peak_bytes = std::max(allocation_counters::s_peak_bytes, allocation_counters::s_bytes);
+    return std::allocator<T>{}.allocate(count);
+  }
+  void deallocate(T* p_data, size_t count) noexcept {
+    allocation_counters::s_bytes -= count * sizeof(T);
+    std::allocator<T>{}.deallocate(p_data, count);
+  }
+  template <typename U> auto operator==(const counting_allocator<U>&) const noexcept -> bool { return true; }
+};
+
+static auto max_rss_kb() -> double {
+  struct rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  return static_cast<double>(usage.ru_maxrss);
+}
+
+template <template <typename> typename GrowthPolicy>
+static void BM_darray_growth_policy_oscillate(benchmark::State& state) {
+  using DArray = CppPlay::darray<unsigned int,CppPlay::ThreadProtectionDisabled<unsigned int>,GrowthPolicy<unsigned int>,counting_allocator<unsigned int>>;
+  const size_t fill = static_cast<size_t>(state.range(0));
+  DArray darray_obj = typename DArray::builder{}.capacity(8).build();
+  // fill then top up until full, so the next push_back has to grow
+  while ( (darray_obj.pod().size() < fill) || (darray_obj.pod().size() < darray_obj.pod().capacity()) ) {
+    darray_obj.push_back(0u); // ignore return value
+  }
+  allocation_counters::reset();
+  allocation_counters::s_bytes = darray_obj.pod().capacity() * sizeof(unsigned int);
+  for ( auto _ : state ) {
+    darray_obj.push_back(1u); // ignore return value
+    benchmark::DoNotOptimize(darray_obj.pop_back());
+  }
+  state.SetItemsProcessed(state.iterations() * 2);
+  state.counters["reallocs"] = benchmark::Counter(static_cast<double>(allocation_counters::s_allocations), benchmark::Counter::kAvgIterations);
+  state.counters["peak_bytes"] = static_cast<double>(allocation_counters::s_peak_bytes);
+  state.counters["max_rss_kb"] = max_rss_kb();
+}
+BENCHMARK_TEMPLATE(BM_darray_growth_policy_oscillate, CppPlay::GrowthPolicyDouble)->Arg(1<<10)->Arg(1<<20);
+BENCHMARK_TEMPLATE(BM_darray_growth_policy_oscillate, CppPlay::GrowthPolicyOneAndHalf)->Arg(1<<10)->Arg(1<<20);
+BENCHMARK_TEMPLATE(BM_darray_growth_policy_oscillate, CppPlay::GrowthPolicyHysteresis)->Arg(1<<10)->Arg(1<<20);
+template <typename T> using GrowthPolicyPageGranular4K = CppPlay::GrowthPolicyPageGranular<T>;
+BENCHMARK_TEMPLATE(BM_darray_growth_policy_oscillate, GrowthPolicyPageGranular4K)->Arg(1<<10)->Arg(1<<20);
+
+// fill to count then drain to empty, peak bytes and reallocations over a
+// whole cycle
+template <template <typename> typename GrowthPolicy>
+static void BM_darray_growth_policy_fill_drain(benchmark::State& state) {
+  using DArray = CppPlay::darray<unsigned int,CppPlay::ThreadProtectionDisabled<unsigned int>,GrowthPolicy<unsigned int>,counting_allocator<unsigned int>>;
+  const unsigned int count = static_cast<unsigned int>(state.range(0));
+  allocation_counters::reset();
+  for ( auto _ : state ) {
+    DArray darray_obj = typename DArray::builder{}.capacity(8).build();
+    for ( unsigned int idx=0 ; idx<count ; idx++ ) {
+      darray_obj.push_back(idx); // ignore return value
+    }
+    for ( unsigned int idx=0 ; idx<count ; idx++ ) {
+      benchmark::DoNotOptimize(darray_obj.pop_back());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * count * 2);
+  state.counters["reallocs"] = benchmark::Counter(static_cast<double>(allocation_counters::s_allocations), benchmark::Counter::kAvgIterations);
+  state.counters["peak_bytes"] = static_cast<double>(allocation_counters::s_peak_bytes);
+  state.counters["max_rss_kb"] = max_rss_kb();
+}
+BENCHMARK_TEMPLATE(BM_darray_growth_policy_fill_drain, CppPlay::GrowthPolicyDouble)->Arg(1<<20);
+BENCHMARK_TEMPLATE(BM_darray_growth_policy_fill_drain, CppPlay::GrowthPolicyOneAndHalf)->Arg(1<<20);
+BENCHMARK_TEMPLATE(BM_darray_growth_policy_fill_drain, CppPlay::GrowthPolicyHysteresis)->Arg(1<<20);
+BENCHMARK_TEMPLATE(BM_darray_growth_policy_fill_drain, GrowthPolicyPageGranular4K)->Arg(1<<20);
+
+
+//
+// in place growth, remap_allocator grows relocatable buffers with
+// realloc/mremap instead of allocate, copy, free
+// growth curve from 1M to 256M elements, peak RSS of each run via the kernel
+// high water mark (reset per run through /proc/self/clear_refs, linux only)
+//
+static void peak_rss_reset() {
+  std::ofstream clear_refs{"/proc/self/clear_refs"};
+  clear_refs << "5";
+}
+
+static auto peak_rss_kb() -> double {
+  std::ifstream status{"/proc/self/status"};
+  std::string line{};
+  while ( std::getline(status, line) ) {
+    if ( line.starts_with("VmHWM:") ) {
+      return std::stod(line.substr(6));
+    }
+  }
+  return max_rss_kb();
+}
+
+template <typename DArray>
+static void BM_darray_growth_curve(benchmark::State& state) {
+  const unsigned int count = static_cast<unsigned int>(state.range(0));
+  double peak_kb = 0;
+  for ( auto _ : state ) {
+    state.PauseTiming();
+    peak_rss_reset();
+    state.ResumeTiming();
+    DArray darray_obj = typename DArray::builder{}.capacity(8).build();
+    for ( unsigned int idx=0 ; idx<count ; idx++ ) {
+      darray_obj.push_back(idx); // ignore return value
+    }
+    benchmark::DoNotOptimize(darray_obj.begin());
+    state.PauseTiming();
+    peak_kb = std::max(peak_kb, peak_rss_kb());
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+  state.counters["peak_rss_kb"] = peak_kb;
+  state.counters["data_kb"] = static_cast<double>(count) * sizeof(unsigned int) / 1024;
+}
+using DArrayHeap = CppPlay::darray<unsigned int>;
+using DArrayRemap = CppPlay::darray<unsigned int,CppPlay::ThreadProtectionDisabled<unsigned int>,CppPlay::GrowthPolicyDouble<unsigned int>,CppPlay::remap_allocator<unsigned int>>;
+BENCHMARK_TEMPLATE(BM_darray_growth_curve, DArrayHeap)->RangeMultiplier(4)->Range(1<<20, 1<<28)->Iterations(1)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_darray_growth_curve, DArrayRemap)->RangeMultiplier(4)->Range(1<<20, 1<<28)->Iterations(1)->Unit(benchmark::kMillisecond);
+
+
+//
+// bulk load, one growth, one shift and one lock per range
+//
+static auto bulk_source(const size_t count) -> std::vector<unsigned int> {
+  std::vector<unsigned int> source(count);
+  for ( size_t idx=0 ; idx<count ; idx++ ) {
+    source[idx] = static_cast<unsigned int>(idx);
+  }
+  return source;
+}
+
+template <typename ThreadProtection>
+static void BM_darray_bulk_push_back(benchmark::State& state) {
+  using DArray = CppPlay::darray<unsigned int,ThreadProtection>;
+  const std::vector<unsigned int> source = bulk_source(static_cast<size_t>(state.range(0)));
+  for ( auto _ : state ) {
+    DArray darray_obj = typename DArray::builder{}.capacity(8).build();
+    for ( const unsigned int value : source ) {
+      darray_obj.push_back(value); // ignore return value
+    }
+    benchmark::DoNotOptimize(darray_obj.begin());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_darray_bulk_push_back, CppPlay::ThreadProtectionDisabled<unsigned int>)->Arg(1'000'000)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_darray_bulk_push_back, CppPlay::ThreadProtectionEnabled<unsigned int>)->Arg(1'000'000)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+
+template <typename ThreadProtection>
+static void BM_darray_bulk_append_range(benchmark::State& state) {
+  using DArray = CppPlay::darray<unsigned int,ThreadProtection>;
+  const std::vector<unsigned int> source = bulk_source(static_cast<size_t>(state.range(0)));
+  for ( auto _ : state ) {
+    DArray darray_obj = typename DArray::builder{}.capacity(8).build();
+    benchmark::DoNotOptimize(darray_obj.append_range(source));
+    benchmark::DoNotOptimize(darray_obj.begin());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_darray_bulk_append_range, CppPlay::ThreadProtectionDisabled<unsigned int>)->Arg(1'000'000)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_darray_bulk_append_range, CppPlay::ThreadProtectionEnabled<unsigned int>)->Arg(1'000'000)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+
+static void BM_vec_bulk_insert(benchmark::State& state) {
+  const std::vector<unsigned int> source = bulk_source(static_cast<size_t>(state.range(0)));
+  for ( auto _ : state ) {
+    std::vector<unsigned int> vec{};
+    vec.reserve(8);
+    vec.insert(vec.end(), source.begin(), source.end());
+    benchmark::DoNotOptimize(vec.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_vec_bulk_insert)->Arg(1'000'000)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+
+// insert a range of 1000 into the middle of range(0) elements
+static void BM_darray_bulk_insert_range_mid(benchmark::State& state) {
+  const size_t count = static_cast<size_t>(state.range(0));
+  const std::vector<unsigned int> source = bulk_source(count);
+  const std::vector<unsigned int> middle = bulk_source(1000);
+  for ( auto _ : state ) {
+    state.PauseTiming();
+    CppPlay::darray<unsigned int> darray_obj = CppPlay::darray<unsigned int>::builder{}.capacity(8).build();
+    darray_obj.append_range(source); // ignore return value
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(darray_obj.insert_range(count/2, middle));
+  }
+  state.SetItemsProcessed(state.iterations() * 1000);
+}
+BENCHMARK(BM_darray_bulk_insert_range_mid)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+
+static void BM_vec_bulk_insert_mid(benchmark::State& state) {
+  const size_t count = static_cast<size_t>(state.range(0));
+  const std::vector<unsigned int> source = bulk_source(count);
+  const std::vector<unsigned int> middle = bulk_source(1000);
+  for ( auto _ : state ) {
+    state.PauseTiming();
+    // spare capacity, as the darray has, so neither reallocates
+    std::vector<unsigned int> vec{};
+    vec.reserve(count * 2);
+    vec.insert(vec.end(), source.begin(), source.end());
+    state.ResumeTiming();
+    vec.insert(vec.begin() + static_cast<std::ptrdiff_t>(count/2), middle.begin(), middle.end());
+    benchmark::DoNotOptimize(vec.data());
+  }
+  state.SetItemsProcessed(state.iterations() * 1000);
+}
+BENCHMARK(BM_vec_bulk_insert_mid)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+
+//
+// purge, drop every third element, compacting in one pass vs one extract per
+// element
+//
+static auto purge_predicate(const unsigned int value) -> bool { return 0 == (value % 3); }
+
+static void BM_darray_purge_erase_if(benchmark::State& state) {
+  const std::vector<unsigned int> source = bulk_source(static_cast<size_t>(state.range(0)));
+  for ( auto _ : state ) {
+    state.PauseTiming();
+    CppPlay::darray<unsigned int> darray_obj = CppPlay::darray<unsigned int>::builder{}.capacity(8).build();
+    darray_obj.append_range(source); // ignore return value
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(darray_obj.erase_if(purge_predicate));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_darray_purge_erase_if)->Arg(1'000'000)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+
+static void BM_vec_purge_erase_if(benchmark::State& state) {
+  const std::vector<unsigned int> source = bulk_source(static_cast<size_t>(state.range(0)));
+  for ( auto _ : state ) {
+    state.PauseTiming();
+    std::vector<unsigned int> vec{source};
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(std::erase_if(vec, purge_predicate));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_vec_purge_erase_if)->Arg(1'000'000)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+
+// quadratic, kept small
+static void BM_darray_purge_extract(benchmark::State& state) {
+  const std::vector<unsigned int> source = bulk_source(static_cast<size_t>(state.range(0)));
+  for ( auto _ : state ) {
+    state.PauseTiming();
+    CppPlay::darray<unsigned int> darray_obj = CppPlay::darray<unsigned int>::builder{}.capacity(8).build();
+    darray_obj.append_range(source); // ignore return value
+    state.ResumeTiming();
+    for ( size_t idx=darray_obj.pod().size() ; idx-- > 0 ; ) {
+      if ( purge_predicate(darray_obj[idx]) ) {
+        benchmark::DoNotOptimize(darray_obj.extract(idx));
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_darray_purge_extract)->Arg(100'000)->Unit(benchmark::kMillisecond);
+
+// order insensitive, each removal is O(1)
+static void BM_darray_purge_swap_remove(benchmark::State& state) {
+  const std::vector<unsigned int> source = bulk_source(static_cast<size_t>(state.range(0)));
+  for ( auto _ : state ) {
+    state.PauseTiming();
+    CppPlay::darray<unsigned int> darray_obj = CppPlay::darray<unsigned int>::builder{}.capacity(8).build();
+    darray_obj.append_range(source); // ignore return value
+    state.ResumeTiming();
+    for ( size_t idx=darray_obj.pod().size() ; idx-- > 0 ; ) {
+      if ( purge_predicate(darray_obj[idx]) ) {
+        benchmark::DoNotOptimize(darray_obj.swap_remove(idx));
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_darray_purge_swap_remove)->Arg(100'000)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+
+//
+// tiny arrays, create, fill with range(0) elements and destroy
+//
+static void BM_small_darray_tiny(benchmark::State& state) {
+  const unsigned int count = static_cast<unsigned int>(state.range(0));
+  for ( auto _ : state ) {
+    CppPlay::small_darray<unsigned int,16> small_obj{};
+    for ( unsigned int value=0 ; value<count ; value++ ) {
+      small_obj.push_back(value); // ignore return value
+    }
+    benchmark::DoNotOptimize(small_obj.begin());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_small_darray_tiny)->Arg(4)->Arg(12)->Arg(16)->Arg(32);
+
+static void BM_darray_tiny(benchmark::State& state) {
+  const unsigned int count = static_cast<unsigned int>(state.range(0));
+  for ( auto _ : state ) {
+    CppPlay::darray<unsigned int> darray_obj{};
+    for ( unsigned int value=0 ; value<count ; value++ ) {
+      darray_obj.push_back(value); // ignore return value
+    }
+    benchmark::DoNotOptimize(darray_obj.begin());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_darray_tiny)->Arg(4)->Arg(12)->Arg(16)->Arg(32);
+
+static void BM_vec_tiny(benchmark::State& state) {
+  const unsigned int count = static_cast<unsigned int>(state.range(0));
+  for ( auto _ : state ) {
+    std::vector<unsigned int> vec{};
+    for ( unsigned int value=0 ; value<count ; value++ ) {
+      vec.push_back(value);
+    }
+    benchmark::DoNotOptimize(vec.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_vec_tiny)->Arg(4)->Arg(12)->Arg(16)->Arg(32);
+
+//
+// push/pop loop, fixed capacity never allocates, heap darray grows and
+// shrinks on the way
+//
+template <size_t COUNT>
+static void BM_static_darray_push_pop(benchmark::State& state) {
+  CppPlay::static_darray<unsigned int,COUNT> static_obj{};
+  for ( auto _ : state ) {
+    for ( unsigned int value=0 ; value<COUNT ; value++ ) {
+      static_obj.push_back(value); // ignore return value
+    }
+    for ( size_t idx=0 ; idx<COUNT ; idx++ ) {
+      benchmark::DoNotOptimize(static_obj.pop_back());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK_TEMPLATE(BM_static_darray_push_pop, 64);
+BENCHMARK_TEMPLATE(BM_static_darray_push_pop, 1024);
+
+template <size_t COUNT>
+static void BM_darray_push_pop(benchmark::State& state) {
+  CppPlay::darray<unsigned int> darray_obj{};
+  for ( auto _ : state ) {
+    for ( unsigned int value=0 ; value<COUNT ; value++ ) {
+      darray_obj.push_back(value); // ignore return value
+    }
+    for ( size_t idx=0 ; idx<COUNT ; idx++ ) {
+      benchmark::DoNotOptimize(darray_obj.pop_back());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK_TEMPLATE(BM_darray_push_pop, 64);
+BENCHMARK_TEMPLATE(BM_darray_push_pop, 1024);
+
+//
+// single field scan, array of structs pulls whole 32 byte records through the
+// cache, structure of arrays only the scanned column
+//
+struct Particle {
+  float m_x, m_y, m_z;
+  float m_vx, m_vy, m_vz;
+  float m_mass;
+  unsigned int m_id;
+};
+using ParticleColumns = CppPlay::soa_darray<float,float,float,float,float,float,float,unsigned int>;
+
+static void BM_darray_aos_scan(benchmark::State& state) {
+  const size_t count = static_cast<size_t>(state.range(0));
+  CppPlay::darray<Particle> particles = CppPlay::darray<Particle>::builder{}.capacity(count).build();
+  for ( size_t idx=0 ; idx<count ; idx++ ) {
+    const float value = static_cast<float>(idx);
+    particles.push_back(Particle{value,value,value,value,value,value,1.0f,static_cast<unsigned int>(idx)}); // ignore return value
+  }
+  for ( auto _ : state ) {
+    float sum = 0.0f;
+    for ( const Particle& particle : particles ) {
+      sum += particle.m_mass;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_darray_aos_scan)->Arg(1'000'000)->Arg(10'000'000);
+
+static void BM_soa_darray_scan(benchmark::State& state) {
+  const size_t count = static_cast<size_t>(state.range(0));
+  ParticleColumns particles = ParticleColumns::builder{}.capacity(count).build();
+  for ( size_t idx=0 ; idx<count ; idx++ ) {
+    const float value = static_cast<float>(idx);
+    particles.push_back(value,value,value,value,value,value,1.0f,static_cast<unsigned int>(idx)); // ignore return value
+  }
+  for ( auto _ : state ) {
+    float sum = 0.0f;
+    for ( const float mass : particles.column<6>() ) {
+      sum += mass;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_soa_darray_scan)->Arg(1'000'000)->Arg(10'000'000);
+
+//
+// scan kernels, vectorized at each instruction set level (arg 1: 0 scalar,
+// 1 SSE2, 2 AVX2, 3 AVX-512) vs std::ranges algorithms on darray::iterator
+// needle and extremes are placed last so every kernel reads the whole range
+//
+template <typename T>
+static auto scan_darray(const size_t count) -> CppPlay::darray<T> {
+  CppPlay::darray<T> darray_obj = typename CppPlay::darray<T>::builder{}.capacity(count).build();
+  for ( size_t idx=0 ; idx<count ; idx++ ) {
+    darray_obj.push_back(static_cast<T>(idx % 100)); // ignore return value
+  }
+  darray_obj[count-1] = static_cast<T>(1000);
+  return darray_obj;
+}
+
+static auto scan_level(benchmark::State& state) -> std::optional<CppPlay::simd::level> {
+  const auto requested = static_cast<CppPlay::simd::level>(state.range(1));
+  if ( requested > CppPlay::simd::supported_level() ) {
+    state.SkipWithError("instruction set not supported");
+    return std::nullopt;
+  }
+  return requested;
+}
+
+template <typename T>
+static void BM_simd_find(benchmark::State& state) {
+  const CppPlay::darray<T> darray_obj = scan_darray<T>(static_cast<size_t>(state.range(0)));
+  const auto requested = scan_level(state);
+  if ( !requested ) { return; }
+  for ( auto _ : state ) {
+    benchmark::DoNotOptimize(CppPlay::simd::find(darray_obj, static_cast<T>(1000), *requested));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<int64_t>(sizeof(T)));
+}
+BENCHMARK_TEMPLATE(BM_simd_find, unsigned int)->ArgsProduct({{1<<20, 1<<24}, {0, 1, 2, 3}});
+BENCHMARK_TEMPLATE(BM_simd_find, float)->ArgsProduct({{1<<20, 1<<24}, {0, 1, 2, 3}});
+
+template <typename T>
+static void BM_ranges_find(benchmark::State& state) {
+  const CppPlay::darray<T> darray_obj = scan_darray<T>(static_cast<size_t>(state.range(0)));
+  for ( auto _ : state ) {
+    benchmark::DoNotOptimize(std::ranges::find(darray_obj, static_cast<T>(1000)));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<int64_t>(sizeof(T)));
+}
+BENCHMARK_TEMPLATE(BM_ranges_find, unsigned int)->Arg(1<<20)->Arg(1<<24);
+BENCHMARK_TEMPLATE(BM_ranges_find, float)->Arg(1<<20)->Arg(1<<24);
+
+template <typename T>
+static void BM_simd_count(benchmark::State& state) {
+  const CppPlay::darray<T> darray_obj = scan_darray<T>(static_cast<size_t>(state.range(0)));
+  const auto requested = scan_level(state);
+  if ( !requested ) { return; }
+  for ( auto _ : state ) {
+    benchmark::DoNotOptimize(CppPlay::simd::count(darray_obj, static_cast<T>(7), *requested));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<int64_t>(sizeof(T)));
+}
+BENCHMARK_TEMPLATE(BM_simd_count, unsigned int)->ArgsProduct({{1<<20, 1<<24}, {0, 1, 2, 3}});
+
+template <typename T>
+static void BM_ranges_count(benchmark::State& state) {
+  const CppPlay::darray<T> darray_obj = scan_darray<T>(static_cast<size_t>(state.range(0)));
+  for ( auto _ : state ) {
+    benchmark::DoNotOptimize(std::ranges::count(darray_obj, static_cast<T>(7)));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<int64_t>(sizeof(T)));
+}
+BENCHMARK_TEMPLATE(BM_ranges_count, unsigned int)->Arg(1<<20)->Arg(1<<24);
+
+template <typename T>
+static void BM_simd_max_element(benchmark::State& state) {
+  const CppPlay::darray<T> darray_obj = scan_darray<T>(static_cast<size_t>(state.range(0)));
+  const auto requested = scan_level(state);
+  if ( !requested ) { return; }
+  for ( auto _ : state ) {
+    benchmark::DoNotOptimize(CppPlay::simd::max_element(darray_obj, *requested));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<int64_t>(sizeof(T)));
+}
+BENCHMARK_TEMPLATE(BM_simd_max_element, unsigned int)->ArgsProduct({{1<<20, 1<<24}, {0, 1, 2, 3}});
+BENCHMARK_TEMPLATE(BM_simd_max_element, float)->ArgsProduct({{1<<20, 1<<24}, {0, 1, 2, 3}});
+
+template <typename T>
+static void BM_ranges_max_element(benchmark::State& state) {
+  const CppPlay::darray<T> darray_obj = scan_darray<T>(static_cast<size_t>(state.range(0)));
+  for ( auto _ : state ) {
+    benchmark::DoNotOptimize(std::ranges::max_element(darray_obj));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<int64_t>(sizeof(T)));
+}
+BENCHMARK_TEMPLATE(BM_ranges_max_element, unsigned int)->Arg(1<<20)->Arg(1<<24);
+BENCHMARK_TEMPLATE(BM_ranges_max_element, float)->Arg(1<<20)->Arg(1<<24);
+
+template <typename T>
+static void BM_simd_sum(benchmark::State& state) {
+  const CppPlay::darray<T> darray_obj = scan_darray<T>(static_cast<size_t>(state.range(0)));
+  const auto requested = scan_level(state);
+  if ( !requested ) { return; }
+  for ( auto _ : state ) {
+    benchmark::DoNotOptimize(CppPlay::simd::sum(darray_obj, *requested));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<int64_t>(sizeof(T)));
+}
+BENCHMARK_TEMPLATE(BM_simd_sum, unsigned int)->ArgsProduct({{1<<20, 1<<24}, {0, 1, 2, 3}});
+BENCHMARK_TEMPLATE(BM_simd_sum, float)->ArgsProduct({{1<<20, 1<<24}, {0, 1, 2, 3}});
+
+template <typename T>
+static void BM_ranges_sum(benchmark::State& state) {
+  const CppPlay::darray<T> darray_obj = scan_darray<T>(static_cast<size_t>(state.range(0)));
+  for ( auto _ : state ) {
+    benchmark::DoNotOptimize(std::accumulate(darray_obj.begin(), darray_obj.end(), CppPlay::simd::sum_type<T>{}));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<int64_t>(sizeof(T)));
+}
+BENCHMARK_TEMPLATE(BM_ranges_sum, unsigned int)->Arg(1<<20)->Arg(1<<24);
+BENCHMARK_TEMPLATE(BM_ranges_sum, float)->Arg(1<<20)->Arg(1<<24);
+
+template <typename T>
+static void BM_simd_dot(benchmark::State& state) {
+  const CppPlay::darray<T> left = scan_darray<T>(static_cast<size_t>(state.range(0)));
+  const CppPlay::darray<T> right = scan_darray<T>(static_cast<size_t>(state.range(0)));
+  const auto requested = scan_level(state);
+  if ( !requested ) { return; }
+  for ( auto _ : state ) {
+    benchmark::DoNotOptimize(CppPlay::simd::dot(left, right, *requested));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * 2 * static_cast<int64_t>(sizeof(T)));
+}
+BENCHMARK_TEMPLATE(BM_simd_dot, float)->ArgsProduct({{1<<20, 1<<24}, {0, 1, 2, 3}});
+
+template <typename T>
+static void BM_ranges_dot(benchmark::State& state) {
+  const CppPlay::darray<T> left = scan_darray<T>(static_cast<size_t>(state.range(0)));
+  const CppPlay::darray<T> right = scan_darray<T>(static_cast<size_t>(state.range(0)));
+  for ( auto _ : state ) {
+    benchmark::DoNotOptimize(std::inner_product(left.begin(), left.end(), right.begin(), T{}));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * 2 * static_cast<int64_t>(sizeof(T)));
+}
+BENCHMARK_TEMPLATE(BM_ranges_dot, float)->Arg(1<<20)->Arg(1<<24);
+
+//
+// priority queue of random keys, d-ary darray_heap (D = 2, 4, 8) against
+// std::priority_queue (binary heap over std::vector)
+// - fill then drain: n pushes then n pops
+// - hold: a heap of n keys, each iteration one push then one pop (push_pop)
+// wider heaps have fewer levels, 4 and 8-ary heaps pop faster than a binary
+// heap once it outgrows the cache and its deep levels miss it
+//
+static auto heap_keys(const size_t count) -> std::vector<unsigned int> {
+  std::vector<unsigned int> keys(count);
+  std::mt19937 generator{42};
+  for ( unsigned int &key : keys ) {
+    key = static_cast<unsigned int>(generator());
+  }
+  return keys;
+}
+
+template <size_t D>
+static void BM_darray_heap_fill_drain(benchmark::State& state) {
+  const std::vector<unsigned int> keys = heap_keys(static_cast<size_t>(state.range(0)));
+  for ( auto _ : state ) {
+    CppPlay::darray_heap<unsigned int, std::less<unsigned int>, D> heap_obj{};
+    for ( const unsigned int key : keys ) {
+      heap_obj.push(key); // ignore return value
+    }
+    for ( size_t idx=0 ; idx<keys.size() ; idx++ ) {
+      benchmark::DoNotOptimize(heap_obj.pop());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_darray_heap_fill_drain, 2)->Arg(1<<16)->Arg(1<<20)->Arg(1<<23)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_darray_heap_fill_drain, 4)->Arg(1<<16)->Arg(1<<20)->Arg(1<<23)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_darray_heap_fill_drain, 8)->Arg(1<<16)->Arg(1<<20)->Arg(1<<23)->Unit(benchmark::kMillisecond);
+
+static void BM_priority_queue_fill_drain(benchmark::State& state) {
+  const std::vector<unsigned int> keys = heap_keys(static_cast<size_t>(state.range(0)));
+  for ( auto _ : state ) {
+    std::priority_queue<unsigned int> queue_obj{};
+    for ( const unsigned int key : keys ) {
+      queue_obj.push(key);
+    }
+    for ( size_t idx=0 ; idx<keys.size() ; idx++ ) {
+      benchmark::DoNotOptimize(queue_obj.top());
+      queue_obj.pop();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_priority_queue_fill_drain)->Arg(1<<16)->Arg(1<<20)->Arg(1<<23)->Unit(benchmark::kMillisecond);
+
+template <size_t D>
+static void BM_darray_heap_hold(benchmark::State& state) {
+  const std::vector<unsigned int> keys = heap_keys(static_cast<size_t>(state.range(0)));
+  CppPlay::darray_heap<unsigned int, std::greater<unsigned int>, D> heap_obj{};
+  heap_obj.heapify(keys); // ignore return value
+  size_t idx = 0;
+  for ( auto _ : state ) {
+    // the smallest key comes back larger by a random step, sinking to a
+    // random depth
+    const unsigned int key = heap_obj.top().value().get();
+    benchmark::DoNotOptimize(heap_obj.push_pop(key + (keys[idx++ % keys.size()] >> 12)));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_darray_heap_hold, 2)->Arg(1<<10)->Arg(1<<20)->Arg(1<<23);
+BENCHMARK_TEMPLATE(BM_darray_heap_hold, 4)->Arg(1<<10)->Arg(1<<20)->Arg(1<<23);
+BENCHMARK_TEMPLATE(BM_darray_heap_hold, 8)->Arg(1<<10)->Arg(1<<20)->Arg(1<<23);
+
+static void BM_priority_queue_hold(benchmark::State& state) {
+  const std::vector<unsigned int> keys = heap_keys(static_cast<size_t>(state.range(0)));
+  std::priority_queue<unsigned int, std::vector<unsigned int>, std::greater<unsigned int>> queue_obj{std::greater<unsigned int>{}, keys};
+  size_t idx = 0;
+  for ( auto _ : state ) {
+    const unsigned int key = queue_obj.top();
+    queue_obj.pop();
+    queue_obj.push(key + (keys[idx++ % keys.size()] >> 12));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_priority_queue_hold)->Arg(1<<10)->Arg(1<<20)->Arg(1<<23);
+
+//
+// membership lookups of random keys (half of them present) in a table of n
+// odd keys, 1K to 100M: std::set, std::lower_bound over a sorted
+// std::vector, flat_set sorted and flat_set frozen (Eytzinger layout)
+// std::set stops at 16M keys, its nodes outgrow memory beyond
+//
+static auto lookup_queries(const size_t count) -> std::vector<unsigned int> {
+  std::vector<unsigned int> queries(4096);
+  std::mt19937 generator{42};
+  std::uniform_int_distribution<unsigned int> distribution{0, static_cast<unsigned int>(2 * count)};
+  for ( unsigned int &query : queries ) {
+    query = distribution(generator);
+  }
+  return queries;
+}
+
+static auto odd_keys(const size_t count) -> std::vector<unsigned int> {
+  std::vector<unsigned int> keys(count);
+  for ( size_t idx=0 ; idx<count ; idx++ ) {
+    keys[idx] = static_cast<unsigned int>((2 * idx) + 1);
+  }
+  return keys;
+}
+
+static void BM_std_set_contains(benchmark::State& state) {
+  const auto count = static_cast<size_t>(state.range(0));
+  const std::vector<unsigned int> keys = odd_keys(count);
+  const std::set<unsigned int> set_obj(keys.begin(), keys.end());
+  const std::vector<unsigned int> queries = lookup_queries(count);
+  size_t idx = 0;
+  for ( auto _ : state ) {
+    benchmark::DoNotOptimize(set_obj.contains(queries[idx++ % queries.size()]));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_std_set_contains)->Arg(1<<10)->Arg(1<<16)->Arg(1<<20)->Arg(1<<24);
+
+static void BM_std_lower_bound_contains(benchmark::State& state) {
+  const auto count = static_cast<size_t>(state.range(0));
+  const std::vector<unsigned int> keys = odd_keys(count);
+  const std::vector<unsigned int> queries = lookup_queries(count);
+  size_t idx = 0;
+  for ( auto _ : state ) {
+    const unsigned int query = queries[idx++ % queries.size()];
+    const auto found = std::lower_bound(keys.begin(), keys.end(), query);
+    benchmark::DoNotOptimize((found != keys.end()) && (*found == query));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_std_lower_bound_contains)->Arg(1<<10)->Arg(1<<16)->Arg(1<<20)->Arg(1<<24)->Arg(100'000'000);
+
+static void BM_flat_set_contains(benchmark::State& state) {
+  const auto count = static_cast<size_t>(state.range(0));
+  CppPlay::flat_set<unsigned int> set_obj{};
+  set_obj.assign(odd_keys(count)); // ignore return value
+  if ( 0 != state.range(1) ) {
+    set_obj.freeze(); // ignore return value
+  }
+  const std::vector<unsigned int> queries = lookup_queries(count);
+  size_t idx = 0;
+  for ( auto _ : state ) {
+    benchmark::DoNotOptimize(set_obj.contains(queries[idx++ % queries.size()]));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_flat_set_contains)->ArgsProduct({{1<<10, 1<<16, 1<<20, 1<<24, 100'000'000}, {0, 1}});
+
+//
+// set algebra of sorted posting lists of unsigned keys: a list of 1M keys
+// and one 1 to 10000 times shorter, drawn from 4M keys
+// - std algorithms append to a reserved std::vector, darray ones to a darray
+//   built with room for the result
+// - intersection in scalar and at the widest vector level the cpu supports
+// - k-way merge of 4 to 64 lists of 1M keys in total against sorting them
+//
+static auto posting_list(const size_t count, const unsigned int seed) -> std::vector<unsigned int> {
+  std::mt19937 generator{seed};
+  std::uniform_int_distribution<unsigned int> distribution{0, (1u<<22) - 1};
+  std::vector<unsigned int> keys{};
+  while ( keys.size() < count ) {
+    for ( size_t idx=keys.size() ; idx<count ; idx++ ) {
+      keys.push_back(distribution(generator));
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  }
+  return keys;
+}
+
+static constexpr size_t s_posting_count = 1<<20;
+
+static void BM_std_set_intersection(benchmark::State& state) {
+  const std::vector<unsigned int> longer = posting_list(s_posting_count, 1);
+  const std::vector<unsigned int> shorter = posting_list(s_posting_count / static_cast<size_t>(state.range(0)), 2);
+  std::vector<unsigned int> out{};
+  out.reserve(shorter.size());
+  for ( auto _ : state ) {
+    out.clear();
+    std::set_intersection(shorter.begin(), shorter.end(), longer.begin(), longer.end(), std::back_inserter(out));
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(longer.size() + shorter.size()));
+}
+BENCHMARK(BM_std_set_intersection)->Arg(1)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000);
+
+static void BM_darray_set_intersection(benchmark::State& state) {
+  const std::vector<unsigned int> longer = posting_list(s_posting_count, 1);
+  const std::vector<unsigned int> shorter = posting_list(s_posting_count / static_cast<size_t>(state.range(0)), 2);
+  const CppPlay::simd::level level = (0 != state.range(1)) ? CppPlay::simd::supported_level() : CppPlay::simd::level::SCALAR;
+  CppPlay::darray<unsigned int> out = CppPlay::darray<unsigned int>::builder{}.capacity(shorter.size()).build();
+  for ( auto _ : state ) {
+    out.clear(); // ignore return value
+    CppPlay::set_intersection(shorter, longer, out, std::less<unsigned int>{}, level); // ignore return value
+    benchmark::DoNotOptimize(out.begin());
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(longer.size() + shorter.size()));
+}
+BENCHMARK(BM_darray_set_intersection)->ArgsProduct({{1, 10, 100, 1000, 10000}, {0, 1}});
+
+static void BM_std_set_union(benchmark::State& state) {
+  const std::vector<unsigned int> longer = posting_list(s_posting_count, 1);
+  const std::vector<unsigned int> shorter = posting_list(s_posting_count / static_cast<size_t>(state.range(0)), 2);
+  std::vector<unsigned int> out{};
+  out.reserve(longer.size() + shorter.size());
+  for ( auto _ : state ) {
+    out.clear();
+    std::set_union(shorter.begin(), shorter.end(), longer.begin(), longer.end(), std::back_inserter(out));
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(longer.size() + shorter.size()));
+}
+BENCHMARK(BM_std_set_union)->Arg(1)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000);
+
+static void BM_darray_set_union(benchmark::State& state) {
+  const std::vector<unsigned int> longer = posting_list(s_posting_count, 1);
+  const std::vector<unsigned int> shorter = posting_list(s_posting_count / static_cast<size_t>(state.range(0)), 2);
+  CppPlay::darray<unsigned int> out = CppPlay::darray<unsigned int>::builder{}.capacity(longer.size() + shorter.size()).build();
+  for ( auto _ : state ) {
+    out.clear(); // ignore return value
+    CppPlay::set_union(shorter, longer, out); // ignore return value
+    benchmark::DoNotOptimize(out.begin());
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(longer.size() + shorter.size()));
+}
+BENCHMARK(BM_darray_set_union)->Arg(1)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000);
+
+static void BM_std_set_difference(benchmark::State& state) {
+  const std::vector<unsigned int> longer = posting_list(s_posting_count, 1);
+  const std::vector<unsigned int> shorter = posting_list(s_posting_count / static_cast<size_t>(state.range(0)), 2);
+  std::vector<unsigned int> out{};
+  out.reserve(longer.size());
+  for ( auto _ : state ) {
+    out.clear();
+    std::set_difference(longer.begin(), longer.end(), shorter.begin(), shorter.end(), std::back_inserter(out));
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(longer.size() + shorter.size()));
+}
+BENCHMARK(BM_std_set_difference)->Arg(1)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000);
+
+static void BM_darray_set_difference(benchmark::State& state) {
+  const std::vector<unsigned int> longer = posting_list(s_posting_count, 1);
+  const std::vector<unsigned int> shorter = posting_list(s_posting_count / static_cast<size_t>(state.range(0)), 2);
+  CppPlay::darray<unsigned int> out = CppPlay::darray<unsigned int>::builder{}.capacity(longer.size()).build();
+  for ( auto _ : state ) {
+    out.clear(); // ignore return value
+    CppPlay::set_difference(longer, shorter, out); // ignore return value
+    benchmark::DoNotOptimize(out.begin());
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(longer.size() + shorter.size()));
+}
+BENCHMARK(BM_darray_set_difference)->Arg(1)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000);
+
+static auto posting_lists(const size_t list_count) -> std::vector<std::vector<unsigned int>> {
+  std::vector<std::vector<unsigned int>> lists{};
+  for ( size_t list=0 ; list<list_count ; list++ ) {
+    lists.push_back(posting_list(s_posting_count / list_count, static_cast<unsigned int>(list)));
+  }
+  return lists;
+}
+
+static void BM_sort_k_lists(benchmark::State& state) {
+  const auto lists = posting_lists(static_cast<size_t>(state.range(0)));
+  std::vector<unsigned int> out{};
+  out.reserve(s_posting_count);
+  for ( auto _ : state ) {
+    out.clear();
+    for ( const auto &list : lists ) {
+      out.insert(out.end(), list.begin(), list.end());
+    }
+    std::sort(out.begin(), out.end());
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(s_posting_count));
+}
+BENCHMARK(BM_sort_k_lists)->Arg(4)->Arg(16)->Arg(64)->Unit(benchmark::kMillisecond);
+
+static void BM_darray_k_way_merge(benchmark::State& state) {
+  const auto lists = posting_lists(static_cast<size_t>(state.range(0)));
+  CppPlay::darray<unsigned int> out = CppPlay::darray<unsigned int>::builder{}.capacity(s_posting_count).build();
+  for ( auto _ : state ) {
+    out.clear(); // ignore return value
+    CppPlay::k_way_merge(lists, out); // ignore return value
+    benchmark::DoNotOptimize(out.begin());
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(s_posting_count));
+}
+BENCHMARK(BM_darray_k_way_merge)->Arg(4)->Arg(16)->Arg(64)->Unit(benchmark::kMillisecond);
+
+//
+// hash tables of n random keys, 1K to 10M: hash_map against std::unordered_map
+// - insert of n keys into an empty table (growing from the default size)
+// - lookups of present keys and of missing keys
+// - erase of every key
+//
+static auto random_keys(const size_t count, const unsigned int seed) -> std::vector<uint64_t> {
+  std::mt19937_64 generator{seed};
+  std::vector<uint64_t> keys(count);
+  for ( uint64_t &key : keys ) {
+    key = generator();
+  }
+  return keys;
+}
+
+static constexpr size_t s_hash_queries = 4096;
+
+template <typename Map>
+static auto hash_fill(Map &map_obj, const std::vector<uint64_t> &keys) -> void {
+  for ( const uint64_t key : keys ) {
+    if constexpr ( requires { map_obj.emplace(key, key); } ) {
+      map_obj.emplace(key, key);
+    } else {
+      map_obj.insert(key, key); // ignore return value
+    }
+  }
+}
+
+static void BM_std_unordered_map_insert(benchmark::State& state) {
+  const auto keys = random_keys(static_cast<size_t>(state.range(0)), 1);
+  for ( auto _ : state ) {
+    std::unordered_map<uint64_t, uint64_t> map_obj{};
+    hash_fill(map_obj, keys);
+    benchmark::DoNotOptimize(map_obj.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_std_unordered_map_insert)->Arg(1<<10)->Arg(1<<16)->Arg(1<<20)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+
+static void BM_hash_map_insert(benchmark::State& state) {
+  const auto keys = random_keys(static_cast<size_t>(state.range(0)), 1);
+  for ( auto _ : state ) {
+    CppPlay::hash_map<uint64_t, uint64_t> map_obj{};
+    hash_fill(map_obj, keys);
+    benchmark::DoNotOptimize(map_obj.pod().size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_hash_map_insert)->Arg(1<<10)->Arg(1<<16)->Arg(1<<20)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+
+// range(1) 1 looks up present keys, 0 missing keys
+static auto hash_queries(const std::vector<uint64_t> &keys, const bool hit) -> std::vector<uint64_t> {
+  if ( !hit ) {
+    return random_keys(s_hash_queries, 2);
+  }
+  std::mt19937 generator{3};
+  std::uniform_int_distribution<size_t> distribution{0, keys.size() - 1};
+  std::vector<uint64_t> queries(s_hash_queries);
+  for ( uint64_t &query : queries ) {
+    query = keys[distribution(generator)];
+  }
+  return queries;
+}
+
+static void BM_std_unordered_map_find(benchmark::State& state) {
+  const auto keys = random_keys(static_cast<size_t>(state.range(0)), 1);
+  const auto queries = hash_queries(keys, 0 != state.range(1));
+  std::unordered_map<uint64_t, uint64_t> map_obj{};
+  hash_fill(map_obj, keys);
+  for ( auto _ : state ) {
+    size_t found = 0;
+    for ( const uint64_t query : queries ) {
+      found += map_obj.contains(query) ? 1 : 0;
+    }
+    benchmark::DoNotOptimize(found);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(s_hash_queries));
+}
+BENCHMARK(BM_std_unordered_map_find)->ArgsProduct({{1<<10, 1<<16, 1<<20, 10'000'000}, {1, 0}});
+
+static void BM_hash_map_find(benchmark::State& state) {
+  const auto keys = random_keys(static_cast<size_t>(state.range(0)), 1);
+  const auto queries = hash_queries(keys, 0 != state.range(1));
+  CppPlay::hash_map<uint64_t, uint64_t> map_obj{};
+  hash_fill(map_obj, keys);
+  for ( auto _ : state ) {
+    size_t found = 0;
+    for ( const uint64_t query : queries ) {
+      found += map_obj.contains(query) ? 1 : 0;
+    }
+    benchmark::DoNotOptimize(found);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(s_hash_queries));
+}
+BENCHMARK(BM_hash_map_find)->ArgsProduct({{1<<10, 1<<16, 1<<20, 10'000'000}, {1, 0}});
+
+static void BM_std_unordered_map_erase(benchmark::State& state) {
+  const auto keys = random_keys(static_cast<size_t>(state.range(0)), 1);
+  for ( auto _ : state ) {
+    state.PauseTiming();
+    std::unordered_map<uint64_t, uint64_t> map_obj{};
+    hash_fill(map_obj, keys);
+    state.ResumeTiming();
+    for ( const uint64_t key : keys ) {
+      map_obj.erase(key);
+    }
+    benchmark::DoNotOptimize(map_obj.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_std_unordered_map_erase)->Arg(1<<10)->Arg(1<<16)->Arg(1<<20)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+
+static void BM_hash_map_erase(benchmark::State& state) {
+  const auto keys = random_keys(static_cast<size_t>(state.range(0)), 1);
+  for ( auto _ : state ) {
+    state.PauseTiming();
+    CppPlay::hash_map<uint64_t, uint64_t> map_obj{};
+    hash_fill(map_obj, keys);
+    state.ResumeTiming();
+    for ( const uint64_t key : keys ) {
+      map_obj.erase(key); // ignore return value
+    }
+    benchmark::DoNotOptimize(map_obj.pod().size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_hash_map_erase)->Arg(1<<10)->Arg(1<<16)->Arg(1<<20)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+
+//
+// startup of a data set of n 64-bit values, 1M to 64M: rebuilt in memory with
+// push_back against reopening a mapped_darray file holding it (in the temp
+// directory), opened alone and opened then scanned once
+// the reopened file is in the page cache, a cold start reads it from disk on
+// demand instead
+//
+static auto mapped_path(const char *const name) -> std::string {
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+static void BM_darray_rebuild_push_back(benchmark::State& state) {
+  const auto count = static_cast<uint64_t>(state.range(0));
+  for ( auto _ : state ) {
+    CppPlay::darray<uint64_t> darray_obj{};
+    for ( uint64_t value=0 ; value<count ; value++ ) {
+      darray_obj.push_back(value); // ignore return value
+    }
+    benchmark::DoNotOptimize(darray_obj.begin());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_darray_rebuild_push_back)->Arg(1<<20)->Arg(1<<24)->Arg(1<<26)->Unit(benchmark::kMillisecond);
+
+static void BM_mapped_darray_push_back(benchmark::State& state) {
+  const auto count = static_cast<uint64_t>(state.range(0));
+  const std::string path = mapped_path("BM_mapped_darray_push_back.darray");
+  for ( auto _ : state ) {
+    state.PauseTiming();
+    std::filesystem::remove(path);
+    state.ResumeTiming();
+    auto mapped = CppPlay::mapped_darray<uint64_t>::builder{}.path(path).build().value();
+    for ( uint64_t value=0 ; value<count ; value++ ) {
+      mapped.push_back(value); // ignore return value
+    }
+    benchmark::DoNotOptimize(mapped.begin());
+  }
+  std::filesystem::remove(path);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_mapped_darray_push_back)->Arg(1<<20)->Arg(1<<24)->Arg(1<<26)->Unit(benchmark::kMillisecond);
+
+// range(1) 1 scans every element after opening
+static void BM_mapped_darray_reopen(benchmark::State& state) {
+  const auto count = static_cast<size_t>(state.range(0));
+  const std::string path = mapped_path("BM_mapped_darray_reopen.darray");
+  std::filesystem::remove(path);
+  {
+    auto mapped = CppPlay::mapped_darray<uint64_t>::builder{}.path(path).capacity(count).build().value();
+    mapped.append_with(count, [&](uint64_t *const p_spare) {
+      std::iota(p_spare, p_spare + count, uint64_t{0});
+      return count;
+    }); // ignore return value
+  }
+  for ( auto _ : state ) {
+    auto mapped = CppPlay::mapped_darray<uint64_t>::builder{}.path(path).build().value();
+    if ( 0 != state.range(1) ) {
+      benchmark::DoNotOptimize(std::accumulate(mapped.begin(), mapped.end(), uint64_t{0}));
+    } else {
+      benchmark::DoNotOptimize(mapped[count - 1]);
+    }
+  }
+  std::filesystem::remove(path);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_mapped_darray_reopen)->ArgsProduct({{1<<20, 1<<24, 1<<26}, {0, 1}})->Unit(benchmark::kMillisecond);
+
+//
+// checkpoint of n 64-bit values (1M and 16M, 8MB and 128MB) to a file in the
+// temp directory and back: snapshot save/load against writing and reading
+// the elements one at a time through a std::fstream, and snapshots of 1M
+// short strings through string_serializer
+//
+static void BM_fstream_save_elements(benchmark::State& state) {
+  const auto count = static_cast<size_t>(state.range(0));
+  const std::string path = mapped_path("BM_fstream_save_elements.bin");
+  std::vector<uint64_t> values(count);
+  std::iota(values.begin(), values.end(), uint64_t{0});
+  for ( auto _ : state ) {
+    std::ofstream out{path, std::ios::binary | std::ios::trunc};
+    for ( const uint64_t value : values ) {
+      out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+  }
+  std::filesystem::remove(path);
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(count * sizeof(uint64_t)));
+}
+BENCHMARK(BM_fstream_save_elements)->Arg(1<<20)->Arg(1<<24)->Unit(benchmark::kMillisecond);
+
+static void BM_darray_save_snapshot(benchmark::State& state) {
+  const auto count = static_cast<size_t>(state.range(0));
+  const std::string path = mapped_path("BM_darray_save_snapshot.snapshot");
+  CppPlay::darray<uint64_t> darray_obj = CppPlay::darray<uint64_t>::builder{}.capacity(count).build();
+  for ( uint64_t value=0 ; value<count ; value++ ) {
+    darray_obj.push_back(value); // ignore return value
+  }
+  for ( auto _ : state ) {
+    CppPlay::save_snapshot(darray_obj, path); // ignore return value
+  }
+  std::filesystem::remove(path);
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(count * sizeof(uint64_t)));
+}
+BENCHMARK(BM_darray_save_snapshot)->Arg(1<<20)->Arg(1<<24)->Unit(benchmark::kMillisecond);
+
+static void BM_fstream_load_elements(benchmark::State& state) {
+  const auto count = static_cast<size_t>(state.range(0));
+  const std::string path = mapped_path("BM_fstream_load_elements.bin");
+  {
+    std::vector<uint64_t> values(count);
+    std::iota(values.begin(), values.end(), uint64_t{0});
+    std::ofstream out{path, std::ios::binary | std::ios::trunc};
+    out.write(reinterpret_cast<const char *>(values.data()), static_cast<std::streamsize>(count * sizeof(uint64_t)));
+  }
+  for ( auto _ : state ) {
+    CppPlay::darray<uint64_t> darray_obj{};
+    std::ifstream in{path, std::ios::binary};
+    uint64_t value = 0;
+    while ( in.read(reinterpret_cast<char *>(&value), sizeof(value)) ) {
+      darray_obj.push_back(value); // ignore return value
+    }
+    benchmark::DoNotOptimize(darray_obj.begin());
+  }
+  std::filesystem::remove(path);
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(count * sizeof(uint64_t)));
+}
+BENCHMARK(BM_fstream_load_elements)->Arg(1<<20)->Arg(1<<24)->Unit(benchmark::kMillisecond);
+
+static void BM_darray_load_snapshot(benchmark::State& state) {
+  const auto count = static_cast<size_t>(state.range(0));
+  const std::string path = mapped_path("BM_darray_load_snapshot.snapshot");
+  {
+    CppPlay::darray<uint64_t> darray_obj = CppPlay::darray<uint64_t>::builder{}.capacity(count).build();
+    for ( uint64_t value=0 ; value<count ; value++ ) {
+      darray_obj.push_back(value); // ignore return value
+    }
+    CppPlay::save_snapshot(darray_obj, path); // ignore return value
+  }
+  for ( auto _ : state ) {
+    CppPlay::darray<uint64_t> darray_obj{};
+    CppPlay::load_snapshot(path, darray_obj); // ignore return value
+    benchmark::DoNotOptimize(darray_obj.begin());
+  }
+  std::filesystem::remove(path);
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(count * sizeof(uint64_t)));
+}
+BENCHMARK(BM_darray_load_snapshot)->Arg(1<<20)->Arg(1<<24)->Unit(benchmark::kMillisecond);
+
+static void BM_darray_string_snapshot(benchmark::State& state) {
+  const std::string path = mapped_path("BM_darray_string_snapshot.snapshot");
+  CppPlay::darray<std::string> strings{};
+  for ( size_t idx=0 ; idx<(1<<20) ; idx++ ) {
+    strings.push_back(std::to_string(idx * 7919)); // ignore return value
+  }
+  const CppPlay::string_serializer<std::string> serializer{};
+  CppPlay::save_snapshot(strings, path, serializer); // ignore return value
+  for ( auto _ : state ) {
+    if ( 0 != state.range(0) ) {
+      CppPlay::darray<std::string> loaded{};
+      CppPlay::load_snapshot(path, loaded, serializer); // ignore return value
+      benchmark::DoNotOptimize(loaded.begin());
+    } else {
+      CppPlay::save_snapshot(strings, path, serializer); // ignore return value
+    }
+  }
+  std::filesystem::remove(path);
+  state.SetItemsProcessed(state.iterations() * (1<<20));
+}
+// range(0) 0 saves, 1 loads
+BENCHMARK(BM_darray_string_snapshot)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+//
+// export of 3 darrays of n 64-bit values (1M, 24MB in all) to a file in the
+// temp directory, and import of n values back, straight from and into the
+// darrays' buffers (pwritev, pread into spare capacity) against staging them
+// through a copy
+//
+static auto io_darray(const size_t count, const uint64_t first) -> CppPlay::darray<uint64_t> {
+  CppPlay::darray<uint64_t> darray_obj = CppPlay::darray<uint64_t>::builder{}.capacity(count).build();
+  for ( uint64_t value=0 ; value<count ; value++ ) {
+    darray_obj.push_back(first + value); // ignore return value
+  }
+  return darray_obj;
+}
+
+static void BM_copy_write_darrays(benchmark::State& state) {
+  const auto count = static_cast<size_t>(state.range(0));
+  const std::string path = mapped_path("BM_copy_write_darrays.bin");
+  const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  const std::array<CppPlay::darray<uint64_t>, 3> darrays{io_darray(count, 0), io_darray(count, count), io_darray(count, 2 * count)};
+  std::vector<uint64_t> staging{};
+  staging.reserve(3 * count);
+  for ( auto _ : state ) {
+    staging.clear();
+    for ( const auto &darray_obj : darrays ) {
+      staging.insert(staging.end(), darray_obj.begin(), darray_obj.end());
+    }
+    pwrite(fd, staging.data(), staging.size() * sizeof(uint64_t), 0); // ignore return value
+  }
+  close(fd);
+  std::filesystem::remove(path);
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(3 * count * sizeof(uint64_t)));
+}
+BENCHMARK(BM_copy_write_darrays)->Arg(1<<20)->Unit(benchmark::kMillisecond);
+
+static void BM_darray_pwrite_buffers(benchmark::State& state) {
+  const auto count = static_cast<size_t>(state.range(0));
+  const std::string path = mapped_path("BM_darray_pwrite_buffers.bin");
+  const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  const std::array<CppPlay::darray<uint64_t>, 3> darrays{io_darray(count, 0), io_darray(count, count), io_darray(count, 2 * count)};
+  for ( auto _ : state ) {
+    CppPlay::pwrite_buffers(fd, 0, darrays[0], darrays[1], darrays[2]); // ignore return value
+  }
+  close(fd);
+  std::filesystem::remove(path);
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(3 * count * sizeof(uint64_t)));
+}
+BENCHMARK(BM_darray_pwrite_buffers)->Arg(1<<20)->Unit(benchmark::kMillisecond);
+
+static void BM_copy_read_darray(benchmark::State& state) {
+  const auto count = static_cast<size_t>(state.range(0));
+  const std::string path = mapped_path("BM_copy_read_darray.bin");
+  const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  CppPlay::write_buffers(fd, io_darray(count, 0)); // ignore return value
+  std::vector<uint64_t> staging(count);
+  for ( auto _ : state ) {
+    CppPlay::darray<uint64_t> darray_obj = CppPlay::darray<uint64_t>::builder{}.capacity(count).build();
+    pread(fd, staging.data(), count * sizeof(uint64_t), 0); // ignore return value
+    darray_obj.append_range(staging); // ignore return value
+    benchmark::DoNotOptimize(darray_obj.begin());
+  }
+  close(fd);
+  std::filesystem::remove(path);
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(count * sizeof(uint64_t)));
+}
+BENCHMARK(BM_copy_read_darray)->Arg(1<<20)->Unit(benchmark::kMillisecond);
+
+static void BM_darray_pread_append(benchmark::State& state) {
+  const auto count = static_cast<size_t>(state.range(0));
+  const std::string path = mapped_path("BM_darray_pread_append.bin");
+  const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  CppPlay::write_buffers(fd, io_darray(count, 0)); // ignore return value
+  for ( auto _ : state ) {
+    CppPlay::darray<uint64_t> darray_obj = CppPlay::darray<uint64_t>::builder{}.capacity(count).build();
+    CppPlay::pread_append(fd, 0, darray_obj, count); // ignore return value
+    benchmark::DoNotOptimize(darray_obj.begin());
+  }
+  close(fd);
+  std::filesystem::remove(path);
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(count * sizeof(uint64_t)));
+}
+BENCHMARK(BM_darray_pread_append)->Arg(1<<20)->Unit(benchmark::kMillisecond);
+
+//
+// snapshot heavy workload on a darray of n values (1K to 1M): append 16
+// values, then take a read-only copy (snapshot) and read it, with an eager
+// darray copy against a cow_darray snapshot
+//
+static constexpr int s_appends_per_snapshot = 16;
+
+static void BM_darray_eager_copy_snapshot(benchmark::State& state) {
+  CppPlay::darray<int> darray_obj{};
+  for ( int value=0 ; value<state.range(0) ; value++ ) {
+    darray_obj.push_back(value); // ignore return value
+  }
+  for ( auto _ : state ) {
+    for ( int value=0 ; value<s_appends_per_snapshot ; value++ ) {
+      darray_obj.push_back(value); // ignore return value
+    }
+    const CppPlay::darray<int> snapshot{darray_obj};
+    benchmark::DoNotOptimize(snapshot[snapshot.pod().size() - 1]);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_darray_eager_copy_snapshot)->Arg(1<<10)->Arg(1<<16)->Arg(1<<20);
+
+static void BM_cow_darray_snapshot(benchmark::State& state) {
+  CppPlay::cow_darray<int> darray_obj{};
+  for ( int value=0 ; value<state.range(0) ; value++ ) {
+    darray_obj.push_back(value); // ignore return value
+  }
+  for ( auto _ : state ) {
+    for ( int value=0 ; value<s_appends_per_snapshot ; value++ ) {
+      darray_obj.push_back(value); // ignore return value
+    }
+    const auto snapshot = darray_obj.snapshot();
+    benchmark::DoNotOptimize(snapshot[snapshot.size() - 1]);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_cow_darray_snapshot)->Arg(1<<10)->Arg(1<<16)->Arg(1<<20);
+
+// plain copies that are only read
+static void BM_darray_copy(benchmark::State& state) {
+  CppPlay::darray<int> darray_obj{};
+  for ( int value=0 ; value<state.range(0) ; value++ ) {
+    darray_obj.push_back(value); // ignore return value
+  }
+  for ( auto _ : state ) {
+    const CppPlay::darray<int> copy{darray_obj};
+    benchmark::DoNotOptimize(copy[0]);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_darray_copy)->Arg(1<<10)->Arg(1<<16)->Arg(1<<20);
+
+static void BM_cow_darray_copy(benchmark::State& state) {
+  CppPlay::cow_darray<int> darray_obj{};
+  for ( int value=0 ; value<state.range(0) ; value++ ) {
+    darray_obj.push_back(value); // ignore return value
+  }
+  for ( auto _ : state ) {
+    const CppPlay::cow_darray<int> copy{darray_obj};
+    benchmark::DoNotOptimize(copy[0]);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_cow_darray_copy)->Arg(1<<10)->Arg(1<<16)->Arg(1<<20);
+
+//
+// push_back tail latency, every push_back of n values (1M and 10M ints, 1M
+// strings) timed on its own, the darray copies everything at each doubling
+// while the incremental_darray moves MIGRATE_STEP elements per push_back
+// percentiles are averaged over the iterations, max is the worst seen
+//
+template <typename Darray, typename Make>
+static void push_back_latency_histogram(benchmark::State& state, Make make_value) {
+  const size_t count = static_cast<size_t>(state.range(0));
+  std::vector<std::int64_t> latencies_ns(count);
+  double p50 = 0, p99 = 0, p999 = 0, max = 0;
+  for ( auto _ : state ) {
+    Darray darray_obj{};
+    for ( size_t idx=0 ; idx<count ; idx++ ) {
+      const auto start = std::chrono::steady_clock::now();
+      darray_obj.push_back(make_value(idx)); // ignore return value
+      const auto end = std::chrono::steady_clock::now();
+      latencies_ns[idx] = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    }
+    state.PauseTiming();
+    const auto percentile = [&](const double fraction) {
+      auto nth = latencies_ns.begin() + static_cast<std::ptrdiff_t>(fraction * static_cast<double>(count - 1));
+      std::nth_element(latencies_ns.begin(), nth, latencies_ns.end());
+      return static_cast<double>(*nth);
+    };
+    p50 += percentile(0.5);
+    p99 += percentile(0.99);
+    p999 += percentile(0.999);
+    max = std::max(max, static_cast<double>(*std::max_element(latencies_ns.begin(), latencies_ns.end())));
+    state.ResumeTiming();
+  }
+  const auto iterations = static_cast<double>(state.iterations());
+  state.counters["p50_ns"] = p50 / iterations;
+  state.counters["p99_ns"] = p99 / iterations;
+  state.counters["p99.9_ns"] = p999 / iterations;
+  state.counters["max_ns"] = max;
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_darray_push_back_latency(benchmark::State& state) {
+  push_back_latency_histogram<CppPlay::darray<int>>(state, [](size_t idx) { return static_cast<int>(idx); });
+}
+BENCHMARK(BM_darray_push_back_latency)->Arg(1<<20)->Arg(10'000'000)->Iterations(3)->Unit(benchmark::kMillisecond);
+
+static void BM_incremental_darray_push_back_latency(benchmark::State& state) {
+  push_back_latency_histogram<CppPlay::incremental_darray<int>>(state, [](size_t idx) { return static_cast<int>(idx); });
+}
+BENCHMARK(BM_incremental_darray_push_back_latency)->Arg(1<<20)->Arg(10'000'000)->Iterations(3)->Unit(benchmark::kMillisecond);
+
+
+static void BM_darray_string_push_back_latency(benchmark::State& state) {
+  push_back_latency_histogram<CppPlay::darray<std::string>>(state, [](size_t idx) { return std::to_string(idx); });
+}
+BENCHMARK(BM_darray_string_push_back_latency)->Arg(1<<20)->Iterations(3)->Unit(benchmark::kMillisecond);
+
+static void BM_incremental_darray_string_push_back_latency(benchmark::State& state) {
+  push_back_latency_histogram<CppPlay::incremental_darray<std::string>>(state, [](size_t idx) { return std::to_string(idx); });
+}
+BENCHMARK(BM_incremental_darray_string_push_back_latency)->Arg(1<<20)->Iterations(3)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,272 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#pragma once
+
+#include "darray.hpp"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef> // size_t & byte
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace CppPlay {
+
+// lock-free append-only darray for many writers and concurrent readers
+// - writers reserve a slot with an atomic fetch_add, construct the element in
+//   place and publish it with a per-slot flag, then help advance a committed
+//   watermark past every contiguously published slot
+// - storage is segmented, segment k holds FIRST_SEGMENT_CAPACITY << k slots
+//   and is allocated by whichever writer first needs it, so growth never
+//   moves (or blocks access to) published elements
+// - readers only see elements below the watermark, reading it, an element or
+//   the segment table never waits (wait-free)
+// elements are never removed, memory is released when the darray is destroyed
+template <typename T, size_t FIRST_SEGMENT_CAPACITY = 64,
+          typename Allocator = std::allocator<T>>
+class append_only_darray {
+  static_assert(std::has_single_bit(FIRST_SEGMENT_CAPACITY),
+                "segment capacities are powers of two");
+
+  enum slot_state : std::uint8_t { EMPTY, PUBLISHED };
+  struct slot {
+    alignas(T) std::byte m_storage[sizeof(T)];
+    std::atomic<slot_state> m_state;
+  };
+  using slot_allocator_type =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<slot>;
+  using slot_traits = std::allocator_traits<slot_allocator_type>;
+
+  static constexpr size_t FIRST_SEGMENT_SHIFT =
+      static_cast<size_t>(std::countr_zero(FIRST_SEGMENT_CAPACITY));
+  static constexpr size_t SEGMENT_COUNT = 64 - FIRST_SEGMENT_SHIFT;
+
+  [[nodiscard]] static constexpr auto segment_capacity(const size_t segment)
+      -> size_t {
+    return FIRST_SEGMENT_CAPACITY << segment;
+  }
+  // index i lives in the segment of the highest set bit of i + FIRST_CAPACITY
+  [[nodiscard]] static constexpr auto segment_of(const size_t idx)
+      -> std::pair<size_t, size_t> {
+    const size_t biased = idx + FIRST_SEGMENT_CAPACITY;
+    const size_t segment =
+        static_cast<size_t>(std::bit_width(biased)) - 1 - FIRST_SEGMENT_SHIFT;
+    return {segment, biased - segment_capacity(segment)};
+  }
+
+  [[no_unique_address]] slot_allocator_type m_allocator;
+  std::array<std::atomic<slot *>, SEGMENT_COUNT> m_segments;
+  // reserved by writers, and committed (every slot below is published or in a
+  // failed segment), each on its own cache line so readers don't share with writers
+  alignas(64) std::atomic<size_t> m_reserved;
+  alignas(64) std::atomic<size_t> m_committed;
+
+  // live element of a published slot
+  [[nodiscard]] static auto element(slot &target) noexcept -> T * {
+    return std::launder(reinterpret_cast<T *>(target.m_storage));
+  }
+
+  // marks a segment that couldn't be allocated, all its slots are abandoned
+  [[nodiscard]] static auto failed_segment() noexcept -> slot * {
+    static slot s_failed{};
+    return &s_failed;
+  }
+
+  // slot at idx, nullptr if its segment isn't allocated (yet) or failed
+  [[nodiscard]] auto slot_at(const size_t idx) const noexcept -> slot * {
+    const auto [segment, offset] = segment_of(idx);
+    slot *const p_segment = m_segments[segment].load();
+    [[unlikely]] if ((nullptr == p_segment) ||
+                     (failed_segment() == p_segment)) {
+      return nullptr;
+    }
+    return &p_segment[offset];
+  }
+
+  // allocate the segment if this writer is first to need it, racing writers
+  // allocate and the loser frees its copy, a failed allocation marks the
+  // segment failed so the watermark can move past it
+  // returns nullptr if the segment failed
+  auto segment_for(const size_t segment) noexcept -> slot * {
+    slot *p_segment = m_segments[segment].load();
+    [[likely]] if (nullptr != p_segment) {
+      return (failed_segment() == p_segment) ? nullptr : p_segment;
+    }
+
+    const size_t capacity = segment_capacity(segment);
+    slot *p_allocated = failed_segment();
+    try {
+      p_allocated = slot_traits::allocate(m_allocator, capacity);
+      for (size_t idx = 0; idx < capacity; idx++) {
+        // default initialized, storage is left raw and the state is EMPTY
+        ::new (static_cast<void *>(&p_allocated[idx])) slot;
+      }
+    } catch (bad_alloc &) {
+      p_allocated = failed_segment();
+    }
+    if (m_segments[segment].compare_exchange_strong(p_segment, p_allocated)) {
+      p_segment = p_allocated;
+    } else if (failed_segment() != p_allocated) {
+      std::destroy_n(p_allocated, capacity);
+      slot_traits::deallocate(m_allocator, p_allocated, capacity);
+    }
+    return (failed_segment() == p_segment) ? nullptr : p_segment;
+  }
+
+  // move the watermark past every contiguously published (or abandoned) slot
+  // each writer helps after publishing, a writer stopping at an unpublished
+  // slot leaves it to that slot's writer, seq_cst on the slot state, segment
+  // table and watermark ensures one of the two always sees the other
+  auto advance_committed() noexcept -> void {
+    size_t committed = m_committed.load();
+    while (committed < m_reserved.load()) {
+      const auto [segment, offset] = segment_of(committed);
+      slot *const p_segment = m_segments[segment].load();
+      if ((nullptr == p_segment) || ((failed_segment() != p_segment) &&
+                                     (EMPTY == p_segment[offset].m_state))) {
+        return;
+      }
+      // failure reloads committed, another writer moved it on
+      m_committed.compare_exchange_weak(committed, committed + 1);
+    }
+  }
+
+public:
+  using value_type = T;
+  using allocator_type = Allocator;
+
+  //
+  // special member functions
+  //
+  append_only_darray() : append_only_darray{Allocator{}} {}
+  explicit append_only_darray(const Allocator &allocator)
+      : m_allocator{allocator}, m_segments{}, m_reserved{0}, m_committed{0} {}
+  append_only_darray(const append_only_darray &) = delete;
+  append_only_darray(append_only_darray &&) = delete;
+  auto operator=(const append_only_darray &) -> append_only_darray & = delete;
+  auto operator=(append_only_darray &&) -> append_only_darray & = delete;
+
+  // no writer may still be running
+  ~append_only_darray() {
+    const size_t reserved = m_reserved.load();
+    for (size_t idx = 0; idx < reserved; idx++) {
+      slot *const p_slot = slot_at(idx);
+      if ((nullptr != p_slot) && (PUBLISHED == p_slot->m_state.load())) {
+        std::destroy_at(element(*p_slot));
+      }
+    }
+    for (size_t segment = 0; segment < SEGMENT_COUNT; segment++) {
+      slot *const p_segment = m_segments[segment].load();
+      if ((nullptr == p_segment) || (failed_segment() == p_segment)) {
+        continue;
+      }
+      std::destroy_n(p_segment, segment_capacity(segment));
+      slot_traits::deallocate(m_allocator, p_segment,
+                              segment_capacity(segment));
+    }
+  }
+
+  //
+  // store
+  //
+  // returns the index of the new element, which is visible to readers once
+  // every earlier reservation has been published
+  // if the element's segment can't be allocated every slot in it is
+  // abandoned, later elements are still published and reads of an abandoned
+  // element return an error
+  template <typename U>
+  auto push_back(U &&new_element) noexcept -> expected<size_t, error> {
+    const size_t idx = m_reserved.fetch_add(1);
+    const auto [segment, offset] = segment_of(idx);
+    slot *const p_segment = segment_for(segment);
+    [[unlikely]] if (nullptr == p_segment) {
+      advance_committed();
+      return unexpected{
+          error{format("Cannot allocate segment for element {}", idx)}};
+    }
+    std::construct_at(reinterpret_cast<T *>(p_segment[offset].m_storage),
+                      forward<U>(new_element));
+    p_segment[offset].m_state.store(PUBLISHED);
+    advance_committed();
+    return {idx};
+  }
+
+  //
+  // access - random, wait-free
+  //
+  // only committed elements are visible
+  [[nodiscard]] auto at(const size_t idx) const noexcept
+      -> expected<const T *, error> {
+    const size_t committed = m_committed.load(std::memory_order_acquire);
+    [[unlikely]] if (idx >= committed) {
+      return unexpected{error{format(
+          "Requested index {} beyond committed end (size={})", idx, committed)}};
+    }
+    slot *const p_slot = slot_at(idx);
+    [[unlikely]] if (nullptr == p_slot) {
+      return unexpected{error{format("Element {} was abandoned", idx)}};
+    }
+    return {element(*p_slot)};
+  }
+  // idx must be below size() and not abandoned
+  auto operator[](const size_t idx) const noexcept -> const T & {
+    return *element(*slot_at(idx));
+  }
+
+  // visit every committed element, in index order
+  template <typename Function> auto for_each(Function &&function) const -> void {
+    const size_t committed = m_committed.load(std::memory_order_acquire);
+    for (size_t idx = 0; idx < committed; idx++) {
+      slot *const p_slot = slot_at(idx);
+      if (nullptr != p_slot) {
+        function(*element(*p_slot));
+      }
+    }
+  }
+
+  //
+  // metadata, wait-free
+  //
+  // committed elements, readable without synchronization
+  [[nodiscard]] auto size() const noexcept -> expected<size_t, error> {
+    return {m_committed.load(std::memory_order_acquire)};
+  }
+  [[nodiscard]] auto is_empty() const noexcept -> expected<bool, error> {
+    return {0 == m_committed.load(std::memory_order_acquire)};
+  }
+  // reserved by writers, committed or not
+  [[nodiscard]] auto reserved() const noexcept -> size_t {
+    return m_reserved.load(std::memory_order_relaxed);
+  }
+};
+
+} // namespace CppPlay
@@ -0,0 +1,190 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef> // size_t & max_align_t
+#include <cstdint> // SIZE_MAX
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+
+namespace CppPlay {
+
+// monotonic arena
+// memory is handed out by bumping a pointer through blocks taken from the
+// global heap, deallocation is a no-op and nothing goes back to the heap until
+// the arena is reset or released, so a batch of containers using the arena is
+// freed in one go instead of one heap call per buffer
+// is a std::pmr::memory_resource, so can back std::pmr::polymorphic_allocator
+// as well as CppPlay::arena_allocator
+// not thread safe, use one arena per thread
+class monotonic_arena final : public std::pmr::memory_resource {
+  struct block {
+    block *p_next;
+    size_t size; // usable bytes following the (max aligned) header
+  };
+  static constexpr size_t BLOCK_HEADER_SIZE =
+      ((sizeof(block) + alignof(std::max_align_t) - 1) /
+       alignof(std::max_align_t)) *
+      alignof(std::max_align_t);
+  static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+  block *m_p_blocks = nullptr; // most recent (and largest) first
+  std::byte *m_p_current = nullptr;
+  std::byte *m_p_end = nullptr;
+  size_t m_next_block_size;
+
+  static inline auto block_data(block *const p_block) noexcept -> std::byte * {
+    return reinterpret_cast<std::byte *>(p_block) + BLOCK_HEADER_SIZE;
+  }
+
+  inline auto use_block(block *const p_block) noexcept -> void {
+    m_p_current = block_data(p_block);
+    m_p_end = m_p_current + p_block->size;
+  }
+
+  // blocks grow geometrically so the number of heap calls is logarithmic in
+  // the bytes allocated
+  inline auto add_block(const size_t bytes, const size_t alignment) -> void {
+    const size_t size = std::max(m_next_block_size, bytes + alignment);
+    void *const p_memory = ::operator new(BLOCK_HEADER_SIZE + size);
+    m_p_blocks = ::new (p_memory) block{m_p_blocks, size};
+    use_block(m_p_blocks);
+    m_next_block_size = size << 1;
+  }
+
+  static inline auto free_blocks(block *p_block) noexcept -> void {
+    while (nullptr != p_block) {
+      block *const p_next = p_block->p_next;
+      ::operator delete(static_cast<void *>(p_block));
+      p_block = p_next;
+    }
+  }
+
+protected:
+  auto do_allocate(size_t bytes, size_t alignment) -> void * override {
+    void *p_memory = m_p_current;
+    size_t space = static_cast<size_t>(m_p_end - m_p_current);
+    [[unlikely]] if ((nullptr == m_p_current) ||
+                     (nullptr == std::align(alignment, bytes, p_memory,
+                                            space))) {
+      add_block(bytes, alignment);
+      p_memory = m_p_current;
+      space = static_cast<size_t>(m_p_end - m_p_current);
+      std::align(alignment, bytes, p_memory, space);
+    }
+    m_p_current = static_cast<std::byte *>(p_memory) + bytes;
+    return p_memory;
+  }
+
+  // memory is only returned by reset or release
+  auto do_deallocate([[maybe_unused]] void *p_memory,
+                     [[maybe_unused]] size_t bytes,
+                     [[maybe_unused]] size_t alignment) -> void override {}
+
+  [[nodiscard]] auto do_is_equal(const std::pmr::memory_resource &other)
+      const noexcept -> bool override {
+    return this == &other;
+  }
+
+public:
+  explicit monotonic_arena(size_t initial_block_size = DEFAULT_BLOCK_SIZE)
+      : m_next_block_size{std::max(initial_block_size, size_t{1})} {}
+  monotonic_arena(const monotonic_arena &) = delete;
+  auto operator=(const monotonic_arena &) -> monotonic_arena & = delete;
+  ~monotonic_arena() override { release(); }
+
+  // invalidate everything allocated, keeping the largest block for reuse so
+  // a steady state batch cycle makes no heap calls at all
+  auto reset() noexcept -> void {
+    [[unlikely]] if (nullptr == m_p_blocks) { return; }
+    free_blocks(m_p_blocks->p_next);
+    m_p_blocks->p_next = nullptr;
+    use_block(m_p_blocks);
+  }
+
+  // invalidate everything allocated, returning all blocks to the heap
+  auto release() noexcept -> void {
+    free_blocks(m_p_blocks);
+    m_p_blocks = nullptr;
+    m_p_current = nullptr;
+    m_p_end = nullptr;
+  }
+
+  // bytes currently held from the heap (excluding block headers)
+  [[nodiscard]] auto bytes_reserved() const noexcept -> size_t {
+    size_t total = 0;
+    for (const block *p_block = m_p_blocks; nullptr != p_block;
+         p_block = p_block->p_next) {
+      total += p_block->size;
+    }
+    return total;
+  }
+};
+
+// std::allocator_traits compatible allocator drawing from a monotonic_arena
+// the arena must outlive every container using it
+template <typename T> class arena_allocator {
+  monotonic_arena *m_p_arena;
+  template <typename U> friend class arena_allocator;
+
+public:
+  using value_type = T;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  constexpr explicit arena_allocator(monotonic_arena &arena) noexcept
+      : m_p_arena{&arena} {}
+  template <typename U>
+  constexpr arena_allocator(const arena_allocator<U> &other) noexcept
+      : m_p_arena{other.m_p_arena} {}
+
+  [[nodiscard]] auto allocate(const size_t count) -> T * {
+    [[unlikely]] if (count > (SIZE_MAX / sizeof(T))) {
+      throw std::bad_array_new_length{};
+    }
+    return static_cast<T *>(m_p_arena->allocate(count * sizeof(T), alignof(T)));
+  }
+  // memory is returned to the heap with the arena
+  auto deallocate([[maybe_unused]] T *const p_memory,
+                  [[maybe_unused]] const size_t count) noexcept -> void {}
+
+  [[nodiscard]] constexpr auto arena() const noexcept -> monotonic_arena & {
+    return *m_p_arena;
+  }
+
+  template <typename U>
+  [[nodiscard]] constexpr auto
+  operator==(const arena_allocator<U> &other) const noexcept -> bool {
+    return m_p_arena == other.m_p_arena;
+  }
+};
+
+} // namespace CppPlay
@@ -0,0 +1,496 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#pragma once
+
+
+#include "darray.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef> // size_t
+#include <cstdint> // SIZE_MAX
+#include <expected>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ranges>
+#include <shared_mutex>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace CppPlay {
+
+// copy-on-write darray, copies and reader snapshots share one immutable
+// buffer
+// - a copy or snapshot() is O(1), it takes a reference to the buffer instead
+//   of copying elements
+// - the first mutation of a shared buffer detaches, copying the elements
+//   into a buffer of its own, except appends: a darray that is the only
+//   writer of its buffer appends into spare capacity in place, as snapshots
+//   only ever see the elements that existed when they were taken
+// - a snapshot is a read-only view that stays consistent (and keeps its
+//   elements alive) however the darray changes afterwards, so a writer can
+//   keep appending under ThreadProtectionEnabled while readers scan
+//   snapshots without locks
+// elements are only reachable as const, a write through a reference could
+// not detach, use replace() to change one
+template <typename T, typename ThreadProtection = ThreadProtectionDisabled<T>,
+          typename GrowthPolicy = GrowthPolicyDouble<T>,
+          typename Allocator = std::allocator<T>>
+  requires std::is_copy_constructible_v<T>
+class cow_darray {
+public:
+  using value_type = T;
+  using iterator = const T *;
+
+private:
+  using storage_type =
+      darray<T, ThreadProtectionDisabled<T>, GrowthPolicy, Allocator>;
+
+  // buffer shared by copies (writers) and snapshots (readers), never
+  // reallocated or changed below its size while shared
+  struct block {
+    storage_type m_elements;
+    // cow_darrays holding the block, snapshots excluded
+    std::atomic<size_t> m_writers{1};
+    // snapshots holding the block, counted apart from the shared_ptr as its
+    // use_count() is a relaxed load
+    mutable std::atomic<size_t> m_readers{0};
+
+    explicit block(storage_type elements) noexcept
+        : m_elements{std::move(elements)} {}
+  };
+
+  constinit static const size_t DEFAULT_RESERVE_SIZE = 8;
+
+  std::shared_ptr<block> m_p_block;
+
+  // no conditional member variable support as yet, as darray
+  struct Empty {};
+  using ConditionalMutex = std::conditional_t<
+      ThreadProtection::do_multithreaded_protection,
+      std::conditional_t<shared_read_protection<ThreadProtection>,
+                         std::shared_mutex, std::mutex>,
+      Empty>;
+  [[no_unique_address]] mutable ConditionalMutex m_mutex;
+
+  [[nodiscard]] auto write_lock() const {
+    if constexpr (ThreadProtection::do_multithreaded_protection) {
+      return std::unique_lock<ConditionalMutex>{m_mutex};
+    } else {
+      return Empty{};
+    }
+  }
+  [[nodiscard]] auto read_lock() const {
+    if constexpr (shared_read_protection<ThreadProtection>) {
+      return std::shared_lock<std::shared_mutex>{m_mutex};
+    } else if constexpr (ThreadProtection::do_multithreaded_protection) {
+      return std::unique_lock<ConditionalMutex>{m_mutex};
+    } else {
+      return Empty{};
+    }
+  }
+
+  [[nodiscard]] static auto make_block(storage_type elements) noexcept
+      -> expected<std::shared_ptr<block>, error> {
+    try {
+      return {std::make_shared<block>(std::move(elements))};
+    } catch (const bad_alloc &err) {
+      return unexpected{error{format("{}", err.what())}};
+    }
+  }
+  [[nodiscard]] static auto empty_storage(const size_t capacity)
+      -> storage_type {
+    return typename storage_type::builder{}.capacity(capacity).build();
+  }
+
+  explicit cow_darray(const size_t capacity)
+      : m_p_block{make_block(empty_storage(capacity)).value()} {}
+
+  [[nodiscard]] auto elements() const noexcept -> storage_type & {
+    return m_p_block->m_elements;
+  }
+  // neither another writer nor a snapshot holds the buffer, the acquire
+  // loads pair with the release decrements of holders letting go, so their
+  // reads happen before any change made in place
+  [[nodiscard]] auto is_unique() const noexcept -> bool {
+    return (1 == m_p_block->m_writers.load(std::memory_order_acquire)) &&
+           (0 == m_p_block->m_readers.load(std::memory_order_acquire));
+  }
+
+  // give up the shared buffer for a copy of its elements with room for
+  // capacity
+  auto detach(const size_t capacity) noexcept -> expected<void, error> {
+    storage_type copy = empty_storage(capacity);
+    return copy.append_range(elements().as_span())
+        .and_then([&](size_t /*size*/) { return make_block(std::move(copy)); })
+        .transform([&](std::shared_ptr<block> p_detached) {
+          release();
+          m_p_block = std::move(p_detached);
+        });
+  }
+
+  // the buffer to change elements in, a copy when shared
+  auto writable() noexcept -> expected<storage_type *, error> {
+    [[likely]] if (is_unique()) { return {&elements()}; }
+    return detach(elements().pod().capacity()).transform([&]() {
+      return &elements();
+    });
+  }
+
+  // the buffer to append count elements to, the shared one while this is
+  // its only writer and it has the room (snapshots only see what they were
+  // taken with), otherwise a copy with room to grow
+  auto appendable(const size_t count) noexcept
+      -> expected<storage_type *, error> {
+    const size_t size = elements().pod().size();
+    const size_t capacity = elements().pod().capacity();
+    [[likely]] if (is_unique() ||
+                   ((1 == m_p_block->m_writers.load(std::memory_order_acquire)) &&
+                    (count <= (capacity - size)))) {
+      return {&elements()};
+    }
+    [[unlikely]] if (count > (SIZE_MAX - size)) {
+      return unexpected{error{
+          format("Cannot append {} elements to {} elements", count, size)}};
+    }
+    return detach(std::max({size + count, GrowthPolicy::grow(capacity),
+                            DEFAULT_RESERVE_SIZE}))
+        .transform([&]() { return &elements(); });
+  }
+
+  auto release() noexcept -> void {
+    if (nullptr != m_p_block) {
+      m_p_block->m_writers.fetch_sub(1, std::memory_order_acq_rel);
+      m_p_block.reset();
+    }
+  }
+
+  auto share(const cow_darray &other) noexcept -> void {
+    [[maybe_unused]] const auto lock = other.read_lock();
+    m_p_block = other.m_p_block;
+    m_p_block->m_writers.fetch_add(1, std::memory_order_acq_rel);
+  }
+
+public:
+  //
+  // special member functions
+  //
+  cow_darray() : cow_darray{DEFAULT_RESERVE_SIZE} {}
+
+  // O(1), shares other's buffer until either changes
+  cow_darray(const cow_darray &other) { share(other); }
+  auto operator=(const cow_darray &other) -> cow_darray & {
+    if (this != &other) {
+      [[maybe_unused]] const auto lock = write_lock();
+      release();
+      share(other);
+    }
+    return *this;
+  }
+
+  // moved from cow_darray holds no buffer, only destruction and assignment
+  // are valid
+  cow_darray(cow_darray &&other) noexcept {
+    [[maybe_unused]] const auto lock = other.write_lock();
+    m_p_block = std::move(other.m_p_block);
+  }
+  auto operator=(cow_darray &&other) noexcept -> cow_darray & {
+    if (this != &other) {
+      [[maybe_unused]] const auto lock = write_lock();
+      [[maybe_unused]] const auto other_lock = other.write_lock();
+      release();
+      m_p_block = std::move(other.m_p_block);
+    }
+    return *this;
+  }
+
+  ~cow_darray() { release(); }
+
+  //
+  // cow_darray builder helper
+  //
+  class builder {
+    size_t m_initial_capacity = DEFAULT_RESERVE_SIZE;
+
+  public:
+    constexpr auto capacity(size_t capacity) noexcept -> builder & {
+      m_initial_capacity = capacity;
+      return *this;
+    };
+    [[nodiscard]] auto build() const noexcept -> cow_darray {
+      return cow_darray{m_initial_capacity};
+    };
+  };
+  friend builder;
+
+  //
+  // snapshot, a consistent read-only view of the elements at the time it is
+  // taken, valid (and unchanged) for as long as it lives
+  //
+  class snapshot_type {
+    std::shared_ptr<const block> m_p_block;
+    const T *m_p_elements = nullptr;
+    size_t m_size = 0;
+
+    snapshot_type(std::shared_ptr<const block> p_block, const T *p_elements,
+                  const size_t size) noexcept
+        : m_p_block{std::move(p_block)}, m_p_elements{p_elements},
+          m_size{size} {
+      hold();
+    }
+    friend cow_darray;
+
+    // a new reader is taken under the cow_darray's lock or from a snapshot
+    // already holding the block, either way the block is shared already
+    auto hold() const noexcept -> void {
+      if (nullptr != m_p_block) {
+        m_p_block->m_readers.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+    auto release() noexcept -> void {
+      if (nullptr != m_p_block) {
+        m_p_block->m_readers.fetch_sub(1, std::memory_order_release);
+        m_p_block.reset();
+      }
+    }
+
+  public:
+    //
+    // special member functions
+    //
+    snapshot_type() noexcept = default;
+    snapshot_type(const snapshot_type &other) noexcept
+        : m_p_block{other.m_p_block}, m_p_elements{other.m_p_elements},
+          m_size{other.m_size} {
+      hold();
+    }
+    auto operator=(const snapshot_type &other) noexcept -> snapshot_type & {
+      if (this != &other) {
+        release();
+        m_p_block = other.m_p_block;
+        m_p_elements = other.m_p_elements;
+        m_size = other.m_size;
+        hold();
+      }
+      return *this;
+    }
+    snapshot_type(snapshot_type &&other) noexcept
+        : m_p_block{std::move(other.m_p_block)},
+          m_p_elements{std::exchange(other.m_p_elements, nullptr)},
+          m_size{std::exchange(other.m_size, 0)} {}
+    auto operator=(snapshot_type &&other) noexcept -> snapshot_type & {
+      if (this != &other) {
+        release();
+        m_p_block = std::move(other.m_p_block);
+        m_p_elements = std::exchange(other.m_p_elements, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+      }
+      return *this;
+    }
+    ~snapshot_type() { release(); }
+
+    [[nodiscard]] auto begin() const noexcept -> iterator {
+      return m_p_elements;
+    }
+    [[nodiscard]] auto end() const noexcept -> iterator {
+      return m_p_elements + m_size;
+    }
+    [[nodiscard]] auto as_span() const noexcept -> span<const T> {
+      return span<const T>{m_p_elements, m_size};
+    }
+    [[nodiscard]] auto at(const size_t idx) const noexcept
+        -> expected<iterator, error> {
+      [[unlikely]] if (idx >= m_size) {
+        return unexpected{error{format(
+            "Requested index {} beyond snapshot end (size={})", idx, m_size)}};
+      }
+      return {&m_p_elements[idx]};
+    }
+    auto operator[](const size_t idx) const -> const T & {
+      return m_p_elements[idx];
+    }
+    [[nodiscard]] auto size() const noexcept -> size_t { return m_size; }
+    [[nodiscard]] auto is_empty() const noexcept -> bool {
+      return (0 == m_size);
+    }
+  };
+
+  [[nodiscard]] auto snapshot() const noexcept -> snapshot_type {
+    [[maybe_unused]] const auto lock = read_lock();
+    return snapshot_type{m_p_block, elements().data(),
+                         elements().pod().size()};
+  }
+
+  //
+  // store
+  //
+  template <typename U>
+  auto push_back(U &&new_element) noexcept -> expected<size_t, error> {
+    [[maybe_unused]] const auto lock = write_lock();
+    return appendable(1).and_then([&](storage_type *const p_elements) {
+      return p_elements->push_back(forward<U>(new_element));
+    });
+  }
+
+  template <std::ranges::input_range R>
+    requires std::ranges::sized_range<R> &&
+             std::constructible_from<T, std::ranges::range_reference_t<R>>
+  auto append_range(R &&range) noexcept -> expected<size_t, error> {
+    [[maybe_unused]] const auto lock = write_lock();
+    return appendable(static_cast<size_t>(std::ranges::size(range)))
+        .and_then([&](storage_type *const p_elements) {
+          return p_elements->append_range(forward<R>(range));
+        });
+  }
+
+  template <typename U>
+  auto insert(U &&new_element, const size_t index) noexcept
+      -> expected<size_t, error> {
+    [[maybe_unused]] const auto lock = write_lock();
+    return writable().and_then([&](storage_type *const p_elements) {
+      return p_elements->insert(forward<U>(new_element), index);
+    });
+  }
+
+  // replace the element at index with new_element
+  template <typename U>
+    requires std::assignable_from<T &, U &&>
+  auto replace(const size_t index, U &&new_element) noexcept
+      -> expected<void, error> {
+    [[maybe_unused]] const auto lock = write_lock();
+    [[unlikely]] if (index >= elements().pod().size()) {
+      return unexpected{error{format(
+          "Cannot replace, index {} beyond array end (size={})", index,
+          elements().pod().size())}};
+    }
+    return writable().transform([&](storage_type *const p_elements) {
+      (*p_elements)[index] = forward<U>(new_element);
+    });
+  }
+
+  //
+  // extract
+  //
+  auto pop_back() noexcept -> expected<T, error> {
+    [[maybe_unused]] const auto lock = write_lock();
+    return writable().and_then(
+        [](storage_type *const p_elements) { return p_elements->pop_back(); });
+  }
+
+  auto extract(const size_t index) noexcept -> expected<T, error> {
+    [[maybe_unused]] const auto lock = write_lock();
+    return writable().and_then([&](storage_type *const p_elements) {
+      return p_elements->extract(index);
+    });
+  }
+
+  // a shared buffer is left to its other holders rather than copied
+  auto clear() noexcept -> expected<void, error> {
+    [[maybe_unused]] const auto lock = write_lock();
+    [[likely]] if (is_unique()) { return elements().clear(); }
+    return make_block(empty_storage(DEFAULT_RESERVE_SIZE))
+        .transform([&](std::shared_ptr<block> p_empty) {
+          release();
+          m_p_block = std::move(p_empty);
+        });
+  }
+
+  //
+  // access, read-only
+  //
+  auto begin() const noexcept -> iterator { return elements().data(); }
+  auto end() const noexcept -> iterator {
+    return elements().data() + elements().pod().size();
+  }
+  [[nodiscard]] auto as_span() const noexcept -> span<const T> {
+    return span<const T>{elements().data(), elements().pod().size()};
+  }
+  [[nodiscard]] auto at(const size_t idx) const noexcept
+      -> expected<iterator, error> {
+    [[maybe_unused]] const auto lock = read_lock();
+    [[unlikely]] if (idx >= elements().pod().size()) {
+      return unexpected{error{
+          format("Requested index {} beyond array end (size={})", idx,
+                 elements().pod().size())}};
+    }
+    return {&elements().data()[idx]};
+  }
+  auto operator[](const size_t idx) const -> const T & {
+    [[maybe_unused]] const auto lock = read_lock();
+    return elements()[idx];
+  }
+
+  //
+  // metadata
+  //
+  [[nodiscard]] auto capacity() const noexcept -> expected<size_t, error> {
+    [[maybe_unused]] const auto lock = read_lock();
+    return {elements().pod().capacity()};
+  }
+  [[nodiscard]] auto size() const noexcept -> expected<size_t, error> {
+    [[maybe_unused]] const auto lock = read_lock();
+    return {elements().pod().size()};
+  }
+  [[nodiscard]] auto is_empty() const noexcept -> expected<bool, error> {
+    [[maybe_unused]] const auto lock = read_lock();
+    return {elements().pod().is_empty()};
+  }
+  // the buffer is held by another copy or a snapshot
+  [[nodiscard]] auto is_shared() const noexcept -> bool {
+    [[maybe_unused]] const auto lock = read_lock();
+    return !is_unique();
+  }
+
+  // non-monadic (plain-old-data return value) metadata accessors
+  class pod_metadata_accessor {
+    const cow_darray &m_darray;
+    constexpr explicit pod_metadata_accessor(const cow_darray &darray_obj)
+        : m_darray{darray_obj} {}
+    friend cow_darray;
+
+  public:
+    [[nodiscard]] auto capacity() const noexcept -> size_t {
+      return m_darray.capacity().value();
+    }
+    [[nodiscard]] auto size() const noexcept -> size_t {
+      return m_darray.size().value();
+    }
+    [[nodiscard]] auto is_empty() const noexcept -> bool {
+      return m_darray.is_empty().value();
+    }
+  };
+  // get plain-old-data metadata accessor
+  [[nodiscard]] constexpr auto pod() const noexcept
+      -> const pod_metadata_accessor {
+    return pod_metadata_accessor{*this};
+  }
+};
+
+} // namespace CppPlay
@@ -25,7 +25,11 @@
  *  For more information, please refer to <https://unlicense.org>
  */
 
+#pragma once
+
 #include <algorithm>
+#include <atomic>
+#include <concepts>
 #include <cstddef> // size_t & ptrdiff_t
 #include <cstring>
 #include <expected>
@@ -35,26 +39,28 @@
 #include <memory>
 #include <mutex>
 #include <new>
+#include <optional>
 #include <ranges>
+#include <shared_mutex>
+#include <span>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 
 namespace CppPlay {
 
+using std::allocator_traits;
 using std::bad_alloc;
 using std::expected;
 using std::format;
 using std::forward;
 using std::function;
-using std::is_move_assignable_v;
+using std::is_move_constructible_v;
 using std::is_trivially_copyable_v;
-using std::lock_guard;
-using std::make_unique;
 using std::memcpy;
 using std::move;
 using std::optional;
-using std::scoped_lock;
 using std::span;
 using std::string;
 using std::unexpected;
@@ -65,10 +71,18 @@ using std::ranges::views::reverse;
 using std::mutex;
 
 // custom error object
+// - a string literal is referred to rather than copied, so errors of
+//   fixed text (e.g. static_darray's) are reported without allocating
 struct error {
   string m_message;
-  explicit error(string msg) : m_message{msg} {};
-  [[nodiscard]] string message() const noexcept { return m_message; }
+  std::string_view m_literal{};
+  constexpr explicit error(string msg) : m_message{msg} {};
+  template <size_t N>
+  constexpr explicit error(const char (&literal)[N]) noexcept
+      : m_literal{literal, N - 1} {};
+  [[nodiscard]] constexpr string message() const noexcept {
+    return m_literal.empty() ? m_message : string{m_literal};
+  }
 };
 
 //
@@ -87,10 +101,219 @@ template <typename T> struct ThreadProtectionEnabled {
   static constexpr bool do_multithreaded_protection = true;
 };
 
-template <typename T, typename ThreadProtection = ThreadProtectionDisabled<T>>
+// use as ThreadProtection template parameter
+// to enable thread protection with concurrent readers, mutations are
+// exclusive and element/metadata reads share a std::shared_mutex
+template <typename T> struct ThreadProtectionSharedRead {
+  static constexpr bool do_multithreaded_protection = true;
+  static constexpr bool do_shared_read = true;
+};
+
+// use as ThreadProtection template parameter
+// as ThreadProtectionSharedRead, but metadata (size, capacity) is read
+// through a seqlock without taking any lock, mutations publish the metadata
+// as they release the exclusive lock
+template <typename T> struct ThreadProtectionSharedReadSeqlock {
+  static constexpr bool do_multithreaded_protection = true;
+  static constexpr bool do_shared_read = true;
+  static constexpr bool do_seqlock_metadata = true;
+};
+
+template <typename ThreadProtection>
+concept shared_read_protection = requires {
+  requires ThreadProtection::do_multithreaded_protection;
+  requires ThreadProtection::do_shared_read;
+};
+template <typename ThreadProtection>
+concept seqlock_metadata_protection =
+    shared_read_protection<ThreadProtection> &&
+    requires { requires ThreadProtection::do_seqlock_metadata; };
+
+// allocators providing reallocate(p, old_count, new_count), resizing a buffer
+// keeping its bytes, such as CppPlay::remap_allocator
+template <typename Allocator>
+concept reallocating_allocator =
+    requires(Allocator allocator, typename Allocator::value_type *p_buffer,
+             size_t count) {
+      {
+        allocator.reallocate(p_buffer, count, count)
+      } -> std::same_as<typename Allocator::value_type *>;
+    };
+
+// use as GrowthPolicy template parameter
+// each policy provides:
+// - grow(capacity): capacity to grow to when full
+// - shrink(size, capacity): capacity to shrink to once size elements remain,
+//   or capacity itself to keep the current buffer
+// darray never shrinks below the capacity it was built with, nor below size
+
+// double when full, halve once half full (default)
+template <typename T> struct GrowthPolicyDouble {
+  [[nodiscard]] static constexpr auto grow(const size_t capacity) noexcept
+      -> size_t {
+    return capacity << 1;
+  }
+  [[nodiscard]] static constexpr auto shrink(const size_t size,
+                                             const size_t capacity) noexcept
+      -> size_t {
+    return (size <= (capacity >> 1)) ? (capacity >> 1) : capacity;
+  }
+};
+
+// grow by half when full, less memory overhead but more reallocations
+template <typename T> struct GrowthPolicyOneAndHalf {
+  [[nodiscard]] static constexpr auto grow(const size_t capacity) noexcept
+      -> size_t {
+    return capacity + (capacity >> 1);
+  }
+  [[nodiscard]] static constexpr auto shrink(const size_t size,
+                                             const size_t capacity) noexcept
+      -> size_t {
+    return (size <= (capacity >> 1)) ? (capacity - (capacity / 3)) : capacity;
+  }
+};
+
+// double/halve with capacities rounded up to whole pages, so buffers large
+// enough to be page mapped don't waste a partial page
+template <typename T, size_t PAGE_SIZE = 4096>
+struct GrowthPolicyPageGranular {
+  static constexpr size_t ELEMENTS_PER_PAGE =
+      (sizeof(T) >= PAGE_SIZE) ? 1 : (PAGE_SIZE / sizeof(T));
+  [[nodiscard]] static constexpr auto
+  round_to_page(const size_t capacity) noexcept -> size_t {
+    return ((capacity + ELEMENTS_PER_PAGE - 1) / ELEMENTS_PER_PAGE) *
+           ELEMENTS_PER_PAGE;
+  }
+  [[nodiscard]] static constexpr auto grow(const size_t capacity) noexcept
+      -> size_t {
+    return round_to_page(capacity << 1);
+  }
+  [[nodiscard]] static constexpr auto shrink(const size_t size,
+                                             const size_t capacity) noexcept
+      -> size_t {
+    return (size <= (capacity >> 1)) ? round_to_page(capacity >> 1) : capacity;
+  }
+};
+
+// double when full, but only halve once a quarter full, so alternating
+// push_back/pop_back at a capacity boundary doesn't reallocate every call
+template <typename T> struct GrowthPolicyHysteresis {
+  [[nodiscard]] static constexpr auto grow(const size_t capacity) noexcept
+      -> size_t {
+    return capacity << 1;
+  }
+  [[nodiscard]] static constexpr auto shrink(const size_t size,
+                                             const size_t capacity) noexcept
+      -> size_t {
+    return (size <= (capacity >> 2)) ? (capacity >> 1) : capacity;
+  }
+};
+
+// elements of a relocatable type can be transferred between buffers by copying
+// their bytes (memcpy/memmove) rather than moving them one at a time
+// trivially copyable types are relocatable by default, other types whose
+// object representation doesn't depend on their address (e.g. types only
+// owning heap memory through pointers) can opt in by specialization:
+//   template <> struct CppPlay::is_trivially_relocatable<MyType>
+//       : std::true_type {};
+// specializing to std::false_type forces element-wise transfer
+template <typename T>
+struct is_trivially_relocatable
+    : std::bool_constant<is_trivially_copyable_v<T>> {};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v =
+    is_trivially_relocatable<T>::value;
+
+// Allocator is any std::allocator_traits compatible allocator with plain
+// pointers, such as std::allocator (default), std::pmr::polymorphic_allocator
+// or CppPlay::arena_allocator
+template <typename T, typename ThreadProtection = ThreadProtectionDisabled<T>,
+          typename GrowthPolicy = GrowthPolicyDouble<T>,
+          typename Allocator = std::allocator<T>>
 class darray {
+public:
+  using allocator_type =
+      typename allocator_traits<Allocator>::template rebind_alloc<T>;
+
+private:
+  using alloc_traits = allocator_traits<allocator_type>;
+  static_assert(std::is_same_v<typename alloc_traits::pointer, T *>,
+                "darray requires an allocator using plain pointers");
+
   constinit static const size_t DEFAULT_RESERVE_SIZE = 8;
-  unique_ptr<T[]> m_buffer;
+
+  // buffers are raw (uninitialized) storage, elements are constructed in place
+  // and explicitly destroyed so only [0, m_size) holds live objects
+  // each buffer carries the allocator it came from, so the allocator moves
+  // with the memory as buffers are swapped
+  struct buffer_deallocator {
+    [[no_unique_address]] allocator_type m_allocator;
+    size_t m_capacity;
+
+    buffer_deallocator(const allocator_type &allocator, size_t capacity)
+        : m_allocator{allocator}, m_capacity{capacity} {}
+    buffer_deallocator(const buffer_deallocator &) = default;
+    buffer_deallocator(buffer_deallocator &&) noexcept = default;
+    ~buffer_deallocator() = default;
+    // allocators need not be assignable (e.g. polymorphic_allocator), so
+    // re-construct in place, buffer and allocator always travel together
+    auto operator=(const buffer_deallocator &other) -> buffer_deallocator & {
+      if (this != &other) {
+        std::destroy_at(this);
+        std::construct_at(this, other);
+      }
+      return *this;
+    }
+    auto operator=(buffer_deallocator &&other) noexcept
+        -> buffer_deallocator & {
+      if (this != &other) {
+        std::destroy_at(this);
+        std::construct_at(this, move(other));
+      }
+      return *this;
+    }
+
+    auto operator()(T *const p_buffer) noexcept -> void {
+      alloc_traits::deallocate(m_allocator, p_buffer, m_capacity);
+    }
+  };
+  using buffer_type = unique_ptr<T[], buffer_deallocator>;
+
+  static inline auto buffer_allocate(const size_t capacity,
+                                     allocator_type allocator) -> buffer_type {
+    [[unlikely]] if (capacity > alloc_traits::max_size(allocator)) {
+      throw std::bad_array_new_length{};
+    }
+    T *const p_buffer = alloc_traits::allocate(allocator, capacity);
+    return buffer_type{p_buffer, buffer_deallocator{allocator, capacity}};
+  }
+  inline auto buffer_allocate(const size_t capacity) const -> buffer_type {
+    return buffer_allocate(capacity, get_allocator());
+  }
+
+  // capacity to grow to when full, a zero capacity (e.g. moved from) darray
+  // starts again from the default
+  [[nodiscard]] constexpr auto grown_capacity() const noexcept -> size_t {
+    [[unlikely]] if (0 == m_capacity) { return DEFAULT_RESERVE_SIZE; }
+    return std::max(GrowthPolicy::grow(m_capacity), m_capacity + 1);
+  }
+
+  // capacity to shrink to once size_after elements remain, m_capacity to keep
+  // the current buffer
+  [[nodiscard]] constexpr auto shrunk_capacity(const size_t size_after,
+                                               const size_t capacity) const noexcept
+      -> size_t {
+    [[likely]] if (capacity <= m_original_capacity) { return capacity; }
+    return std::clamp(GrowthPolicy::shrink(size_after, capacity),
+                      std::max(m_original_capacity, size_after), capacity);
+  }
+  [[nodiscard]] constexpr auto
+  shrunk_capacity(const size_t size_after) const noexcept -> size_t {
+    return shrunk_capacity(size_after, m_capacity);
+  }
+
+  buffer_type m_buffer;
   size_t m_capacity;
   size_t m_original_capacity;
   size_t m_size;
@@ -98,21 +321,126 @@ class darray {
   // no conditional member variable support as yet, so all this foo is to
   // reduce impact of m_mutex member when thread protection disabled
   struct Empty {};
-  using ConditionalMutex =
-      std::conditional<ThreadProtection::do_multithreaded_protection,
-                       std::mutex, Empty>::type;
+  using ConditionalMutex = std::conditional_t<
+      ThreadProtection::do_multithreaded_protection,
+      std::conditional_t<shared_read_protection<ThreadProtection>,
+                         std::shared_mutex, std::mutex>,
+      Empty>;
   [[no_unique_address]] mutable ConditionalMutex m_mutex;
 
+  // metadata published for lock free reads, the sequence is odd while being
+  // written, a reader retries until it reads the same even sequence either
+  // side of the metadata
+  //  - https://en.wikipedia.org/wiki/Seqlock
+  struct Seqlock {
+    std::atomic<size_t> m_sequence{0};
+    std::atomic<size_t> m_size{0};
+    std::atomic<size_t> m_capacity{0};
+  };
+  using ConditionalSeqlock =
+      std::conditional_t<seqlock_metadata_protection<ThreadProtection>,
+                         Seqlock, Empty>;
+  [[no_unique_address]] mutable ConditionalSeqlock m_seqlock;
+
+  struct metadata {
+    size_t m_size;
+    size_t m_capacity;
+  };
+
+  // only one writer at a time, all writers hold the exclusive lock
+  auto publish_metadata() const noexcept -> void {
+    if constexpr (seqlock_metadata_protection<ThreadProtection>) {
+      const size_t sequence =
+          m_seqlock.m_sequence.load(std::memory_order_relaxed);
+      m_seqlock.m_sequence.store(sequence + 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      m_seqlock.m_size.store(m_size, std::memory_order_relaxed);
+      m_seqlock.m_capacity.store(m_capacity, std::memory_order_relaxed);
+      m_seqlock.m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+  }
+
+  [[nodiscard]] auto read_metadata() const noexcept -> metadata {
+    if constexpr (seqlock_metadata_protection<ThreadProtection>) {
+      while (true) {
+        const size_t sequence =
+            m_seqlock.m_sequence.load(std::memory_order_acquire);
+        [[unlikely]] if (sequence & 1) { continue; }
+        const metadata snapshot{
+            m_seqlock.m_size.load(std::memory_order_relaxed),
+            m_seqlock.m_capacity.load(std::memory_order_relaxed)};
+        std::atomic_thread_fence(std::memory_order_acquire);
+        [[likely]] if (sequence ==
+                       m_seqlock.m_sequence.load(std::memory_order_relaxed)) {
+          return snapshot;
+        }
+      }
+    } else {
+      [[maybe_unused]] const auto lock = read_lock();
+      return {m_size, m_capacity};
+    }
+  }
+
+  // exclusive lock publishing metadata (seqlock protection) as it's released
+  template <typename Lock> struct publishing_lock {
+    Lock m_lock;
+    const darray *m_p_darray;
+    const darray *m_p_other;
+    ~publishing_lock() {
+      m_p_darray->publish_metadata();
+      if (nullptr != m_p_other) {
+        m_p_other->publish_metadata();
+      }
+    }
+  };
+
+  // locks held for the duration of an operation, nothing when thread
+  // protection is disabled
+  [[nodiscard]] auto write_lock() const {
+    if constexpr (seqlock_metadata_protection<ThreadProtection>) {
+      return publishing_lock<std::unique_lock<std::shared_mutex>>{
+          std::unique_lock<std::shared_mutex>{m_mutex}, this, nullptr};
+    } else if constexpr (ThreadProtection::do_multithreaded_protection) {
+      return std::unique_lock<ConditionalMutex>{m_mutex};
+    } else {
+      return Empty{};
+    }
+  }
+  // both darrays, locked without risk of deadlock
+  [[nodiscard]] auto write_lock(const darray &other) const {
+    if constexpr (seqlock_metadata_protection<ThreadProtection>) {
+      return publishing_lock<
+          std::scoped_lock<std::shared_mutex, std::shared_mutex>>{
+          std::scoped_lock{m_mutex, other.m_mutex}, this, &other};
+    } else if constexpr (ThreadProtection::do_multithreaded_protection) {
+      return std::scoped_lock{m_mutex, other.m_mutex};
+    } else {
+      return Empty{};
+    }
+  }
+  [[nodiscard]] auto read_lock() const {
+    if constexpr (shared_read_protection<ThreadProtection>) {
+      return std::shared_lock<std::shared_mutex>{m_mutex};
+    } else if constexpr (ThreadProtection::do_multithreaded_protection) {
+      return std::unique_lock<ConditionalMutex>{m_mutex};
+    } else {
+      return Empty{};
+    }
+  }
+
   // construct darray specifying initial capacity
-  constexpr explicit darray(std::size_t initial_capacity)
-      : m_buffer{make_unique<T[]>(initial_capacity)},
+  constexpr darray(std::size_t initial_capacity,
+                   const allocator_type &allocator)
+      : m_buffer{buffer_allocate(initial_capacity, allocator)},
         m_capacity{initial_capacity}, m_original_capacity{initial_capacity},
-        m_size{0} {}
+        m_size{0} {
+    publish_metadata();
+  }
 
   struct ProcessingData {
     explicit ProcessingData(size_t current_capacity)
         : buffer_resized{}, buffer_resized_capacity{current_capacity} {}
-    optional<unique_ptr<T[]>> buffer_resized;
+    optional<buffer_type> buffer_resized;
     size_t buffer_resized_capacity;
   };
 
@@ -120,7 +448,7 @@ class darray {
                                       const size_t capacity) noexcept
       -> expected<ProcessingData *const, error> {
     try {
-      unique_ptr<T[]> buffer_resized = make_unique<T[]>(capacity);
+      buffer_type buffer_resized = buffer_allocate(capacity);
       p_data->buffer_resized = optional{move(buffer_resized)};
       p_data->buffer_resized_capacity = capacity;
       return {p_data};
@@ -129,19 +457,92 @@ class darray {
     }
   }
 
+  // grow the current buffer in place, leaving p_data without a resized buffer
+  // so no transfer follows, the allocator may still move the buffer but does
+  // so without the old and new buffers coexisting (e.g. mremap)
+  // on failure the current buffer is untouched
+  constexpr inline auto buffer_reallocate(ProcessingData *const p_data,
+                                          const size_t capacity) noexcept
+      -> expected<ProcessingData *const, error> {
+    try {
+      buffer_deallocator &deallocator = m_buffer.get_deleter();
+      [[unlikely]] if (capacity >
+                       alloc_traits::max_size(deallocator.m_allocator)) {
+        throw std::bad_array_new_length{};
+      }
+      T *const p_buffer = deallocator.m_allocator.reallocate(
+          m_buffer.get(), m_capacity, capacity);
+      static_cast<void>(m_buffer.release());
+      m_buffer.reset(p_buffer);
+      deallocator.m_capacity = capacity;
+      m_capacity = capacity;
+      p_data->buffer_resized_capacity = capacity;
+      return {p_data};
+    } catch (bad_alloc &err) {
+      return unexpected{error{format("{}", err.what())}};
+    }
+  }
+
+  // relocatable elements in a buffer from a reallocating allocator grow in
+  // place, anything else is transferred to a new buffer
+  constexpr inline auto buffer_grow(ProcessingData *const p_data,
+                                    const size_t capacity) noexcept
+      -> expected<ProcessingData *const, error> {
+    if constexpr (is_trivially_relocatable_v<T> &&
+                  reallocating_allocator<allocator_type>) {
+      [[likely]] if (nullptr != m_buffer) {
+        return buffer_reallocate(p_data, capacity);
+      }
+    }
+    return buffer_create(p_data, capacity);
+  }
+
   constexpr inline auto
   buffer_increase_if(ProcessingData *const p_data,
                      const function<bool(void)> &predicate) noexcept
       -> expected<ProcessingData *const, error> {
     [[likely]] if (false == predicate()) { return {p_data}; }
-    return buffer_create(p_data, m_capacity << 1);
+    return buffer_grow(p_data, grown_capacity());
   }
+
+  // grow once, by as many growth policy steps as needed, to hold size_needed
+  // elements
   constexpr inline auto
-  buffer_decrease_if(ProcessingData *const p_data,
-                     const function<bool(void)> &predicate) noexcept
+  buffer_increase_to_fit(ProcessingData *const p_data,
+                         const size_t size_needed) noexcept
       -> expected<ProcessingData *const, error> {
-    [[likely]] if (false == predicate()) { return {p_data}; }
-    return buffer_create(p_data, m_capacity >> 1);
+    [[likely]] if (size_needed <= m_capacity) { return {p_data}; }
+    size_t capacity = grown_capacity();
+    while (capacity < size_needed) {
+      const size_t grown = std::max(GrowthPolicy::grow(capacity), capacity + 1);
+      [[unlikely]] if (grown < capacity) { // overflow
+        capacity = size_needed;
+        break;
+      }
+      capacity = grown;
+    }
+    return buffer_grow(p_data, capacity);
+  }
+  // shrink if the growth policy calls for it once size_after elements remain
+  constexpr inline auto buffer_decrease_if(ProcessingData *const p_data,
+                                           const size_t size_after) noexcept
+      -> expected<ProcessingData *const, error> {
+    const size_t capacity = shrunk_capacity(size_after);
+    [[likely]] if (capacity == m_capacity) { return {p_data}; }
+    return buffer_create(p_data, capacity);
+  }
+  // shrink once, by as many growth policy steps as call for it, once
+  // size_after elements remain
+  constexpr inline auto buffer_decrease_to_fit(ProcessingData *const p_data,
+                                               const size_t size_after) noexcept
+      -> expected<ProcessingData *const, error> {
+    size_t capacity = m_capacity;
+    for (size_t next = shrunk_capacity(size_after, capacity); next != capacity;
+         next = shrunk_capacity(size_after, capacity)) {
+      capacity = next;
+    }
+    [[likely]] if (capacity == m_capacity) { return {p_data}; }
+    return buffer_create(p_data, capacity);
   }
   constexpr inline auto buffer_reset_original_capacity_if(
       ProcessingData *const p_data,
@@ -154,17 +555,58 @@ class darray {
   template <typename U>
   inline auto emplace(U &&element, size_t idx) noexcept
       -> expected<void, error> {
-    m_buffer[idx] = forward<U>(element);
+    std::construct_at(&m_buffer[idx], forward<U>(element));
     return {};
   }
 
+  // element is an element of this darray
+  template <typename U>
+  [[nodiscard]] auto element_aliases(const U &element) const noexcept -> bool {
+    if constexpr (std::same_as<std::remove_cvref_t<U>, T>) {
+      const std::less<const T *> before{};
+      const T *const p_element = std::addressof(element);
+      return !before(p_element, m_buffer.get()) &&
+             before(p_element, m_buffer.get() + m_size);
+    } else {
+      return false;
+    }
+  }
+
+  // copy (or move) element out of the buffer before it is resized or shifted
+  template <typename U>
+  inline auto stage_if_aliased(optional<T> &staged, U &&element) noexcept
+      -> void {
+    if constexpr (std::same_as<std::remove_cvref_t<U>, T>) {
+      [[unlikely]] if (element_aliases(element)) {
+        staged.emplace(forward<U>(element));
+      }
+    }
+  }
+
+  template <typename U>
+  inline auto emplace_staged(optional<T> &staged, U &&element, size_t idx)
+      noexcept -> expected<void, error> {
+    if constexpr (std::same_as<std::remove_cvref_t<U>, T>) {
+      [[unlikely]] if (staged.has_value()) {
+        if constexpr (is_move_constructible_v<T>) {
+          return emplace(move(*staged), idx);
+        } else {
+          return emplace(*staged, idx);
+        }
+      }
+    }
+    return emplace(forward<U>(element), idx);
+  }
+
   // only valid for copyable objects
   // used when objects should be copyied, such as copy constructor and copy
   // assignment
+  // dest is raw storage, copies are constructed in place
   inline auto buffer_copy(const span<T> source, span<T> dest) noexcept
       -> expected<size_t, error> {
-    for_each(source,
-             [&dest, idx = 0](T &value) mutable { dest[idx++] = value; });
+    for_each(source, [&dest, idx = 0](T &value) mutable {
+      std::construct_at(&dest[idx++], value);
+    });
     return {dest.size()};
   }
 
@@ -178,35 +620,56 @@ class darray {
   struct TransferMethodRight {
     static constexpr TransferMethod method = SHIFT_RIGHT;
   };
+  // bulk transfer for relocatable types
+  // buffer elements are array elements (complete objects), never
+  // potentially-overlapping subobjects, so their bytes can be copied directly
+  //  - https://en.cppreference.com/w/cpp/types/is_trivially_copyable
+  //  - https://en.cppreference.com/w/cpp/string/byte/memmove
+  // the copied bytes become the destination objects, source slots are left as
+  // raw storage without their destructors running
+  template <typename Method>
+  inline auto buffer_relocate(const span<T> source, span<T> dest) noexcept
+      -> void {
+    [[unlikely]] if (source.empty()) { return; }
+    if constexpr (DIRECT == Method::method) {
+      memcpy(static_cast<void *>(dest.data()),
+             static_cast<const void *>(source.data()), source.size_bytes());
+    } else {
+      // memmove correctly copies forward or reverse depending on overlap
+      std::memmove(static_cast<void *>(dest.data()),
+                   static_cast<const void *>(source.data()),
+                   source.size_bytes());
+    }
+  }
+
   // valid for moveable and "copy only" objects, preferring move
   // used when objects should be transfered between buffers, such as resize,
   // move constructor and move assignment
+  // dest is raw storage, each element is constructed in dest and destroyed in
+  // source, leaving source as raw storage
   template <typename Method>
   inline auto buffer_transfer(const span<T> source, span<T> dest) noexcept
       -> void {
-    // could memcpy be used for is_trivially_copyable DIRECT, or memove for
-    // SHIFT_LEFT and SHIFT_RIGHT? (memove would be great as it correctly uses
-    // forward or reverse copying depending on buffer overlap)
-    // memcopy  and memmove can only be used if "not potentially-overlapping
-    // subobjects" which AFAIK can't be detected
-    //  - https://en.cppreference.com/w/cpp/types/is_trivially_copyable
-    //  - https://en.cppreference.com/w/cpp/string/byte/memmove
-    if constexpr (SHIFT_RIGHT == Method::method) {
+    if constexpr (is_trivially_relocatable_v<T>) {
+      buffer_relocate<Method>(source, dest);
+    } else if constexpr (SHIFT_RIGHT == Method::method) {
       for_each(source | reverse,
                [&dest, idx = source.size()](T &value) mutable {
-                 if constexpr (is_move_assignable_v<T>) {
-                   dest[--idx] = move(value);
+                 if constexpr (is_move_constructible_v<T>) {
+                   std::construct_at(&dest[--idx], move(value));
                  } else {
-                   dest[--idx] = value;
+                   std::construct_at(&dest[--idx], value);
                  }
+                 std::destroy_at(&value);
                });
     } else {
       for_each(source, [&dest, idx = 0](T &value) mutable {
-        if constexpr (is_move_assignable_v<T>) {
-          dest[idx++] = move(value);
+        if constexpr (is_move_constructible_v<T>) {
+          std::construct_at(&dest[idx++], move(value));
         } else {
-          dest[idx++] = value;
+          std::construct_at(&dest[idx++], value);
         }
+        std::destroy_at(&value);
       });
     }
   }
@@ -223,12 +686,18 @@ class darray {
     return {p_data};
   };
 
+  // closes the gap of erase_count elements at erase_index
   constexpr auto transfer_erase(ProcessingData *const p_data,
-                                const size_t erase_index) noexcept
+                                const size_t erase_index,
+                                const size_t erase_count = 1) noexcept
       -> expected<ProcessingData *const, error> {
+    // erased elements have been extracted (leaving moved from objects behind)
+    // or are simply discarded
+    std::destroy_n(&m_buffer[erase_index], erase_count);
+
     const span<T> src_left{m_buffer.get(), erase_index};
-    const span<T> src_right{&(m_buffer.get()[erase_index + 1]),
-                            m_size - (erase_index + 1)};
+    const span<T> src_right{&(m_buffer.get()[erase_index + erase_count]),
+                            m_size - (erase_index + erase_count)};
     span<T> dest_right{&(m_buffer.get()[erase_index]), src_right.size()};
 
     std::function transfer_left = [&]() -> expected<void, error> { return {}; };
@@ -263,13 +732,16 @@ class darray {
         });
   };
 
+  // leaves a gap of insert_count raw slots at insert_index
   constexpr auto transfer_insert(ProcessingData *const p_data,
-                                 const size_t insert_index) noexcept
+                                 const size_t insert_index,
+                                 const size_t insert_count = 1) noexcept
       -> expected<ProcessingData *const, error> {
     const span<T> src_left{m_buffer.get(), insert_index};
     const span<T> src_right{&(m_buffer.get()[insert_index]),
                             m_size - insert_index};
-    span<T> dest_right{&(m_buffer.get()[insert_index + 1]), src_right.size()};
+    span<T> dest_right{&(m_buffer.get()[insert_index + insert_count]),
+                       src_right.size()};
 
     std::function transfer_left = [&]() -> expected<void, error> { return {}; };
 
@@ -284,9 +756,9 @@ class darray {
         return {};
       };
 
-      dest_right =
-          span{&(p_data->buffer_resized.value().get()[insert_index + 1]),
-               src_right.size()};
+      dest_right = span{
+          &(p_data->buffer_resized.value().get()[insert_index + insert_count]),
+          src_right.size()};
     }
 
     const auto transfer_right = [&]() -> expected<void, error> {
@@ -305,9 +777,22 @@ class darray {
   };
 
   // darray helpers
-  inline auto darray_copy_into_me(const darray &other) noexcept
+  inline auto darray_copy_into_me(const darray &other,
+                                  const allocator_type &allocator) noexcept
       -> expected<size_t, error> {
 
+    const auto create = [&](ProcessingData *p_data)
+        -> expected<ProcessingData *const, error> {
+      try {
+        p_data->buffer_resized =
+            optional{buffer_allocate(other.m_capacity, allocator)};
+        p_data->buffer_resized_capacity = other.m_capacity;
+        return {p_data};
+      } catch (bad_alloc &err) {
+        return unexpected{error{format("{}", err.what())}};
+      }
+    };
+
     const auto copy =
         [&](ProcessingData *p_data) -> expected<ProcessingData *const, error> {
       return buffer_copy(
@@ -321,9 +806,9 @@ class darray {
 
     const auto process = [&]() {
       ProcessingData data{m_capacity};
-      return buffer_create(&data, other.m_capacity)
-          .and_then(copy)
-          .and_then([&](ProcessingData *const p_data) {
+      return create(&data).and_then(copy).and_then(
+          [&](ProcessingData *const p_data) {
+            std::destroy_n(m_buffer.get(), m_size);
             m_buffer.swap(p_data->buffer_resized.value());
             m_capacity = other.m_capacity;
             m_original_capacity = other.m_original_capacity;
@@ -332,30 +817,56 @@ class darray {
           });
     };
 
-    if constexpr (ThreadProtection::do_multithreaded_protection) {
-      const scoped_lock<mutex> lock(m_mutex, other.m_mutex);
-      return process();
-    } else {
-      return process();
-    }
+    [[maybe_unused]] const auto lock = write_lock(other);
+    return process();
   }
 
-  inline auto darray_move_into_me(darray &&other) noexcept
+  // other's buffer is taken over when its allocator can be, otherwise its
+  // elements are transferred into a buffer from this darray's allocator
+  inline auto darray_move_into_me(darray &&other,
+                                  const bool take_allocator) noexcept
       -> expected<size_t, error> {
-    const auto process = [&]() -> expected<size_t, error> {
-      m_buffer = move(other.m_buffer);
+    const auto take_buffer = [&]() -> expected<size_t, error> {
+      std::destroy_n(m_buffer.get(), m_size);
+      m_buffer.swap(other.m_buffer);
       m_capacity = other.m_capacity;
       m_original_capacity = other.m_original_capacity;
       m_size = other.m_size;
+      // other keeps (and releases) this darray's old buffer, empty
+      other.m_buffer.reset();
+      other.m_capacity = 0;
+      other.m_original_capacity = 0;
+      other.m_size = 0;
       return {m_size};
     };
 
-    if constexpr (ThreadProtection::do_multithreaded_protection) {
-      const scoped_lock<mutex> lock(m_mutex, other.m_mutex);
-      return process();
-    } else {
-      return process();
-    }
+    const auto transfer_buffer = [&]() -> expected<size_t, error> {
+      ProcessingData data{m_capacity};
+      return buffer_create(&data, other.m_capacity)
+          .and_then([&](ProcessingData *const p_data)
+                        -> expected<size_t, error> {
+            buffer_transfer<TransferMethodDirect>(
+                span{other.m_buffer.get(), other.m_size},
+                span{p_data->buffer_resized.value().get(), other.m_size});
+            std::destroy_n(m_buffer.get(), m_size);
+            m_buffer.swap(p_data->buffer_resized.value());
+            m_capacity = other.m_capacity;
+            m_original_capacity = other.m_original_capacity;
+            m_size = other.m_size;
+            other.m_size = 0;
+            return {m_size};
+          });
+    };
+
+    const auto process = [&]() -> expected<size_t, error> {
+      if (take_allocator || (get_allocator() == other.get_allocator())) {
+        return take_buffer();
+      }
+      return transfer_buffer();
+    };
+
+    [[maybe_unused]] const auto lock = write_lock(other);
+    return process();
   }
 
 public:
@@ -363,50 +874,92 @@ public:
   // special member functions
   //
 
-  constexpr darray()
-      : m_buffer{make_unique<T[]>(DEFAULT_RESERVE_SIZE)},
+  constexpr darray() : darray{allocator_type{}} {}
+
+  constexpr explicit darray(const allocator_type &allocator)
+      : m_buffer{buffer_allocate(DEFAULT_RESERVE_SIZE, allocator)},
         m_capacity{DEFAULT_RESERVE_SIZE},
-        m_original_capacity{DEFAULT_RESERVE_SIZE}, m_size{0} {}
+        m_original_capacity{DEFAULT_RESERVE_SIZE}, m_size{0} {
+    publish_metadata();
+  }
 
-  constexpr ~darray() = default;
+  // buffer is released by its deallocator, only live elements are destroyed
+  constexpr ~darray() { std::destroy_n(m_buffer.get(), m_size); }
 
-  constexpr darray(const darray &other) {
+  constexpr darray(const darray &other)
+      : m_buffer{nullptr,
+                 buffer_deallocator{
+                     alloc_traits::select_on_container_copy_construction(
+                         other.get_allocator()),
+                     0}},
+        m_capacity{0}, m_original_capacity{0}, m_size{0} {
     // thread protection provided in darray_copy_into_me
-    darray_copy_into_me(other).or_else(
-        [](error err) -> expected<size_t, error> { throw err; });
+    darray_copy_into_me(other, get_allocator())
+        .or_else([](error err) -> expected<size_t, error> { throw err; });
   }
 
   constexpr auto operator=(const darray &other) -> darray & {
+    [[unlikely]] if (this == &other) { return *this; }
+    const allocator_type allocator =
+        alloc_traits::propagate_on_container_copy_assignment::value
+            ? other.get_allocator()
+            : get_allocator();
     // thread protection provided in darray_copy_into_me
-    darray_copy_into_me(other).or_else([](error err) { throw err; });
-    return this;
+    darray_copy_into_me(other, allocator)
+        .or_else([](error err) -> expected<size_t, error> { throw err; });
+    return *this;
   }
 
-  constexpr explicit darray(T &&other) noexcept {
+  // moved from darray is left empty with zero capacity, it's usable and grows
+  // again from the default capacity
+  constexpr darray(darray &&other) noexcept
+      : m_buffer{nullptr, buffer_deallocator{other.get_allocator(), 0}},
+        m_capacity{0}, m_original_capacity{0}, m_size{0} {
     // thread protection provided in darray_move_into_me
-    darray_move_into_me(other).or_else(
-        [](error err) -> expected<size_t, error> { throw err; });
+    darray_move_into_me(move(other), true);
   };
 
-  constexpr auto operator=(T &&other) noexcept -> T & {
+  constexpr auto operator=(darray &&other) noexcept -> darray & {
+    [[unlikely]] if (this == &other) { return *this; }
     // thread protection provided in darray_move_into_me
-    darray_move_into_me(other).or_else(
-        [](error err) -> expected<size_t, error> { throw err; });
+    // failure to allocate when allocators differ leaves both unchanged
+    darray_move_into_me(
+        move(other),
+        alloc_traits::propagate_on_container_move_assignment::value);
+    return *this;
   };
 
+  [[nodiscard]] constexpr auto get_allocator() const noexcept
+      -> allocator_type {
+    return m_buffer.get_deleter().m_allocator;
+  }
+
   //
   // darray builder helper
   //
   class builder {
     size_t m_initial_capacity = DEFAULT_RESERVE_SIZE;
+    allocator_type m_allocator;
 
   public:
+    constexpr builder()
+      requires std::is_default_constructible_v<allocator_type>
+        : m_allocator{} {}
+    constexpr explicit builder(const allocator_type &allocator)
+        : m_allocator{allocator} {}
+
     constexpr auto capacity(size_t capacity) noexcept -> builder & {
       m_initial_capacity = capacity;
       return *this;
     };
+    constexpr auto allocator(const allocator_type &allocator) noexcept
+        -> builder & {
+      std::destroy_at(&m_allocator);
+      std::construct_at(&m_allocator, allocator);
+      return *this;
+    };
     [[nodiscard]] constexpr auto build() const noexcept -> darray {
-      return darray{m_initial_capacity};
+      return darray{m_initial_capacity, m_allocator};
     };
   };
   friend builder;
@@ -439,10 +992,14 @@ public:
       return {p_data};
     };
 
+    // an element of this darray is freed with the buffer it grows out of,
+    // a copy of it is stored instead
+    optional<T> staged{};
+
     const auto store_new_element =
         [&]([[maybe_unused]] ProcessingData *const p_data)
         -> expected<size_t, error> {
-      return emplace(forward<U>(new_element), m_size)
+      return emplace_staged(staged, forward<U>(new_element), m_size)
           .and_then([&]() -> expected<size_t, error> { return {++m_size}; });
     };
 
@@ -454,12 +1011,11 @@ public:
           .and_then(store_new_element);
     };
 
-    if constexpr (ThreadProtection::do_multithreaded_protection) {
-      const std::lock_guard<std::mutex> lock(m_mutex);
-      return process();
-    } else {
-      return process();
+    [[maybe_unused]] const auto lock = write_lock();
+    [[unlikely]] if (m_size == m_capacity) {
+      stage_if_aliased(staged, forward<U>(new_element));
     }
+    return process();
   }
 
   // alternate implementation without monadic error handling and the composition
@@ -468,21 +1024,24 @@ public:
   template <typename U>
   auto push_back_2(U &&new_element) noexcept -> expected<size_t, error> {
 
+    optional<T> staged{};
+
     const auto process = [&]() -> expected<size_t, error> {
       if (m_size == m_capacity) {
+        stage_if_aliased(staged, forward<U>(new_element));
         try {
-          size_t buffer_resized_capacity = m_capacity << 1;
-          unique_ptr<T[]> buffer_resized =
-              make_unique<T[]>(buffer_resized_capacity);
+          size_t buffer_resized_capacity = grown_capacity();
+          buffer_type buffer_resized = buffer_allocate(buffer_resized_capacity);
 
           auto src = m_buffer.get();
           auto dest = buffer_resized.get();
           for (size_t idx = 0; idx < m_size; idx++) {
-            if constexpr (is_move_assignable_v<T>) {
-              dest[idx] = move(src[idx]);
+            if constexpr (is_move_constructible_v<T>) {
+              std::construct_at(&dest[idx], move(src[idx]));
             } else {
-              dest[idx] = src[idx];
+              std::construct_at(&dest[idx], src[idx]);
             }
+            std::destroy_at(&src[idx]);
           }
 
           m_buffer.swap(buffer_resized);
@@ -491,16 +1050,12 @@ public:
           return unexpected{error{format("{}", err.what())}};
         }
       }
-      m_buffer[m_size++] = forward<U>(new_element);
-      return {m_size};
+      return emplace_staged(staged, forward<U>(new_element), m_size)
+          .and_then([&]() -> expected<size_t, error> { return {++m_size}; });
     };
 
-    if constexpr (ThreadProtection::do_multithreaded_protection) {
-      const std::lock_guard<std::mutex> lock(m_mutex);
-      return process();
-    } else {
-      return process();
-    }
+    [[maybe_unused]] const auto lock = write_lock();
+    return process();
   }
 
   template <typename U>
@@ -536,10 +1091,14 @@ public:
       return {p_data};
     };
 
+    // an element of this darray is shifted, or freed with the buffer it grows
+    // out of, a copy of it is stored instead
+    optional<T> staged{};
+
     const auto store_new_element =
         [&]([[maybe_unused]] ProcessingData *const p_data)
         -> expected<size_t, error> {
-      return emplace(forward<U>(new_element), index)
+      return emplace_staged(staged, forward<U>(new_element), index)
           .and_then([&]() -> expected<size_t, error> { return {++m_size}; });
     };
 
@@ -552,27 +1111,251 @@ public:
           .and_then(store_new_element);
     };
 
-    if constexpr (ThreadProtection::do_multithreaded_protection) {
-      const std::lock_guard<std::mutex> lock(m_mutex);
-      return process();
+    [[maybe_unused]] const auto lock = write_lock();
+    stage_if_aliased(staged, forward<U>(new_element));
+    return process();
+  }
+
+  // insert every element of range before index, growing at most once,
+  // shifting the tail once and locking once, returns the new size
+  // elements are copied, or moved from a range of rvalues (e.g.
+  // std::move_iterator)
+  template <std::ranges::input_range R>
+    requires std::constructible_from<T, std::ranges::range_reference_t<R>>
+  auto insert_range(const size_t index, R &&range) noexcept
+      -> expected<size_t, error> {
+    return range_insert(index, false, forward<R>(range));
+  }
+  template <std::input_iterator I, std::sentinel_for<I> S>
+    requires std::constructible_from<T, std::iter_reference_t<I>>
+  auto insert_range(const size_t index, I first, S last) noexcept
+      -> expected<size_t, error> {
+    return range_insert(index, false,
+                        std::ranges::subrange{move(first), move(last)});
+  }
+
+  // append every element of range, as insert_range at the end
+  template <std::ranges::input_range R>
+    requires std::constructible_from<T, std::ranges::range_reference_t<R>>
+  auto append_range(R &&range) noexcept -> expected<size_t, error> {
+    return range_insert(0, true, forward<R>(range));
+  }
+  template <std::input_iterator I, std::sentinel_for<I> S>
+    requires std::constructible_from<T, std::iter_reference_t<I>>
+  auto append_range(I first, S last) noexcept -> expected<size_t, error> {
+    return range_insert(0, true,
+                        std::ranges::subrange{move(first), move(last)});
+  }
+
+  // append elements constructed in place by writer, growing at most once and
+  // locking once, returns the new size
+  // writer is called with raw spare capacity for max_count elements, it
+  // constructs the first count of them, returns count (at most max_count)
+  // and must not throw, a count above max_count is an error and appends
+  // nothing
+  template <typename Writer>
+    requires std::is_invocable_r_v<size_t, Writer &, T *>
+  auto append_with(const size_t max_count, Writer &&writer) noexcept
+      -> expected<size_t, error> {
+
+    const auto check_preconditions = [&](ProcessingData *const p_data)
+        -> expected<ProcessingData *const, error> {
+      if (max_count > (alloc_traits::max_size(get_allocator()) - m_size)) {
+        return unexpected{error{format(
+            "Cannot append {} elements to {} elements", max_count, m_size)}};
+      }
+      return {p_data};
+    };
+
+    const auto resize_to_fit = [&](ProcessingData *const p_data) {
+      return buffer_increase_to_fit(p_data, m_size + max_count);
+    };
+
+    const auto transfer_contents_as_needed = [&](ProcessingData *const p_data)
+        -> expected<ProcessingData *const, error> {
+      return transfer_insert(p_data, m_size, max_count);
+    };
+
+    const auto use_new_buffer_if_resized = [&](ProcessingData *const p_data)
+        -> expected<ProcessingData *const, error> {
+      if (p_data->buffer_resized.has_value()) {
+        m_buffer.swap(p_data->buffer_resized.value());
+        m_capacity = p_data->buffer_resized_capacity;
+      }
+      return {p_data};
+    };
+
+    const auto store_new_elements =
+        [&]([[maybe_unused]] ProcessingData *const p_data)
+        -> expected<size_t, error> {
+      const auto count = static_cast<size_t>(writer(m_buffer.get() + m_size));
+      [[unlikely]] if (count > max_count) {
+        return unexpected{error{
+            format("Writer returned {} elements, given room for {}", count,
+                   max_count)}};
+      }
+      m_size += count;
+      return {m_size};
+    };
+
+    const auto process = [&]() -> expected<size_t, error> {
+      ProcessingData data{m_capacity};
+      return check_preconditions(&data)
+          .and_then(resize_to_fit)
+          .and_then(transfer_contents_as_needed)
+          .and_then(use_new_buffer_if_resized)
+          .and_then(store_new_elements);
+    };
+
+    [[maybe_unused]] const auto lock = write_lock();
+    return process();
+  }
+
+private:
+  // some element of range is an element of this darray, inserting straight
+  // from it would read storage the insert frees (resize) or shifts
+  template <typename R>
+  [[nodiscard]] auto range_aliases(R &range) const noexcept -> bool {
+    const std::less<const T *> before{};
+    const T *const p_first = m_buffer.get();
+    const T *const p_last = p_first + m_size;
+    if constexpr (std::ranges::contiguous_range<R>) {
+      const T *const p_data = std::ranges::data(range);
+      const T *const p_data_last = p_data + std::ranges::size(range);
+      return before(p_data, p_last) && before(p_first, p_data_last);
+    } else {
+      return std::ranges::any_of(range, [&](const T &value) {
+        const T *const p_value = std::addressof(value);
+        return !before(p_value, p_first) && before(p_value, p_last);
+      });
+    }
+  }
+
+  // at_end inserts at the size found once locked
+  template <typename R>
+  auto range_insert(const size_t index, const bool at_end, R &&range) noexcept
+      -> expected<size_t, error> {
+
+    if constexpr (!std::ranges::forward_range<R> &&
+                  !std::ranges::sized_range<R>) {
+      // single pass range of unknown length, stage it so it can be counted
+      darray<T, ThreadProtectionDisabled<T>, GrowthPolicy, Allocator> staged{
+          get_allocator()};
+      for (auto &&element : range) {
+        const expected<size_t, error> result =
+            staged.push_back(forward<decltype(element)>(element));
+        [[unlikely]] if (!result.has_value()) {
+          return unexpected{result.error()};
+        }
+      }
+      return range_insert(index, at_end,
+                          std::ranges::subrange{
+                              std::make_move_iterator(staged.begin()),
+                              std::make_move_iterator(staged.end())});
     } else {
+      if constexpr (std::ranges::forward_range<R> &&
+                    std::is_lvalue_reference_v<
+                        std::ranges::range_reference_t<R>> &&
+                    std::same_as<std::remove_cvref_t<
+                                     std::ranges::range_reference_t<R>>,
+                                 T>) {
+        // elements of this darray (e.g. d.append_range(d)), stage a copy
+        // of them first
+        std::optional<
+            darray<T, ThreadProtectionDisabled<T>, GrowthPolicy, Allocator>>
+            staged{};
+        {
+          [[maybe_unused]] const auto lock = read_lock();
+          if (range_aliases(range)) {
+            staged.emplace(get_allocator());
+            const expected<size_t, error> result = staged->append_range(range);
+            [[unlikely]] if (!result.has_value()) {
+              return unexpected{result.error()};
+            }
+          }
+        }
+        if (staged.has_value()) {
+          return range_insert(index, at_end,
+                              std::ranges::subrange{
+                                  std::make_move_iterator(staged->begin()),
+                                  std::make_move_iterator(staged->end())});
+        }
+      }
+      const size_t count = static_cast<size_t>(std::ranges::distance(range));
+      size_t insert_index = index;
+
+      const auto check_preconditions = [&](ProcessingData *const p_data)
+          -> expected<ProcessingData *const, error> {
+        if (at_end) {
+          insert_index = m_size;
+        }
+        if (insert_index > m_size) {
+          return unexpected{error{
+              format("Invalid insert criteria. Index ({}) beyond length of "
+                     "contiguous elements ({})",
+                     insert_index, m_size)}};
+        }
+        if (count > (alloc_traits::max_size(get_allocator()) - m_size)) {
+          return unexpected{error{format(
+              "Cannot insert {} elements into {} elements", count, m_size)}};
+        }
+        return {p_data};
+      };
+
+      const auto resize_to_fit = [&](ProcessingData *const p_data) {
+        return buffer_increase_to_fit(p_data, m_size + count);
+      };
+
+      const auto transfer_contents_as_needed =
+          [&](ProcessingData *const p_data)
+          -> expected<ProcessingData *const, error> {
+        return transfer_insert(p_data, insert_index, count);
+      };
+
+      const auto use_new_buffer_if_resized = [&](ProcessingData *const p_data)
+          -> expected<ProcessingData *const, error> {
+        if (p_data->buffer_resized.has_value()) {
+          m_buffer.swap(p_data->buffer_resized.value());
+          m_capacity = p_data->buffer_resized_capacity;
+        }
+        return {p_data};
+      };
+
+      // uninitialized_copy copies trivially copyable elements in bulk
+      const auto store_new_elements =
+          [&]([[maybe_unused]] ProcessingData *const p_data)
+          -> expected<size_t, error> {
+        T *const p_dest = m_buffer.get() + insert_index;
+        std::ranges::uninitialized_copy_n(std::ranges::begin(range),
+                                          static_cast<std::ptrdiff_t>(count),
+                                          p_dest, p_dest + count);
+        m_size += count;
+        return {m_size};
+      };
+
+      const auto process = [&]() -> expected<size_t, error> {
+        ProcessingData data{m_capacity};
+        return check_preconditions(&data)
+            .and_then(resize_to_fit)
+            .and_then(transfer_contents_as_needed)
+            .and_then(use_new_buffer_if_resized)
+            .and_then(store_new_elements);
+      };
+
+      [[maybe_unused]] const auto lock = write_lock();
       return process();
     }
   }
 
+public:
   //
   // delete
   //
   auto pop_back() noexcept -> expected<T, error> {
 
-    const auto resize_if_size_half_capacity =
+    const auto resize_if_policy_shrinks =
         [&](ProcessingData *const p_data) {
-          return buffer_decrease_if(p_data,
-                                    [&]() {
-                                      return (
-                                          (m_capacity > m_original_capacity) &&
-                                          (m_size <= (m_capacity >> 1)));
-                                    })
+          return buffer_decrease_if(p_data, m_size)
               // ignore buffer resize error, failure to allocate different
               // buffer does not invalidate any class invariants
               .or_else([p_data]([[maybe_unused]] error err)
@@ -597,12 +1380,14 @@ public:
 
       // pull element directly into return type so can be used for RVO, minimize
       // copy/move
-      expected<T, error> ret;
-      if constexpr (is_move_assignable_v<T>) {
-        ret = {std::move(m_buffer[--m_size])};
-      } else {
-        ret = {m_buffer[--m_size]};
-      }
+      expected<T, error> ret = [&]() -> expected<T, error> {
+        if constexpr (is_move_constructible_v<T>) {
+          return {std::move(m_buffer[--m_size])};
+        } else {
+          return {m_buffer[--m_size]};
+        }
+      }();
+      std::destroy_at(&m_buffer[m_size]);
 
       const auto transfer_contents_as_needed = [&](ProcessingData *const p_data)
           -> expected<ProcessingData *const, error> {
@@ -610,10 +1395,10 @@ public:
             [&](error err) -> expected<ProcessingData *const, error> {
               // transfer error? smaller buffer not used, so can safely place
               // element back to avoid data loss
-              if constexpr (is_move_assignable_v<T>) {
-                m_buffer[m_size++] = std::move(ret.value());
+              if constexpr (is_move_constructible_v<T>) {
+                std::construct_at(&m_buffer[m_size++], std::move(ret.value()));
               } else {
-                m_buffer[m_size++] = ret.value();
+                std::construct_at(&m_buffer[m_size++], ret.value());
               }
               return unexpected{err};
             });
@@ -621,7 +1406,7 @@ public:
 
       ProcessingData data{m_capacity};
       expected<ProcessingData *const, error> proc_result =
-          resize_if_size_half_capacity(&data)
+          resize_if_policy_shrinks(&data)
               .and_then(transfer_contents_as_needed)
               .and_then(use_new_buffer_if_resized);
 
@@ -631,12 +1416,8 @@ public:
       return unexpected{proc_result.error()};
     };
 
-    if constexpr (ThreadProtection::do_multithreaded_protection) {
-      const std::lock_guard<std::mutex> lock(m_mutex);
-      return process();
-    } else {
-      return process();
-    }
+    [[maybe_unused]] const auto lock = write_lock();
+    return process();
   }
 
   auto extract(const std::size_t index) noexcept -> std::expected<T, error> {
@@ -648,21 +1429,17 @@ public:
 
       // pull element directly into return type so can be used for RVO, minimize
       // copy/move
-      expected<T, error> ret;
-      if constexpr (is_move_assignable_v<T>) {
-        ret = {std::move(m_buffer[index])};
-      } else {
-        ret = {m_buffer[index]};
-      }
+      expected<T, error> ret = [&]() -> expected<T, error> {
+        if constexpr (is_move_constructible_v<T>) {
+          return {std::move(m_buffer[index])};
+        } else {
+          return {m_buffer[index]};
+        }
+      }();
 
-      const auto resize_if_size_half_capacity =
+      const auto resize_if_policy_shrinks =
           [&](ProcessingData *const p_data) {
-            return buffer_decrease_if(
-                       p_data,
-                       [&]() {
-                         return ((m_capacity > m_original_capacity) &&
-                                 ((m_size - 1) <= (m_capacity >> 1)));
-                       })
+            return buffer_decrease_if(p_data, m_size - 1)
                 // ignore buffer resize error, failure to allocate different
                 // buffer does not invalidate any class invariants
                 .or_else([p_data]([[maybe_unused]] error err)
@@ -677,10 +1454,10 @@ public:
             .or_else([&](error err) -> expected<ProcessingData *const, error> {
               // transfer error? smaller buffer not used, so can safely place
               // element back to avoid data loss
-              if constexpr (is_move_assignable_v<T>) {
-                m_buffer[index] = std::move(ret.value());
+              if constexpr (is_move_constructible_v<T>) {
+                std::construct_at(&m_buffer[index], std::move(ret.value()));
               } else {
-                m_buffer[index] = ret.value();
+                std::construct_at(&m_buffer[index], ret.value());
               }
               return unexpected{err};
             });
@@ -697,7 +1474,7 @@ public:
 
       ProcessingData data{m_capacity};
       expected<ProcessingData *const, error> proc_result =
-          resize_if_size_half_capacity(&data)
+          resize_if_policy_shrinks(&data)
               .and_then(transfer_contents_as_needed)
               .and_then(use_new_buffer_if_resized)
               .and_then([&](ProcessingData *const p_data)
@@ -712,12 +1489,204 @@ public:
       return unexpected{proc_result.error()};
     };
 
-    if constexpr (ThreadProtection::do_multithreaded_protection) {
-      const std::lock_guard<std::mutex> lock(m_mutex);
-      return process();
-    } else {
-      return process();
-    }
+    [[maybe_unused]] const auto lock = write_lock();
+    return process();
+  }
+
+  // erase elements [first, last), shifting the tail once and shrinking at
+  // most once, returns the new size
+  auto erase_range(const size_t first, const size_t last) noexcept
+      -> expected<size_t, error> {
+
+    const auto check_preconditions = [&](ProcessingData *const p_data)
+        -> expected<ProcessingData *const, error> {
+      if ((first > last) || (last > m_size)) {
+        return unexpected{error{
+            format("Invalid erase criteria. Range [{}, {}) beyond length of "
+                   "contiguous elements ({})",
+                   first, last, m_size)}};
+      }
+      return {p_data};
+    };
+
+    const auto resize_if_policy_shrinks = [&](ProcessingData *const p_data) {
+      return buffer_decrease_to_fit(p_data, m_size - (last - first))
+          // ignore buffer resize error, failure to allocate different
+          // buffer does not invalidate any class invariants
+          .or_else([p_data]([[maybe_unused]] error err)
+                       -> expected<ProcessingData *const, error> {
+            return {p_data};
+          });
+    };
+
+    const auto transfer_contents_as_needed = [&](ProcessingData *const p_data)
+        -> expected<ProcessingData *const, error> {
+      return transfer_erase(p_data, first, last - first);
+    };
+
+    const auto use_new_buffer_if_resized = [&](ProcessingData *const p_data)
+        -> expected<ProcessingData *const, error> {
+      if (p_data->buffer_resized.has_value()) {
+        m_buffer.swap(p_data->buffer_resized.value());
+        m_capacity = p_data->buffer_resized_capacity;
+      }
+      return {p_data};
+    };
+
+    const auto process = [&]() -> expected<size_t, error> {
+      ProcessingData data{m_capacity};
+      return check_preconditions(&data).and_then(
+          [&](ProcessingData *const p_data) -> expected<size_t, error> {
+            [[unlikely]] if (first == last) { return {m_size}; }
+            return resize_if_policy_shrinks(p_data)
+                .and_then(transfer_contents_as_needed)
+                .and_then(use_new_buffer_if_resized)
+                .and_then([&]([[maybe_unused]] ProcessingData *const p_done)
+                              -> expected<size_t, error> {
+                  m_size -= (last - first);
+                  return {m_size};
+                });
+          });
+    };
+
+    [[maybe_unused]] const auto lock = write_lock();
+    return process();
+  }
+
+  // erase every element matching predicate in a single compacting pass,
+  // keeping the order of the rest, shrinking at most once at the end
+  // returns the number of elements erased
+  template <typename Predicate>
+    requires std::predicate<Predicate &, const T &>
+  auto erase_if(Predicate predicate) noexcept -> expected<size_t, error> {
+
+    // erased elements are destroyed in place, kept elements are transferred
+    // one at a time into the gap, short single element transfers inline where
+    // a call per run of kept elements would not
+    const auto compact = [&](ProcessingData *const p_data)
+        -> expected<ProcessingData *const, error> {
+      size_t write = 0;
+      for (size_t read = 0; read < m_size; read++) {
+        if (predicate(std::as_const(m_buffer[read]))) {
+          std::destroy_at(&m_buffer[read]);
+          continue;
+        }
+        if (write != read) {
+          buffer_transfer<TransferMethodDirect>(
+              span<T, 1>{&(m_buffer.get()[read]), 1},
+              span<T, 1>{&(m_buffer.get()[write]), 1});
+        }
+        write++;
+      }
+      m_size = write;
+      return {p_data};
+    };
+
+    const auto resize_if_policy_shrinks = [&](ProcessingData *const p_data) {
+      return buffer_decrease_to_fit(p_data, m_size)
+          // ignore buffer resize error, failure to allocate different
+          // buffer does not invalidate any class invariants
+          .or_else([p_data]([[maybe_unused]] error err)
+                       -> expected<ProcessingData *const, error> {
+            return {p_data};
+          });
+    };
+
+    const auto transfer_if_resized = [&](ProcessingData *const p_data)
+        -> expected<ProcessingData *const, error> {
+      return transfer_direct_if_buffer_resized(p_data);
+    };
+
+    const auto use_new_buffer_if_resized = [&](ProcessingData *const p_data)
+        -> expected<ProcessingData *const, error> {
+      if (p_data->buffer_resized.has_value()) {
+        m_buffer.swap(p_data->buffer_resized.value());
+        m_capacity = p_data->buffer_resized_capacity;
+      }
+      return {p_data};
+    };
+
+    const auto process = [&]() -> expected<size_t, error> {
+      const size_t size_before = m_size;
+      ProcessingData data{m_capacity};
+      return compact(&data)
+          .and_then(resize_if_policy_shrinks)
+          .and_then(transfer_if_resized)
+          .and_then(use_new_buffer_if_resized)
+          .and_then([&]([[maybe_unused]] ProcessingData *const p_data)
+                        -> expected<size_t, error> {
+            return {size_before - m_size};
+          });
+    };
+
+    [[maybe_unused]] const auto lock = write_lock();
+    return process();
+  }
+
+  // remove the element at index in O(1), the last element takes its place,
+  // so order is not kept
+  auto swap_remove(const size_t index) noexcept -> expected<T, error> {
+
+    auto process = [&]() -> expected<T, error> {
+      [[unlikely]] if (index >= m_size) {
+        return unexpected{error{format("Cannot remove, index too large")}};
+      }
+
+      // pull element directly into return type so can be used for RVO, minimize
+      // copy/move
+      expected<T, error> ret = [&]() -> expected<T, error> {
+        if constexpr (is_move_constructible_v<T>) {
+          return {std::move(m_buffer[index])};
+        } else {
+          return {m_buffer[index]};
+        }
+      }();
+      std::destroy_at(&m_buffer[index]);
+      if (index != --m_size) {
+        buffer_transfer<TransferMethodDirect>(
+            span{&(m_buffer.get()[m_size]), 1},
+            span{&(m_buffer.get()[index]), 1});
+      }
+
+      const auto resize_if_policy_shrinks =
+          [&](ProcessingData *const p_data) {
+            return buffer_decrease_if(p_data, m_size)
+                // ignore buffer resize error, failure to allocate different
+                // buffer does not invalidate any class invariants
+                .or_else([p_data]([[maybe_unused]] error err)
+                             -> expected<ProcessingData *const, error> {
+                  return {p_data};
+                });
+          };
+
+      const auto transfer_if_resized = [&](ProcessingData *const p_data)
+          -> expected<ProcessingData *const, error> {
+        return transfer_direct_if_buffer_resized(p_data);
+      };
+
+      const auto use_new_buffer_if_resized = [&](ProcessingData *const p_data)
+          -> expected<ProcessingData *const, error> {
+        if (p_data->buffer_resized.has_value()) {
+          m_buffer.swap(p_data->buffer_resized.value());
+          m_capacity = p_data->buffer_resized_capacity;
+        }
+        return {p_data};
+      };
+
+      ProcessingData data{m_capacity};
+      expected<ProcessingData *const, error> proc_result =
+          resize_if_policy_shrinks(&data)
+              .and_then(transfer_if_resized)
+              .and_then(use_new_buffer_if_resized);
+
+      if (proc_result.has_value()) {
+        return ret;
+      }
+      return unexpected{proc_result.error()};
+    };
+
+    [[maybe_unused]] const auto lock = write_lock();
+    return process();
   }
 
   auto clear() noexcept -> std::expected<void, error> {
@@ -725,48 +1694,36 @@ public:
     const auto resize_if_not_original_size = [&](ProcessingData *const p_data)
         -> expected<ProcessingData *const, error> {
       return buffer_reset_original_capacity_if(
-                 p_data, [&]() { return m_capacity > m_original_capacity; })
-          .and_then([&](ProcessingData *const p_data)
-                        -> expected<ProcessingData *const, error> {
-            if (false == p_data->buffer_resized.has_value()) {
-              return {p_data};
-            }
-            m_buffer.swap(p_data->buffer_resized.value());
-            m_capacity = p_data->buffer_resized_capacity;
-            m_size = 0;
-            return {p_data};
-          });
+          p_data, [&]() { return m_capacity > m_original_capacity; });
     };
 
-    const auto clear_elements_if_not_resized = [&](ProcessingData *const p_data)
+    const auto destroy_elements = [&](ProcessingData *const p_data)
         -> expected<ProcessingData *const, error> {
-      for_each(span{m_buffer.get(), m_size},
-               [&, idx = 0]([[maybe_unused]] T &element) mutable {
-                 if constexpr (is_move_assignable_v<T>) {
-                   m_buffer[idx++] = T{};
-                 } else {
-                   T default_element{};
-                   m_buffer[idx++] = default_element;
-                 }
-               });
+      std::destroy_n(m_buffer.get(), m_size);
       m_size = 0;
       return {p_data};
     };
 
+    const auto use_new_buffer_if_resized = [&](ProcessingData *const p_data)
+        -> expected<ProcessingData *const, error> {
+      if (p_data->buffer_resized.has_value()) {
+        m_buffer.swap(p_data->buffer_resized.value());
+        m_capacity = p_data->buffer_resized_capacity;
+      }
+      return {p_data};
+    };
+
     const auto process = [&]() {
       ProcessingData data{m_capacity};
       return resize_if_not_original_size(&data)
-          .and_then(clear_elements_if_not_resized)
+          .and_then(destroy_elements)
+          .and_then(use_new_buffer_if_resized)
           .and_then([]([[maybe_unused]] ProcessingData *const p_data)
                         -> expected<void, error> { return {}; });
     };
 
-    if constexpr (ThreadProtection::do_multithreaded_protection) {
-      const std::lock_guard<std::mutex> lock(m_mutex);
-      return process();
-    } else {
-      return process();
-    }
+    [[maybe_unused]] const auto lock = write_lock();
+    return process();
   }
 
   //
@@ -781,60 +1738,62 @@ public:
     using pointer = element_type *;
     using reference = element_type &;
 
-    iterator() = default;
-    explicit iterator(pointer p) { m_ptr = p; }
+    constexpr iterator() = default;
+    constexpr explicit iterator(pointer p) { m_ptr = p; }
 
-    reference operator*() const { return *m_ptr; }
-    pointer operator->() const { return m_ptr; }
+    constexpr reference operator*() const { return *m_ptr; }
+    constexpr pointer operator->() const { return m_ptr; }
 
-    iterator &operator++() {
+    constexpr iterator &operator++() {
       m_ptr++;
       return *this;
     }
-    iterator operator++(int) {
+    constexpr iterator operator++(int) {
       iterator tmp = *this;
       ++(*this);
       return tmp;
     }
-    iterator &operator+=(int i) {
+    constexpr iterator &operator+=(int i) {
       m_ptr += i;
       return *this;
     }
-    iterator operator+(const difference_type other) const {
+    constexpr iterator operator+(const difference_type other) const {
       return iterator{m_ptr + other};
     }
-    friend iterator operator+(const difference_type value,
-                              const iterator &other) {
+    friend constexpr iterator operator+(const difference_type value,
+                                        const iterator &other) {
       return iterator{other + value};
     }
 
-    iterator &operator--() {
+    constexpr iterator &operator--() {
       m_ptr--;
       return *this;
     }
-    iterator operator--(int) {
+    constexpr iterator operator--(int) {
       iterator tmp = *this;
       --(*this);
       return tmp;
     }
-    iterator &operator-=(int i) {
+    constexpr iterator &operator-=(int i) {
       m_ptr -= i;
       return *this;
     }
-    difference_type operator-(const iterator &other) const {
+    constexpr difference_type operator-(const iterator &other) const {
       return m_ptr - other.m_ptr;
     }
-    iterator operator-(const difference_type other) const {
+    constexpr iterator operator-(const difference_type other) const {
       return iterator{m_ptr - other};
     }
-    friend iterator operator-(const difference_type value,
-                              const iterator &other) {
+    friend constexpr iterator operator-(const difference_type value,
+                                        const iterator &other) {
       return iterator{other - value};
     }
 
-    reference operator[](difference_type idx) const { return m_ptr[idx]; }
+    constexpr reference operator[](difference_type idx) const {
+      return m_ptr[idx];
+    }
 
-    auto operator<=>(const iterator &) const = default;
+    constexpr auto operator<=>(const iterator &) const = default;
 
   private:
     pointer m_ptr;
@@ -844,6 +1803,21 @@ public:
     return iterator{&(m_buffer.get()[m_size])};
   }
 
+  //
+  // access - contiguous buffer, for C and system call interfaces (write,
+  // io_uring, ...), valid until the next store or extract, as iterators
+  //
+  auto data() const noexcept -> T * { return m_buffer.get(); }
+  auto as_span() const noexcept -> span<T> {
+    return span<T>{m_buffer.get(), m_size};
+  }
+  // object representation of the elements
+  auto as_bytes() const noexcept -> span<const std::byte>
+    requires is_trivially_copyable_v<T>
+  {
+    return std::as_bytes(as_span());
+  }
+
   //
   // access - random
   //
@@ -858,20 +1832,12 @@ public:
       return {iterator{&(m_buffer[idx])}};
     };
 
-    if constexpr (ThreadProtection::do_multithreaded_protection) {
-      const std::lock_guard<std::mutex> lock(m_mutex);
-      return process();
-    } else {
-      return process();
-    }
+    [[maybe_unused]] const auto lock = read_lock();
+    return process();
   }
   auto operator[](std::size_t idx) const -> T & {
-    if constexpr (ThreadProtection::do_multithreaded_protection) {
-      const std::lock_guard<std::mutex> lock(m_mutex);
-      return m_buffer[idx];
-    } else {
-      return m_buffer[idx];
-    }
+    [[maybe_unused]] const auto lock = read_lock();
+    return m_buffer[idx];
   }
 
   //
@@ -879,31 +1845,16 @@ public:
   //
 
   [[nodiscard]] auto capacity() const noexcept -> expected<std::size_t, error> {
-    if constexpr (ThreadProtection::do_multithreaded_protection) {
-      const std::lock_guard<std::mutex> lock(m_mutex);
-      return {m_capacity};
-    } else {
-      return {m_capacity};
-    }
+    return {read_metadata().m_capacity};
   }
 
   [[nodiscard]] auto size() const noexcept
       -> std::expected<std::size_t, error> {
-    if constexpr (ThreadProtection::do_multithreaded_protection) {
-      const std::lock_guard<std::mutex> lock(m_mutex);
-      return {m_size};
-    } else {
-      return {m_size};
-    }
+    return {read_metadata().m_size};
   }
 
   [[nodiscard]] auto is_empty() const noexcept -> std::expected<bool, error> {
-    if constexpr (ThreadProtection::do_multithreaded_protection) {
-      const std::lock_guard<std::mutex> lock(m_mutex);
-      return {(0 == m_size)};
-    } else {
-      return {(0 == m_size)};
-    }
+    return {(0 == read_metadata().m_size)};
   }
 
   // non-monadic (plain-old-data return value) metadata accessors
@@ -915,30 +1866,15 @@ public:
 
   public:
     [[nodiscard]] constexpr auto capacity() const noexcept -> std::size_t {
-      if constexpr (ThreadProtection::do_multithreaded_protection) {
-        const std::lock_guard<std::mutex> lock(m_darray.m_mutex);
-        return m_darray.m_capacity;
-      } else {
-        return m_darray.m_capacity;
-      }
+      return m_darray.read_metadata().m_capacity;
     }
 
     [[nodiscard]] constexpr auto size() const noexcept -> std::size_t {
-      if constexpr (ThreadProtection::do_multithreaded_protection) {
-        const std::lock_guard<std::mutex> lock(m_darray.m_mutex);
-        return m_darray.m_size;
-      } else {
-        return m_darray.m_size;
-      }
+      return m_darray.read_metadata().m_size;
     }
 
     [[nodiscard]] constexpr auto is_empty() const noexcept -> bool {
-      if constexpr (ThreadProtection::do_multithreaded_protection) {
-        const std::lock_guard<std::mutex> lock(m_darray.m_mutex);
-        return (0 == m_darray.m_size);
-      } else {
-        return (0 == m_darray.m_size);
-      }
+      return (0 == m_darray.read_metadata().m_size);
     }
   };
   // get plain-old-data metadata accessor
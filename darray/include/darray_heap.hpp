@@ -0,0 +1,553 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#pragma once
+
+#include "darray.hpp"
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef> // size_t & byte
+#include <expected>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+namespace CppPlay {
+
+// handle policies of darray_heap
+// - disabled: elements only, push returns the new size
+// - enabled: every element carries a handle, push returns it, the element
+//   can then be re-prioritized (update, decrease_key) wherever it moved to
+struct HeapHandlesDisabled {};
+struct HeapHandlesEnabled {};
+
+// d-ary heap (priority queue) stored in a darray, top is the element ordered
+// last by Compare, as std::priority_queue (std::less: largest on top)
+// - the D children of a node are contiguous, a sift down compares them in
+//   one or two cache lines and the tree is log(D) times shallower than a
+//   binary heap, fewer levels miss the cache on large heaps
+// - sifts move a hole instead of swapping, each level moves one element
+// Compare and moves of T must not throw
+// no thread protection, protect the owner if shared
+template <typename T, typename Compare = std::less<T>, size_t D = 4,
+          typename Handles = HeapHandlesDisabled>
+  requires(D >= 2) && std::strict_weak_order<Compare &, const T &, const T &>
+class darray_heap {
+public:
+  using value_type = T;
+  using handle_type = size_t;
+
+private:
+  static constexpr bool s_handles = std::is_same_v<Handles, HeapHandlesEnabled>;
+  static constexpr size_t s_no_position = std::numeric_limits<size_t>::max();
+  static constexpr size_t s_cache_line = 64;
+
+  struct handle_node {
+    T m_value;
+    handle_type m_handle;
+  };
+  using node_type = std::conditional_t<s_handles, handle_node, T>;
+  template <typename U>
+  using storage_type =
+      darray<U, ThreadProtectionDisabled<U>, GrowthPolicyDouble<U>>;
+
+  storage_type<node_type> m_nodes;
+  // handle -> node index, s_no_position for handles free for reuse
+  storage_type<size_t> m_positions;
+  storage_type<handle_type> m_free_handles;
+  [[no_unique_address]] Compare m_compare;
+
+  constinit static const size_t DEFAULT_RESERVE_SIZE = 8;
+
+  explicit darray_heap(const size_t capacity, Compare compare)
+      : m_nodes{typename storage_type<node_type>::builder{}
+                    .capacity(capacity)
+                    .build()},
+        m_positions{typename storage_type<size_t>::builder{}
+                        .capacity(s_handles ? capacity : 0)
+                        .build()},
+        m_compare{std::move(compare)} {}
+
+  static auto value_of(node_type &node) noexcept -> T & {
+    if constexpr (s_handles) {
+      return node.m_value;
+    } else {
+      return node;
+    }
+  }
+
+  [[nodiscard]] auto nodes() const noexcept -> node_type * {
+    return m_nodes.data();
+  }
+  [[nodiscard]] auto node_count() const noexcept -> size_t {
+    return m_nodes.pod().size();
+  }
+
+  // put node at idx, keeping its handle's position
+  auto place(node_type *const p_nodes, const size_t idx, node_type &&node)
+      -> void {
+    p_nodes[idx] = std::move(node);
+    if constexpr (s_handles) {
+      m_positions[p_nodes[idx].m_handle] = idx;
+    }
+  }
+
+  // the hole at idx moves up while node orders after the parent
+  auto sift_up(size_t idx, node_type node) -> void {
+    node_type *const p_nodes = nodes();
+    while (idx > 0) {
+      const size_t parent = (idx - 1) / D;
+      if (!m_compare(value_of(p_nodes[parent]), value_of(node))) {
+        break;
+      }
+      place(p_nodes, idx, std::move(p_nodes[parent]));
+      idx = parent;
+    }
+    place(p_nodes, idx, std::move(node));
+  }
+
+  // the D * D grandchildren of idx are contiguous, fetching them while the
+  // children are compared overlaps the cache misses of the next level with
+  // this one, branchless sifts give the cpu nothing to speculate on
+  static auto prefetch_grandchildren(const node_type *const p_nodes,
+                                     const size_t idx,
+                                     const size_t count) noexcept -> void {
+    const size_t first = (D * D * idx) + D + 1;
+    if (first >= count) {
+      return;
+    }
+    const size_t bytes = std::min(D * D, count - first) * sizeof(node_type);
+    const auto *const p_bytes =
+        reinterpret_cast<const std::byte *>(&p_nodes[first]);
+    for (size_t offset = 0; offset < bytes; offset += s_cache_line) {
+      __builtin_prefetch(p_bytes + offset);
+    }
+  }
+
+  // right when right_wins, else left, without a branch, comparisons of
+  // random keys are unpredictable and compilers emit branches for a ternary
+  static constexpr auto select_index(const bool right_wins, const size_t left,
+                                     const size_t right) noexcept -> size_t {
+    return left +
+           ((right - left) & (size_t{0} - static_cast<size_t>(right_wins)));
+  }
+
+  // index ordered last of the COUNT nodes from first, as a tournament of
+  // pairs, the comparisons of a round do not depend on each other
+  template <size_t COUNT>
+  auto best_of(node_type *const p_nodes, const size_t first) -> size_t {
+    if constexpr (COUNT == 1) {
+      return first;
+    } else {
+      const size_t left = best_of<COUNT / 2>(p_nodes, first);
+      const size_t right =
+          best_of<COUNT - (COUNT / 2)>(p_nodes, first + (COUNT / 2));
+      return select_index(
+          m_compare(value_of(p_nodes[left]), value_of(p_nodes[right])), left,
+          right);
+    }
+  }
+
+  // child of first_child's parent ordered last, all but the last parent have
+  // a full set of D children
+  auto best_child(node_type *const p_nodes, const size_t first_child,
+                  const size_t count) -> size_t {
+    if ((first_child + D) <= count) [[likely]] {
+      return best_of<D>(p_nodes, first_child);
+    }
+    size_t best = first_child;
+    for (size_t child = first_child + 1; child < count; child++) {
+      best = select_index(
+          m_compare(value_of(p_nodes[best]), value_of(p_nodes[child])), best,
+          child);
+    }
+    return best;
+  }
+
+  // the hole at idx moves down while a child orders after node
+  auto sift_down(size_t idx, node_type node) -> void {
+    node_type *const p_nodes = nodes();
+    const size_t count = node_count();
+    for (size_t first_child = (D * idx) + 1; first_child < count;
+         first_child = (D * idx) + 1) {
+      prefetch_grandchildren(p_nodes, idx, count);
+      const size_t best = best_child(p_nodes, first_child, count);
+      if (!m_compare(value_of(node), value_of(p_nodes[best]))) {
+        break;
+      }
+      place(p_nodes, idx, std::move(p_nodes[best]));
+      idx = best;
+    }
+    place(p_nodes, idx, std::move(node));
+  }
+
+  // the hole at the top moves down to a leaf along the children ordered last,
+  // then node moves up from there, a node taken from the bottom (pop) usually
+  // belongs near the bottom, so this saves the comparison with node at every
+  // level of a plain sift down
+  auto sift_down_from_top(node_type node) -> void {
+    node_type *const p_nodes = nodes();
+    const size_t count = node_count();
+    size_t idx = 0;
+    for (size_t first_child = 1; first_child < count;
+         first_child = (D * idx) + 1) {
+      prefetch_grandchildren(p_nodes, idx, count);
+      const size_t best = best_child(p_nodes, first_child, count);
+      place(p_nodes, idx, std::move(p_nodes[best]));
+      idx = best;
+    }
+    sift_up(idx, std::move(node));
+  }
+
+  // move the node at idx, whose value changed, to where it now belongs
+  auto restore(const size_t idx) -> void {
+    node_type *const p_nodes = nodes();
+    node_type node = std::move(p_nodes[idx]);
+    if ((idx > 0) &&
+        m_compare(value_of(p_nodes[(idx - 1) / D]), value_of(node))) {
+      sift_up(idx, std::move(node));
+    } else {
+      sift_down(idx, std::move(node));
+    }
+  }
+
+  // every parent, last first, so the nodes form a heap
+  auto sift_down_all() -> void {
+    const size_t count = node_count();
+    if (count > 1) {
+      node_type *const p_nodes = nodes();
+      for (size_t idx = ((count - 2) / D) + 1; idx-- > 0;) {
+        sift_down(idx, std::move(p_nodes[idx]));
+      }
+    }
+  }
+
+  [[nodiscard]] auto position_of(const handle_type handle) const noexcept
+      -> expected<size_t, error> {
+    [[unlikely]] if ((handle >= m_positions.pod().size()) ||
+                     (s_no_position == m_positions[handle])) {
+      return unexpected{error{format("Handle {} not in heap", handle)}};
+    }
+    return {m_positions[handle]};
+  }
+
+  auto acquire_handle() noexcept -> expected<handle_type, error> {
+    if (!m_free_handles.pod().is_empty()) {
+      return m_free_handles.pop_back();
+    }
+    const handle_type handle = m_positions.pod().size();
+    return m_positions.push_back(s_no_position).transform(
+        [handle]([[maybe_unused]] size_t size) { return handle; });
+  }
+
+  auto release_handle(const handle_type handle) noexcept -> void {
+    m_positions[handle] = s_no_position;
+    // ignore a failed push, the handle is then never reused
+    static_cast<void>(m_free_handles.push_back(handle));
+  }
+
+  template <typename U>
+  auto push_node(U &&new_element) noexcept -> expected<handle_type, error> {
+    if constexpr (s_handles) {
+      return acquire_handle().and_then(
+          [&](const handle_type handle) -> expected<handle_type, error> {
+            return m_nodes
+                .push_back(
+                    handle_node{T{std::forward<U>(new_element)}, handle})
+                .transform([&](const size_t size) {
+                  sift_up(size - 1, std::move(nodes()[size - 1]));
+                  return handle;
+                })
+                .or_else([&](error err) -> expected<handle_type, error> {
+                  release_handle(handle);
+                  return unexpected{err};
+                });
+          });
+    } else {
+      return m_nodes.push_back(std::forward<U>(new_element))
+          .transform([&](const size_t size) {
+            sift_up(size - 1, std::move(nodes()[size - 1]));
+            return size;
+          });
+    }
+  }
+
+public:
+  //
+  // special member functions
+  //
+  darray_heap() : darray_heap{DEFAULT_RESERVE_SIZE, Compare{}} {}
+  explicit darray_heap(Compare compare)
+      : darray_heap{DEFAULT_RESERVE_SIZE, std::move(compare)} {}
+  darray_heap(const darray_heap &other) = default;
+  auto operator=(const darray_heap &other) -> darray_heap & = default;
+  darray_heap(darray_heap &&other) noexcept = default;
+  auto operator=(darray_heap &&other) noexcept -> darray_heap & = default;
+  ~darray_heap() = default;
+
+  //
+  // darray_heap builder helper
+  //
+  class builder {
+    size_t m_initial_capacity = DEFAULT_RESERVE_SIZE;
+    Compare m_compare{};
+
+  public:
+    constexpr auto capacity(size_t capacity) noexcept -> builder & {
+      m_initial_capacity = capacity;
+      return *this;
+    };
+    auto compare(Compare compare) noexcept -> builder & {
+      m_compare = std::move(compare);
+      return *this;
+    };
+    [[nodiscard]] auto build() const noexcept -> darray_heap {
+      return darray_heap{m_initial_capacity, m_compare};
+    };
+  };
+  friend builder;
+
+  //
+  // store
+  //
+  // returns the new size
+  template <typename U>
+    requires std::constructible_from<T, U &&> && (!s_handles)
+  auto push(U &&new_element) noexcept -> expected<size_t, error> {
+    return push_node(std::forward<U>(new_element));
+  }
+  // returns the handle of the element, valid until it leaves the heap
+  template <typename U>
+    requires std::constructible_from<T, U &&> && s_handles
+  auto push(U &&new_element) noexcept -> expected<handle_type, error> {
+    return push_node(std::forward<U>(new_element));
+  }
+
+  // add the elements of range and restore the heap bottom-up, O(n) instead
+  // of O(n log n) for n pushes, sized ranges grow the nodes once, on failure
+  // the heap is unchanged, returns the new size
+  template <std::ranges::input_range R>
+    requires std::constructible_from<T, std::ranges::range_reference_t<R>> &&
+             (!s_handles)
+  auto heapify(R &&range) noexcept -> expected<size_t, error> {
+    return m_nodes.append_range(std::forward<R>(range))
+        .transform([&](const size_t count) {
+          sift_down_all();
+          return count;
+        });
+  }
+  // as above, the elements of range get consecutive handles in range order,
+  // returns the first of them
+  template <std::ranges::input_range R>
+    requires std::constructible_from<T, std::ranges::range_reference_t<R>> &&
+             s_handles
+  auto heapify(R &&range) noexcept -> expected<handle_type, error> {
+    const size_t old_count = node_count();
+    const handle_type first = m_positions.pod().size();
+    return m_nodes
+        .append_range(std::forward<R>(range) |
+                      std::views::transform([](auto &&element) {
+                        return handle_node{
+                            T{std::forward<decltype(element)>(element)},
+                            s_no_position};
+                      }))
+        .and_then([&](const size_t count) -> expected<handle_type, error> {
+          // handle first + n is the node at old_count + n until the sifts
+          const size_t added = count - old_count;
+          const auto positions =
+              m_positions.append_with(added, [&](size_t *const p_positions) {
+                for (size_t offset = 0; offset < added; offset++) {
+                  p_positions[offset] = old_count + offset;
+                }
+                return added;
+              });
+          [[unlikely]] if (!positions.has_value()) {
+            // drop the elements added, the heap is unchanged
+            while (node_count() > old_count) {
+              static_cast<void>(m_nodes.pop_back());
+            }
+            return unexpected{positions.error()};
+          }
+          node_type *const p_nodes = nodes();
+          for (size_t idx = old_count; idx < count; idx++) {
+            p_nodes[idx].m_handle = first + (idx - old_count);
+          }
+          sift_down_all();
+          return {first};
+        });
+  }
+
+  //
+  // extract
+  //
+  auto pop() noexcept -> expected<T, error> {
+    [[unlikely]] if (0 == node_count()) {
+      return unexpected{error{format("No elements to pop")}};
+    }
+    // pop_back of a non-empty darray never fails, shrinking is best effort
+    node_type last = std::move(m_nodes.pop_back().value());
+    if (0 == node_count()) {
+      if constexpr (s_handles) {
+        release_handle(last.m_handle);
+      }
+      return {std::move(value_of(last))};
+    }
+    node_type top = std::move(nodes()[0]);
+    sift_down_from_top(std::move(last));
+    if constexpr (s_handles) {
+      release_handle(top.m_handle);
+    }
+    return {std::move(value_of(top))};
+  }
+
+  // push new_element then pop, in one sift: new_element is returned at once
+  // when it would be the top, otherwise it replaces the top
+  template <typename U>
+    requires std::constructible_from<T, U &&> && (!s_handles)
+  auto push_pop(U &&new_element) noexcept -> expected<T, error> {
+    T element{std::forward<U>(new_element)};
+    if ((0 == node_count()) || !m_compare(element, nodes()[0])) {
+      return {std::move(element)};
+    }
+    T top = std::move(nodes()[0]);
+    sift_down(0, std::move(element));
+    return {std::move(top)};
+  }
+
+  auto clear() noexcept -> expected<void, error> {
+    if constexpr (s_handles) {
+      for (node_type &node : m_nodes) {
+        release_handle(node.m_handle);
+      }
+    }
+    return m_nodes.clear();
+  }
+
+  //
+  // update
+  //
+  // replace the value of handle's element, moving it up or down
+  template <typename U>
+    requires std::assignable_from<T &, U &&> && s_handles
+  auto update(const handle_type handle, U &&new_value) noexcept
+      -> expected<void, error> {
+    return position_of(handle).transform([&](const size_t idx) {
+      nodes()[idx].m_value = std::forward<U>(new_value);
+      restore(idx);
+    });
+  }
+
+  // replace the value of handle's element by one ordered after it (closer to
+  // the top), the decrease-key of a min-heap
+  template <typename U>
+    requires std::assignable_from<T &, U &&> && s_handles
+  auto decrease_key(const handle_type handle, U &&new_value) noexcept
+      -> expected<void, error> {
+    return position_of(handle).and_then(
+        [&](const size_t idx) -> expected<void, error> {
+          node_type *const p_nodes = nodes();
+          [[unlikely]] if (m_compare(new_value, p_nodes[idx].m_value)) {
+            return unexpected{error{
+                format("New value of handle {} moves it away from the top",
+                       handle)}};
+          }
+          p_nodes[idx].m_value = std::forward<U>(new_value);
+          sift_up(idx, std::move(p_nodes[idx]));
+          return {};
+        });
+  }
+
+  //
+  // access
+  //
+  // top element, valid until the next change to the heap
+  [[nodiscard]] auto top() const noexcept
+      -> expected<std::reference_wrapper<const T>, error> {
+    [[unlikely]] if (0 == node_count()) {
+      return unexpected{error{format("No top element, heap is empty")}};
+    }
+    return {std::cref(value_of(nodes()[0]))};
+  }
+
+  // value of handle's element
+  [[nodiscard]] auto at(const handle_type handle) const noexcept
+      -> expected<std::reference_wrapper<const T>, error>
+    requires s_handles
+  {
+    return position_of(handle).transform(
+        [&](const size_t idx) { return std::cref(nodes()[idx].m_value); });
+  }
+
+  [[nodiscard]] auto contains(const handle_type handle) const noexcept -> bool
+    requires s_handles
+  {
+    return position_of(handle).has_value();
+  }
+
+  //
+  // metadata
+  //
+  [[nodiscard]] auto capacity() const noexcept -> expected<size_t, error> {
+    return m_nodes.capacity();
+  }
+  [[nodiscard]] auto size() const noexcept -> expected<size_t, error> {
+    return {node_count()};
+  }
+  [[nodiscard]] auto is_empty() const noexcept -> expected<bool, error> {
+    return {(0 == node_count())};
+  }
+
+  // non-monadic (plain-old-data return value) metadata accessors
+  class pod_metadata_accessor {
+    const darray_heap &m_heap;
+    constexpr explicit pod_metadata_accessor(const darray_heap &heap_obj)
+        : m_heap{heap_obj} {}
+    friend darray_heap;
+
+  public:
+    [[nodiscard]] auto capacity() const noexcept -> size_t {
+      return m_heap.m_nodes.pod().capacity();
+    }
+    [[nodiscard]] auto size() const noexcept -> size_t {
+      return m_heap.node_count();
+    }
+    [[nodiscard]] auto is_empty() const noexcept -> bool {
+      return (0 == m_heap.node_count());
+    }
+  };
+  // get plain-old-data metadata accessor
+  [[nodiscard]] constexpr auto pod() const noexcept
+      -> const pod_metadata_accessor {
+    return pod_metadata_accessor{*this};
+  }
+};
+
+} // namespace CppPlay
@@ -0,0 +1,306 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#pragma once
+
+
+#include "darray.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <climits> // IOV_MAX
+#include <cstddef> // size_t & byte
+#include <cstring>
+#include <expected>
+#include <ranges>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace CppPlay {
+
+#if defined(__linux__)
+
+// contiguous range whose elements can be written as their bytes (darray,
+// span, std::vector, ...)
+template <typename R>
+concept byte_writable_range =
+    std::ranges::contiguous_range<R> && std::ranges::sized_range<R> &&
+    std::is_trivially_copyable_v<std::ranges::range_value_t<R>>;
+
+namespace detail {
+
+[[nodiscard]] inline auto io_error(const char *const operation) noexcept
+    -> unexpected<error> {
+  return unexpected{
+      error{format("Cannot {}: {}", operation, std::strerror(errno))}};
+}
+
+// write all count bytes at offset, or at the file position when offset is
+// negative, retrying interrupted and partial writes
+inline auto write_fully(const int fd, const std::byte *p_bytes, size_t count,
+                        off_t offset = -1) noexcept -> expected<void, error> {
+  while (count > 0) {
+    const ssize_t written = (offset < 0) ? write(fd, p_bytes, count)
+                                         : pwrite(fd, p_bytes, count, offset);
+    if (written < 0) {
+      if (EINTR == errno) {
+        continue;
+      }
+      return io_error("write");
+    }
+    p_bytes += written;
+    count -= static_cast<size_t>(written);
+    offset = (offset < 0) ? offset : (offset + static_cast<off_t>(written));
+  }
+  return {};
+}
+
+// read count bytes at offset (or the file position), fewer only at the end
+// of the file
+[[nodiscard]] inline auto read_fully(const int fd, std::byte *p_bytes,
+                                     const size_t count,
+                                     off_t offset = -1) noexcept
+    -> expected<size_t, error> {
+  size_t total = 0;
+  while (total < count) {
+    const ssize_t got =
+        (offset < 0) ? read(fd, &p_bytes[total], count - total)
+                     : pread(fd, &p_bytes[total], count - total, offset);
+    if (got < 0) {
+      if (EINTR == errno) {
+        continue;
+      }
+      return io_error("read");
+    }
+    if (0 == got) {
+      break;
+    }
+    total += static_cast<size_t>(got);
+    offset = (offset < 0) ? offset : (offset + static_cast<off_t>(got));
+  }
+  return {total};
+}
+
+// write every byte of count iovecs at offset (or the file position), IOV_MAX
+// at a time, a partial write resumes mid iovec, the iovecs are consumed
+inline auto writev_fully(const int fd, iovec *p_iovecs, size_t count,
+                         off_t offset = -1) noexcept
+    -> expected<size_t, error> {
+  size_t total = 0;
+  while (count > 0) {
+    const auto batch =
+        static_cast<int>(std::min(count, static_cast<size_t>(IOV_MAX)));
+    const ssize_t written = (offset < 0)
+                                ? writev(fd, p_iovecs, batch)
+                                : pwritev(fd, p_iovecs, batch, offset);
+    if (written < 0) {
+      if (EINTR == errno) {
+        continue;
+      }
+      return io_error("write");
+    }
+    total += static_cast<size_t>(written);
+    offset = (offset < 0) ? offset : (offset + static_cast<off_t>(written));
+    auto left = static_cast<size_t>(written);
+    while ((count > 0) && (left >= p_iovecs->iov_len)) {
+      left -= p_iovecs->iov_len;
+      p_iovecs++;
+      count--;
+    }
+    if (count > 0) {
+      p_iovecs->iov_base = static_cast<std::byte *>(p_iovecs->iov_base) + left;
+      p_iovecs->iov_len -= left;
+    }
+  }
+  return {total};
+}
+
+template <byte_writable_range R>
+[[nodiscard]] auto iovec_of(const R &buffer) noexcept -> iovec {
+  // iovec is a C interface, it takes a non-const base even for writes
+  return iovec{const_cast<void *>(static_cast<const void *>(
+                   std::ranges::data(buffer))),
+               static_cast<size_t>(std::ranges::size(buffer)) *
+                   sizeof(std::ranges::range_value_t<R>)};
+}
+
+template <byte_writable_range... R>
+auto write_buffers_at(const int fd, const off_t offset,
+                      const R &...buffers) noexcept
+    -> expected<size_t, error> {
+  std::array<iovec, sizeof...(R)> iovecs{iovec_of(buffers)...};
+  return writev_fully(fd, iovecs.data(), iovecs.size(), offset);
+}
+
+template <std::ranges::input_range List>
+auto write_buffer_list_at(const int fd, const off_t offset,
+                          const List &buffers) noexcept
+    -> expected<size_t, error> {
+  auto iovecs = darray<iovec>::builder{}.capacity(0).build();
+  const auto count = static_cast<size_t>(std::ranges::size(buffers));
+  return iovecs
+      .append_with(count,
+                   [&](iovec *const p_iovecs) {
+                     std::ranges::transform(
+                         buffers, p_iovecs,
+                         [](const auto &buffer) { return iovec_of(buffer); });
+                     return count;
+                   })
+      .and_then([&](size_t /*size*/) {
+        return writev_fully(fd, iovecs.data(), count, offset);
+      });
+}
+
+template <typename T, typename ThreadProtection, typename GrowthPolicy,
+          typename Allocator>
+auto read_append_at(const int fd, const off_t offset,
+                    darray<T, ThreadProtection, GrowthPolicy, Allocator>
+                        &destination,
+                    const size_t max_count) noexcept
+    -> expected<size_t, error> {
+  expected<size_t, error> result{0};
+  return destination
+      .append_with(
+          max_count,
+          [&](T *const p_spare) -> size_t {
+            auto *const p_bytes = reinterpret_cast<std::byte *>(p_spare);
+            const size_t max_bytes = max_count * sizeof(T);
+            ssize_t got = 0;
+            do {
+              got = (offset < 0) ? read(fd, p_bytes, max_bytes)
+                                 : pread(fd, p_bytes, max_bytes, offset);
+            } while ((got < 0) && (EINTR == errno));
+            [[unlikely]] if (got < 0) {
+              result = io_error("read");
+              return 0;
+            }
+            // a pipe or socket may split an element across reads
+            const auto bytes = static_cast<size_t>(got);
+            const size_t partial = bytes % sizeof(T);
+            if (0 != partial) {
+              const size_t missing = sizeof(T) - partial;
+              const expected<size_t, error> rest = read_fully(
+                  fd, &p_bytes[bytes], missing,
+                  (offset < 0) ? offset : (offset + static_cast<off_t>(bytes)));
+              [[unlikely]] if (!rest.has_value()) {
+                result = unexpected{rest.error()};
+                return 0;
+              }
+              [[unlikely]] if (missing != rest.value()) {
+                // the whole elements before it are kept
+                result = unexpected{error{format(
+                    "Cannot read, end of file within an element ({} of {} "
+                    "bytes)",
+                    partial + rest.value(), sizeof(T))}};
+                return bytes / sizeof(T);
+              }
+            }
+            result = (bytes + sizeof(T) - 1) / sizeof(T);
+            return result.value();
+          })
+      .and_then([&](size_t /*size*/) { return result; });
+}
+
+} // namespace detail
+
+//
+// write, straight from the buffers (no staging copy), one system call unless
+// the kernel writes part of the bytes
+//
+// write the bytes of every buffer in order at the file position (writev),
+// returns the bytes written
+template <byte_writable_range... R>
+  requires(sizeof...(R) > 0)
+auto write_buffers(const int fd, const R &...buffers) noexcept
+    -> expected<size_t, error> {
+  return detail::write_buffers_at(fd, -1, buffers...);
+}
+// as write_buffers, at offset of a seekable file (pwritev), the file position
+// is unchanged
+template <byte_writable_range... R>
+  requires(sizeof...(R) > 0)
+auto pwrite_buffers(const int fd, const off_t offset,
+                    const R &...buffers) noexcept -> expected<size_t, error> {
+  return detail::write_buffers_at(fd, offset, buffers...);
+}
+
+// as write_buffers, for a list of buffers (e.g. a darray of darrays) known
+// at run time
+template <std::ranges::input_range List>
+  requires std::ranges::sized_range<List> &&
+           byte_writable_range<std::ranges::range_value_t<List>>
+auto write_buffer_list(const int fd, const List &buffers) noexcept
+    -> expected<size_t, error> {
+  return detail::write_buffer_list_at(fd, -1, buffers);
+}
+template <std::ranges::input_range List>
+  requires std::ranges::sized_range<List> &&
+           byte_writable_range<std::ranges::range_value_t<List>>
+auto pwrite_buffer_list(const int fd, const off_t offset,
+                        const List &buffers) noexcept
+    -> expected<size_t, error> {
+  return detail::write_buffer_list_at(fd, offset, buffers);
+}
+
+//
+// read, straight into a darray's spare capacity (no staging copy)
+//
+// append up to max_count elements from one read at the file position,
+// growing destination at most once (not at all when it has max_count spare
+// capacity), returns the number appended, 0 at the end of the file
+// a read ending within an element reads on to complete it, the end of the
+// file within an element is an error, the whole elements read before it are
+// still appended
+template <typename T, typename ThreadProtection, typename GrowthPolicy,
+          typename Allocator>
+  requires std::is_trivially_copyable_v<T>
+auto read_append(const int fd,
+                 darray<T, ThreadProtection, GrowthPolicy, Allocator>
+                     &destination,
+                 const size_t max_count) noexcept -> expected<size_t, error> {
+  return detail::read_append_at(fd, -1, destination, max_count);
+}
+// as read_append, at offset of a seekable file (pread), the file position is
+// unchanged
+template <typename T, typename ThreadProtection, typename GrowthPolicy,
+          typename Allocator>
+  requires std::is_trivially_copyable_v<T>
+auto pread_append(const int fd, const off_t offset,
+                  darray<T, ThreadProtection, GrowthPolicy, Allocator>
+                      &destination,
+                  const size_t max_count) noexcept -> expected<size_t, error> {
+  return detail::read_append_at(fd, offset, destination, max_count);
+}
+
+#endif // __linux__
+
+} // namespace CppPlay
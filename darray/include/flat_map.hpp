@@ -0,0 +1,668 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#pragma once
+
+#include "darray.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef> // size_t & byte
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace CppPlay {
+
+namespace detail {
+
+// Eytzinger (BFS order) layout of a sorted sequence: the complete binary
+// search tree of count keys stored level by level, node k (1-based) has
+// children 2k and 2k + 1, an in-order walk visits the keys sorted
+// - a search walks one path from the root, the top levels share a few cache
+//   lines and the descendants a few levels down are contiguous, so they can
+//   be fetched ahead of the comparisons
+
+// first node in order, 0 when empty
+[[nodiscard]] constexpr auto eytzinger_first(const size_t count) noexcept
+    -> size_t {
+  if (0 == count) {
+    return 0;
+  }
+  size_t node = 1;
+  while ((2 * node) <= count) {
+    node *= 2;
+  }
+  return node;
+}
+
+// next node in order, 0 past the last
+// - with a right subtree, its leftmost node
+// - otherwise climb while node is a right child (trailing one bits), the
+//   parent of the last left child is next
+[[nodiscard]] constexpr auto eytzinger_next(size_t node,
+                                            const size_t count) noexcept
+    -> size_t {
+  if (((2 * node) + 1) <= count) {
+    node = (2 * node) + 1;
+    while ((2 * node) <= count) {
+      node *= 2;
+    }
+    return node;
+  }
+  return node >> (std::countr_one(node) + 1);
+}
+
+// hint the cache with the line holding p_base[index], without forming a
+// pointer past the array
+template <typename Key>
+auto prefetch_key(const Key *const p_base, const size_t index) noexcept
+    -> void {
+  __builtin_prefetch(reinterpret_cast<const void *>(
+      reinterpret_cast<std::uintptr_t>(p_base) + (index * sizeof(Key))));
+}
+
+// keys of a cache line, nodes that many levels down a path are contiguous
+template <typename Key>
+inline constexpr size_t keys_per_line =
+    std::bit_floor(std::max<size_t>(1, 64 / sizeof(Key)));
+
+// node (1-based) of the first key not ordered before key, 0 if none
+// branchless: the comparison selects the child arithmetically, the
+// descendants keys_per_line levels down are fetched ahead
+template <typename Key, typename Compare>
+[[nodiscard]] auto eytzinger_lower_bound(const Key *const p_keys,
+                                         const size_t count, const Key &key,
+                                         Compare &compare) noexcept -> size_t {
+  size_t node = 1;
+  while (node <= count) {
+    prefetch_key(p_keys, (keys_per_line<Key> * node) - 1);
+    node = (2 * node) + static_cast<size_t>(compare(p_keys[node - 1], key));
+  }
+  // the path turned left at the answer, then only right
+  return node >> (std::countr_one(node) + 1);
+}
+
+// index of the first key not ordered before key in sorted p_keys, count if
+// none, branchless binary search fetching both possible next probes
+template <typename Key, typename Compare>
+[[nodiscard]] auto sorted_lower_bound(const Key *const p_keys,
+                                      const size_t count, const Key &key,
+                                      Compare &compare) noexcept -> size_t {
+  if (0 == count) {
+    return 0;
+  }
+  const Key *p_base = p_keys;
+  size_t length = count;
+  while (length > 1) {
+    const size_t half = length / 2;
+    const size_t next_half = (length - half) / 2;
+    prefetch_key(p_base, next_half);
+    prefetch_key(p_base, half + next_half);
+    p_base += half * static_cast<size_t>(compare(p_base[half], key));
+    length -= half;
+  }
+  return static_cast<size_t>(p_base - p_keys) +
+         static_cast<size_t>(compare(*p_base, key));
+}
+
+template <typename Mapped> struct flat_values {
+  using type = darray<Mapped, ThreadProtectionDisabled<Mapped>,
+                      GrowthPolicyDouble<Mapped>>;
+};
+template <> struct flat_values<void> {
+  struct type {};
+};
+
+} // namespace detail
+
+// sorted associative container on darray storage, keys unique
+// flat_set<Key> (Mapped void) or flat_map<Key, Mapped>
+// - keys and mapped values are separate darrays, lookups only touch keys
+// - sorted: lookups are a branchless binary search, inserts shift the tail
+//   (insert_sorted merges a whole sorted batch in one pass)
+// - frozen: freeze() reorders keys (and values) in Eytzinger order for
+//   faster lookups on large, static tables, modifications are refused until
+//   thaw() restores the sorted order
+// iteration is in key order in both layouts
+// no thread protection, protect the owner if shared
+template <typename Key, typename Mapped, typename Compare = std::less<Key>>
+  requires std::strict_weak_order<Compare &, const Key &, const Key &>
+class basic_flat_map {
+  static constexpr bool s_map = !std::is_void_v<Mapped>;
+  // Mapped, or a placeholder for sets so pair types stay well formed
+  using stored_mapped = std::conditional_t<s_map, Mapped, std::byte>;
+
+public:
+  using key_type = Key;
+  using mapped_type = Mapped;
+  // element of assign and insert_sorted ranges
+  using value_type =
+      std::conditional_t<s_map, std::pair<Key, stored_mapped>, Key>;
+  using reference = std::conditional_t<s_map,
+                                       std::pair<const Key &, stored_mapped &>,
+                                       const Key &>;
+
+private:
+  template <typename U>
+  using storage_type =
+      darray<U, ThreadProtectionDisabled<U>, GrowthPolicyDouble<U>>;
+  using values_type = typename detail::flat_values<Mapped>::type;
+
+  storage_type<Key> m_keys;
+  [[no_unique_address]] values_type m_values;
+  [[no_unique_address]] Compare m_compare;
+  bool m_frozen = false;
+
+  constinit static const size_t DEFAULT_RESERVE_SIZE = 8;
+
+  static auto make_keys(const size_t capacity) noexcept -> storage_type<Key> {
+    return typename storage_type<Key>::builder{}.capacity(capacity).build();
+  }
+  static auto make_values(const size_t capacity) noexcept -> values_type {
+    if constexpr (s_map) {
+      return typename values_type::builder{}.capacity(capacity).build();
+    } else {
+      return {};
+    }
+  }
+
+  explicit basic_flat_map(const size_t capacity, Compare compare)
+      : m_keys{make_keys(capacity)}, m_values{make_values(capacity)},
+        m_compare{std::move(compare)} {}
+
+  [[nodiscard]] auto key_count() const noexcept -> size_t {
+    return m_keys.pod().size();
+  }
+  [[nodiscard]] auto keys() const noexcept -> Key * {
+    return m_keys.data();
+  }
+
+  static auto key_of(const value_type &element) noexcept -> const Key & {
+    if constexpr (s_map) {
+      return element.first;
+    } else {
+      return element;
+    }
+  }
+
+  // sorted index, or Eytzinger node when frozen, of the lower bound
+  [[nodiscard]] auto lower_bound_position(const Key &key) const noexcept
+      -> size_t {
+    if (m_frozen) {
+      return detail::eytzinger_lower_bound(keys(), key_count(), key,
+                                           m_compare);
+    }
+    return detail::sorted_lower_bound(keys(), key_count(), key, m_compare);
+  }
+  [[nodiscard]] auto end_position() const noexcept -> size_t {
+    return m_frozen ? 0 : key_count();
+  }
+  [[nodiscard]] auto index_of(const size_t position) const noexcept
+      -> size_t {
+    return m_frozen ? (position - 1) : position;
+  }
+  // position of key, end_position() when missing
+  [[nodiscard]] auto find_position(const Key &key) const noexcept -> size_t {
+    const size_t position = lower_bound_position(key);
+    if ((position == end_position()) ||
+        m_compare(key, keys()[index_of(position)])) {
+      return end_position();
+    }
+    return position;
+  }
+
+  [[nodiscard]] auto refuse_if_frozen() const noexcept
+      -> expected<void, error> {
+    [[unlikely]] if (m_frozen) {
+      return unexpected{error{format("Cannot modify a frozen table, thaw it")}};
+    }
+    return {};
+  }
+
+  // replace the storage by elements already sorted and unique, moved in
+  // from [first, last)
+  template <typename I>
+  auto adopt(I first, I last, const size_t count) noexcept
+      -> expected<size_t, error> {
+    storage_type<Key> new_keys = make_keys(count);
+    values_type new_values = make_values(count);
+    for (; first != last; ++first) {
+      value_type &element = *first;
+      expected<size_t, error> result = [&]() {
+        if constexpr (s_map) {
+          return new_keys.push_back(std::move(element.first))
+              .and_then([&]([[maybe_unused]] size_t size) {
+                return new_values.push_back(std::move(element.second));
+              });
+        } else {
+          return new_keys.push_back(std::move(element));
+        }
+      }();
+      [[unlikely]] if (!result.has_value()) {
+        return unexpected{result.error()};
+      }
+    }
+    m_keys = std::move(new_keys);
+    m_values = std::move(new_values);
+    return {key_count()};
+  }
+
+  // move keys and values between sorted and Eytzinger order
+  auto permute(const bool to_eytzinger) noexcept -> expected<void, error> {
+    const size_t count = key_count();
+    // source[destination index] = source index
+    std::vector<size_t> source;
+    try {
+      source.resize(count);
+    } catch (const std::exception &err) {
+      return unexpected{error{format("Cannot reorder, {}", err.what())}};
+    }
+    size_t node = detail::eytzinger_first(count);
+    for (size_t idx = 0; idx < count; idx++) {
+      if (to_eytzinger) {
+        source[node - 1] = idx;
+      } else {
+        source[idx] = node - 1;
+      }
+      node = detail::eytzinger_next(node, count);
+    }
+    // pushes into the reserved capacity do not fail
+    storage_type<Key> new_keys = make_keys(count);
+    values_type new_values = make_values(count);
+    for (const size_t idx : source) {
+      static_cast<void>(new_keys.push_back(std::move(m_keys[idx])));
+      if constexpr (s_map) {
+        static_cast<void>(new_values.push_back(std::move(m_values[idx])));
+      }
+    }
+    m_keys = std::move(new_keys);
+    m_values = std::move(new_values);
+    m_frozen = to_eytzinger;
+    return {};
+  }
+
+public:
+  //
+  // special member functions
+  //
+  basic_flat_map() : basic_flat_map{DEFAULT_RESERVE_SIZE, Compare{}} {}
+  explicit basic_flat_map(Compare compare)
+      : basic_flat_map{DEFAULT_RESERVE_SIZE, std::move(compare)} {}
+  basic_flat_map(const basic_flat_map &other) = default;
+  auto operator=(const basic_flat_map &other) -> basic_flat_map & = default;
+  basic_flat_map(basic_flat_map &&other) noexcept = default;
+  auto operator=(basic_flat_map &&other) noexcept
+      -> basic_flat_map & = default;
+  ~basic_flat_map() = default;
+
+  //
+  // basic_flat_map builder helper
+  //
+  class builder {
+    size_t m_initial_capacity = DEFAULT_RESERVE_SIZE;
+    Compare m_compare{};
+
+  public:
+    constexpr auto capacity(size_t capacity) noexcept -> builder & {
+      m_initial_capacity = capacity;
+      return *this;
+    };
+    auto compare(Compare compare) noexcept -> builder & {
+      m_compare = std::move(compare);
+      return *this;
+    };
+    [[nodiscard]] auto build() const noexcept -> basic_flat_map {
+      return basic_flat_map{m_initial_capacity, m_compare};
+    };
+  };
+  friend builder;
+
+  //
+  // access - iterator (forward, key order)
+  //
+  struct iterator {
+    // a map dereferences to a (key, mapped) reference pair (prvalue), so a
+    // legacy input iterator but a C++20 forward iterator
+    using iterator_concept = std::forward_iterator_tag;
+    using iterator_category =
+        std::conditional_t<s_map, std::input_iterator_tag,
+                           std::forward_iterator_tag>;
+    using difference_type = std::ptrdiff_t;
+    using value_type = basic_flat_map::value_type;
+    using reference = basic_flat_map::reference;
+
+    iterator() = default;
+    iterator(const basic_flat_map *p_map, size_t position)
+        : m_p_map{p_map}, m_position{position} {}
+
+    reference operator*() const {
+      const size_t idx = m_p_map->index_of(m_position);
+      if constexpr (s_map) {
+        return reference{m_p_map->m_keys[idx], m_p_map->m_values[idx]};
+      } else {
+        return m_p_map->m_keys[idx];
+      }
+    }
+    iterator &operator++() {
+      m_position = m_p_map->m_frozen
+                       ? detail::eytzinger_next(m_position,
+                                                m_p_map->key_count())
+                       : (m_position + 1);
+      return *this;
+    }
+    iterator operator++(int) {
+      iterator tmp = *this;
+      ++(*this);
+      return tmp;
+    }
+    bool operator==(const iterator &other) const {
+      return m_position == other.m_position;
+    }
+
+  private:
+    const basic_flat_map *m_p_map = nullptr;
+    size_t m_position = 0;
+  };
+
+  auto begin() const noexcept -> iterator {
+    return iterator{this, m_frozen ? detail::eytzinger_first(key_count()) : 0};
+  }
+  auto end() const noexcept -> iterator {
+    return iterator{this, end_position()};
+  }
+
+  //
+  // store
+  //
+  // replace the contents by the elements of an unsorted range, sorted once,
+  // the first of equal keys is kept, returns the new size
+  template <std::ranges::input_range R>
+    requires std::constructible_from<value_type,
+                                     std::ranges::range_reference_t<R>>
+  auto assign(R &&range) noexcept -> expected<size_t, error> {
+    return refuse_if_frozen().and_then([&]() -> expected<size_t, error> {
+      std::vector<value_type> elements;
+      try {
+        for (auto &&element : range) {
+          elements.emplace_back(std::forward<decltype(element)>(element));
+        }
+        const auto by_key = [&](const value_type &left,
+                                const value_type &right) {
+          return m_compare(key_of(left), key_of(right));
+        };
+        std::stable_sort(elements.begin(), elements.end(), by_key);
+        const auto last = std::unique(
+            elements.begin(), elements.end(),
+            [&](const value_type &left, const value_type &right) {
+              return !by_key(left, right);
+            });
+        elements.erase(last, elements.end());
+      } catch (const std::exception &err) {
+        return unexpected{error{format("Cannot assign, {}", err.what())}};
+      }
+      return adopt(elements.begin(), elements.end(), elements.size());
+    });
+  }
+
+  // merge a range sorted by key in one pass, keys already present (or
+  // repeated in the range) keep their first element, returns the number of
+  // elements inserted
+  template <std::ranges::forward_range R>
+    requires std::constructible_from<value_type,
+                                     std::ranges::range_reference_t<R>>
+  auto insert_sorted(R &&range) noexcept -> expected<size_t, error> {
+    return refuse_if_frozen().and_then([&]() -> expected<size_t, error> {
+      const size_t count = key_count();
+      // new elements only, the map is untouched until they are all built
+      std::vector<value_type> incoming;
+      try {
+        const auto key_of_range = [](const auto &element) -> const Key & {
+          if constexpr (s_map) {
+            return std::get<0>(element);
+          } else {
+            return element;
+          }
+        };
+        [[unlikely]] if (!std::ranges::is_sorted(range, m_compare,
+                                                 key_of_range)) {
+          return unexpected{error{format("Range to insert is not sorted")}};
+        }
+        size_t idx = 0;
+        for (auto &&element : range) {
+          const Key &key = key_of_range(element);
+          while ((idx < count) && m_compare(m_keys[idx], key)) {
+            idx++;
+          }
+          const bool present =
+              ((idx < count) && !m_compare(key, m_keys[idx])) ||
+              (!incoming.empty() && !m_compare(key_of(incoming.back()), key));
+          if (!present) {
+            incoming.emplace_back(std::forward<decltype(element)>(element));
+          }
+        }
+      } catch (const std::exception &err) {
+        return unexpected{error{format("Cannot insert, {}", err.what())}};
+      }
+
+      // pushes into the reserved capacity do not fail, so existing elements
+      // are only moved once nothing else can
+      storage_type<Key> new_keys = make_keys(count + incoming.size());
+      values_type new_values = make_values(count + incoming.size());
+      const auto take_existing = [&](const size_t idx) {
+        static_cast<void>(new_keys.push_back(std::move(m_keys[idx])));
+        if constexpr (s_map) {
+          static_cast<void>(new_values.push_back(std::move(m_values[idx])));
+        }
+      };
+      const auto take_incoming = [&](value_type &element) {
+        if constexpr (s_map) {
+          static_cast<void>(new_keys.push_back(std::move(element.first)));
+          static_cast<void>(new_values.push_back(std::move(element.second)));
+        } else {
+          static_cast<void>(new_keys.push_back(std::move(element)));
+        }
+      };
+      size_t idx = 0;
+      for (value_type &element : incoming) {
+        while ((idx < count) && m_compare(m_keys[idx], key_of(element))) {
+          take_existing(idx++);
+        }
+        take_incoming(element);
+      }
+      while (idx < count) {
+        take_existing(idx++);
+      }
+      m_keys = std::move(new_keys);
+      m_values = std::move(new_values);
+      return {incoming.size()};
+    });
+  }
+
+  // insert key, returns false when already present
+  template <typename U>
+    requires std::constructible_from<Key, U &&> && (!s_map)
+  auto insert(U &&key) noexcept -> expected<bool, error> {
+    return refuse_if_frozen().and_then([&]() -> expected<bool, error> {
+      const Key new_key{std::forward<U>(key)};
+      const size_t idx = lower_bound_position(new_key);
+      if ((idx < key_count()) && !m_compare(new_key, m_keys[idx])) {
+        return {false};
+      }
+      return m_keys.insert(std::move(new_key), idx).transform(
+          []([[maybe_unused]] size_t size) { return true; });
+    });
+  }
+  // insert key with value, returns false (value unused) when key is present
+  template <typename U, typename V>
+    requires std::constructible_from<Key, U &&> &&
+             std::constructible_from<stored_mapped, V &&> &&
+             s_map
+  auto insert(U &&key, V &&value) noexcept -> expected<bool, error> {
+    return refuse_if_frozen().and_then([&]() -> expected<bool, error> {
+      Key new_key{std::forward<U>(key)};
+      const size_t idx = lower_bound_position(new_key);
+      if ((idx < key_count()) && !m_compare(new_key, m_keys[idx])) {
+        return {false};
+      }
+      return m_values.insert(std::forward<V>(value), idx)
+          .and_then([&]([[maybe_unused]] size_t size) {
+            return m_keys.insert(std::move(new_key), idx)
+                .or_else([&](error err) -> expected<size_t, error> {
+                  static_cast<void>(m_values.extract(idx));
+                  return unexpected{err};
+                });
+          })
+          .transform([]([[maybe_unused]] size_t size) { return true; });
+    });
+  }
+
+  //
+  // extract
+  //
+  // erase key, returns false when not present
+  auto erase(const Key &key) noexcept -> expected<bool, error> {
+    return refuse_if_frozen().and_then([&]() -> expected<bool, error> {
+      const size_t idx = find_position(key);
+      if (idx == end_position()) {
+        return {false};
+      }
+      if constexpr (s_map) {
+        static_cast<void>(m_values.extract(idx));
+      }
+      return m_keys.extract(idx).transform(
+          []([[maybe_unused]] Key erased) { return true; });
+    });
+  }
+
+  auto clear() noexcept -> expected<void, error> {
+    m_frozen = false;
+    if constexpr (s_map) {
+      static_cast<void>(m_values.clear());
+    }
+    return m_keys.clear();
+  }
+
+  //
+  // layout
+  //
+  // reorder into Eytzinger order, lookups get faster and modifications are
+  // refused until thaw()
+  auto freeze() noexcept -> expected<void, error> {
+    if (m_frozen) {
+      return {};
+    }
+    return permute(true);
+  }
+  // back to sorted order, modifications are accepted again
+  auto thaw() noexcept -> expected<void, error> {
+    if (!m_frozen) {
+      return {};
+    }
+    return permute(false);
+  }
+  [[nodiscard]] auto is_frozen() const noexcept -> bool { return m_frozen; }
+
+  //
+  // lookup
+  //
+  [[nodiscard]] auto contains(const Key &key) const noexcept -> bool {
+    return find_position(key) != end_position();
+  }
+  // element of key, end() when missing
+  [[nodiscard]] auto find(const Key &key) const noexcept -> iterator {
+    return iterator{this, find_position(key)};
+  }
+  // first element not ordered before key, end() when none
+  [[nodiscard]] auto lower_bound(const Key &key) const noexcept -> iterator {
+    return iterator{this, lower_bound_position(key)};
+  }
+  // value mapped to key
+  [[nodiscard]] auto at(const Key &key) const noexcept
+      -> expected<std::reference_wrapper<stored_mapped>, error>
+    requires s_map
+  {
+    const size_t position = find_position(key);
+    [[unlikely]] if (position == end_position()) {
+      return unexpected{error{format("Key not found")}};
+    }
+    return {std::ref(m_values[index_of(position)])};
+  }
+
+  //
+  // metadata
+  //
+  [[nodiscard]] auto capacity() const noexcept -> expected<size_t, error> {
+    return m_keys.capacity();
+  }
+  [[nodiscard]] auto size() const noexcept -> expected<size_t, error> {
+    return {key_count()};
+  }
+  [[nodiscard]] auto is_empty() const noexcept -> expected<bool, error> {
+    return {(0 == key_count())};
+  }
+
+  // non-monadic (plain-old-data return value) metadata accessors
+  class pod_metadata_accessor {
+    const basic_flat_map &m_map;
+    constexpr explicit pod_metadata_accessor(const basic_flat_map &map_obj)
+        : m_map{map_obj} {}
+    friend basic_flat_map;
+
+  public:
+    [[nodiscard]] auto capacity() const noexcept -> size_t {
+      return m_map.m_keys.pod().capacity();
+    }
+    [[nodiscard]] auto size() const noexcept -> size_t {
+      return m_map.key_count();
+    }
+    [[nodiscard]] auto is_empty() const noexcept -> bool {
+      return (0 == m_map.key_count());
+    }
+  };
+  // get plain-old-data metadata accessor
+  [[nodiscard]] constexpr auto pod() const noexcept
+      -> const pod_metadata_accessor {
+    return pod_metadata_accessor{*this};
+  }
+};
+
+template <typename Key, typename Compare = std::less<Key>>
+using flat_set = basic_flat_map<Key, void, Compare>;
+
+template <typename Key, typename Mapped, typename Compare = std::less<Key>>
+using flat_map = basic_flat_map<Key, Mapped, Compare>;
+
+} // namespace CppPlay
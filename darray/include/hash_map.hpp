@@ -0,0 +1,682 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#pragma once
+
+
+#include "darray.hpp"
+#include "simd_algorithm.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef> // size_t & byte
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace CppPlay {
+
+namespace detail {
+
+// control byte of a slot: empty, or the low 7 bits of a full slot's hash
+using control_byte = std::int8_t;
+inline constexpr control_byte s_empty_control = -128;
+inline constexpr size_t s_group_width = 16;
+inline constexpr size_t s_control_bits = 7;
+
+// bitmask of the sign bits of a group of control bytes (the empty slots)
+[[nodiscard]] inline auto
+group_sign_bits(const simd::detail::vector_t<control_byte, s_group_width>
+                    &group) noexcept -> std::uint32_t {
+#if defined(__SSE2__)
+  return static_cast<std::uint32_t>(
+      _mm_movemask_epi8(std::bit_cast<__m128i>(group)));
+#else
+  std::uint32_t bits = 0;
+  for (size_t lane = 0; lane < s_group_width; lane++) {
+    bits |= static_cast<std::uint32_t>(group[lane] < 0) << lane;
+  }
+  return bits;
+#endif
+}
+
+// bitmasks of the slots of the group from p_controls holding control, and of
+// its empty slots
+struct group_match {
+  std::uint32_t m_matches;
+  std::uint32_t m_empties;
+};
+[[nodiscard]] inline auto match_group(const control_byte *const p_controls,
+                                      const control_byte control) noexcept
+    -> group_match {
+  using group_t = simd::detail::vector_t<control_byte, s_group_width>;
+  group_t group;
+  simd::detail::load<control_byte, s_group_width>(group, p_controls);
+  const group_t equal =
+      reinterpret_cast<group_t>(group == (group_t{} + control));
+  return {group_sign_bits(equal), group_sign_bits(group)};
+}
+
+// the low bits of std::hash are often the key itself, one multiply and a
+// fold spread every bit of hash over the control bits and the slot index
+[[nodiscard]] constexpr auto hash_mix(const size_t hash) noexcept -> size_t {
+  constexpr size_t HALF = std::numeric_limits<size_t>::digits / 2;
+  const size_t product = hash * static_cast<size_t>(0x9E3779B97F4A7C15ULL);
+  return product ^ (product >> HALF);
+}
+
+// lookups by a type other than Key, as std::unordered_map: both Hash and
+// KeyEqual declare is_transparent
+template <typename K, typename Key, typename Hash, typename KeyEqual>
+concept heterogeneous_key =
+    !std::same_as<std::remove_cvref_t<K>, Key> &&
+    requires { typename Hash::is_transparent; } &&
+    requires { typename KeyEqual::is_transparent; } &&
+    std::invocable<const Hash &, const K &> &&
+    std::predicate<const KeyEqual &, const K &, const Key &>;
+
+} // namespace detail
+
+// open addressing hash map, Swiss table style control bytes over darray
+// storage
+// - a control byte per slot holds 7 bits of the hash of the key in it (or
+//   empty), a lookup compares a group of 16 control bytes at once with SSE2
+//   and only compares keys whose control byte matches
+// - linear probing, so an erase shifts the rest of the probe run back into
+//   the hole instead of leaving a tombstone, lookups never wade through
+//   erased slots and no rehash is needed to clear them
+// - the slot count is a power of two, the table doubles (rehashes) past 7/8
+//   full, control bytes and slots live in darrays allocated once per size
+// Hash and KeyEqual must not throw, neither must moves of Key and Mapped
+// no thread protection, protect the owner if shared
+template <typename Key, typename Mapped, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+  requires std::is_nothrow_move_constructible_v<Key> &&
+           std::is_nothrow_move_constructible_v<Mapped> &&
+           std::invocable<const Hash &, const Key &> &&
+           std::equivalence_relation<const KeyEqual &, const Key &,
+                                     const Key &>
+class hash_map {
+public:
+  using key_type = Key;
+  using mapped_type = Mapped;
+  using value_type = std::pair<Key, Mapped>;
+  using reference = std::pair<const Key &, Mapped &>;
+
+private:
+  // raw storage, a value lives in a slot only while its control byte is full
+  struct slot {
+    alignas(value_type) std::byte m_bytes[sizeof(value_type)];
+  };
+  template <typename U>
+  using storage_type =
+      darray<U, ThreadProtectionDisabled<U>, GrowthPolicyDouble<U>>;
+  using control_byte = detail::control_byte;
+
+  static constexpr size_t s_group_width = detail::s_group_width;
+  static constexpr size_t s_min_slots = s_group_width;
+  static constexpr size_t s_no_slot = std::numeric_limits<size_t>::max();
+
+  // a byte per slot, then the first group width - 1 bytes again, so a group
+  // loads from any slot without wrapping
+  storage_type<control_byte> m_controls;
+  storage_type<slot> m_slots;
+  size_t m_mask = 0; // slot count - 1, 0 while no table is allocated
+  size_t m_size = 0;
+  [[no_unique_address]] Hash m_hash;
+  [[no_unique_address]] KeyEqual m_key_equal;
+
+  constinit static const size_t DEFAULT_RESERVE_SIZE = 8;
+
+  explicit hash_map(const size_t capacity, Hash hash, KeyEqual key_equal)
+      : m_controls{typename storage_type<control_byte>::builder{}
+                       .capacity(0)
+                       .build()},
+        m_slots{typename storage_type<slot>::builder{}.capacity(0).build()},
+        m_hash{std::move(hash)}, m_key_equal{std::move(key_equal)} {
+    // an allocation failure leaves no table, the first insert allocates
+    static_cast<void>(rehash(slot_count_for(capacity)));
+  }
+
+  [[nodiscard]] auto slot_count() const noexcept -> size_t {
+    return (0 == m_mask) ? 0 : (m_mask + 1);
+  }
+  // elements held before the table doubles, 7/8 of the slots
+  [[nodiscard]] static constexpr auto max_load(const size_t slots) noexcept
+      -> size_t {
+    return slots - (slots / 8);
+  }
+  [[nodiscard]] static constexpr auto slot_count_for(const size_t count) noexcept
+      -> size_t {
+    size_t slots = std::bit_ceil(std::max(count, s_min_slots));
+    while (max_load(slots) < count) {
+      slots *= 2;
+    }
+    return slots;
+  }
+
+  [[nodiscard]] auto controls() const noexcept -> control_byte * {
+    return m_controls.data();
+  }
+  [[nodiscard]] auto value_at(const size_t idx) const noexcept
+      -> value_type & {
+    return *std::launder(
+        reinterpret_cast<value_type *>(m_slots.data()[idx].m_bytes));
+  }
+  [[nodiscard]] auto is_full(const size_t idx) const noexcept -> bool {
+    return controls()[idx] >= 0;
+  }
+
+  template <typename K>
+  [[nodiscard]] auto hash_of(const K &key) const noexcept -> size_t {
+    return detail::hash_mix(static_cast<size_t>(m_hash(key)));
+  }
+  [[nodiscard]] static auto control_of(const size_t hash) noexcept
+      -> control_byte {
+    return static_cast<control_byte>(hash & 0x7FU);
+  }
+  [[nodiscard]] auto home_of(const size_t hash) const noexcept -> size_t {
+    return (hash >> detail::s_control_bits) & m_mask;
+  }
+
+  // set slot idx's control byte, and its clone past the end for the first
+  // group width - 1 slots (the same byte for the others)
+  auto set_control(const size_t idx, const control_byte control) noexcept
+      -> void {
+    control_byte *const p_controls = controls();
+    p_controls[idx] = control;
+    p_controls[((idx - (s_group_width - 1)) & m_mask) + (s_group_width - 1)] =
+        control;
+  }
+
+  // slot holding key and true, or the first empty slot of its probe run and
+  // false, the table must be allocated
+  template <typename K>
+  [[nodiscard]] auto probe(const K &key, const size_t hash) const noexcept
+      -> std::pair<size_t, bool> {
+    const control_byte control = control_of(hash);
+    size_t group = home_of(hash);
+    while (true) {
+      const detail::group_match match =
+          detail::match_group(&controls()[group], control);
+      for (std::uint32_t matches = match.m_matches; 0 != matches;
+           matches &= (matches - 1)) {
+        const size_t idx =
+            (group + static_cast<size_t>(std::countr_zero(matches))) & m_mask;
+        if (m_key_equal(key, value_at(idx).first)) {
+          return {idx, true};
+        }
+      }
+      // a key is never stored past the first empty slot of its probe run
+      if (0 != match.m_empties) {
+        return {(group + static_cast<size_t>(std::countr_zero(
+                             match.m_empties))) &
+                    m_mask,
+                false};
+      }
+      group = (group + s_group_width) & m_mask;
+    }
+  }
+
+  template <typename K>
+  [[nodiscard]] auto find_slot(const K &key) const noexcept -> size_t {
+    if (0 == m_size) {
+      return s_no_slot;
+    }
+    const auto [idx, found] = probe(key, hash_of(key));
+    return found ? idx : s_no_slot;
+  }
+
+  // first empty slot of the probe run of hash
+  [[nodiscard]] auto first_empty(const size_t hash) const noexcept -> size_t {
+    size_t group = home_of(hash);
+    while (true) {
+      const std::uint32_t empties =
+          detail::match_group(&controls()[group], 0).m_empties;
+      if (0 != empties) {
+        return (group + static_cast<size_t>(std::countr_zero(empties))) &
+               m_mask;
+      }
+      group = (group + s_group_width) & m_mask;
+    }
+  }
+
+  // move every element into a new table of slots slots
+  auto rehash(const size_t slots) noexcept -> expected<void, error> {
+    auto new_controls =
+        typename storage_type<control_byte>::builder{}.capacity(0).build();
+    auto new_slots = typename storage_type<slot>::builder{}.capacity(0).build();
+    const size_t control_count = slots + s_group_width - 1;
+    return new_controls
+        .append_with(control_count,
+                     [&](control_byte *const p_controls) {
+                       std::uninitialized_fill_n(p_controls, control_count,
+                                                 detail::s_empty_control);
+                       return control_count;
+                     })
+        .and_then([&](size_t /*size*/) {
+          // raw slots, nothing to construct
+          return new_slots.append_with(
+              slots, [&](slot *const /*p_slots*/) { return slots; });
+        })
+        .transform([&](size_t /*size*/) {
+          const size_t old_slots = slot_count();
+          std::swap(m_controls, new_controls);
+          std::swap(m_slots, new_slots);
+          m_mask = slots - 1;
+          if (0 == m_size) {
+            return;
+          }
+          // the old table is still readable through the swapped out darrays
+          const control_byte *const p_old_controls = new_controls.data();
+          slot *const p_old_slots = new_slots.data();
+          for (size_t idx = 0; idx < old_slots; idx++) {
+            if (p_old_controls[idx] < 0) {
+              continue;
+            }
+            value_type *const p_value = std::launder(
+                reinterpret_cast<value_type *>(p_old_slots[idx].m_bytes));
+            const size_t hash = hash_of(p_value->first);
+            const size_t new_idx = first_empty(hash);
+            std::construct_at(&value_at(new_idx), std::move(*p_value));
+            std::destroy_at(p_value);
+            set_control(new_idx, control_of(hash));
+          }
+        });
+  }
+
+  // slot for key and whether key is already there, growing when an insert
+  // would pass the load limit
+  template <typename K>
+  auto prepare_insert(const K &key) noexcept
+      -> expected<std::pair<size_t, bool>, error> {
+    const size_t hash = hash_of(key);
+    if (0 != m_mask) {
+      const auto [idx, found] = probe(key, hash);
+      if (found || (m_size < max_load(slot_count()))) {
+        return {std::pair{idx, found}};
+      }
+    }
+    const size_t slots =
+        (0 == m_mask) ? s_min_slots : (slot_count() * 2);
+    return rehash(slots).transform(
+        [&]() { return std::pair{first_empty(hash), false}; });
+  }
+
+  template <typename U, typename V>
+  auto emplace_at(const size_t idx, U &&key, V &&value) noexcept -> void {
+    const size_t hash = hash_of(key);
+    std::construct_at(&value_at(idx), std::forward<U>(key),
+                      std::forward<V>(value));
+    set_control(idx, control_of(hash));
+    m_size++;
+  }
+
+  // empty slot idx, then move later elements of the probe run back while
+  // the hole lies on their own probe path (between their home and them)
+  auto erase_slot(size_t idx) noexcept -> void {
+    std::destroy_at(&value_at(idx));
+    m_size--;
+    size_t next = (idx + 1) & m_mask;
+    while (is_full(next)) {
+      const size_t home = home_of(hash_of(value_at(next).first));
+      if (((next - home) & m_mask) >= ((next - idx) & m_mask)) {
+        std::construct_at(&value_at(idx), std::move(value_at(next)));
+        std::destroy_at(&value_at(next));
+        set_control(idx, controls()[next]);
+        idx = next;
+      }
+      next = (next + 1) & m_mask;
+    }
+    set_control(idx, detail::s_empty_control);
+  }
+
+  auto destroy_all() noexcept -> void {
+    for (size_t idx = 0; (idx < slot_count()) && (0 != m_size); idx++) {
+      if (is_full(idx)) {
+        std::destroy_at(&value_at(idx));
+        set_control(idx, detail::s_empty_control);
+        m_size--;
+      }
+    }
+  }
+
+public:
+  //
+  // special member functions
+  //
+  hash_map() : hash_map{DEFAULT_RESERVE_SIZE, Hash{}, KeyEqual{}} {}
+  // copies every element into a table of the same size, throws error on
+  // allocation failure as darray does
+  hash_map(const hash_map &other)
+      : hash_map{0, other.m_hash, other.m_key_equal} {
+    rehash(std::max(other.slot_count(), s_min_slots))
+        .or_else([](error err) -> expected<void, error> { throw err; });
+    for (size_t idx = 0; idx < other.slot_count(); idx++) {
+      if (other.is_full(idx)) {
+        const value_type &element = other.value_at(idx);
+        emplace_at(first_empty(hash_of(element.first)), element.first,
+                   element.second);
+      }
+    }
+  }
+  auto operator=(const hash_map &other) -> hash_map & {
+    if (this != &other) {
+      hash_map copy{other};
+      swap(copy);
+    }
+    return *this;
+  }
+  // moved from hash_map is left empty without a table, it's usable
+  hash_map(hash_map &&other) noexcept
+      : m_controls{std::move(other.m_controls)},
+        m_slots{std::move(other.m_slots)},
+        m_mask{std::exchange(other.m_mask, 0)},
+        m_size{std::exchange(other.m_size, 0)},
+        m_hash{std::move(other.m_hash)},
+        m_key_equal{std::move(other.m_key_equal)} {}
+  auto operator=(hash_map &&other) noexcept -> hash_map & {
+    if (this != &other) {
+      hash_map moved{std::move(other)};
+      swap(moved);
+    }
+    return *this;
+  }
+  ~hash_map() { destroy_all(); }
+
+  auto swap(hash_map &other) noexcept -> void {
+    std::swap(m_controls, other.m_controls);
+    std::swap(m_slots, other.m_slots);
+    std::swap(m_mask, other.m_mask);
+    std::swap(m_size, other.m_size);
+    std::swap(m_hash, other.m_hash);
+    std::swap(m_key_equal, other.m_key_equal);
+  }
+
+  //
+  // hash_map builder helper
+  //
+  class builder {
+    size_t m_initial_capacity = DEFAULT_RESERVE_SIZE;
+    Hash m_hash{};
+    KeyEqual m_key_equal{};
+
+  public:
+    // elements held before the table grows
+    constexpr auto capacity(size_t capacity) noexcept -> builder & {
+      m_initial_capacity = capacity;
+      return *this;
+    };
+    auto hash(Hash hash) noexcept -> builder & {
+      m_hash = std::move(hash);
+      return *this;
+    };
+    auto key_equal(KeyEqual key_equal) noexcept -> builder & {
+      m_key_equal = std::move(key_equal);
+      return *this;
+    };
+    [[nodiscard]] auto build() const noexcept -> hash_map {
+      return hash_map{m_initial_capacity, m_hash, m_key_equal};
+    };
+  };
+  friend builder;
+
+  //
+  // access - iterator (forward, slot order)
+  //
+  struct iterator {
+    // dereferences to a (key, mapped) reference pair (prvalue), so a legacy
+    // input iterator but a C++20 forward iterator
+    using iterator_concept = std::forward_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = hash_map::value_type;
+    using reference = hash_map::reference;
+
+    iterator() = default;
+    iterator(const hash_map *p_map, size_t idx)
+        : m_p_map{p_map}, m_idx{idx} {}
+
+    reference operator*() const {
+      value_type &element = m_p_map->value_at(m_idx);
+      return reference{element.first, element.second};
+    }
+    iterator &operator++() {
+      m_idx = m_p_map->next_full(m_idx + 1);
+      return *this;
+    }
+    iterator operator++(int) {
+      iterator tmp = *this;
+      ++(*this);
+      return tmp;
+    }
+    bool operator==(const iterator &other) const {
+      return m_idx == other.m_idx;
+    }
+
+  private:
+    const hash_map *m_p_map = nullptr;
+    size_t m_idx = 0;
+  };
+
+private:
+  // first full slot from idx, slot_count() when none, a group at a time
+  [[nodiscard]] auto next_full(size_t idx) const noexcept -> size_t {
+    const size_t slots = slot_count();
+    while (idx < slots) {
+      using group_t = simd::detail::vector_t<control_byte, s_group_width>;
+      group_t group;
+      simd::detail::load<control_byte, s_group_width>(group, &controls()[idx]);
+      const std::uint32_t full =
+          ~detail::group_sign_bits(group) & ((1U << s_group_width) - 1);
+      if (0 != full) {
+        return std::min(idx + static_cast<size_t>(std::countr_zero(full)),
+                        slots);
+      }
+      idx += s_group_width;
+    }
+    return slots;
+  }
+
+public:
+  auto begin() const noexcept -> iterator {
+    return iterator{this, next_full(0)};
+  }
+  auto end() const noexcept -> iterator { return iterator{this, slot_count()}; }
+
+  //
+  // store
+  //
+  // insert key with value, returns false (value unused) when key is present
+  template <typename U, typename V>
+    requires std::constructible_from<Key, U &&> &&
+             std::constructible_from<Mapped, V &&>
+  auto insert(U &&key, V &&value) noexcept -> expected<bool, error> {
+    Key new_key{std::forward<U>(key)};
+    return prepare_insert(new_key).transform([&](const auto slot_found) {
+      const auto [idx, found] = slot_found;
+      if (!found) {
+        emplace_at(idx, std::move(new_key), std::forward<V>(value));
+      }
+      return !found;
+    });
+  }
+
+  // insert key with value, or assign value to key's element when present,
+  // returns true when inserted
+  template <typename U, typename V>
+    requires std::constructible_from<Key, U &&> &&
+             std::constructible_from<Mapped, V &&> &&
+             std::assignable_from<Mapped &, V &&>
+  auto insert_or_assign(U &&key, V &&value) noexcept -> expected<bool, error> {
+    Key new_key{std::forward<U>(key)};
+    return prepare_insert(new_key).transform([&](const auto slot_found) {
+      const auto [idx, found] = slot_found;
+      if (found) {
+        value_at(idx).second = std::forward<V>(value);
+      } else {
+        emplace_at(idx, std::move(new_key), std::forward<V>(value));
+      }
+      return !found;
+    });
+  }
+
+  // size the table for count elements, rehashing at most once, so count
+  // inserts do not grow it
+  auto reserve(const size_t count) noexcept -> expected<void, error> {
+    const size_t slots = slot_count_for(count);
+    if (slots <= slot_count()) {
+      return {};
+    }
+    return rehash(slots);
+  }
+
+  //
+  // extract
+  //
+  // erase key, returns false when not present
+  auto erase(const Key &key) noexcept -> expected<bool, error> {
+    return erase_key(key);
+  }
+  template <typename K>
+    requires detail::heterogeneous_key<K, Key, Hash, KeyEqual>
+  auto erase(const K &key) noexcept -> expected<bool, error> {
+    return erase_key(key);
+  }
+
+  // destroy every element, the table keeps its size
+  auto clear() noexcept -> expected<void, error> {
+    destroy_all();
+    return {};
+  }
+
+private:
+  template <typename K>
+  auto erase_key(const K &key) noexcept -> expected<bool, error> {
+    const size_t idx = find_slot(key);
+    if (s_no_slot == idx) {
+      return {false};
+    }
+    erase_slot(idx);
+    return {true};
+  }
+
+  template <typename K>
+  [[nodiscard]] auto at_key(const K &key) const noexcept
+      -> expected<std::reference_wrapper<Mapped>, error> {
+    const size_t idx = find_slot(key);
+    [[unlikely]] if (s_no_slot == idx) {
+      return unexpected{error{format("Key not found")}};
+    }
+    return {std::ref(value_at(idx).second)};
+  }
+
+public:
+  //
+  // lookup, heterogeneous when Hash and KeyEqual are transparent
+  //
+  [[nodiscard]] auto contains(const Key &key) const noexcept -> bool {
+    return s_no_slot != find_slot(key);
+  }
+  template <typename K>
+    requires detail::heterogeneous_key<K, Key, Hash, KeyEqual>
+  [[nodiscard]] auto contains(const K &key) const noexcept -> bool {
+    return s_no_slot != find_slot(key);
+  }
+
+  // element of key, end() when missing
+  [[nodiscard]] auto find(const Key &key) const noexcept -> iterator {
+    const size_t idx = find_slot(key);
+    return (s_no_slot == idx) ? end() : iterator{this, idx};
+  }
+  template <typename K>
+    requires detail::heterogeneous_key<K, Key, Hash, KeyEqual>
+  [[nodiscard]] auto find(const K &key) const noexcept -> iterator {
+    const size_t idx = find_slot(key);
+    return (s_no_slot == idx) ? end() : iterator{this, idx};
+  }
+
+  // value mapped to key
+  [[nodiscard]] auto at(const Key &key) const noexcept
+      -> expected<std::reference_wrapper<Mapped>, error> {
+    return at_key(key);
+  }
+  template <typename K>
+    requires detail::heterogeneous_key<K, Key, Hash, KeyEqual>
+  [[nodiscard]] auto at(const K &key) const noexcept
+      -> expected<std::reference_wrapper<Mapped>, error> {
+    return at_key(key);
+  }
+
+  //
+  // metadata
+  //
+  // capacity is the number of elements held before the table grows
+  [[nodiscard]] auto capacity() const noexcept -> expected<size_t, error> {
+    return {max_load(slot_count())};
+  }
+  [[nodiscard]] auto size() const noexcept -> expected<size_t, error> {
+    return {m_size};
+  }
+  [[nodiscard]] auto is_empty() const noexcept -> expected<bool, error> {
+    return {(0 == m_size)};
+  }
+
+  // non-monadic (plain-old-data return value) metadata accessors
+  class pod_metadata_accessor {
+    const hash_map &m_map;
+    constexpr explicit pod_metadata_accessor(const hash_map &map_obj)
+        : m_map{map_obj} {}
+    friend hash_map;
+
+  public:
+    [[nodiscard]] auto capacity() const noexcept -> size_t {
+      return max_load(m_map.slot_count());
+    }
+    [[nodiscard]] auto size() const noexcept -> size_t { return m_map.m_size; }
+    [[nodiscard]] auto is_empty() const noexcept -> bool {
+      return (0 == m_map.m_size);
+    }
+  };
+  // get plain-old-data metadata accessor
+  [[nodiscard]] constexpr auto pod() const noexcept
+      -> const pod_metadata_accessor {
+    return pod_metadata_accessor{*this};
+  }
+};
+
+} // namespace CppPlay
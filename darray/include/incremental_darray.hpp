@@ -0,0 +1,459 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#pragma once
+
+
+#include "darray.hpp"
+
+#include <algorithm>
+#include <cstddef> // size_t
+#include <cstdint> // SIZE_MAX
+#include <cstring>
+#include <expected>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <shared_mutex>
+#include <type_traits>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace CppPlay {
+
+// darray with incremental (de-amortized) resizing, no single push_back is
+// O(n)
+// - growing allocates the larger buffer and appends there straight away, the
+//   elements still in the smaller buffer are moved over a bounded number at a
+//   time, MIGRATE_STEP or more on every following mutation, the way
+//   incremental rehashing works
+//  - https://en.wikipedia.org/wiki/Hash_table#Dynamic_resizing
+// - the step is sized so the migration always completes before the larger
+//   buffer is full, for any growth policy
+// - migrated pages of the old buffer are handed back to the kernel a
+//   RELEASE_CHUNK at a time (Linux), so freeing it once migrated doesn't
+//   unmap every page of a large buffer in one push_back
+// - while migrating both buffers are held, and an element lives in one or the
+//   other, so elements are reached by index (at(), [], for_each()) rather than
+//   as one contiguous span
+template <typename T, typename ThreadProtection = ThreadProtectionDisabled<T>,
+          typename GrowthPolicy = GrowthPolicyDouble<T>,
+          typename Allocator = std::allocator<T>, size_t MIGRATE_STEP = 32>
+class incremental_darray {
+  static_assert(MIGRATE_STEP > 0, "migration must make progress");
+
+public:
+  using value_type = T;
+  using allocator_type =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+
+private:
+  using alloc_traits = std::allocator_traits<allocator_type>;
+
+  constinit static const size_t DEFAULT_RESERVE_SIZE = 8;
+  constinit static const size_t RELEASE_CHUNK = size_t{64} << 10;
+
+  [[no_unique_address]] allocator_type m_allocator;
+  // raw storage, elements are constructed in place and explicitly destroyed
+  T *m_p_buffer = nullptr;
+  size_t m_capacity = 0;
+  size_t m_size = 0;
+  // the buffer being migrated from, elements [m_migrated, m_old_size) still
+  // live there, every other element lives in m_p_buffer
+  T *m_p_old_buffer = nullptr;
+  size_t m_old_capacity = 0;
+  size_t m_old_size = 0;
+  size_t m_migrated = 0;
+  // elements migrated per mutation for the current migration
+  size_t m_step = MIGRATE_STEP;
+  // old buffer pages below this address have been released
+  std::uintptr_t m_released = 0;
+
+  // no conditional member variable support as yet, as darray
+  struct Empty {};
+  using ConditionalMutex = std::conditional_t<
+      ThreadProtection::do_multithreaded_protection,
+      std::conditional_t<shared_read_protection<ThreadProtection>,
+                         std::shared_mutex, std::mutex>,
+      Empty>;
+  [[no_unique_address]] mutable ConditionalMutex m_mutex;
+
+  [[nodiscard]] auto write_lock() const {
+    if constexpr (ThreadProtection::do_multithreaded_protection) {
+      return std::unique_lock<ConditionalMutex>{m_mutex};
+    } else {
+      return Empty{};
+    }
+  }
+  [[nodiscard]] auto read_lock() const {
+    if constexpr (shared_read_protection<ThreadProtection>) {
+      return std::shared_lock<std::shared_mutex>{m_mutex};
+    } else if constexpr (ThreadProtection::do_multithreaded_protection) {
+      return std::unique_lock<ConditionalMutex>{m_mutex};
+    } else {
+      return Empty{};
+    }
+  }
+
+  [[nodiscard]] auto allocate(const size_t capacity) noexcept
+      -> expected<T *, error> {
+    try {
+      [[unlikely]] if (capacity > alloc_traits::max_size(m_allocator)) {
+        throw std::bad_array_new_length{};
+      }
+      return {alloc_traits::allocate(m_allocator, capacity)};
+    } catch (const bad_alloc &err) {
+      return unexpected{error{
+          format("Cannot allocate {} elements: {}", capacity, err.what())}};
+    }
+  }
+  auto deallocate(T *const p_buffer, const size_t capacity) noexcept -> void {
+    if (nullptr != p_buffer) {
+      alloc_traits::deallocate(m_allocator, p_buffer, capacity);
+    }
+  }
+
+  // slot of element idx, one unsigned compare picks the buffer, the old
+  // range is empty when not migrating
+  [[nodiscard]] auto slot(const size_t idx) const noexcept -> T * {
+    [[unlikely]] if ((idx - m_migrated) < (m_old_size - m_migrated)) {
+      return &m_p_old_buffer[idx];
+    }
+    return &m_p_buffer[idx];
+  }
+
+  [[nodiscard]] auto is_migrating_unlocked() const noexcept -> bool {
+    return nullptr != m_p_old_buffer;
+  }
+
+  // move up to count elements from the old buffer, releasing it once empty
+  // dest is raw storage, source slots are left as raw storage
+  auto migrate(const size_t count) noexcept -> void {
+    [[likely]] if (false == is_migrating_unlocked()) { return; }
+    const size_t moving = std::min(count, m_old_size - m_migrated);
+    T *const p_source = &m_p_old_buffer[m_migrated];
+    T *const p_dest = &m_p_buffer[m_migrated];
+    if constexpr (is_trivially_relocatable_v<T>) {
+      [[likely]] if (0 != moving) {
+        std::memcpy(static_cast<void *>(p_dest),
+                    static_cast<const void *>(p_source), moving * sizeof(T));
+      }
+    } else {
+      for (size_t idx = 0; idx < moving; idx++) {
+        if constexpr (is_move_constructible_v<T>) {
+          std::construct_at(&p_dest[idx], std::move(p_source[idx]));
+        } else {
+          std::construct_at(&p_dest[idx], p_source[idx]);
+        }
+        std::destroy_at(&p_source[idx]);
+      }
+    }
+    m_migrated += moving;
+    release_migrated();
+    [[unlikely]] if (m_migrated == m_old_size) {
+      deallocate(m_p_old_buffer, m_old_capacity);
+      m_p_old_buffer = nullptr;
+      m_old_capacity = 0;
+      m_old_size = 0;
+      m_migrated = 0;
+    }
+  }
+
+  // migrated slots are raw storage, whole pages of them are dropped with
+  // MADV_DONTNEED once a chunk has built up, contents are gone but the
+  // allocation stays valid to free
+  auto release_migrated() noexcept -> void {
+#if defined(__linux__)
+    static const auto s_page_size =
+        static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+    const std::uintptr_t migrated_end =
+        reinterpret_cast<std::uintptr_t>(&m_p_old_buffer[m_migrated]) &
+        ~(s_page_size - 1);
+    [[likely]] if (migrated_end < (m_released + RELEASE_CHUNK)) { return; }
+    // failure only leaves the pages for the final free
+    madvise(reinterpret_cast<void *>(m_released), migrated_end - m_released,
+            MADV_DONTNEED);
+    m_released = migrated_end;
+#endif
+  }
+
+  // switch appends to a larger buffer, the current one becomes the old
+  // buffer to migrate from
+  // each of the (capacity - size) appends until the larger buffer is full
+  // migrates m_step elements, which covers every element of the old buffer
+  auto grow() noexcept -> expected<void, error> {
+    // only reachable if pops and pushes undid the step sizing, finish first
+    // so there is one old buffer at most
+    migrate(SIZE_MAX);
+    const size_t capacity =
+        (0 == m_capacity)
+            ? DEFAULT_RESERVE_SIZE
+            : std::max(GrowthPolicy::grow(m_capacity), m_capacity + 1);
+    [[unlikely]] if (capacity <= m_capacity) { // overflow
+      return unexpected{
+          error{format("Cannot grow beyond capacity {}", m_capacity)}};
+    }
+    return allocate(capacity).transform([&](T *const p_buffer) {
+      m_p_old_buffer = m_p_buffer;
+      m_old_capacity = m_capacity;
+      m_old_size = m_size;
+      m_migrated = 0;
+      // first whole page of the old buffer
+      m_released = (reinterpret_cast<std::uintptr_t>(m_p_old_buffer) +
+                    RELEASE_CHUNK - 1) & ~(RELEASE_CHUNK - 1);
+      m_p_buffer = p_buffer;
+      m_capacity = capacity;
+      const size_t room = capacity - m_size;
+      m_step = std::max(MIGRATE_STEP, (m_size + room - 1) / room);
+      // nothing to migrate, e.g. the first allocation
+      migrate(0);
+    });
+  }
+
+  auto destroy_all() noexcept -> void {
+    for (size_t idx = 0; idx < m_size; idx++) {
+      std::destroy_at(slot(idx));
+    }
+    m_size = 0;
+    m_old_size = 0;
+    m_migrated = 0;
+    deallocate(m_p_old_buffer, m_old_capacity);
+    m_p_old_buffer = nullptr;
+    m_old_capacity = 0;
+  }
+
+  auto steal(incremental_darray &other) noexcept -> void {
+    m_p_buffer = std::exchange(other.m_p_buffer, nullptr);
+    m_capacity = std::exchange(other.m_capacity, 0);
+    m_size = std::exchange(other.m_size, 0);
+    m_p_old_buffer = std::exchange(other.m_p_old_buffer, nullptr);
+    m_old_capacity = std::exchange(other.m_old_capacity, 0);
+    m_old_size = std::exchange(other.m_old_size, 0);
+    m_migrated = std::exchange(other.m_migrated, 0);
+    m_step = other.m_step;
+    m_released = other.m_released;
+  }
+
+  explicit incremental_darray(const size_t capacity,
+                              const allocator_type &allocator)
+      : m_allocator{allocator} {
+    [[likely]] if (0 != capacity) {
+      m_p_buffer = alloc_traits::allocate(m_allocator, capacity);
+      m_capacity = capacity;
+    }
+  }
+
+public:
+  //
+  // special member functions
+  //
+  incremental_darray()
+      : incremental_darray{DEFAULT_RESERVE_SIZE, allocator_type{}} {}
+  incremental_darray(const incremental_darray &) = delete;
+  auto operator=(const incremental_darray &)
+      -> incremental_darray & = delete;
+
+  // moved from incremental_darray is empty with no capacity, and grows again
+  // from the default on the next push_back
+  incremental_darray(incremental_darray &&other) noexcept
+      : m_allocator{other.m_allocator} {
+    [[maybe_unused]] const auto lock = other.write_lock();
+    steal(other);
+  }
+  auto operator=(incremental_darray &&other) noexcept -> incremental_darray & {
+    if (this != &other) {
+      [[maybe_unused]] const auto lock = write_lock();
+      [[maybe_unused]] const auto other_lock = other.write_lock();
+      destroy_all();
+      deallocate(m_p_buffer, m_capacity);
+      std::destroy_at(&m_allocator);
+      std::construct_at(&m_allocator, other.m_allocator);
+      steal(other);
+    }
+    return *this;
+  }
+
+  ~incremental_darray() {
+    destroy_all();
+    deallocate(m_p_buffer, m_capacity);
+  }
+
+  //
+  // incremental_darray builder helper
+  //
+  class builder {
+    size_t m_initial_capacity = DEFAULT_RESERVE_SIZE;
+    allocator_type m_allocator{};
+
+  public:
+    constexpr auto capacity(size_t capacity) noexcept -> builder & {
+      m_initial_capacity = capacity;
+      return *this;
+    };
+    constexpr auto allocator(const allocator_type &allocator) noexcept
+        -> builder & {
+      m_allocator = allocator;
+      return *this;
+    };
+    [[nodiscard]] auto build() const noexcept -> incremental_darray {
+      return incremental_darray{m_initial_capacity, m_allocator};
+    };
+  };
+  friend builder;
+
+  //
+  // store
+  //
+  // O(MIGRATE_STEP) worst case, plus an allocation when full
+  template <typename U>
+  auto push_back(U &&new_element) noexcept -> expected<size_t, error> {
+    [[maybe_unused]] const auto lock = write_lock();
+    const auto store = [&]() -> expected<size_t, error> {
+      std::construct_at(&m_p_buffer[m_size], forward<U>(new_element));
+      migrate(m_step);
+      return {m_size++};
+    };
+    [[likely]] if (m_size < m_capacity) { return store(); }
+    return grow().and_then(store);
+  }
+
+  //
+  // delete
+  //
+  // never releases capacity
+  auto pop_back() noexcept -> expected<T, error> {
+    [[maybe_unused]] const auto lock = write_lock();
+    [[unlikely]] if (0 == m_size) {
+      return unexpected{error{format("No elements to pop")}};
+    }
+    T *const p_slot = slot(--m_size);
+    // pull element directly into return type so can be used for RVO
+    expected<T, error> ret = [&]() -> expected<T, error> {
+      if constexpr (is_move_constructible_v<T>) {
+        return {std::move(*p_slot)};
+      } else {
+        return {*p_slot};
+      }
+    }();
+    std::destroy_at(p_slot);
+    // popped below the elements awaiting migration
+    m_old_size = std::min(m_old_size, m_size);
+    m_migrated = std::min(m_migrated, m_old_size);
+    migrate(m_step);
+    return ret;
+  }
+
+  // keeps the current buffer, releases the one being migrated from
+  auto clear() noexcept -> expected<void, error> {
+    [[maybe_unused]] const auto lock = write_lock();
+    destroy_all();
+    return {};
+  }
+
+  //
+  // access - random
+  //
+  [[nodiscard]] auto at(const size_t idx) const noexcept
+      -> expected<T *, error> {
+    [[maybe_unused]] const auto lock = read_lock();
+    [[unlikely]] if (idx >= m_size) {
+      return unexpected{error{format(
+          "Requested index {} beyond array end (size={})", idx, m_size)}};
+    }
+    return {slot(idx)};
+  }
+  auto operator[](const size_t idx) const -> T & {
+    [[maybe_unused]] const auto lock = read_lock();
+    return *slot(idx);
+  }
+
+  // visit every element in index order, a contiguous run per buffer
+  template <typename Function> auto for_each(Function &&function) const -> void {
+    [[maybe_unused]] const auto lock = read_lock();
+    const auto visit = [&](T *const p_buffer, const size_t first,
+                           const size_t last) {
+      for (size_t idx = first; idx < last; idx++) {
+        function(p_buffer[idx]);
+      }
+    };
+    const size_t old_last = std::max(m_old_size, m_migrated);
+    visit(m_p_buffer, 0, m_migrated);
+    visit(m_p_old_buffer, m_migrated, old_last);
+    visit(m_p_buffer, old_last, m_size);
+  }
+
+  //
+  // metadata
+  //
+  [[nodiscard]] auto capacity() const noexcept -> expected<size_t, error> {
+    [[maybe_unused]] const auto lock = read_lock();
+    return {m_capacity};
+  }
+  [[nodiscard]] auto size() const noexcept -> expected<size_t, error> {
+    [[maybe_unused]] const auto lock = read_lock();
+    return {m_size};
+  }
+  [[nodiscard]] auto is_empty() const noexcept -> expected<bool, error> {
+    [[maybe_unused]] const auto lock = read_lock();
+    return {0 == m_size};
+  }
+  // elements are still being moved out of the previous buffer
+  [[nodiscard]] auto is_migrating() const noexcept -> bool {
+    [[maybe_unused]] const auto lock = read_lock();
+    return is_migrating_unlocked();
+  }
+
+  // non-monadic (plain-old-data return value) metadata accessors
+  class pod_metadata_accessor {
+    const incremental_darray &m_darray;
+    constexpr explicit pod_metadata_accessor(const incremental_darray &darray_obj)
+        : m_darray{darray_obj} {}
+    friend incremental_darray;
+
+  public:
+    [[nodiscard]] auto capacity() const noexcept -> size_t {
+      return m_darray.capacity().value();
+    }
+    [[nodiscard]] auto size() const noexcept -> size_t {
+      return m_darray.size().value();
+    }
+    [[nodiscard]] auto is_empty() const noexcept -> bool {
+      return m_darray.is_empty().value();
+    }
+  };
+  // get plain-old-data metadata accessor
+  [[nodiscard]] constexpr auto pod() const noexcept
+      -> const pod_metadata_accessor {
+    return pod_metadata_accessor{*this};
+  }
+};
+
+} // namespace CppPlay
@@ -0,0 +1,485 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#pragma once
+
+
+#include "darray.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef> // size_t & byte
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace CppPlay {
+
+#if defined(__linux__)
+
+// darray of trivially copyable elements living in a memory mapped file
+// - the file is a one page header (magic, version, element size, size)
+//   followed by the elements at their in-memory representation, so opening
+//   an existing file maps it and reads the header, no parsing or copying
+//   however many elements it holds (O(1) startup)
+// - pages are read on first access and written back by the kernel, a data
+//   set larger than RAM pages in and out on demand
+// - growth doubles the capacity, extending the file with ftruncate and the
+//   mapping with mremap, which may move it but never copies elements
+// - sync flushes elements and size to the file, they otherwise reach it when
+//   the kernel writes back dirty pages (at the latest when the last mapping
+//   of the file is gone and the page cache is flushed)
+// the file holds native byte order and layout, it is not portable across
+// architectures or element type changes (the element size is checked)
+// move only, no thread protection, one process at a time may open a file
+template <typename T>
+  requires std::is_trivially_copyable_v<T>
+class mapped_darray {
+  static_assert(alignof(T) <= 4096, "elements start at a page boundary");
+
+public:
+  using value_type = T;
+  using iterator = typename darray<T>::iterator;
+
+private:
+  struct file_header {
+    std::uint64_t m_magic;
+    std::uint32_t m_version;
+    std::uint32_t m_element_size;
+    std::uint64_t m_size;
+  };
+  // "CPDARRAY" read as a little endian integer
+  static constexpr std::uint64_t s_magic = 0x5941525241445043ULL;
+  static constexpr std::uint32_t s_version = 1;
+  // elements start a page after the header, so they are page aligned and
+  // the mapping grows with the file
+  static constexpr size_t s_header_bytes = 4096;
+
+  constinit static const size_t DEFAULT_RESERVE_SIZE = 1024;
+
+  int m_fd = -1;
+  std::byte *m_p_map = nullptr;
+  size_t m_capacity = 0;
+
+  [[nodiscard]] static constexpr auto map_bytes(const size_t capacity) noexcept
+      -> size_t {
+    return s_header_bytes + (capacity * sizeof(T));
+  }
+  [[nodiscard]] auto header() const noexcept -> file_header * {
+    return reinterpret_cast<file_header *>(m_p_map);
+  }
+  [[nodiscard]] auto data() const noexcept -> T * {
+    return reinterpret_cast<T *>(m_p_map + s_header_bytes);
+  }
+  [[nodiscard]] auto size_ref() const noexcept -> std::uint64_t & {
+    return header()->m_size;
+  }
+  [[nodiscard]] static auto system_error(const char *const operation)
+      -> unexpected<error> {
+    return unexpected{
+        error{format("Cannot {}: {}", operation, std::strerror(errno))}};
+  }
+
+  auto release() noexcept -> void {
+    if (nullptr != m_p_map) {
+      munmap(static_cast<void *>(m_p_map), map_bytes(m_capacity));
+      m_p_map = nullptr;
+    }
+    if (-1 != m_fd) {
+      close(m_fd);
+      m_fd = -1;
+    }
+    m_capacity = 0;
+  }
+
+  // map a newly opened file, creating its header when it is empty
+  auto open_file(const string &path, const size_t capacity) noexcept
+      -> expected<void, error> {
+    m_fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    [[unlikely]] if (-1 == m_fd) { return system_error("open mapped file"); }
+    struct stat status {};
+    [[unlikely]] if (0 != fstat(m_fd, &status)) {
+      return system_error("stat mapped file");
+    }
+    const auto file_bytes = static_cast<size_t>(status.st_size);
+
+    if (0 == file_bytes) {
+      [[unlikely]] if (0 != ftruncate(m_fd, static_cast<off_t>(
+                                                map_bytes(capacity)))) {
+        return system_error("size mapped file");
+      }
+      return map_file(capacity).transform([&]() {
+        *header() = file_header{s_magic, s_version,
+                                static_cast<std::uint32_t>(sizeof(T)), 0};
+      });
+    }
+
+    [[unlikely]] if (file_bytes < s_header_bytes) {
+      return unexpected{error{format(
+          "Cannot open mapped file, {} bytes is too short for a header",
+          file_bytes)}};
+    }
+    return map_file((file_bytes - s_header_bytes) / sizeof(T))
+        .and_then([&]() -> expected<void, error> {
+          const file_header &existing = *header();
+          [[unlikely]] if ((s_magic != existing.m_magic) ||
+                           (s_version != existing.m_version)) {
+            return unexpected{
+                error{"Cannot open mapped file, not a mapped darray file"}};
+          }
+          [[unlikely]] if (sizeof(T) != existing.m_element_size) {
+            return unexpected{error{format(
+                "Cannot open mapped file of {} byte elements as {} byte "
+                "elements",
+                existing.m_element_size, sizeof(T))}};
+          }
+          [[unlikely]] if (existing.m_size > m_capacity) {
+            return unexpected{error{format(
+                "Cannot open mapped file, size {} beyond capacity {}",
+                existing.m_size, m_capacity)}};
+          }
+          return reserve_to(capacity);
+        });
+  }
+
+  auto map_file(const size_t capacity) noexcept -> expected<void, error> {
+    void *const p_map = mmap(nullptr, map_bytes(capacity),
+                             PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    [[unlikely]] if (MAP_FAILED == p_map) { return system_error("map file"); }
+    m_p_map = static_cast<std::byte *>(p_map);
+    m_capacity = capacity;
+    return {};
+  }
+
+  // extend file and mapping to hold capacity elements
+  auto reserve_to(const size_t capacity) noexcept -> expected<void, error> {
+    if (capacity <= m_capacity) {
+      return {};
+    }
+    [[unlikely]] if (capacity > ((SIZE_MAX - s_header_bytes) / sizeof(T))) {
+      return unexpected{
+          error{format("Cannot map {} elements, too large", capacity)}};
+    }
+    [[unlikely]] if (0 != ftruncate(m_fd, static_cast<off_t>(
+                                              map_bytes(capacity)))) {
+      return system_error("grow mapped file");
+    }
+    void *const p_map =
+        mremap(static_cast<void *>(m_p_map), map_bytes(m_capacity),
+               map_bytes(capacity), MREMAP_MAYMOVE);
+    [[unlikely]] if (MAP_FAILED == p_map) {
+      const auto err = system_error("grow file mapping");
+      // the old mapping is untouched, give the file its old length back
+      static_cast<void>(
+          ftruncate(m_fd, static_cast<off_t>(map_bytes(m_capacity))));
+      return err;
+    }
+    m_p_map = static_cast<std::byte *>(p_map);
+    m_capacity = capacity;
+    return {};
+  }
+
+  // room for count more elements, doubling the capacity
+  auto reserve_more(const size_t count) noexcept -> expected<void, error> {
+    const size_t size = size_ref();
+    [[likely]] if (count <= (m_capacity - size)) { return {}; }
+    [[unlikely]] if (count > (SIZE_MAX - size)) {
+      return unexpected{error{
+          format("Cannot append {} elements to {} elements", count, size)}};
+    }
+    return reserve_to(std::max(size + count, m_capacity * 2));
+  }
+
+  // some element of range is in the mapping, growing it may move them
+  template <typename R>
+  [[nodiscard]] auto range_aliases(R &range) const noexcept -> bool {
+    [[unlikely]] if (nullptr == m_p_map) { return false; }
+    const std::less<const T *> before{};
+    const T *const p_first = data();
+    const T *const p_last = p_first + m_capacity;
+    if constexpr (std::ranges::contiguous_range<R>) {
+      const T *const p_data = std::ranges::data(range);
+      const T *const p_data_last = p_data + std::ranges::size(range);
+      return before(p_data, p_last) && before(p_first, p_data_last);
+    } else {
+      return std::ranges::any_of(range, [&](const T &value) {
+        const T *const p_value = std::addressof(value);
+        return !before(p_value, p_first) && before(p_value, p_last);
+      });
+    }
+  }
+
+  mapped_darray() noexcept = default;
+
+public:
+  //
+  // special member functions
+  //
+  mapped_darray(const mapped_darray &) = delete;
+  auto operator=(const mapped_darray &) -> mapped_darray & = delete;
+
+  // moved from mapped_darray holds no file, only destruction and assignment
+  // are valid
+  mapped_darray(mapped_darray &&other) noexcept
+      : m_fd{std::exchange(other.m_fd, -1)},
+        m_p_map{std::exchange(other.m_p_map, nullptr)},
+        m_capacity{std::exchange(other.m_capacity, 0)} {}
+  auto operator=(mapped_darray &&other) noexcept -> mapped_darray & {
+    if (this != &other) {
+      release();
+      m_fd = std::exchange(other.m_fd, -1);
+      m_p_map = std::exchange(other.m_p_map, nullptr);
+      m_capacity = std::exchange(other.m_capacity, 0);
+    }
+    return *this;
+  }
+
+  // unmaps without flushing, the kernel still writes back dirty pages
+  ~mapped_darray() { release(); }
+
+  //
+  // mapped_darray builder helper
+  //
+  class builder {
+    string m_path{};
+    size_t m_initial_capacity = DEFAULT_RESERVE_SIZE;
+
+  public:
+    // file to open, created when missing
+    auto path(string path) noexcept -> builder & {
+      m_path = std::move(path);
+      return *this;
+    };
+    // minimum capacity, an existing file keeps a larger one
+    constexpr auto capacity(size_t capacity) noexcept -> builder & {
+      m_initial_capacity = capacity;
+      return *this;
+    };
+    // opening a file can fail, unlike building a darray
+    [[nodiscard]] auto build() const noexcept
+        -> expected<mapped_darray, error> {
+      mapped_darray mapped{};
+      return mapped.open_file(m_path, m_initial_capacity)
+          .transform([&]() { return std::move(mapped); });
+    };
+  };
+  friend builder;
+
+  //
+  // store
+  //
+  // new_element is copied first, it may be an element of the mapping growth
+  // moves
+  auto push_back(const T &new_element) noexcept -> expected<size_t, error> {
+    const T element = new_element;
+    return reserve_more(1).transform([&]() {
+      std::uint64_t &size = size_ref();
+      std::memcpy(static_cast<void *>(&data()[size]),
+                  static_cast<const void *>(&element), sizeof(T));
+      return static_cast<size_t>(++size);
+    });
+  }
+
+  // append every element of range, growing at most once for sized ranges,
+  // returns the new size
+  template <std::ranges::input_range R>
+    requires std::convertible_to<std::ranges::range_reference_t<R>, T>
+  auto append_range(R &&range) noexcept -> expected<size_t, error> {
+    if constexpr (std::ranges::sized_range<R>) {
+      if constexpr (std::ranges::forward_range<R> &&
+                    std::is_lvalue_reference_v<
+                        std::ranges::range_reference_t<R>> &&
+                    std::same_as<std::remove_cvref_t<
+                                     std::ranges::range_reference_t<R>>,
+                                 T>) {
+        // elements of this mapping (e.g. m.append_range(m)), stage a copy
+        // of them first
+        [[unlikely]] if (range_aliases(range)) {
+          darray<T> staged = typename darray<T>::builder{}.build();
+          const expected<size_t, error> result = staged.append_range(range);
+          [[unlikely]] if (!result.has_value()) {
+            return unexpected{result.error()};
+          }
+          return append_range(
+              std::span<const T>{staged.data(), staged.pod().size()});
+        }
+      }
+      const auto count = static_cast<size_t>(std::ranges::size(range));
+      return append_with(count, [&](T *const p_spare) {
+        if constexpr (std::ranges::contiguous_range<R> &&
+                      std::same_as<std::ranges::range_value_t<R>, T>) {
+          if (0 != count) {
+            std::memcpy(static_cast<void *>(p_spare),
+                        static_cast<const void *>(std::ranges::data(range)),
+                        count * sizeof(T));
+          }
+        } else {
+          std::ranges::copy(range, p_spare);
+        }
+        return count;
+      });
+    } else {
+      for (auto &&element : range) {
+        const expected<size_t, error> result =
+            push_back(static_cast<T>(element));
+        [[unlikely]] if (!result.has_value()) {
+          return unexpected{result.error()};
+        }
+      }
+      return {static_cast<size_t>(size_ref())};
+    }
+  }
+
+  // append elements written in place by writer, as darray::append_with,
+  // returns the new size
+  template <typename Writer>
+    requires std::is_invocable_r_v<size_t, Writer &, T *>
+  auto append_with(const size_t max_count, Writer &&writer) noexcept
+      -> expected<size_t, error> {
+    return reserve_more(max_count).and_then([&]() -> expected<size_t, error> {
+      std::uint64_t &size = size_ref();
+      const auto count = static_cast<size_t>(writer(&data()[size]));
+      [[unlikely]] if (count > max_count) {
+        return unexpected{error{
+            format("Writer returned {} elements, given room for {}", count,
+                   max_count)}};
+      }
+      size += count;
+      return {static_cast<size_t>(size)};
+    });
+  }
+
+  // grow the file to hold capacity elements, the only way to shrink is a new
+  // file
+  auto reserve(const size_t capacity) noexcept -> expected<void, error> {
+    return reserve_to(capacity);
+  }
+
+  //
+  // extract
+  //
+  auto pop_back() noexcept -> expected<T, error> {
+    std::uint64_t &size = size_ref();
+    [[unlikely]] if (0 == size) {
+      return unexpected{error{"No elements to pop"}};
+    }
+    return {data()[--size]};
+  }
+
+  // the file keeps its length (capacity)
+  auto clear() noexcept -> expected<void, error> {
+    size_ref() = 0;
+    return {};
+  }
+
+  // flush elements and size to the file, returns once they are written
+  auto sync() noexcept -> expected<void, error> {
+    const size_t used_bytes = map_bytes(static_cast<size_t>(size_ref()));
+    [[unlikely]] if (0 != msync(static_cast<void *>(m_p_map), used_bytes,
+                                MS_SYNC)) {
+      return system_error("sync mapped file");
+    }
+    return {};
+  }
+
+  //
+  // access - iterator (random access)
+  //
+  auto begin() const noexcept -> iterator { return iterator{data()}; }
+  auto end() const noexcept -> iterator {
+    return iterator{&data()[size_ref()]};
+  }
+
+  //
+  // access - random
+  //
+  [[nodiscard]] auto at(const size_t idx) const noexcept
+      -> expected<iterator, error> {
+    [[unlikely]] if (idx >= size_ref()) {
+      return unexpected{error{format(
+          "Requested index ({}) beyond array end ({})", idx, size_ref())}};
+    }
+    return {iterator{&data()[idx]}};
+  }
+  auto operator[](const size_t idx) const -> T & { return data()[idx]; }
+
+  //
+  // metadata
+  //
+  [[nodiscard]] auto capacity() const noexcept -> expected<size_t, error> {
+    return {m_capacity};
+  }
+  [[nodiscard]] auto size() const noexcept -> expected<size_t, error> {
+    return {static_cast<size_t>(size_ref())};
+  }
+  [[nodiscard]] auto is_empty() const noexcept -> expected<bool, error> {
+    return {(0 == size_ref())};
+  }
+
+  // non-monadic (plain-old-data return value) metadata accessors
+  class pod_metadata_accessor {
+    const mapped_darray &m_darray;
+    constexpr explicit pod_metadata_accessor(const mapped_darray &darray_obj)
+        : m_darray{darray_obj} {}
+    friend mapped_darray;
+
+  public:
+    [[nodiscard]] auto capacity() const noexcept -> size_t {
+      return m_darray.m_capacity;
+    }
+    [[nodiscard]] auto size() const noexcept -> size_t {
+      return static_cast<size_t>(m_darray.size_ref());
+    }
+    [[nodiscard]] auto is_empty() const noexcept -> bool {
+      return (0 == m_darray.size_ref());
+    }
+  };
+  // get plain-old-data metadata accessor
+  [[nodiscard]] constexpr auto pod() const noexcept
+      -> const pod_metadata_accessor {
+    return pod_metadata_accessor{*this};
+  }
+};
+
+#endif // __linux__
+
+} // namespace CppPlay
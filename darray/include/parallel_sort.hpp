@@ -0,0 +1,251 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#pragma once
+
+#include "darray.hpp"
+#include "task_pool.hpp"
+
+#include <algorithm>
+#include <cstddef> // size_t & byte
+#include <expected>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <ranges>
+#include <utility>
+
+namespace CppPlay {
+
+namespace detail {
+
+// parallel merge sort over random access iterators (e.g. darray::iterator)
+// - halves are sorted as tasks of the pool, down to a grain sorted with
+//   std::sort, then merged in parallel by splitting the larger half at its
+//   middle and the smaller one at the matching lower bound
+// - sorted runs alternate between the range and a buffer of the same size
+//   at each level (ping-pong), so every merge moves elements exactly once
+// - the buffer is uninitialized storage from allocator, the elements are
+//   move constructed into it and sorted from there, so the last merge lands
+//   back in the range and no default constructed element is needed
+template <std::random_access_iterator I, typename Compare,
+          typename Allocator = std::allocator<std::iter_value_t<I>>>
+class merge_sorter {
+  using value_type = std::iter_value_t<I>;
+  using buffer_allocator = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<value_type>;
+  using buffer_traits = std::allocator_traits<buffer_allocator>;
+
+  task_pool &m_pool;
+  Compare &m_compare;
+  buffer_allocator m_allocator;
+  size_t m_sort_grain;
+  size_t m_merge_grain;
+
+  // run left as a task and right inline, then wait for both
+  // the task is always waited for before an exception leaves, it references
+  // this frame
+  template <typename Left, typename Right>
+  auto fork_join(Left &&left, Right &&right) -> void {
+    task_pool::group group_obj;
+    m_pool.submit(group_obj, std::forward<Left>(left))
+        .or_else([](error err) -> expected<void, error> { throw err; });
+    try {
+      right();
+    } catch (...) {
+      (void)m_pool.wait(group_obj);
+      throw;
+    }
+    m_pool.wait(group_obj).or_else([](error err) -> expected<void, error> {
+      throw err;
+    });
+  }
+
+  template <typename In, typename Out>
+  auto merge(In left_first, In left_last, In right_first, In right_last,
+             Out dest) -> void {
+    const auto left_count = static_cast<size_t>(left_last - left_first);
+    const auto right_count = static_cast<size_t>(right_last - right_first);
+    if ((left_count + right_count) <= m_merge_grain) {
+      std::merge(std::make_move_iterator(left_first),
+                 std::make_move_iterator(left_last),
+                 std::make_move_iterator(right_first),
+                 std::make_move_iterator(right_last), dest,
+                 std::ref(m_compare));
+      return;
+    }
+    if (left_count < right_count) {
+      // split the larger run, the smaller one follows, order of runs does
+      // not matter for an unstable sort
+      merge(right_first, right_last, left_first, left_last, dest);
+      return;
+    }
+    // left elements before the pivot are not after it, right elements before
+    // the split are before it
+    const In left_middle = left_first + (left_count / 2);
+    const In right_split = std::lower_bound(right_first, right_last,
+                                            *left_middle, std::ref(m_compare));
+    const Out dest_split =
+        dest + (left_middle - left_first) + (right_split - right_first);
+
+    fork_join(
+        [=, this]() {
+          merge(left_first, left_middle, right_first, right_split, dest);
+        },
+        [&]() {
+          merge(left_middle, left_last, right_split, right_last, dest_split);
+        });
+  }
+
+  // sort [first, first + count), leaving the result there or, when
+  // into_buffer, in [buffer, buffer + count)
+  template <typename Data, typename Buffer>
+  auto sort(const Data first, const Buffer buffer, const size_t count,
+            const bool into_buffer) -> void {
+    if (count <= m_sort_grain) {
+      std::sort(first, first + static_cast<std::ptrdiff_t>(count),
+                std::ref(m_compare));
+      if (into_buffer) {
+        std::move(first, first + static_cast<std::ptrdiff_t>(count), buffer);
+      }
+      return;
+    }
+    const auto left_count = static_cast<std::ptrdiff_t>(count / 2);
+    const auto right_count = static_cast<std::ptrdiff_t>(count) - left_count;
+
+    // halves are sorted into the other location, then merged back
+    fork_join(
+        [=, this]() {
+          sort(first, buffer, static_cast<size_t>(left_count), !into_buffer);
+        },
+        [&]() {
+          sort(first + left_count, buffer + left_count,
+               static_cast<size_t>(right_count), !into_buffer);
+        });
+
+    if (into_buffer) {
+      merge(first, first + left_count, first + left_count,
+            first + left_count + right_count, buffer);
+    } else {
+      merge(buffer, buffer + left_count, buffer + left_count,
+            buffer + left_count + right_count, first);
+    }
+  }
+
+public:
+  merge_sorter(task_pool &pool, Compare &compare, const size_t count,
+               const Allocator &allocator)
+      : m_pool{pool}, m_compare{compare}, m_allocator{allocator},
+        m_sort_grain{std::max<size_t>(
+            s_minimum_grain, count / (pool.thread_count() * s_tasks_per_thread))},
+        m_merge_grain{m_sort_grain} {}
+
+  auto operator()(const I first, const size_t count) -> void {
+    const auto buffer_release = [&](value_type *const p_buffer) {
+      buffer_traits::deallocate(m_allocator, p_buffer, count);
+    };
+    const std::unique_ptr<value_type[], decltype(buffer_release)> buffer{
+        buffer_traits::allocate(m_allocator, count), buffer_release};
+    std::uninitialized_move_n(first, count, buffer.get());
+    // elements are live in the buffer from here, destroyed however the sort
+    // ends
+    const auto buffer_destroy = [count](value_type *const p_buffer) {
+      std::destroy_n(p_buffer, count);
+    };
+    const std::unique_ptr<value_type[], decltype(buffer_destroy)> live{
+        buffer.get(), buffer_destroy};
+    sort(buffer.get(), first, count, true);
+  }
+
+  // pieces smaller than this are not worth a task
+  static constexpr size_t s_minimum_grain = size_t{1} << 14;
+  // pieces per thread, more than one so early finishers can steal
+  static constexpr size_t s_tasks_per_thread = 8;
+};
+
+// std::sort when there is nothing to run in parallel, scratch buffer from
+// allocator otherwise
+template <std::random_access_iterator I, typename Compare,
+          typename Allocator>
+auto parallel_sort(task_pool &pool, const I first, const size_t count,
+                   Compare &compare, const Allocator &allocator) noexcept
+    -> expected<void, error> {
+  try {
+    if ((1 == pool.thread_count()) ||
+        (count <=
+         merge_sorter<I, Compare, Allocator>::s_minimum_grain)) {
+      std::sort(first, first + static_cast<std::ptrdiff_t>(count),
+                std::ref(compare));
+      return {};
+    }
+    merge_sorter<I, Compare, Allocator>{pool, compare, count,
+                                        allocator}(first, count);
+  } catch (const error &err) {
+    return unexpected{err};
+  } catch (const std::exception &err) {
+    return unexpected{error{format("{}", err.what())}};
+  } catch (...) {
+    return unexpected{error{format("Unknown exception thrown while sorting")}};
+  }
+  return {};
+}
+
+} // namespace detail
+
+// sort [first, last) with the threads of pool, not stable
+// elements are moved through a temporary buffer of the same size
+// comparator exceptions end the sort, leaving the elements valid but
+// unspecified, and are returned as an error
+template <std::random_access_iterator I, std::sentinel_for<I> S,
+          typename Compare = std::ranges::less>
+  requires std::sortable<I, Compare>
+auto parallel_sort(task_pool &pool, const I first, const S last,
+                   Compare compare = {}) noexcept -> expected<void, error> {
+  return detail::parallel_sort(
+      pool, first, static_cast<size_t>(std::ranges::distance(first, last)),
+      compare, std::allocator<std::iter_value_t<I>>{});
+}
+
+// sort a random access range, e.g. a darray, the temporary buffer comes
+// from the range's allocator when it has one
+template <std::ranges::random_access_range R,
+          typename Compare = std::ranges::less>
+  requires std::sortable<std::ranges::iterator_t<R>, Compare>
+auto parallel_sort(task_pool &pool, R &&range, Compare compare = {}) noexcept
+    -> expected<void, error> {
+  const auto count = static_cast<size_t>(std::ranges::distance(range));
+  if constexpr (requires { range.get_allocator(); }) {
+    return detail::parallel_sort(pool, std::ranges::begin(range), count,
+                                 compare, range.get_allocator());
+  } else {
+    return detail::parallel_sort(
+        pool, std::ranges::begin(range), count, compare,
+        std::allocator<std::ranges::range_value_t<R>>{});
+  }
+}
+
+} // namespace CppPlay
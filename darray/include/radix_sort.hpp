@@ -0,0 +1,212 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#pragma once
+
+#include "darray.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <climits>
+#include <concepts>
+#include <cstddef> // size_t & byte
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace CppPlay {
+
+// keys radix_sort orders by their bits: integers and IEEE floats
+template <typename K>
+concept radix_key =
+    (std::integral<K> && !std::same_as<std::remove_cv_t<K>, bool> &&
+     (sizeof(K) <= sizeof(std::uint64_t))) ||
+    (std::floating_point<K> && std::numeric_limits<K>::is_iec559 &&
+     ((sizeof(K) == sizeof(std::uint32_t)) ||
+      (sizeof(K) == sizeof(std::uint64_t))));
+
+namespace detail {
+
+template <size_t BYTES> struct radix_unsigned;
+template <> struct radix_unsigned<1> { using type = std::uint8_t; };
+template <> struct radix_unsigned<2> { using type = std::uint16_t; };
+template <> struct radix_unsigned<4> { using type = std::uint32_t; };
+template <> struct radix_unsigned<8> { using type = std::uint64_t; };
+
+template <radix_key K>
+using radix_bits_t = typename radix_unsigned<sizeof(K)>::type;
+
+// unsigned bits ordered like the key
+// - signed integers: flipping the sign bit puts negatives first
+// - floats: negatives have every bit flipped (larger magnitude first),
+//   positives only the sign bit, so -0.0 sorts before 0.0 and NaNs with
+//   the sign bit set before -inf, the others after inf
+template <radix_key K>
+[[nodiscard]] constexpr auto radix_bits(const K key) noexcept
+    -> radix_bits_t<K> {
+  using bits_type = radix_bits_t<K>;
+  constexpr auto sign_bit =
+      static_cast<bits_type>(bits_type{1} << ((sizeof(K) * CHAR_BIT) - 1));
+  const auto bits = std::bit_cast<bits_type>(key);
+  if constexpr (std::floating_point<K>) {
+    return ((bits & sign_bit) != 0) ? static_cast<bits_type>(~bits)
+                                    : static_cast<bits_type>(bits | sign_bit);
+  } else if constexpr (std::signed_integral<K>) {
+    return static_cast<bits_type>(bits ^ sign_bit);
+  } else {
+    return bits;
+  }
+}
+
+// 8-bit keys and 16-bit keys take 1 and 2 passes of 8-bit digits, larger
+// keys 11-bit digits, 3 passes for 32 bits and 6 for 64, the 2048 counters
+// of a digit still fit in L1
+template <radix_key K>
+inline constexpr size_t radix_digit_bits = (sizeof(K) <= 2) ? 8 : 11;
+
+// below this, std::stable_sort beats clearing and scanning the histograms
+inline constexpr size_t radix_minimum_count = 256;
+
+// stable LSD radix sort of values by key(value), through a buffer of the
+// same size from allocator
+// - one read pass counts the digits of every pass, passes where every key
+//   has the same digit are skipped
+// - each remaining pass scatters between values and the buffer, the result
+//   is copied back when it ends in the buffer
+template <typename T, typename KeyExtractor, typename Allocator>
+auto radix_sort(const std::span<T> values, KeyExtractor &key,
+                const Allocator &allocator) -> void {
+  using key_type = std::remove_cvref_t<std::invoke_result_t<KeyExtractor &,
+                                                            const T &>>;
+  constexpr size_t digit_bits = radix_digit_bits<key_type>;
+  constexpr size_t digit_count = size_t{1} << digit_bits;
+  constexpr size_t digit_mask = digit_count - 1;
+  constexpr size_t pass_count =
+      ((sizeof(key_type) * CHAR_BIT) + digit_bits - 1) / digit_bits;
+
+  const size_t count = values.size();
+  const auto digit = [&](const T &value, const size_t pass) -> size_t {
+    return static_cast<size_t>(
+        (radix_bits(std::invoke(key, value)) >> (pass * digit_bits)) &
+        digit_mask);
+  };
+  if (count < radix_minimum_count) {
+    std::stable_sort(values.begin(), values.end(),
+                     [&](const T &left, const T &right) {
+                       return radix_bits(std::invoke(key, left)) <
+                              radix_bits(std::invoke(key, right));
+                     });
+    return;
+  }
+
+  std::vector<size_t> histograms(pass_count * digit_count, 0);
+  for (const T &value : values) {
+    const auto bits = radix_bits(std::invoke(key, value));
+    for (size_t pass = 0; pass < pass_count; pass++) {
+      histograms[(pass * digit_count) +
+                 static_cast<size_t>((bits >> (pass * digit_bits)) &
+                                     digit_mask)]++;
+    }
+  }
+
+  using buffer_allocator =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+  using buffer_traits = std::allocator_traits<buffer_allocator>;
+  buffer_allocator buffer_alloc{allocator};
+  const auto buffer_release = [&](T *const p_buffer) {
+    buffer_traits::deallocate(buffer_alloc, p_buffer, count);
+  };
+  const std::unique_ptr<T[], decltype(buffer_release)> buffer{
+      buffer_traits::allocate(buffer_alloc, count), buffer_release};
+
+  T *p_source = values.data();
+  T *p_destination = buffer.get();
+  for (size_t pass = 0; pass < pass_count; pass++) {
+    const std::span<size_t> counts{&histograms[pass * digit_count],
+                                   digit_count};
+    if (std::ranges::find(counts, count) != counts.end()) {
+      continue;
+    }
+    // counts become the first destination index of each digit
+    size_t offset = 0;
+    for (size_t &digit_offset : counts) {
+      offset += std::exchange(digit_offset, offset);
+    }
+    for (size_t idx = 0; idx < count; idx++) {
+      std::memcpy(&p_destination[counts[digit(p_source[idx], pass)]++],
+                  &p_source[idx], sizeof(T));
+    }
+    std::swap(p_source, p_destination);
+  }
+  if (p_source != values.data()) {
+    std::memcpy(values.data(), p_source, count * sizeof(T));
+  }
+}
+
+} // namespace detail
+
+// stable radix sort of a darray of records, ascending by the integer or float
+// key extracted from each, e.g. [](const record &r) { return r.m_id; }
+// records are moved as bytes, so must be trivially copyable
+template <typename T, typename ThreadProtection, typename GrowthPolicy,
+          typename Allocator, typename KeyExtractor>
+  requires std::is_trivially_copyable_v<T> &&
+           std::regular_invocable<KeyExtractor &, const T &> &&
+           radix_key<std::remove_cvref_t<
+               std::invoke_result_t<KeyExtractor &, const T &>>>
+auto radix_sort(darray<T, ThreadProtection, GrowthPolicy, Allocator> &darray_obj,
+                KeyExtractor key) noexcept -> expected<void, error> {
+  try {
+    detail::radix_sort(std::span<T>{darray_obj.begin(), darray_obj.end()}, key,
+                       darray_obj.get_allocator());
+  } catch (const std::exception &err) {
+    return unexpected{error{format("Cannot radix sort, {}", err.what())}};
+  } catch (...) {
+    return unexpected{error{format("Unknown exception thrown by radix sort")}};
+  }
+  return {};
+}
+
+// stable radix sort of a darray of integer or float keys, ascending, with a
+// temporary buffer of the same size from the darray's allocator
+// NaNs sort by their bits: after inf, or before -inf with the sign bit set
+template <radix_key K, typename ThreadProtection, typename GrowthPolicy,
+          typename Allocator>
+auto radix_sort(darray<K, ThreadProtection, GrowthPolicy, Allocator>
+                    &darray_obj) noexcept -> expected<void, error> {
+  return radix_sort(darray_obj, std::identity{});
+}
+
+} // namespace CppPlay
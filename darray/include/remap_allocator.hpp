@@ -0,0 +1,155 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#pragma once
+
+#include <cstddef> // size_t & max_align_t
+#include <cstdint> // SIZE_MAX
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace CppPlay {
+
+// allocator able to grow a buffer in place
+// buffers below MMAP_THRESHOLD bytes come from malloc and grow with realloc,
+// which extends in place when the heap allows, larger buffers are mapped
+// directly and grow with mremap, so the kernel moves page table entries
+// rather than copying pages and the old and new buffer never coexist
+// reallocate moves bytes, so is only valid for trivially relocatable types,
+// darray only uses it for those
+// stateless, any instance can free memory from any other
+template <typename T, size_t MMAP_THRESHOLD = size_t{1} << 20>
+class remap_allocator {
+  static_assert(alignof(T) <= alignof(std::max_align_t),
+                "malloc and mmap only guarantee max_align_t alignment");
+
+  [[nodiscard]] static constexpr auto is_mapped(const size_t bytes) noexcept
+      -> bool {
+#if defined(__linux__)
+    return bytes >= MMAP_THRESHOLD;
+#else
+    return false;
+#endif
+  }
+
+  [[nodiscard]] static inline auto bytes_of(const size_t count) -> size_t {
+    [[unlikely]] if (count > (SIZE_MAX / sizeof(T))) {
+      throw std::bad_array_new_length{};
+    }
+    return count * sizeof(T);
+  }
+
+  [[nodiscard]] static inline auto allocate_bytes(const size_t bytes)
+      -> void * {
+#if defined(__linux__)
+    if (is_mapped(bytes)) {
+      void *const p_memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                                  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      [[unlikely]] if (MAP_FAILED == p_memory) { throw std::bad_alloc{}; }
+      return p_memory;
+    }
+#endif
+    // malloc(0) may return nullptr, a zero capacity buffer is still a buffer
+    void *const p_memory = std::malloc((0 == bytes) ? 1 : bytes);
+    [[unlikely]] if (nullptr == p_memory) { throw std::bad_alloc{}; }
+    return p_memory;
+  }
+
+  static inline auto deallocate_bytes(void *const p_memory,
+                                      const size_t bytes) noexcept -> void {
+#if defined(__linux__)
+    if (is_mapped(bytes)) {
+      munmap(p_memory, bytes);
+      return;
+    }
+#endif
+    std::free(p_memory);
+  }
+
+public:
+  using value_type = T;
+  using is_always_equal = std::true_type;
+  template <typename U> struct rebind {
+    using other = remap_allocator<U, MMAP_THRESHOLD>;
+  };
+
+  constexpr remap_allocator() noexcept = default;
+  template <typename U>
+  constexpr remap_allocator(
+      [[maybe_unused]] const remap_allocator<U, MMAP_THRESHOLD> &other) noexcept {}
+
+  [[nodiscard]] auto allocate(const size_t count) -> T * {
+    return static_cast<T *>(allocate_bytes(bytes_of(count)));
+  }
+  auto deallocate(T *const p_memory, const size_t count) noexcept -> void {
+    deallocate_bytes(static_cast<void *>(p_memory), count * sizeof(T));
+  }
+
+  // resize the buffer holding old_count elements to new_count elements,
+  // keeping its contents (bytes beyond new_count are lost), the buffer may
+  // move, on failure throws and the original buffer is untouched
+  [[nodiscard]] auto reallocate(T *const p_memory, const size_t old_count,
+                                const size_t new_count) -> T * {
+    const size_t old_bytes = old_count * sizeof(T);
+    const size_t new_bytes = bytes_of(new_count);
+    void *p_resized = nullptr;
+#if defined(__linux__)
+    if (is_mapped(old_bytes) && is_mapped(new_bytes)) {
+      p_resized = mremap(static_cast<void *>(p_memory), old_bytes, new_bytes,
+                         MREMAP_MAYMOVE);
+      [[unlikely]] if (MAP_FAILED == p_resized) { throw std::bad_alloc{}; }
+      return static_cast<T *>(p_resized);
+    }
+    if (is_mapped(old_bytes) || is_mapped(new_bytes)) {
+      // crossing the threshold, one copy of the smaller side
+      p_resized = allocate_bytes(new_bytes);
+      std::memcpy(p_resized, static_cast<const void *>(p_memory),
+                  (old_bytes < new_bytes) ? old_bytes : new_bytes);
+      deallocate_bytes(static_cast<void *>(p_memory), old_bytes);
+      return static_cast<T *>(p_resized);
+    }
+#endif
+    p_resized = std::realloc(static_cast<void *>(p_memory), new_bytes);
+    [[unlikely]] if (nullptr == p_resized) { throw std::bad_alloc{}; }
+    return static_cast<T *>(p_resized);
+  }
+
+  template <typename U>
+  [[nodiscard]] constexpr auto
+  operator==([[maybe_unused]] const remap_allocator<U, MMAP_THRESHOLD> &other)
+      const noexcept -> bool {
+    return true;
+  }
+};
+
+} // namespace CppPlay
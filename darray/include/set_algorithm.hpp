@@ -0,0 +1,752 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#pragma once
+
+
+#include "darray.hpp"
+#include "simd_algorithm.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef> // size_t & byte
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+// merge and set algebra of sorted contiguous ranges (darray, std::vector,
+// span, ...), appending the result to a darray
+// - the output grows at most once, to the largest possible result, so a
+//   darray built with that much spare capacity is filled without allocating
+// - ranges are sorted by comp, which must not throw, duplicates are kept as
+//   by the std algorithms (e.g. an intersection keeps the lower count)
+// - an input many times longer than the other is galloped (exponential then
+//   binary search) instead of walked, skewed sizes cost O(m log(n / m))
+// - intersections of 32-bit integers compare blocks of both ranges with SSE2
+//   or AVX2 once both are checked to be strictly increasing, ranges with
+//   duplicates are walked
+// - k_way_merge plays a tournament tree, log2(k) comparisons per element
+// - the output darray must not be one of the inputs
+namespace CppPlay {
+
+// sorted input of T, elements are read in place
+template <typename R, typename T>
+concept sorted_input = std::ranges::contiguous_range<R> &&
+                       std::ranges::sized_range<R> &&
+                       std::same_as<std::ranges::range_value_t<R>, T>;
+
+namespace detail {
+
+// a range this many times longer than the other is galloped, the vector
+// intersection walks 8 elements of a sparse range per step and keeps up with
+// a gallop further
+inline constexpr size_t s_gallop_ratio = 4;
+inline constexpr size_t s_vector_gallop_ratio = 64;
+inline constexpr size_t s_gallop_scan = 16;
+
+[[nodiscard]] constexpr auto
+gallops(const size_t short_count, const size_t long_count,
+        const size_t ratio = s_gallop_ratio) noexcept -> bool {
+  return (short_count < (long_count / ratio));
+}
+
+template <typename T, typename R>
+[[nodiscard]] auto as_span(const R &range) noexcept -> std::span<const T> {
+  return {std::ranges::data(range),
+          static_cast<size_t>(std::ranges::size(range))};
+}
+
+// first element of [first, last) failing pred, expected near first: a short
+// run is scanned (ending in a single mispredicted branch), past that the step
+// doubles until it passes it, then the last step is binary searched
+template <typename T, typename Pred>
+auto gallop(const T *const first, const T *const last, Pred pred) -> const T * {
+  const auto count = static_cast<size_t>(last - first);
+  const size_t scanned = std::min(count, s_gallop_scan);
+  for (size_t idx = 0; idx < scanned; idx++) {
+    if (!pred(first[idx])) {
+      return first + idx;
+    }
+  }
+  if (scanned == count) {
+    return last;
+  }
+  size_t bound = s_gallop_scan;
+  while ((bound < count) && pred(first[bound])) {
+    bound *= 2;
+  }
+  return std::partition_point(first + (bound / 2),
+                              first + std::min(bound + 1, count), pred);
+}
+
+// construct value at p_out, advance past it when kept, trivially copyable
+// values are stored either way so the loops do not branch on the result
+template <typename T>
+[[gnu::always_inline]] inline auto emit(T *const p_out, const T &value,
+                                        const bool keep) -> T * {
+  if constexpr (std::is_trivially_copyable_v<T>) {
+    std::construct_at(p_out, value);
+    return p_out + static_cast<size_t>(keep);
+  } else {
+    if (keep) {
+      std::construct_at(p_out, value);
+      return p_out + 1;
+    }
+    return p_out;
+  }
+}
+
+template <typename T>
+auto copy_out(const T *const first, const T *const last, T *const p_out)
+    -> T * {
+  return std::uninitialized_copy(first, last, p_out);
+}
+
+//
+// merge, equal elements of left first
+//
+template <typename T, typename Compare>
+auto merge_walk(const std::span<const T> left, const std::span<const T> right,
+                T *p_out, Compare &comp) -> T * {
+  const T *p_left = left.data();
+  const T *p_right = right.data();
+  const T *const p_left_end = p_left + left.size();
+  const T *const p_right_end = p_right + right.size();
+  while ((p_left != p_left_end) && (p_right != p_right_end)) {
+    const bool take_right = comp(*p_right, *p_left);
+    std::construct_at(p_out++, take_right ? *p_right : *p_left);
+    p_right += static_cast<size_t>(take_right);
+    p_left += static_cast<size_t>(!take_right);
+  }
+  p_out = copy_out(p_left, p_left_end, p_out);
+  return copy_out(p_right, p_right_end, p_out);
+}
+
+// each element of the short range lands after a galloped run of the long one
+template <bool SHORT_IS_LEFT, typename T, typename Compare>
+auto merge_gallop(const std::span<const T> short_range,
+                  const std::span<const T> long_range, T *p_out,
+                  Compare &comp) -> T * {
+  const T *p_long = long_range.data();
+  const T *const p_long_end = p_long + long_range.size();
+  for (const T &value : short_range) {
+    const T *const p_run_end =
+        gallop(p_long, p_long_end, [&](const T &long_value) {
+          if constexpr (SHORT_IS_LEFT) {
+            return comp(long_value, value);
+          } else {
+            return !comp(value, long_value);
+          }
+        });
+    p_out = copy_out(p_long, p_run_end, p_out);
+    p_long = p_run_end;
+    std::construct_at(p_out++, value);
+  }
+  return copy_out(p_long, p_long_end, p_out);
+}
+
+template <typename T, typename Compare>
+auto merge(const std::span<const T> left, const std::span<const T> right,
+           T *const p_out, Compare &comp) -> T * {
+  if (gallops(left.size(), right.size())) {
+    return merge_gallop<true>(left, right, p_out, comp);
+  }
+  if (gallops(right.size(), left.size())) {
+    return merge_gallop<false>(right, left, p_out, comp);
+  }
+  return merge_walk(left, right, p_out, comp);
+}
+
+//
+// union, of equal elements left's are kept
+//
+template <typename T, typename Compare>
+auto union_walk(const std::span<const T> left, const std::span<const T> right,
+                T *p_out, Compare &comp) -> T * {
+  const T *p_left = left.data();
+  const T *p_right = right.data();
+  const T *const p_left_end = p_left + left.size();
+  const T *const p_right_end = p_right + right.size();
+  while ((p_left != p_left_end) && (p_right != p_right_end)) {
+    const bool left_less = comp(*p_left, *p_right);
+    const bool right_less = comp(*p_right, *p_left);
+    std::construct_at(p_out++, right_less ? *p_right : *p_left);
+    p_left += static_cast<size_t>(!right_less);
+    p_right += static_cast<size_t>(!left_less);
+  }
+  p_out = copy_out(p_left, p_left_end, p_out);
+  return copy_out(p_right, p_right_end, p_out);
+}
+
+template <bool SHORT_IS_LEFT, typename T, typename Compare>
+auto union_gallop(const std::span<const T> short_range,
+                  const std::span<const T> long_range, T *p_out,
+                  Compare &comp) -> T * {
+  const T *p_long = long_range.data();
+  const T *const p_long_end = p_long + long_range.size();
+  for (const T &value : short_range) {
+    const T *const p_run_end = gallop(
+        p_long, p_long_end,
+        [&](const T &long_value) { return comp(long_value, value); });
+    p_out = copy_out(p_long, p_run_end, p_out);
+    p_long = p_run_end;
+    const bool equal = (p_long != p_long_end) && !comp(value, *p_long);
+    std::construct_at(p_out++, (SHORT_IS_LEFT || !equal) ? value : *p_long);
+    p_long += static_cast<size_t>(equal);
+  }
+  return copy_out(p_long, p_long_end, p_out);
+}
+
+template <typename T, typename Compare>
+auto set_union(const std::span<const T> left, const std::span<const T> right,
+               T *const p_out, Compare &comp) -> T * {
+  if (gallops(left.size(), right.size())) {
+    return union_gallop<true>(left, right, p_out, comp);
+  }
+  if (gallops(right.size(), left.size())) {
+    return union_gallop<false>(right, left, p_out, comp);
+  }
+  return union_walk(left, right, p_out, comp);
+}
+
+//
+// intersection, of equal elements left's are kept
+//
+template <typename T, typename Compare>
+auto intersection_walk(const std::span<const T> left,
+                       const std::span<const T> right, T *p_out,
+                       Compare &comp) -> T * {
+  const T *p_left = left.data();
+  const T *p_right = right.data();
+  const T *const p_left_end = p_left + left.size();
+  const T *const p_right_end = p_right + right.size();
+  while ((p_left != p_left_end) && (p_right != p_right_end)) {
+    const bool left_less = comp(*p_left, *p_right);
+    const bool right_less = comp(*p_right, *p_left);
+    p_out = emit(p_out, *p_left, !left_less && !right_less);
+    p_left += static_cast<size_t>(!right_less);
+    p_right += static_cast<size_t>(!left_less);
+  }
+  return p_out;
+}
+
+template <bool SHORT_IS_LEFT, typename T, typename Compare>
+auto intersection_gallop(const std::span<const T> short_range,
+                         const std::span<const T> long_range, T *p_out,
+                         Compare &comp) -> T * {
+  const T *p_long = long_range.data();
+  const T *const p_long_end = p_long + long_range.size();
+  for (const T &value : short_range) {
+    p_long = gallop(p_long, p_long_end, [&](const T &long_value) {
+      return comp(long_value, value);
+    });
+    if (p_long == p_long_end) {
+      break;
+    }
+    const bool equal = !comp(value, *p_long);
+    p_out = emit(p_out, SHORT_IS_LEFT ? value : *p_long, equal);
+    p_long += static_cast<size_t>(equal);
+  }
+  return p_out;
+}
+
+// 32-bit integers ordered by < are intersected a block of each range at a
+// time: every lane of the left block is compared with every lane of the
+// right one through LANES rotations, then the block with the smaller last
+// element (or both) moves on
+// - AVX-512 runs the AVX2 width, its comparisons yield mask registers GCC
+//   cannot turn back into 32-bit lanes without AVX512DQ
+// - every lane of a block with a match is stored and the output advances
+//   past the matched ones, so the stores do not branch, the block loop stops
+//   while LANES stores still fit the output (the shorter range's length)
+// - blocks match a lane against any equal lane, which overcounts duplicates,
+//   callers check the ranges are strictly increasing, the tail still stops
+//   at the output's length
+template <typename T> struct intersection_kernel {
+  using value_type = T;
+  static constexpr size_t s_max_bytes = 32;
+
+  static auto scalar(const T *const p_left, const size_t left_count,
+                     const T *const p_right, const size_t right_count,
+                     T *const p_out) noexcept -> size_t {
+    std::less<T> comp{};
+    return static_cast<size_t>(
+        intersection_walk(std::span<const T>{p_left, left_count},
+                          std::span<const T>{p_right, right_count}, p_out,
+                          comp) -
+        p_out);
+  }
+
+  // equal |= (left == right rotated by ROTATE lanes)
+  template <size_t BYTES, size_t ROTATE, typename Mask, size_t... LANE>
+  [[gnu::always_inline]] static inline auto
+  match_rotation(const simd::detail::vector_t<T, BYTES> &left,
+                 const simd::detail::vector_t<T, BYTES> &right, Mask &equal,
+                 std::index_sequence<LANE...> /*lanes*/) noexcept -> void {
+    using index_t =
+        simd::detail::vector_t<simd::detail::lane_uint<T>, BYTES>;
+    constexpr size_t LANES = sizeof...(LANE);
+    equal |= (left == __builtin_shuffle(
+                          right, index_t{((LANE + ROTATE) % LANES)...}));
+  }
+
+  template <size_t BYTES, typename Mask, size_t... ROTATE>
+  [[gnu::always_inline]] static inline auto
+  match_block(const simd::detail::vector_t<T, BYTES> &left,
+              const simd::detail::vector_t<T, BYTES> &right, Mask &equal,
+              std::index_sequence<ROTATE...> /*rotations*/) noexcept -> void {
+    constexpr size_t LANES = BYTES / sizeof(T);
+    (match_rotation<BYTES, ROTATE + 1>(left, right, equal,
+                                       std::make_index_sequence<LANES>{}),
+     ...);
+  }
+
+  template <size_t VECTOR_BYTES>
+  [[gnu::always_inline]] static inline auto
+  vectorized(const T *const p_left, const size_t left_count,
+             const T *const p_right, const size_t right_count,
+             T *const p_out) noexcept -> size_t {
+    constexpr size_t BYTES = std::min(VECTOR_BYTES, s_max_bytes);
+    constexpr size_t LANES = BYTES / sizeof(T);
+    const size_t out_count = std::min(left_count, right_count);
+    size_t left = 0;
+    size_t right = 0;
+    size_t out = 0;
+    while (((left + LANES) <= left_count) &&
+           ((right + LANES) <= right_count) && ((out + LANES) <= out_count)) {
+      simd::detail::vector_t<T, BYTES> left_chunk;
+      simd::detail::vector_t<T, BYTES> right_chunk;
+      simd::detail::load<T, BYTES>(left_chunk, &p_left[left]);
+      simd::detail::load<T, BYTES>(right_chunk, &p_right[right]);
+      auto equal = (left_chunk == right_chunk);
+      match_block<BYTES>(left_chunk, right_chunk, equal,
+                         std::make_index_sequence<LANES - 1>{});
+      if (simd::detail::any<BYTES>(equal)) {
+        for (size_t lane = 0; lane < LANES; lane++) {
+          p_out[out] = p_left[left + lane];
+          out += static_cast<size_t>(0 != equal[lane]);
+        }
+      }
+      const T left_last = p_left[left + LANES - 1];
+      const T right_last = p_right[right + LANES - 1];
+      // masks rather than products, GCC turns those back into a branch
+      left += LANES & (size_t{0} - static_cast<size_t>(left_last <= right_last));
+      right +=
+          LANES & (size_t{0} - static_cast<size_t>(right_last <= left_last));
+    }
+    while ((left < left_count) && (right < right_count) &&
+           (out < out_count)) {
+      const T left_value = p_left[left];
+      const T right_value = p_right[right];
+      p_out[out] = left_value;
+      out += static_cast<size_t>(left_value == right_value);
+      left += static_cast<size_t>(left_value <= right_value);
+      right += static_cast<size_t>(right_value <= left_value);
+    }
+    return out;
+  }
+};
+
+template <typename T, typename Compare>
+inline constexpr bool s_simd_intersection =
+    std::integral<T> && (sizeof(T) == sizeof(std::uint32_t)) &&
+    (std::same_as<Compare, std::less<T>> || std::same_as<Compare, std::less<>> ||
+     std::same_as<Compare, std::ranges::less>);
+
+template <typename T>
+auto strictly_increasing(const std::span<const T> values) noexcept -> bool {
+  return std::adjacent_find(values.begin(), values.end(),
+                            std::greater_equal<T>{}) == values.end();
+}
+
+template <typename T, typename Compare>
+auto set_intersection(const std::span<const T> left,
+                      const std::span<const T> right, T *const p_out,
+                      Compare &comp, const simd::level requested) -> T * {
+  bool vectorized = false;
+  if constexpr (s_simd_intersection<T, Compare>) {
+    vectorized = (simd::level::SCALAR !=
+                  std::min(requested, simd::supported_level()));
+  }
+  const size_t ratio = vectorized ? s_vector_gallop_ratio : s_gallop_ratio;
+  if (gallops(left.size(), right.size(), ratio)) {
+    return intersection_gallop<true>(left, right, p_out, comp);
+  }
+  if (gallops(right.size(), left.size(), ratio)) {
+    return intersection_gallop<false>(right, left, p_out, comp);
+  }
+  if constexpr (s_simd_intersection<T, Compare>) {
+    // a linear pass, the blocks would overcount duplicates
+    if (vectorized && strictly_increasing(left) &&
+        strictly_increasing(right)) {
+      return p_out + simd::detail::dispatch<intersection_kernel<T>>(
+                         requested, left.data(), left.size(), right.data(),
+                         right.size(), p_out);
+    }
+  }
+  return intersection_walk(left, right, p_out, comp);
+}
+
+//
+// difference, elements of left not in right
+//
+template <typename T, typename Compare>
+auto difference_walk(const std::span<const T> left,
+                     const std::span<const T> right, T *p_out, Compare &comp)
+    -> T * {
+  const T *p_left = left.data();
+  const T *p_right = right.data();
+  const T *const p_left_end = p_left + left.size();
+  const T *const p_right_end = p_right + right.size();
+  while ((p_left != p_left_end) && (p_right != p_right_end)) {
+    const bool left_less = comp(*p_left, *p_right);
+    const bool right_less = comp(*p_right, *p_left);
+    p_out = emit(p_out, *p_left, left_less);
+    p_left += static_cast<size_t>(!right_less);
+    p_right += static_cast<size_t>(!left_less);
+  }
+  return copy_out(p_left, p_left_end, p_out);
+}
+
+// long left: runs of left between the elements of right are copied
+template <typename T, typename Compare>
+auto difference_gallop_left(const std::span<const T> left,
+                            const std::span<const T> right, T *p_out,
+                            Compare &comp) -> T * {
+  const T *p_left = left.data();
+  const T *const p_left_end = p_left + left.size();
+  for (const T &value : right) {
+    const T *const p_run_end = gallop(
+        p_left, p_left_end,
+        [&](const T &left_value) { return comp(left_value, value); });
+    p_out = copy_out(p_left, p_run_end, p_out);
+    p_left = p_run_end;
+    p_left += static_cast<size_t>((p_left != p_left_end) &&
+                                  !comp(value, *p_left));
+  }
+  return copy_out(p_left, p_left_end, p_out);
+}
+
+// long right: each element of left is looked up in right
+template <typename T, typename Compare>
+auto difference_gallop_right(const std::span<const T> left,
+                             const std::span<const T> right, T *p_out,
+                             Compare &comp) -> T * {
+  const T *p_right = right.data();
+  const T *const p_right_end = p_right + right.size();
+  for (const T &value : left) {
+    p_right = gallop(p_right, p_right_end, [&](const T &right_value) {
+      return comp(right_value, value);
+    });
+    const bool equal = (p_right != p_right_end) && !comp(value, *p_right);
+    p_out = emit(p_out, value, !equal);
+    p_right += static_cast<size_t>(equal);
+  }
+  return p_out;
+}
+
+template <typename T, typename Compare>
+auto set_difference(const std::span<const T> left,
+                    const std::span<const T> right, T *const p_out,
+                    Compare &comp) -> T * {
+  if (gallops(left.size(), right.size())) {
+    return difference_gallop_right(left, right, p_out, comp);
+  }
+  if (gallops(right.size(), left.size())) {
+    return difference_gallop_left(left, right, p_out, comp);
+  }
+  return difference_walk(left, right, p_out, comp);
+}
+
+//
+// k-way merge, a tournament tree of losers over the inputs: every inner node
+// keeps the input that lost the match played there, the winner (smallest
+// next element, then lowest rank) is output and only the matches on its path
+// to the root are replayed, log2(k) comparisons per element
+// - an input's rank is its index, an exhausted input (or padding) points at
+//   the largest element of all inputs with a rank above every input's, so
+//   it loses every match without a test, and matches play without branches
+//
+template <typename T> struct merge_cursor {
+  const T *m_p_next;
+  const T *m_p_end;
+  size_t m_rank;
+};
+
+template <typename T, typename Compare> struct loser_tree {
+  merge_cursor<T> *m_p_cursors; // leaves
+  size_t *m_p_losers;           // inner nodes 1 to leaves - 1
+  size_t m_leaves;              // power of two
+  const T *m_p_largest;
+  Compare &m_comp;
+
+  [[nodiscard]] auto beats(const size_t input, const size_t other) const
+      -> bool {
+    const merge_cursor<T> &cursor = m_p_cursors[input];
+    const merge_cursor<T> &other_cursor = m_p_cursors[other];
+    const bool less = m_comp(*cursor.m_p_next, *other_cursor.m_p_next);
+    const bool greater = m_comp(*other_cursor.m_p_next, *cursor.m_p_next);
+    return less | (!greater & (cursor.m_rank < other_cursor.m_rank));
+  }
+
+  // play the matches below node, returns the winner
+  auto build(const size_t node) -> size_t {
+    if (node >= m_leaves) {
+      return node - m_leaves;
+    }
+    const size_t left = build(2 * node);
+    const size_t right = build((2 * node) + 1);
+    const bool left_wins = beats(left, right);
+    m_p_losers[node] = left_wins ? right : left;
+    return left_wins ? left : right;
+  }
+
+  // the winner's next element and rank are carried up its path, only the
+  // losers' cursors are loaded
+  auto merge(const size_t count, T *p_out) -> T * {
+    size_t winner = build(1);
+    for (size_t idx = 0; idx < count; idx++) {
+      merge_cursor<T> &cursor = m_p_cursors[winner];
+      std::construct_at(p_out++, *cursor.m_p_next++);
+      [[unlikely]] if (cursor.m_p_next == cursor.m_p_end) {
+        cursor.m_p_next = m_p_largest;
+        cursor.m_rank += m_leaves;
+      }
+      auto next = reinterpret_cast<std::uintptr_t>(cursor.m_p_next);
+      size_t rank = cursor.m_rank;
+      for (size_t node = (m_leaves + winner) / 2; node > 0; node /= 2) {
+        const size_t loser = m_p_losers[node];
+        const merge_cursor<T> &loser_cursor = m_p_cursors[loser];
+        const T &winner_next = *reinterpret_cast<const T *>(next);
+        const bool loser_wins =
+            m_comp(*loser_cursor.m_p_next, winner_next) |
+            (!m_comp(winner_next, *loser_cursor.m_p_next) &
+             (loser_cursor.m_rank < rank));
+        // swap without a branch, compilers emit one for a ternary
+        const size_t mask = size_t{0} - static_cast<size_t>(loser_wins);
+        const size_t swap_input = (winner ^ loser) & mask;
+        m_p_losers[node] = loser ^ swap_input;
+        winner ^= swap_input;
+        next ^= (next ^ reinterpret_cast<std::uintptr_t>(
+                            loser_cursor.m_p_next)) &
+                mask;
+        rank ^= (rank ^ loser_cursor.m_rank) & mask;
+      }
+    }
+    return p_out;
+  }
+};
+
+// append what fill writes to out, fill gets the output and returns its end
+template <typename T, typename ThreadProtection, typename GrowthPolicy,
+          typename Allocator, typename Fill>
+auto append_result(darray<T, ThreadProtection, GrowthPolicy, Allocator> &out,
+                   const size_t max_count, Fill &&fill) noexcept
+    -> expected<size_t, error> {
+  size_t count = 0;
+  return out
+      .append_with(max_count,
+                   [&](T *const p_out) -> size_t {
+                     count = static_cast<size_t>(fill(p_out) - p_out);
+                     return count;
+                   })
+      .transform([&](size_t /*size*/) { return count; });
+}
+
+} // namespace detail
+
+// append left merged with right, of equal elements left's first (stable),
+// returns the number of elements appended
+template <typename L, typename R, typename T, typename ThreadProtection,
+          typename GrowthPolicy, typename Allocator,
+          typename Compare = std::less<T>>
+  requires sorted_input<L, T> && sorted_input<R, T> &&
+           std::copy_constructible<T> &&
+           std::strict_weak_order<Compare &, const T &, const T &>
+auto merge(const L &left, const R &right,
+           darray<T, ThreadProtection, GrowthPolicy, Allocator> &out,
+           Compare comp = {}) noexcept -> expected<size_t, error> {
+  const auto left_span = detail::as_span<T>(left);
+  const auto right_span = detail::as_span<T>(right);
+  return detail::append_result(
+      out, left_span.size() + right_span.size(), [&](T *const p_out) {
+        return detail::merge(left_span, right_span, p_out, comp);
+      });
+}
+
+// append the inputs merged, of equal elements those of earlier inputs
+// first (stable), returns the number of elements appended
+template <std::ranges::input_range Inputs, typename T,
+          typename ThreadProtection, typename GrowthPolicy,
+          typename Allocator, typename Compare = std::less<T>>
+  requires sorted_input<std::ranges::range_reference_t<Inputs>, T> &&
+           std::copy_constructible<T> &&
+           std::strict_weak_order<Compare &, const T &, const T &>
+auto k_way_merge(Inputs &&inputs,
+                 darray<T, ThreadProtection, GrowthPolicy, Allocator> &out,
+                 Compare comp = {}) noexcept -> expected<size_t, error> {
+  using cursor = detail::merge_cursor<T>;
+
+  darray<std::span<const T>> spans =
+      typename darray<std::span<const T>>::builder{}.build();
+  size_t total = 0;
+  for (auto &&input : inputs) {
+    const auto input_span = detail::as_span<T>(input);
+    if (input_span.empty()) {
+      continue;
+    }
+    const auto pushed = spans.push_back(input_span);
+    [[unlikely]] if (!pushed.has_value()) {
+      return unexpected{pushed.error()};
+    }
+    total += input_span.size();
+  }
+
+  // up to two inputs need no tree
+  const size_t count = spans.pod().size();
+  if (count <= 2) {
+    const std::span<const T> none{};
+    return CppPlay::merge((count > 0) ? spans[0] : none,
+                          (count > 1) ? spans[1] : none, out,
+                          std::move(comp));
+  }
+
+  // leaves and inner nodes
+  const size_t leaves = std::bit_ceil(count);
+  darray<cursor> cursors = typename darray<cursor>::builder{}
+                               .capacity(leaves)
+                               .build();
+  darray<size_t> losers =
+      typename darray<size_t>::builder{}.capacity(leaves).build();
+  const T *p_largest = nullptr;
+  for (size_t input = 0; input < count; input++) {
+    const T *const p_last = &spans[input].back();
+    if ((nullptr == p_largest) || comp(*p_largest, *p_last)) {
+      p_largest = p_last;
+    }
+  }
+  const auto allocated =
+      cursors
+          .append_with(leaves,
+                       [&](cursor *const p_cursors) {
+                         for (size_t input = 0; input < leaves; input++) {
+                           std::construct_at(
+                               &p_cursors[input],
+                               (input < count)
+                                   ? cursor{spans[input].data(),
+                                            spans[input].data() +
+                                                spans[input].size(),
+                                            input}
+                                   : cursor{p_largest, p_largest,
+                                            leaves + input});
+                         }
+                         return leaves;
+                       })
+          .and_then([&](size_t /*size*/) {
+            return losers.append_with(leaves, [&](size_t *const p_losers) {
+              std::uninitialized_value_construct_n(p_losers, leaves);
+              return leaves;
+            });
+          });
+  [[unlikely]] if (!allocated.has_value()) {
+    return unexpected{allocated.error()};
+  }
+  detail::loser_tree<T, Compare> tree{cursors.data(), losers.data(), leaves,
+                                      p_largest, comp};
+  return detail::append_result(out, total, [&](T *const p_out) {
+    return tree.merge(total, p_out);
+  });
+}
+
+// append the elements of left or right, of equal elements left's, returns
+// the number of elements appended
+template <typename L, typename R, typename T, typename ThreadProtection,
+          typename GrowthPolicy, typename Allocator,
+          typename Compare = std::less<T>>
+  requires sorted_input<L, T> && sorted_input<R, T> &&
+           std::copy_constructible<T> &&
+           std::strict_weak_order<Compare &, const T &, const T &>
+auto set_union(const L &left, const R &right,
+               darray<T, ThreadProtection, GrowthPolicy, Allocator> &out,
+               Compare comp = {}) noexcept -> expected<size_t, error> {
+  const auto left_span = detail::as_span<T>(left);
+  const auto right_span = detail::as_span<T>(right);
+  return detail::append_result(
+      out, left_span.size() + right_span.size(), [&](T *const p_out) {
+        return detail::set_union(left_span, right_span, p_out, comp);
+      });
+}
+
+// append the elements of left also in right, returns the number of elements
+// appended
+template <typename L, typename R, typename T, typename ThreadProtection,
+          typename GrowthPolicy, typename Allocator,
+          typename Compare = std::less<T>>
+  requires sorted_input<L, T> && sorted_input<R, T> &&
+           std::copy_constructible<T> &&
+           std::strict_weak_order<Compare &, const T &, const T &>
+auto set_intersection(
+    const L &left, const R &right,
+    darray<T, ThreadProtection, GrowthPolicy, Allocator> &out,
+    Compare comp = {},
+    const simd::level requested = simd::supported_level()) noexcept
+    -> expected<size_t, error> {
+  const auto left_span = detail::as_span<T>(left);
+  const auto right_span = detail::as_span<T>(right);
+  return detail::append_result(
+      out, std::min(left_span.size(), right_span.size()),
+      [&](T *const p_out) {
+        return detail::set_intersection(left_span, right_span, p_out, comp,
+                                        requested);
+      });
+}
+
+// append the elements of left not in right, returns the number of elements
+// appended
+template <typename L, typename R, typename T, typename ThreadProtection,
+          typename GrowthPolicy, typename Allocator,
+          typename Compare = std::less<T>>
+  requires sorted_input<L, T> && sorted_input<R, T> &&
+           std::copy_constructible<T> &&
+           std::strict_weak_order<Compare &, const T &, const T &>
+auto set_difference(const L &left, const R &right,
+                    darray<T, ThreadProtection, GrowthPolicy, Allocator> &out,
+                    Compare comp = {}) noexcept -> expected<size_t, error> {
+  const auto left_span = detail::as_span<T>(left);
+  const auto right_span = detail::as_span<T>(right);
+  return detail::append_result(out, left_span.size(), [&](T *const p_out) {
+    return detail::set_difference(left_span, right_span, p_out, comp);
+  });
+}
+
+} // namespace CppPlay
@@ -0,0 +1,260 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#pragma once
+
+#include "darray.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef> // size_t
+#include <deque>
+#include <exception>
+#include <expected>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace CppPlay {
+
+// concurrent darray for multi-producer push_back
+// storage is partitioned into shards, each a darray behind its own mutex on
+// its own cache line, and each thread appends to the shard picked by its
+// thread slot, so producers only contend when more threads than shards
+// elements are not ordered across shards, flatten or drain merge the shards
+// into one contiguous darray
+template <typename T, typename GrowthPolicy = GrowthPolicyDouble<T>,
+          typename Allocator = std::allocator<T>>
+class sharded_darray {
+public:
+  using shard_darray =
+      darray<T, ThreadProtectionDisabled<T>, GrowthPolicy, Allocator>;
+  using allocator_type = typename shard_darray::allocator_type;
+
+private:
+  // fixed rather than std::hardware_destructive_interference_size, which
+  // varies with compiler flags
+  static constexpr size_t CACHE_LINE_SIZE = 64;
+  static constexpr size_t DEFAULT_SHARD_CAPACITY = 64;
+
+  struct alignas(CACHE_LINE_SIZE) shard {
+    mutable std::mutex m_mutex;
+    shard_darray m_darray;
+
+    shard(const size_t capacity, const allocator_type &allocator)
+        : m_mutex{},
+          m_darray{typename shard_darray::builder{allocator}
+                       .capacity(capacity)
+                       .build()} {}
+  };
+
+  // deque never moves its elements, so shards (and their mutexes) stay put
+  std::deque<shard> m_shards;
+
+  sharded_darray(const size_t shard_count, const size_t shard_capacity,
+                 const allocator_type &allocator)
+      : m_shards{} {
+    for (size_t idx = 0; idx < std::max(shard_count, size_t{1}); idx++) {
+      m_shards.emplace_back(shard_capacity, allocator);
+    }
+  }
+
+  // threads are numbered in order of first use, so consecutive threads land
+  // on different shards
+  [[nodiscard]] static auto thread_slot() noexcept -> size_t {
+    static std::atomic<size_t> s_next_slot{0};
+    thread_local const size_t t_slot =
+        s_next_slot.fetch_add(1, std::memory_order_relaxed);
+    return t_slot;
+  }
+
+  // lock every shard, always in index order so concurrent callers can't
+  // deadlock
+  [[nodiscard]] auto lock_all() const
+      -> std::vector<std::unique_lock<std::mutex>> {
+    std::vector<std::unique_lock<std::mutex>> locks{};
+    locks.reserve(m_shards.size());
+    for (const shard &each : m_shards) {
+      locks.emplace_back(each.m_mutex);
+    }
+    return locks;
+  }
+
+  [[nodiscard]] auto size_locked() const noexcept -> size_t {
+    size_t total = 0;
+    for (const shard &each : m_shards) {
+      total += each.m_darray.pod().size();
+    }
+    return total;
+  }
+
+  // merge every shard into one darray, copying or moving elements out
+  template <bool MOVE, typename Self>
+  static auto merge(Self &self) noexcept -> expected<shard_darray, error> {
+    try {
+      const auto locks = self.lock_all();
+      shard_darray merged = typename shard_darray::builder{
+          self.m_shards.front().m_darray.get_allocator()}
+                                .capacity(self.size_locked())
+                                .build();
+      for (auto &each : self.m_shards) {
+        for (T &element : each.m_darray) {
+          expected<size_t, error> result = [&]() {
+            if constexpr (MOVE) {
+              return merged.push_back(move(element));
+            } else {
+              return merged.push_back(element);
+            }
+          }();
+          [[unlikely]] if (!result.has_value()) {
+            return unexpected{result.error()};
+          }
+        }
+        if constexpr (MOVE) {
+          // ignore clear error, elements have already been moved out
+          static_cast<void>(each.m_darray.clear());
+        }
+      }
+      return {move(merged)};
+    } catch (std::exception &err) {
+      return unexpected{error{format("{}", err.what())}};
+    }
+  }
+
+public:
+  //
+  // special member functions
+  //
+  sharded_darray() : sharded_darray{default_shard_count()} {}
+  explicit sharded_darray(const size_t shard_count)
+      : sharded_darray{shard_count, DEFAULT_SHARD_CAPACITY, allocator_type{}} {}
+  sharded_darray(const sharded_darray &) = delete;
+  auto operator=(const sharded_darray &) -> sharded_darray & = delete;
+  // moving is not thread protected, no other thread may be using either
+  sharded_darray(sharded_darray &&) noexcept = default;
+  auto operator=(sharded_darray &&) noexcept -> sharded_darray & = default;
+  ~sharded_darray() = default;
+
+  // one shard per hardware thread
+  [[nodiscard]] static auto default_shard_count() noexcept -> size_t {
+    return std::max(static_cast<size_t>(std::thread::hardware_concurrency()),
+                    size_t{1});
+  }
+
+  //
+  // sharded_darray builder helper
+  //
+  class builder {
+    size_t m_shard_count = default_shard_count();
+    size_t m_shard_capacity = DEFAULT_SHARD_CAPACITY;
+    allocator_type m_allocator;
+
+  public:
+    builder()
+      requires std::is_default_constructible_v<allocator_type>
+        : m_allocator{} {}
+    explicit builder(const allocator_type &allocator)
+        : m_allocator{allocator} {}
+
+    auto shards(const size_t shard_count) noexcept -> builder & {
+      m_shard_count = shard_count;
+      return *this;
+    }
+    // initial capacity of each shard
+    auto capacity(const size_t shard_capacity) noexcept -> builder & {
+      m_shard_capacity = shard_capacity;
+      return *this;
+    }
+    [[nodiscard]] auto build() const -> sharded_darray {
+      return sharded_darray{m_shard_count, m_shard_capacity, m_allocator};
+    }
+  };
+  friend builder;
+
+  //
+  // store
+  //
+  // appends to the calling thread's shard, returns the size of that shard
+  template <typename U>
+  auto push_back(U &&new_element) noexcept -> expected<size_t, error> {
+    shard &target = m_shards[shard_index()];
+    const std::lock_guard<std::mutex> lock(target.m_mutex);
+    return target.m_darray.push_back(forward<U>(new_element));
+  }
+
+  //
+  // merge
+  //
+  // copy of every element, shard by shard, as one contiguous darray
+  [[nodiscard]] auto flatten() const noexcept
+      -> expected<shard_darray, error> {
+    return merge<false>(*this);
+  }
+
+  // move every element out, shard by shard, as one contiguous darray,
+  // leaving every shard empty
+  [[nodiscard]] auto drain() noexcept -> expected<shard_darray, error> {
+    return merge<true>(*this);
+  }
+
+  // visit every element, each shard is locked while its elements are visited
+  template <typename Function> auto for_each(Function &&function) const -> void {
+    for (const shard &each : m_shards) {
+      const std::lock_guard<std::mutex> lock(each.m_mutex);
+      for (const T &element : each.m_darray) {
+        function(element);
+      }
+    }
+  }
+
+  //
+  // metadata
+  //
+  // consistent across shards, all are locked while counting
+  [[nodiscard]] auto size() const noexcept -> expected<size_t, error> {
+    try {
+      const auto locks = lock_all();
+      return {size_locked()};
+    } catch (std::exception &err) {
+      return unexpected{error{format("{}", err.what())}};
+    }
+  }
+
+  [[nodiscard]] auto shard_count() const noexcept -> size_t {
+    return m_shards.size();
+  }
+
+  // shard the calling thread appends to
+  [[nodiscard]] auto shard_index() const noexcept -> size_t {
+    return thread_slot() % m_shards.size();
+  }
+};
+
+} // namespace CppPlay
@@ -0,0 +1,523 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#pragma once
+
+#include "darray.hpp"
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef> // size_t & byte
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <type_traits>
+
+// x86 vector paths need GCC (or clang) target attributes and cpu detection
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define CPPPLAY_SIMD_X86 1
+#else
+#define CPPPLAY_SIMD_X86 0
+#endif
+
+// vectorized search and reduction kernels over contiguous arithmetic ranges
+// (darray, std::vector, span, ...)
+// - each kernel has SSE2, AVX2 and AVX-512 paths, chosen at runtime from what
+//   the cpu supports, and a scalar fallback
+// - kernels are written once with GCC vector extensions and compiled per
+//   instruction set through target attributes, so no build flags are needed
+// - floating point sum and dot are reassociated across vector lanes, so they
+//   may round differently than a sequential loop, and NaN elements give an
+//   unspecified min/max
+namespace CppPlay::simd {
+
+enum class level : std::uint8_t { SCALAR, SSE2, AVX2, AVX512 };
+
+// highest level the running cpu supports, detected once
+[[nodiscard]] inline auto supported_level() noexcept -> level {
+#if CPPPLAY_SIMD_X86
+  static const level s_level = []() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") &&
+        __builtin_cpu_supports("avx512bw")) {
+      return level::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+      return level::AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+      return level::SSE2;
+    }
+    return level::SCALAR;
+  }();
+  return s_level;
+#else
+  return level::SCALAR;
+#endif
+}
+
+template <typename T>
+concept arithmetic = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+
+template <typename R>
+concept arithmetic_range =
+    std::ranges::contiguous_range<R> && std::ranges::sized_range<R> &&
+    arithmetic<std::ranges::range_value_t<R>>;
+
+// sum and dot accumulate integers in 64 bits, floating point in T
+template <arithmetic T>
+using sum_type = std::conditional_t<
+    std::is_floating_point_v<T>, T,
+    std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>>;
+
+template <arithmetic T> struct indexed_value {
+  T m_value;
+  size_t m_index;
+  auto operator==(const indexed_value &) const -> bool = default;
+};
+
+namespace detail {
+
+template <typename T, size_t BYTES> struct vector {
+  typedef T type __attribute__((vector_size(BYTES)));
+};
+template <typename T, size_t BYTES>
+using vector_t = typename vector<T, BYTES>::type;
+
+// unsigned integer as wide as T, the lane type of comparison masks
+template <typename T>
+using lane_uint = std::conditional_t<
+    sizeof(T) == 1, std::uint8_t,
+    std::conditional_t<sizeof(T) == 2, std::uint16_t,
+                       std::conditional_t<sizeof(T) == 4, std::uint32_t,
+                                          std::uint64_t>>>;
+
+// long double has no vector lanes, scalar only
+template <typename T>
+inline constexpr bool vectorizable = (sizeof(T) <= sizeof(std::uint64_t));
+
+// unaligned load
+template <typename T, size_t BYTES>
+[[gnu::always_inline]] inline auto load(vector_t<T, BYTES> &chunk,
+                                        const T *const p_values) noexcept
+    -> void {
+  std::memcpy(&chunk, p_values, BYTES);
+}
+
+// any lane of a comparison mask set
+template <size_t BYTES, typename Mask>
+[[gnu::always_inline]] inline auto any(const Mask &mask) noexcept -> bool {
+  using words_t = vector_t<std::uint64_t, BYTES>;
+  const words_t words = reinterpret_cast<const words_t &>(mask);
+  std::uint64_t any_set = 0;
+  for (size_t word = 0; word < (BYTES / sizeof(std::uint64_t)); word++) {
+    any_set |= words[word];
+  }
+  return 0 != any_set;
+}
+
+//
+// kernels, a scalar fallback and a vector path for a vector width in bytes
+//
+template <typename T> struct find_kernel {
+  using value_type = T;
+
+  static auto scalar(const T *const p_values, const size_t count,
+                     const T value) noexcept -> size_t {
+    for (size_t idx = 0; idx < count; idx++) {
+      if (p_values[idx] == value) {
+        return idx;
+      }
+    }
+    return count;
+  }
+
+  template <size_t BYTES>
+  [[gnu::always_inline]] static inline auto
+  vectorized(const T *const p_values, const size_t count,
+             const T value) noexcept -> size_t {
+    constexpr size_t LANES = BYTES / sizeof(T);
+    const vector_t<T, BYTES> needle = vector_t<T, BYTES>{} + value;
+    size_t idx = 0;
+    for (; (idx + LANES) <= count; idx += LANES) {
+      vector_t<T, BYTES> chunk;
+      load<T, BYTES>(chunk, &p_values[idx]);
+      const auto equal = (chunk == needle);
+      if (any<BYTES>(equal)) {
+        for (size_t lane = 0; lane < LANES; lane++) {
+          if (0 != equal[lane]) {
+            return idx + lane;
+          }
+        }
+      }
+    }
+    return idx + scalar(&p_values[idx], count - idx, value);
+  }
+};
+
+template <typename T> struct count_kernel {
+  using value_type = T;
+
+  static auto scalar(const T *const p_values, const size_t count,
+                     const T value) noexcept -> size_t {
+    size_t equal = 0;
+    for (size_t idx = 0; idx < count; idx++) {
+      equal += (p_values[idx] == value) ? 1 : 0;
+    }
+    return equal;
+  }
+
+  template <size_t BYTES>
+  [[gnu::always_inline]] static inline auto
+  vectorized(const T *const p_values, const size_t count,
+             const T value) noexcept -> size_t {
+    constexpr size_t LANES = BYTES / sizeof(T);
+    using counts_t = vector_t<lane_uint<T>, BYTES>;
+    // a set mask lane is all ones, subtracting it counts one, lanes are
+    // flushed before they can wrap
+    constexpr size_t FLUSH_CHUNKS =
+        std::numeric_limits<lane_uint<T>>::max() < (size_t{1} << 30)
+            ? std::numeric_limits<lane_uint<T>>::max()
+            : (size_t{1} << 30);
+    const vector_t<T, BYTES> needle = vector_t<T, BYTES>{} + value;
+    size_t equal = 0;
+    size_t idx = 0;
+    while ((idx + LANES) <= count) {
+      counts_t counts{};
+      for (size_t flush = 0; (flush < FLUSH_CHUNKS) && ((idx + LANES) <= count);
+           flush++, idx += LANES) {
+        vector_t<T, BYTES> chunk;
+        load<T, BYTES>(chunk, &p_values[idx]);
+        const auto equal = (chunk == needle);
+        counts -= reinterpret_cast<const counts_t &>(equal);
+      }
+      for (size_t lane = 0; lane < LANES; lane++) {
+        equal += counts[lane];
+      }
+    }
+    return equal + scalar(&p_values[idx], count - idx, value);
+  }
+};
+
+// minimum or maximum, the first element of the extreme value is found
+// the range is scanned in blocks keeping the extreme value of each, only the
+// block holding the first extreme is scanned again for its index
+template <typename T, bool MINIMUM> struct extreme_kernel {
+  using value_type = T;
+
+  [[gnu::always_inline]] static inline auto before(const T left,
+                                                   const T right) noexcept
+      -> bool {
+    if constexpr (MINIMUM) {
+      return left < right;
+    } else {
+      return left > right;
+    }
+  }
+  // lane wise before, vectors are only passed by reference, a vector passed by
+  // value to a function compiled for another instruction set (e.g. std::less)
+  // is passed differently than the caller expects
+  template <size_t BYTES>
+  [[gnu::always_inline]] static inline auto
+  keep_before(vector_t<T, BYTES> &extremes,
+              const vector_t<T, BYTES> &chunk) noexcept -> void {
+    if constexpr (MINIMUM) {
+      extremes = (chunk < extremes) ? chunk : extremes;
+    } else {
+      extremes = (chunk > extremes) ? chunk : extremes;
+    }
+  }
+
+  static constexpr size_t BLOCK = 4096;
+
+  static auto scalar(const T *const p_values, const size_t count) noexcept
+      -> indexed_value<T> {
+    size_t extreme = 0;
+    for (size_t idx = 1; idx < count; idx++) {
+      if (before(p_values[idx], p_values[extreme])) {
+        extreme = idx;
+      }
+    }
+    return {p_values[extreme], extreme};
+  }
+
+  template <size_t BYTES>
+  [[gnu::always_inline]] static inline auto
+  vectorized(const T *const p_values, const size_t count) noexcept
+      -> indexed_value<T> {
+    constexpr size_t LANES = BYTES / sizeof(T);
+    T extreme = p_values[0];
+    size_t extreme_block = 0;
+    for (size_t block = 0; block < count; block += BLOCK) {
+      const size_t block_end = std::min(block + BLOCK, count);
+      vector_t<T, BYTES> block_extremes =
+          vector_t<T, BYTES>{} + p_values[block];
+      size_t idx = block;
+      for (; (idx + LANES) <= block_end; idx += LANES) {
+        vector_t<T, BYTES> chunk;
+        load<T, BYTES>(chunk, &p_values[idx]);
+        keep_before<BYTES>(block_extremes, chunk);
+      }
+      T block_extreme = block_extremes[0];
+      for (size_t lane = 1; lane < LANES; lane++) {
+        if (before(block_extremes[lane], block_extreme)) {
+          block_extreme = block_extremes[lane];
+        }
+      }
+      for (; idx < block_end; idx++) {
+        if (before(p_values[idx], block_extreme)) {
+          block_extreme = p_values[idx];
+        }
+      }
+      if (before(block_extreme, extreme)) {
+        extreme = block_extreme;
+        extreme_block = block;
+      }
+    }
+    const size_t block_count = std::min(BLOCK, count - extreme_block);
+    const size_t index =
+        find_kernel<T>::template vectorized<BYTES>(
+            &p_values[extreme_block], block_count, extreme) +
+        extreme_block;
+    [[unlikely]] if (index >= count) {
+      // unordered extreme (NaN), leave it to the scalar ordering
+      return scalar(p_values, count);
+    }
+    return {extreme, index};
+  }
+};
+
+template <typename T> struct sum_kernel {
+  using value_type = T;
+
+  static auto scalar(const T *const p_values, const size_t count) noexcept
+      -> sum_type<T> {
+    sum_type<T> sum{};
+    for (size_t idx = 0; idx < count; idx++) {
+      sum += static_cast<sum_type<T>>(p_values[idx]);
+    }
+    return sum;
+  }
+
+  template <size_t BYTES>
+  [[gnu::always_inline]] static inline auto
+  vectorized(const T *const p_values, const size_t count) noexcept
+      -> sum_type<T> {
+    // integers are loaded in parts that widen to one full vector of
+    // sum_type, a wider accumulator would not fit a register
+    constexpr size_t WIDEN = sizeof(sum_type<T>) / sizeof(T);
+    constexpr size_t PART_LANES = BYTES / sizeof(sum_type<T>);
+    using sums_t = vector_t<sum_type<T>, BYTES>;
+    sums_t sums{};
+    size_t idx = 0;
+    for (; (idx + (PART_LANES * WIDEN)) <= count;) {
+      for (size_t part = 0; part < WIDEN; part++, idx += PART_LANES) {
+        vector_t<T, BYTES / WIDEN> chunk;
+        load<T, BYTES / WIDEN>(chunk, &p_values[idx]);
+        sums += __builtin_convertvector(chunk, sums_t);
+      }
+    }
+    sum_type<T> sum{};
+    for (size_t lane = 0; lane < PART_LANES; lane++) {
+      sum += sums[lane];
+    }
+    return sum + scalar(&p_values[idx], count - idx);
+  }
+};
+
+template <typename T> struct dot_kernel {
+  using value_type = T;
+
+  static auto scalar(const T *const p_left, const T *const p_right,
+                     const size_t count) noexcept -> sum_type<T> {
+    sum_type<T> dot{};
+    for (size_t idx = 0; idx < count; idx++) {
+      dot += static_cast<sum_type<T>>(p_left[idx]) *
+             static_cast<sum_type<T>>(p_right[idx]);
+    }
+    return dot;
+  }
+
+  template <size_t BYTES>
+  [[gnu::always_inline]] static inline auto
+  vectorized(const T *const p_left, const T *const p_right,
+             const size_t count) noexcept -> sum_type<T> {
+    // widened in parts, as sum
+    constexpr size_t WIDEN = sizeof(sum_type<T>) / sizeof(T);
+    constexpr size_t PART_LANES = BYTES / sizeof(sum_type<T>);
+    using sums_t = vector_t<sum_type<T>, BYTES>;
+    sums_t sums{};
+    size_t idx = 0;
+    for (; (idx + (PART_LANES * WIDEN)) <= count;) {
+      for (size_t part = 0; part < WIDEN; part++, idx += PART_LANES) {
+        vector_t<T, BYTES / WIDEN> left;
+        vector_t<T, BYTES / WIDEN> right;
+        load<T, BYTES / WIDEN>(left, &p_left[idx]);
+        load<T, BYTES / WIDEN>(right, &p_right[idx]);
+        sums += __builtin_convertvector(left, sums_t) *
+                __builtin_convertvector(right, sums_t);
+      }
+    }
+    sum_type<T> dot{};
+    for (size_t lane = 0; lane < PART_LANES; lane++) {
+      dot += sums[lane];
+    }
+    return dot + scalar(&p_left[idx], &p_right[idx], count - idx);
+  }
+};
+
+//
+// runtime dispatch, a kernel's vector path is inlined into a function
+// compiled for each instruction set
+//
+#if CPPPLAY_SIMD_X86
+template <typename Kernel, typename... Args>
+[[gnu::target("sse2")]] auto run_sse2(const Args... args) noexcept {
+  return Kernel::template vectorized<16>(args...);
+}
+template <typename Kernel, typename... Args>
+[[gnu::target("avx2")]] auto run_avx2(const Args... args) noexcept {
+  return Kernel::template vectorized<32>(args...);
+}
+template <typename Kernel, typename... Args>
+[[gnu::target("avx512f,avx512bw")]] auto
+run_avx512(const Args... args) noexcept {
+  return Kernel::template vectorized<64>(args...);
+}
+#endif
+
+// requested level is capped at what the cpu supports
+template <typename Kernel, typename... Args>
+auto dispatch(const level requested, const Args... args) noexcept {
+#if CPPPLAY_SIMD_X86
+  if constexpr (vectorizable<typename Kernel::value_type>) {
+    switch (std::min(requested, supported_level())) {
+    case level::AVX512:
+      return run_avx512<Kernel>(args...);
+    case level::AVX2:
+      return run_avx2<Kernel>(args...);
+    case level::SSE2:
+      return run_sse2<Kernel>(args...);
+    case level::SCALAR:
+      break;
+    }
+  }
+#endif
+  return Kernel::scalar(args...);
+}
+
+} // namespace detail
+
+//
+// kernels
+//
+
+// index of the first element equal to value, size of the range if none
+template <arithmetic_range R>
+[[nodiscard]] auto find(const R &values,
+                        const std::ranges::range_value_t<R> value,
+                        const level requested = supported_level()) noexcept
+    -> size_t {
+  using T = std::ranges::range_value_t<R>;
+  return detail::dispatch<detail::find_kernel<T>>(
+      requested, std::ranges::data(values),
+      static_cast<size_t>(std::ranges::size(values)), value);
+}
+
+// number of elements equal to value
+template <arithmetic_range R>
+[[nodiscard]] auto count(const R &values,
+                         const std::ranges::range_value_t<R> value,
+                         const level requested = supported_level()) noexcept
+    -> size_t {
+  using T = std::ranges::range_value_t<R>;
+  return detail::dispatch<detail::count_kernel<T>>(
+      requested, std::ranges::data(values),
+      static_cast<size_t>(std::ranges::size(values)), value);
+}
+
+// smallest element and the index of its first occurrence
+template <arithmetic_range R>
+[[nodiscard]] auto min_element(const R &values,
+                               const level requested = supported_level()) noexcept
+    -> expected<indexed_value<std::ranges::range_value_t<R>>, error> {
+  using T = std::ranges::range_value_t<R>;
+  [[unlikely]] if (0 == std::ranges::size(values)) {
+    return unexpected{error{format("No minimum of an empty range")}};
+  }
+  return {detail::dispatch<detail::extreme_kernel<T, true>>(
+      requested, std::ranges::data(values),
+      static_cast<size_t>(std::ranges::size(values)))};
+}
+
+// largest element and the index of its first occurrence
+template <arithmetic_range R>
+[[nodiscard]] auto max_element(const R &values,
+                               const level requested = supported_level()) noexcept
+    -> expected<indexed_value<std::ranges::range_value_t<R>>, error> {
+  using T = std::ranges::range_value_t<R>;
+  [[unlikely]] if (0 == std::ranges::size(values)) {
+    return unexpected{error{format("No maximum of an empty range")}};
+  }
+  return {detail::dispatch<detail::extreme_kernel<T, false>>(
+      requested, std::ranges::data(values),
+      static_cast<size_t>(std::ranges::size(values)))};
+}
+
+template <arithmetic_range R>
+[[nodiscard]] auto sum(const R &values,
+                       const level requested = supported_level()) noexcept
+    -> sum_type<std::ranges::range_value_t<R>> {
+  using T = std::ranges::range_value_t<R>;
+  return detail::dispatch<detail::sum_kernel<T>>(
+      requested, std::ranges::data(values),
+      static_cast<size_t>(std::ranges::size(values)));
+}
+
+// ranges must be the same length
+template <arithmetic_range R, arithmetic_range S>
+  requires std::same_as<std::ranges::range_value_t<R>,
+                        std::ranges::range_value_t<S>>
+[[nodiscard]] auto dot(const R &left, const S &right,
+                       const level requested = supported_level()) noexcept
+    -> expected<sum_type<std::ranges::range_value_t<R>>, error> {
+  using T = std::ranges::range_value_t<R>;
+  [[unlikely]] if (std::ranges::size(left) != std::ranges::size(right)) {
+    return unexpected{error{format("Dot product of ranges of different length "
+                                   "({} and {})",
+                                   std::ranges::size(left),
+                                   std::ranges::size(right))}};
+  }
+  return {detail::dispatch<detail::dot_kernel<T>>(
+      requested, std::ranges::data(left), std::ranges::data(right),
+      static_cast<size_t>(std::ranges::size(left)))};
+}
+
+} // namespace CppPlay::simd
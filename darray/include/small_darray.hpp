@@ -0,0 +1,457 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#pragma once
+
+#include "darray.hpp"
+
+#include <algorithm>
+#include <cstddef> // size_t & byte
+#include <cstring>
+#include <expected>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace CppPlay {
+
+// darray keeping its first N elements inside the object
+// - no allocation until the N + 1 element is stored, so short lived arrays
+//   of a few elements never touch the heap
+// - on overflow elements spill to a heap buffer grown by GrowthPolicy, and
+//   return inside once a shrink would fit them
+// same store/extract/iterator API as darray, without thread protection
+// (tiny arrays are thread local, protect the owner if shared)
+template <typename T, size_t N, typename GrowthPolicy = GrowthPolicyDouble<T>,
+          typename Allocator = std::allocator<T>>
+class small_darray {
+  static_assert(N > 0, "inline capacity must hold at least one element");
+
+public:
+  using value_type = T;
+  using allocator_type =
+      typename allocator_traits<Allocator>::template rebind_alloc<T>;
+  using iterator = typename darray<T>::iterator;
+  static constexpr size_t INLINE_CAPACITY = N;
+
+private:
+  using alloc_traits = allocator_traits<allocator_type>;
+  static_assert(std::is_same_v<typename alloc_traits::pointer, T *>,
+                "small_darray requires an allocator using plain pointers");
+
+  // raw inline storage, only live elements are constructed
+  alignas(T) std::byte m_inline[N * sizeof(T)];
+  T *m_p_data;
+  size_t m_capacity;
+  size_t m_size;
+  [[no_unique_address]] allocator_type m_allocator;
+
+  [[nodiscard]] auto inline_data() noexcept -> T * {
+    return reinterpret_cast<T *>(m_inline);
+  }
+  [[nodiscard]] auto inline_data() const noexcept -> const T * {
+    return reinterpret_cast<const T *>(m_inline);
+  }
+
+  // valid for moveable and "copy only" objects, preferring move
+  // dest is raw storage, source is left as raw storage
+  // dest may overlap source when it is on the left (shift left or same buffer)
+  static auto relocate_left(T *const p_source, const size_t count,
+                            T *const p_dest) noexcept -> void {
+    [[unlikely]] if (0 == count) { return; }
+    if constexpr (is_trivially_relocatable_v<T>) {
+      std::memmove(static_cast<void *>(p_dest),
+                   static_cast<const void *>(p_source), count * sizeof(T));
+    } else {
+      for (size_t idx = 0; idx < count; idx++) {
+        if constexpr (is_move_constructible_v<T>) {
+          std::construct_at(&p_dest[idx], move(p_source[idx]));
+        } else {
+          std::construct_at(&p_dest[idx], p_source[idx]);
+        }
+        std::destroy_at(&p_source[idx]);
+      }
+    }
+  }
+  // as relocate_left, dest may overlap source when it is on the right
+  static auto relocate_right(T *const p_source, const size_t count,
+                             T *const p_dest) noexcept -> void {
+    [[unlikely]] if (0 == count) { return; }
+    if constexpr (is_trivially_relocatable_v<T>) {
+      std::memmove(static_cast<void *>(p_dest),
+                   static_cast<const void *>(p_source), count * sizeof(T));
+    } else {
+      for (size_t idx = count; idx-- > 0;) {
+        if constexpr (is_move_constructible_v<T>) {
+          std::construct_at(&p_dest[idx], move(p_source[idx]));
+        } else {
+          std::construct_at(&p_dest[idx], p_source[idx]);
+        }
+        std::destroy_at(&p_source[idx]);
+      }
+    }
+  }
+
+  auto heap_release() noexcept -> void {
+    if (!is_inline()) {
+      alloc_traits::deallocate(m_allocator, m_p_data, m_capacity);
+    }
+    m_p_data = inline_data();
+    m_capacity = N;
+  }
+
+  // move elements into a buffer of capacity, the inline storage when it fits
+  // leaves the darray unchanged when allocation fails
+  auto buffer_move_to(const size_t capacity) noexcept
+      -> expected<void, error> {
+    T *p_dest = inline_data();
+    if (capacity > N) {
+      try {
+        p_dest = alloc_traits::allocate(m_allocator, capacity);
+      } catch (bad_alloc &err) {
+        return unexpected{error{format("{}", err.what())}};
+      }
+    } else if (is_inline()) {
+      return {};
+    }
+    relocate_left(m_p_data, m_size, p_dest);
+    heap_release();
+    m_p_data = p_dest;
+    m_capacity = std::max(capacity, N);
+    return {};
+  }
+
+  auto buffer_increase_if_full() noexcept -> expected<void, error> {
+    [[likely]] if (m_size < m_capacity) { return {}; }
+    [[unlikely]] if (m_capacity >= alloc_traits::max_size(m_allocator)) {
+      return unexpected{error{format("Cannot grow beyond {} elements",
+                                     m_capacity)}};
+    }
+    return buffer_move_to(
+        std::max(GrowthPolicy::grow(m_capacity), m_capacity + 1));
+  }
+
+  // one growth policy step, back inside once it fits, failure to allocate a
+  // smaller buffer does not invalidate any invariants so is ignored
+  auto buffer_decrease_if_policy_shrinks() noexcept -> void {
+    [[likely]] if (is_inline()) { return; }
+    const size_t capacity = std::clamp(
+        GrowthPolicy::shrink(m_size, m_capacity), m_size, m_capacity);
+    [[likely]] if (capacity == m_capacity) { return; }
+    [[maybe_unused]] const auto result = buffer_move_to(capacity);
+  }
+
+  template <typename U>
+  auto emplace(U &&new_element, T *const p_dest) noexcept
+      -> expected<void, error> {
+    std::construct_at(p_dest, forward<U>(new_element));
+    return {};
+  }
+
+  // expects an empty inline darray, left that way when copying throws
+  auto copy_from(const small_darray &other) -> void {
+    if (other.m_size > N) {
+      m_p_data = alloc_traits::allocate(m_allocator, other.m_capacity);
+      m_capacity = other.m_capacity;
+    }
+    try {
+      std::uninitialized_copy_n(other.m_p_data, other.m_size, m_p_data);
+    } catch (...) {
+      heap_release();
+      throw;
+    }
+    m_size = other.m_size;
+  }
+
+  // allocators are equal (or propagated), so a heap buffer can be taken
+  auto take_from(small_darray &other) noexcept -> void {
+    if (other.is_inline()) {
+      relocate_left(other.m_p_data, other.m_size, inline_data());
+    } else {
+      m_p_data = other.m_p_data;
+      m_capacity = other.m_capacity;
+      other.m_p_data = other.inline_data();
+      other.m_capacity = N;
+    }
+    m_size = other.m_size;
+    other.m_size = 0;
+  }
+
+  explicit small_darray(const size_t capacity, const allocator_type &allocator)
+      : m_p_data{inline_data()}, m_capacity{N}, m_size{0},
+        m_allocator{allocator} {
+    if (capacity > N) {
+      // may throw, as darray does when its initial buffer cannot be allocated
+      m_p_data = alloc_traits::allocate(m_allocator, capacity);
+      m_capacity = capacity;
+    }
+  }
+
+public:
+  //
+  // special member functions
+  //
+
+  small_darray() noexcept(noexcept(allocator_type{}))
+    requires std::is_default_constructible_v<allocator_type>
+      : small_darray{allocator_type{}} {}
+
+  explicit small_darray(const allocator_type &allocator) noexcept
+      : m_p_data{inline_data()}, m_capacity{N}, m_size{0},
+        m_allocator{allocator} {}
+
+  ~small_darray() {
+    std::destroy_n(m_p_data, m_size);
+    heap_release();
+  }
+
+  small_darray(const small_darray &other)
+      : m_p_data{inline_data()}, m_capacity{N}, m_size{0},
+        m_allocator{alloc_traits::select_on_container_copy_construction(
+            other.m_allocator)} {
+    copy_from(other);
+  }
+
+  auto operator=(const small_darray &other) -> small_darray & {
+    [[unlikely]] if (this == &other) { return *this; }
+    std::destroy_n(m_p_data, m_size);
+    m_size = 0;
+    heap_release();
+    if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+      m_allocator = other.m_allocator;
+    }
+    copy_from(other);
+    return *this;
+  }
+
+  small_darray(small_darray &&other) noexcept
+      : m_p_data{inline_data()}, m_capacity{N}, m_size{0},
+        m_allocator{other.m_allocator} {
+    take_from(other);
+  }
+
+  // failure to allocate when allocators differ leaves both unchanged
+  auto operator=(small_darray &&other) noexcept -> small_darray & {
+    [[unlikely]] if (this == &other) { return *this; }
+    if (alloc_traits::propagate_on_container_move_assignment::value ||
+        (m_allocator == other.m_allocator)) {
+      std::destroy_n(m_p_data, m_size);
+      m_size = 0;
+      heap_release();
+      if constexpr (alloc_traits::propagate_on_container_move_assignment::
+                        value) {
+        m_allocator = other.m_allocator;
+      }
+      take_from(other);
+      return *this;
+    }
+    T *p_dest = inline_data();
+    if (other.m_size > N) {
+      try {
+        p_dest = alloc_traits::allocate(m_allocator, other.m_capacity);
+      } catch ([[maybe_unused]] bad_alloc &err) {
+        return *this;
+      }
+    }
+    std::destroy_n(m_p_data, m_size);
+    heap_release();
+    relocate_left(other.m_p_data, other.m_size, p_dest);
+    m_p_data = p_dest;
+    m_capacity = (other.m_size > N) ? other.m_capacity : N;
+    m_size = other.m_size;
+    other.m_size = 0;
+    return *this;
+  }
+
+  [[nodiscard]] auto get_allocator() const noexcept -> allocator_type {
+    return m_allocator;
+  }
+
+  //
+  // small_darray builder helper
+  //
+  class builder {
+    size_t m_initial_capacity = N;
+    allocator_type m_allocator;
+
+  public:
+    constexpr builder()
+      requires std::is_default_constructible_v<allocator_type>
+        : m_allocator{} {}
+    constexpr explicit builder(const allocator_type &allocator)
+        : m_allocator{allocator} {}
+
+    // capacities up to N are inline, beyond N allocate on build
+    constexpr auto capacity(size_t capacity) noexcept -> builder & {
+      m_initial_capacity = capacity;
+      return *this;
+    };
+    constexpr auto allocator(const allocator_type &allocator) noexcept
+        -> builder & {
+      std::destroy_at(&m_allocator);
+      std::construct_at(&m_allocator, allocator);
+      return *this;
+    };
+    [[nodiscard]] auto build() const -> small_darray {
+      return small_darray{m_initial_capacity, m_allocator};
+    };
+  };
+  friend builder;
+
+  //
+  // store
+  //
+  template <typename U>
+  auto push_back(U &&new_element) noexcept -> expected<size_t, error> {
+    return buffer_increase_if_full()
+        .and_then([&]() { return emplace(forward<U>(new_element), end_ptr()); })
+        .and_then([&]() -> expected<size_t, error> { return {++m_size}; });
+  }
+
+  template <typename U>
+  auto insert(U &&new_element, const size_t index) noexcept
+      -> expected<size_t, error> {
+    if (index > m_size) {
+      return unexpected{
+          error{format("Invalid insert criteria. Index ({}) beyond length of "
+                       "contiguous elements ({})",
+                       index, m_size)}};
+    }
+    return buffer_increase_if_full()
+        .and_then([&]() -> expected<void, error> {
+          relocate_right(&m_p_data[index], m_size - index,
+                         &m_p_data[index + 1]);
+          return emplace(forward<U>(new_element), &m_p_data[index]);
+        })
+        .and_then([&]() -> expected<size_t, error> { return {++m_size}; });
+  }
+
+  //
+  // extract
+  //
+  auto pop_back() noexcept -> expected<T, error> {
+    [[unlikely]] if (0 == m_size) {
+      return unexpected{error{format("No elements to pop")}};
+    }
+    return extract(m_size - 1);
+  }
+
+  auto extract(const size_t index) noexcept -> expected<T, error> {
+    [[unlikely]] if (index >= m_size) {
+      return unexpected{error{format("Cannot extract, index too large")}};
+    }
+    // pull element directly into return type so can be used for RVO, minimize
+    // copy/move
+    expected<T, error> ret = [&]() -> expected<T, error> {
+      if constexpr (is_move_constructible_v<T>) {
+        return {std::move(m_p_data[index])};
+      } else {
+        return {m_p_data[index]};
+      }
+    }();
+    std::destroy_at(&m_p_data[index]);
+    relocate_left(&m_p_data[index + 1], m_size - (index + 1),
+                  &m_p_data[index]);
+    m_size--;
+    buffer_decrease_if_policy_shrinks();
+    return ret;
+  }
+
+  // destroys every element and returns to inline storage
+  auto clear() noexcept -> expected<void, error> {
+    std::destroy_n(m_p_data, m_size);
+    m_size = 0;
+    heap_release();
+    return {};
+  }
+
+  //
+  // access - iterator (random access)
+  //
+  auto begin() const noexcept -> iterator { return iterator{m_p_data}; }
+  auto end() const noexcept -> iterator { return iterator{&m_p_data[m_size]}; }
+
+  //
+  // access - random
+  //
+  [[nodiscard]] auto at(const size_t idx) const noexcept
+      -> expected<iterator, error> {
+    [[unlikely]] if (idx >= m_size) {
+      return unexpected{error{format(
+          "Requested index {} beyond array end (size={})", idx, m_size)}};
+    }
+    return {iterator{&m_p_data[idx]}};
+  }
+  auto operator[](const size_t idx) const -> T & { return m_p_data[idx]; }
+
+  //
+  // metadata
+  //
+  [[nodiscard]] auto capacity() const noexcept -> expected<size_t, error> {
+    return {m_capacity};
+  }
+  [[nodiscard]] auto size() const noexcept -> expected<size_t, error> {
+    return {m_size};
+  }
+  [[nodiscard]] auto is_empty() const noexcept -> expected<bool, error> {
+    return {(0 == m_size)};
+  }
+  // elements are stored inside the object, not on the heap
+  [[nodiscard]] auto is_inline() const noexcept -> bool {
+    return m_p_data == inline_data();
+  }
+
+  // non-monadic (plain-old-data return value) metadata accessors
+  class pod_metadata_accessor {
+    const small_darray &m_darray;
+    constexpr explicit pod_metadata_accessor(const small_darray &darray_obj)
+        : m_darray{darray_obj} {}
+    friend small_darray;
+
+  public:
+    [[nodiscard]] constexpr auto capacity() const noexcept -> size_t {
+      return m_darray.m_capacity;
+    }
+    [[nodiscard]] constexpr auto size() const noexcept -> size_t {
+      return m_darray.m_size;
+    }
+    [[nodiscard]] constexpr auto is_empty() const noexcept -> bool {
+      return (0 == m_darray.m_size);
+    }
+  };
+  // get plain-old-data metadata accessor
+  [[nodiscard]] constexpr auto pod() const noexcept
+      -> const pod_metadata_accessor {
+    return pod_metadata_accessor{*this};
+  }
+
+private:
+  [[nodiscard]] auto end_ptr() noexcept -> T * { return &m_p_data[m_size]; }
+};
+
+} // namespace CppPlay
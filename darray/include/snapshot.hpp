@@ -0,0 +1,642 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#pragma once
+
+
+#include "darray.hpp"
+#include "darray_io.hpp"
+#include "simd_algorithm.hpp" // CPPPLAY_SIMD_X86
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <concepts>
+#include <cstddef> // size_t & byte
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <limits>
+#include <memory>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace CppPlay {
+
+#if defined(__linux__)
+
+// pluggable encoding of elements that are not trivially copyable
+// - size(element) is the encoded size in bytes
+// - save(element, p_out) writes exactly size(element) bytes to p_out
+// - load(bytes) decodes an element from the bytes save wrote for it
+template <typename S, typename T>
+concept snapshot_serializer =
+    requires(const S &serializer, const T &element, std::byte *p_out,
+             std::span<const std::byte> bytes) {
+      { serializer.size(element) } -> std::convertible_to<size_t>;
+      serializer.save(element, p_out);
+      { serializer.load(bytes) } -> std::same_as<expected<T, error>>;
+    };
+
+// serializer of strings (or any std::basic_string of trivial characters)
+template <typename String> struct string_serializer {
+  using char_type = typename String::value_type;
+
+  [[nodiscard]] auto size(const String &element) const noexcept -> size_t {
+    return element.size() * sizeof(char_type);
+  }
+  auto save(const String &element, std::byte *const p_out) const noexcept
+      -> void {
+    if (!element.empty()) {
+      std::memcpy(static_cast<void *>(p_out),
+                  static_cast<const void *>(element.data()), size(element));
+    }
+  }
+  [[nodiscard]] auto load(const std::span<const std::byte> bytes) const
+      noexcept -> expected<String, error> {
+    [[unlikely]] if (0 != (bytes.size() % sizeof(char_type))) {
+      return unexpected{error{format(
+          "Cannot load a string from {} bytes", bytes.size())}};
+    }
+    try {
+      String element(bytes.size() / sizeof(char_type), char_type{});
+      if (!bytes.empty()) {
+        std::memcpy(static_cast<void *>(element.data()),
+                    static_cast<const void *>(bytes.data()), bytes.size());
+      }
+      return {std::move(element)};
+    } catch (const std::bad_alloc &err) {
+      return unexpected{error{format("{}", err.what())}};
+    }
+  }
+};
+
+namespace detail {
+
+// snapshot file: header, then the payload
+// - trivially copyable elements: count elements at their in-memory
+//   representation, element size says how large one is
+// - serialized elements (element size 0): count records, each a 32-bit byte
+//   length and the serializer's bytes
+// the checksum is CRC-32C of the payload, numbers are native byte order
+struct snapshot_header {
+  std::uint64_t m_magic;
+  std::uint32_t m_version;
+  std::uint32_t m_element_size;
+  std::uint64_t m_count;
+  std::uint64_t m_payload_bytes;
+  std::uint32_t m_checksum;
+  std::uint32_t m_reserved;
+};
+// "CPSNAPSH" read as a little endian integer
+inline constexpr std::uint64_t s_snapshot_magic = 0x4853504153504350ULL;
+inline constexpr std::uint32_t s_snapshot_version = 1;
+inline constexpr size_t s_snapshot_chunk_bytes = size_t{1} << 20;
+using record_length = std::uint32_t;
+
+//
+// CRC-32C (Castagnoli), the SSE4.2 crc32 instruction when the cpu has it
+//
+inline constexpr std::uint32_t s_crc32c_polynomial = 0x82F63B78U; // reflected
+
+inline constexpr auto s_crc32c_table = []() {
+  std::array<std::uint32_t, 256> table{};
+  for (std::uint32_t byte = 0; byte < 256; byte++) {
+    std::uint32_t crc = byte;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (s_crc32c_polynomial & (0U - (crc & 1U)));
+    }
+    table[byte] = crc;
+  }
+  return table;
+}();
+
+[[nodiscard]] inline auto crc32c_scalar(std::uint32_t crc,
+                                        const std::byte *const p_bytes,
+                                        const size_t count) noexcept
+    -> std::uint32_t {
+  for (size_t idx = 0; idx < count; idx++) {
+    crc = (crc >> 8) ^
+          s_crc32c_table[(crc ^ static_cast<std::uint32_t>(p_bytes[idx])) &
+                         0xFFU];
+  }
+  return crc;
+}
+
+#if CPPPLAY_SIMD_X86 && defined(__x86_64__)
+[[gnu::target("sse4.2")]] inline auto
+crc32c_sse42(std::uint32_t crc, const std::byte *const p_bytes,
+             const size_t count) noexcept -> std::uint32_t {
+  size_t idx = 0;
+  std::uint64_t wide = crc;
+  for (; (idx + 8) <= count; idx += 8) {
+    std::uint64_t word = 0;
+    std::memcpy(&word, &p_bytes[idx], sizeof(word));
+    wide = __builtin_ia32_crc32di(wide, word);
+  }
+  crc = static_cast<std::uint32_t>(wide);
+  for (; idx < count; idx++) {
+    crc = __builtin_ia32_crc32qi(crc, static_cast<unsigned char>(p_bytes[idx]));
+  }
+  return crc;
+}
+#endif
+
+// continue the CRC-32C crc (0 to start) over count more bytes
+[[nodiscard]] inline auto crc32c(const std::uint32_t crc,
+                                 const std::byte *const p_bytes,
+                                 const size_t count) noexcept
+    -> std::uint32_t {
+  const std::uint32_t state = ~crc;
+#if CPPPLAY_SIMD_X86 && defined(__x86_64__)
+  static const bool s_has_sse42 = []() {
+    __builtin_cpu_init();
+    return static_cast<bool>(__builtin_cpu_supports("sse4.2"));
+  }();
+  if (s_has_sse42) {
+    return ~crc32c_sse42(state, p_bytes, count);
+  }
+#endif
+  return ~crc32c_scalar(state, p_bytes, count);
+}
+
+// owns a file descriptor
+class snapshot_file {
+  int m_fd = -1;
+
+public:
+  explicit snapshot_file(const int fd) noexcept : m_fd{fd} {}
+  snapshot_file(const snapshot_file &) = delete;
+  auto operator=(const snapshot_file &) -> snapshot_file & = delete;
+  ~snapshot_file() {
+    if (-1 != m_fd) {
+      close(m_fd);
+    }
+  }
+  [[nodiscard]] auto fd() const noexcept -> int { return m_fd; }
+  // close and report a failure (e.g. a delayed write error)
+  auto close_checked() noexcept -> expected<void, error> {
+    const int fd = std::exchange(m_fd, -1);
+    [[unlikely]] if (0 != close(fd)) { return io_error("close snapshot"); }
+    return {};
+  }
+};
+
+// chunk sized staging buffer, raw bytes
+[[nodiscard]] inline auto staging_buffer(const size_t bytes) noexcept
+    -> expected<darray<std::byte>, error> {
+  auto buffer = darray<std::byte>::builder{}.capacity(0).build();
+  return buffer
+      .append_with(bytes, [&](std::byte *const /*p_bytes*/) { return bytes; })
+      .transform([&](size_t /*size*/) { return std::move(buffer); });
+}
+
+// write the payload through fill, which stores bytes at the file position
+// and folds them into the checksum, then the header, to a temporary file
+// renamed over path once complete, so a crash never leaves a partial
+// snapshot at path, returns the file size
+template <typename Fill>
+auto write_snapshot(const string &path, snapshot_header header,
+                    Fill &&fill) noexcept -> expected<size_t, error> {
+  const string temp_path = path + ".partial";
+  snapshot_file file{
+      open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)};
+  [[unlikely]] if (-1 == file.fd()) { return io_error("create snapshot"); }
+
+  const auto skip_header = [&]() -> expected<void, error> {
+    [[unlikely]] if (0 > lseek(file.fd(), sizeof(snapshot_header),
+                               SEEK_SET)) {
+      return io_error("seek snapshot");
+    }
+    return {};
+  };
+  const auto write_header = [&]() {
+    return write_fully(file.fd(), reinterpret_cast<const std::byte *>(&header),
+                       sizeof(header), 0);
+  };
+  const auto replace_path = [&]() -> expected<void, error> {
+    [[unlikely]] if (0 != rename(temp_path.c_str(), path.c_str())) {
+      return io_error("rename snapshot");
+    }
+    return {};
+  };
+
+  // payload after room for the header, the header once the checksum is known
+  const expected<void, error> result =
+      skip_header()
+          .and_then([&]() { return fill(file.fd(), header); })
+          .and_then(write_header)
+          .and_then([&]() { return file.close_checked(); })
+          .and_then(replace_path);
+  [[unlikely]] if (!result.has_value()) {
+    unlink(temp_path.c_str());
+    return unexpected{result.error()};
+  }
+  return {sizeof(snapshot_header) + header.m_payload_bytes};
+}
+
+// open path and check its header, element_size 0 for serialized elements
+[[nodiscard]] inline auto open_snapshot(const string &path,
+                                        const std::uint32_t element_size,
+                                        snapshot_header &header) noexcept
+    -> expected<int, error> {
+  const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  [[unlikely]] if (-1 == fd) { return io_error("open snapshot"); }
+  const auto check = [&]() -> expected<int, error> {
+    const expected<size_t, error> got =
+        read_fully(fd, reinterpret_cast<std::byte *>(&header), sizeof(header));
+    [[unlikely]] if (!got.has_value()) { return unexpected{got.error()}; }
+    [[unlikely]] if ((sizeof(header) != got.value()) ||
+                     (s_snapshot_magic != header.m_magic)) {
+      return unexpected{error{"Cannot load snapshot, not a snapshot file"}};
+    }
+    [[unlikely]] if (s_snapshot_version != header.m_version) {
+      return unexpected{error{format(
+          "Cannot load snapshot version {}, expected {}", header.m_version,
+          s_snapshot_version)}};
+    }
+    [[unlikely]] if (element_size != header.m_element_size) {
+      return unexpected{error{format(
+          "Cannot load snapshot of {} byte elements as {} byte elements",
+          header.m_element_size, element_size)}};
+    }
+    // a corrupt count or payload size would otherwise size the destination
+    // before a byte of payload is read, the file must hold the whole payload
+    struct stat file_stat {};
+    [[unlikely]] if (-1 == fstat(fd, &file_stat)) {
+      return io_error("stat snapshot");
+    }
+    const auto file_bytes = static_cast<std::uint64_t>(file_stat.st_size);
+    [[unlikely]] if (header.m_payload_bytes != (file_bytes - sizeof(header))) {
+      return unexpected{error{format(
+          "Cannot load snapshot, header has {} payload bytes, file has {}",
+          header.m_payload_bytes, file_bytes - sizeof(header))}};
+    }
+    return {fd};
+  };
+  const expected<int, error> result = check();
+  [[unlikely]] if (!result.has_value()) { close(fd); }
+  return result;
+}
+
+[[nodiscard]] inline auto checksum_mismatch() noexcept -> unexpected<error> {
+  return unexpected{error{"Cannot load snapshot, checksum mismatch"}};
+}
+[[nodiscard]] inline auto truncated_snapshot() noexcept -> unexpected<error> {
+  return unexpected{error{"Cannot load snapshot, file truncated"}};
+}
+
+} // namespace detail
+
+//
+// save
+//
+// write every element of source to a snapshot file at path, replacing it,
+// returns the file size
+// trivially copyable elements are written straight from the darray's
+// buffer a chunk at a time (no copy), the checksum computed on each chunk
+// while it is in cache
+// durability across power loss needs an fsync of the file and directory by
+// the caller, a crash of the process never leaves a partial snapshot
+template <typename T, typename ThreadProtection, typename GrowthPolicy,
+          typename Allocator>
+  requires std::is_trivially_copyable_v<T>
+auto save_snapshot(
+    const darray<T, ThreadProtection, GrowthPolicy, Allocator> &source,
+    const string &path,
+    const size_t chunk_bytes = detail::s_snapshot_chunk_bytes) noexcept
+    -> expected<size_t, error> {
+  const size_t count = source.pod().size();
+  const auto *const p_bytes =
+      reinterpret_cast<const std::byte *>(source.data());
+  const size_t payload_bytes = count * sizeof(T);
+  const size_t chunk = std::max(chunk_bytes, size_t{1});
+  return detail::write_snapshot(
+      path,
+      detail::snapshot_header{detail::s_snapshot_magic,
+                              detail::s_snapshot_version,
+                              static_cast<std::uint32_t>(sizeof(T)), count,
+                              payload_bytes, 0, 0},
+      [&](const int fd, detail::snapshot_header &header)
+          -> expected<void, error> {
+        for (size_t offset = 0; offset < payload_bytes; offset += chunk) {
+          const size_t bytes = std::min(chunk, payload_bytes - offset);
+          header.m_checksum =
+              detail::crc32c(header.m_checksum, &p_bytes[offset], bytes);
+          const expected<void, error> written =
+              detail::write_fully(fd, &p_bytes[offset], bytes);
+          [[unlikely]] if (!written.has_value()) { return written; }
+        }
+        return {};
+      });
+}
+
+// write every element of source to a snapshot file at path, encoded by
+// serializer into records staged chunk_bytes at a time, returns the file
+// size
+template <typename T, typename ThreadProtection, typename GrowthPolicy,
+          typename Allocator, typename Serializer>
+  requires snapshot_serializer<Serializer, T>
+auto save_snapshot(
+    const darray<T, ThreadProtection, GrowthPolicy, Allocator> &source,
+    const string &path, const Serializer &serializer,
+    const size_t chunk_bytes = detail::s_snapshot_chunk_bytes) noexcept
+    -> expected<size_t, error> {
+  using detail::record_length;
+  return detail::write_snapshot(
+      path,
+      detail::snapshot_header{detail::s_snapshot_magic,
+                              detail::s_snapshot_version, 0,
+                              source.pod().size(), 0, 0, 0},
+      [&](const int fd, detail::snapshot_header &header)
+          -> expected<void, error> {
+        expected<darray<std::byte>, error> staging =
+            detail::staging_buffer(std::max(chunk_bytes, sizeof(record_length)));
+        [[unlikely]] if (!staging.has_value()) {
+          return unexpected{staging.error()};
+        }
+        std::byte *const p_staging = staging.value().data();
+        const size_t staging_bytes = staging.value().pod().size();
+        size_t used = 0;
+
+        const auto flush = [&](const std::byte *const p_bytes,
+                               const size_t bytes) {
+          header.m_checksum = detail::crc32c(header.m_checksum, p_bytes, bytes);
+          header.m_payload_bytes += bytes;
+          return detail::write_fully(fd, p_bytes, bytes);
+        };
+        // bytes written through the staging buffer, flushed as it fills
+        const auto stage = [&](const std::byte *p_bytes, size_t bytes)
+            -> expected<void, error> {
+          while (bytes > 0) {
+            const size_t part = std::min(bytes, staging_bytes - used);
+            std::memcpy(&p_staging[used], p_bytes, part);
+            used += part;
+            p_bytes += part;
+            bytes -= part;
+            if (staging_bytes == used) {
+              const expected<void, error> flushed = flush(p_staging, used);
+              [[unlikely]] if (!flushed.has_value()) { return flushed; }
+              used = 0;
+            }
+          }
+          return {};
+        };
+
+        for (const T &element : source) {
+          const size_t bytes = serializer.size(element);
+          [[unlikely]] if (bytes > std::numeric_limits<record_length>::max()) {
+            return unexpected{error{format(
+                "Cannot save a {} byte element, records hold at most {}",
+                bytes, std::numeric_limits<record_length>::max())}};
+          }
+          const auto length = static_cast<record_length>(bytes);
+          const expected<void, error> staged = stage(
+              reinterpret_cast<const std::byte *>(&length), sizeof(length));
+          [[unlikely]] if (!staged.has_value()) { return staged; }
+          if ((staging_bytes - used) >= bytes) {
+            // encode in place
+            serializer.save(element, &p_staging[used]);
+            used += bytes;
+          } else {
+            // larger than the room left, encode aside and stage in parts
+            expected<darray<std::byte>, error> record =
+                detail::staging_buffer(bytes);
+            [[unlikely]] if (!record.has_value()) {
+              return unexpected{record.error()};
+            }
+            std::byte *const p_record = record.value().data();
+            serializer.save(element, p_record);
+            const expected<void, error> parts = stage(p_record, bytes);
+            [[unlikely]] if (!parts.has_value()) { return parts; }
+          }
+        }
+        return flush(p_staging, used);
+      });
+}
+
+//
+// load
+//
+// append the elements of the snapshot at path to destination, growing it
+// once for all of them, returns the number appended
+// trivially copyable elements are read chunk_bytes at a time straight into
+// the darray's spare capacity and checksummed while in cache, nothing is
+// appended unless the whole snapshot reads back and its checksum matches
+template <typename T, typename ThreadProtection, typename GrowthPolicy,
+          typename Allocator>
+  requires std::is_trivially_copyable_v<T>
+auto load_snapshot(
+    const string &path,
+    darray<T, ThreadProtection, GrowthPolicy, Allocator> &destination,
+    const size_t chunk_bytes = detail::s_snapshot_chunk_bytes) noexcept
+    -> expected<size_t, error> {
+  detail::snapshot_header header{};
+  return detail::open_snapshot(path, sizeof(T), header)
+      .and_then([&](const int fd) -> expected<size_t, error> {
+        detail::snapshot_file file{fd};
+        [[unlikely]] if ((header.m_count > (SIZE_MAX / sizeof(T))) ||
+                         (header.m_payload_bytes !=
+                          (header.m_count * sizeof(T)))) {
+          return unexpected{error{"Cannot load snapshot, corrupt header"}};
+        }
+        const auto count = static_cast<size_t>(header.m_count);
+        const size_t payload_bytes = count * sizeof(T);
+        const size_t chunk = std::max(chunk_bytes, size_t{1});
+        expected<void, error> result{};
+        return destination
+            .append_with(count,
+                         [&](T *const p_spare) -> size_t {
+                           auto *const p_bytes =
+                               reinterpret_cast<std::byte *>(p_spare);
+                           std::uint32_t checksum = 0;
+                           for (size_t offset = 0; offset < payload_bytes;
+                                offset += chunk) {
+                             const size_t bytes =
+                                 std::min(chunk, payload_bytes - offset);
+                             const expected<size_t, error> got =
+                                 detail::read_fully(fd, &p_bytes[offset], bytes);
+                             [[unlikely]] if (!got.has_value()) {
+                               result = unexpected{got.error()};
+                               return 0;
+                             }
+                             [[unlikely]] if (bytes != got.value()) {
+                               result = detail::truncated_snapshot();
+                               return 0;
+                             }
+                             checksum = detail::crc32c(
+                                 checksum, &p_bytes[offset], bytes);
+                           }
+                           [[unlikely]] if (checksum != header.m_checksum) {
+                             result = detail::checksum_mismatch();
+                             return 0;
+                           }
+                           return count;
+                         })
+            .and_then([&](size_t /*size*/) -> expected<size_t, error> {
+              return result.transform([&]() { return count; });
+            });
+      });
+}
+
+// append the elements of the snapshot at path to destination, decoded by
+// serializer from chunk_bytes reads, growing destination once, returns the
+// number appended
+// nothing is appended unless every record decodes and the checksum matches
+template <typename T, typename ThreadProtection, typename GrowthPolicy,
+          typename Allocator, typename Serializer>
+  requires snapshot_serializer<Serializer, T> &&
+           std::is_nothrow_move_constructible_v<T>
+auto load_snapshot(
+    const string &path,
+    darray<T, ThreadProtection, GrowthPolicy, Allocator> &destination,
+    const Serializer &serializer,
+    const size_t chunk_bytes = detail::s_snapshot_chunk_bytes) noexcept
+    -> expected<size_t, error> {
+  using detail::record_length;
+  detail::snapshot_header header{};
+  return detail::open_snapshot(path, 0, header)
+      .and_then([&](const int fd) -> expected<size_t, error> {
+        detail::snapshot_file file{fd};
+        // every record holds at least its length
+        [[unlikely]] if (header.m_count >
+                         (header.m_payload_bytes / sizeof(record_length))) {
+          return unexpected{error{"Cannot load snapshot, corrupt header"}};
+        }
+        const auto count = static_cast<size_t>(header.m_count);
+        expected<darray<std::byte>, error> staging = detail::staging_buffer(
+            std::max(chunk_bytes, sizeof(record_length)));
+        [[unlikely]] if (!staging.has_value()) {
+          return unexpected{staging.error()};
+        }
+
+        // the staging buffer holds bytes [begin, end) of the current read,
+        // it is refilled (and grown for a record larger than it) as records
+        // are consumed
+        std::byte *p_staging = staging.value().data();
+        size_t staging_bytes = staging.value().pod().size();
+        size_t begin = 0;
+        size_t end = 0;
+        std::uint64_t payload_left = header.m_payload_bytes;
+        std::uint32_t checksum = 0;
+        const auto ensure = [&](const size_t bytes) -> expected<void, error> {
+          if ((end - begin) >= bytes) {
+            return {};
+          }
+          [[unlikely]] if ((bytes - (end - begin)) > payload_left) {
+            return detail::truncated_snapshot();
+          }
+          if (bytes > staging_bytes) {
+            expected<darray<std::byte>, error> larger =
+                detail::staging_buffer(bytes);
+            [[unlikely]] if (!larger.has_value()) {
+              return unexpected{larger.error()};
+            }
+            std::memcpy(larger.value().data(), &p_staging[begin],
+                        end - begin);
+            std::swap(staging.value(), larger.value());
+            p_staging = staging.value().data();
+            staging_bytes = bytes;
+          } else {
+            std::memmove(p_staging, &p_staging[begin], end - begin);
+          }
+          end -= begin;
+          begin = 0;
+          const size_t wanted = static_cast<size_t>(
+              std::min<std::uint64_t>(staging_bytes - end, payload_left));
+          const expected<size_t, error> got =
+              detail::read_fully(fd, &p_staging[end], wanted);
+          [[unlikely]] if (!got.has_value()) {
+            return unexpected{got.error()};
+          }
+          checksum = detail::crc32c(checksum, &p_staging[end], got.value());
+          payload_left -= got.value();
+          end += got.value();
+          [[unlikely]] if ((end - begin) < bytes) {
+            return detail::truncated_snapshot();
+          }
+          return {};
+        };
+
+        expected<void, error> result{};
+        return destination
+            .append_with(
+                count,
+                [&](T *const p_spare) -> size_t {
+                  size_t loaded = 0;
+                  const auto fail = [&](const error &err) -> size_t {
+                    std::destroy_n(p_spare, loaded);
+                    result = unexpected{err};
+                    return 0;
+                  };
+                  for (; loaded < count; loaded++) {
+                    record_length length = 0;
+                    const expected<void, error> has_length =
+                        ensure(sizeof(length));
+                    [[unlikely]] if (!has_length.has_value()) {
+                      return fail(has_length.error());
+                    }
+                    std::memcpy(&length, &p_staging[begin], sizeof(length));
+                    begin += sizeof(length);
+                    const expected<void, error> has_record = ensure(length);
+                    [[unlikely]] if (!has_record.has_value()) {
+                      return fail(has_record.error());
+                    }
+                    expected<T, error> element = serializer.load(
+                        std::span<const std::byte>{&p_staging[begin], length});
+                    [[unlikely]] if (!element.has_value()) {
+                      return fail(element.error());
+                    }
+                    std::construct_at(&p_spare[loaded],
+                                      std::move(element.value()));
+                    begin += length;
+                  }
+                  [[unlikely]] if ((0 != payload_left) || (begin != end)) {
+                    return fail(error{"Cannot load snapshot, trailing bytes"});
+                  }
+                  [[unlikely]] if (checksum != header.m_checksum) {
+                    return fail(detail::checksum_mismatch().error());
+                  }
+                  return count;
+                })
+            .and_then([&](size_t /*size*/) -> expected<size_t, error> {
+              return result.transform([&]() { return count; });
+            });
+      });
+}
+
+#endif // __linux__
+
+} // namespace CppPlay
@@ -0,0 +1,342 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#pragma once
+
+#include "darray.hpp"
+
+#include <cstddef> // size_t & byte
+#include <expected>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace CppPlay {
+
+// structure-of-arrays darray, a record of Fields... is stored as one
+// contiguous column per field
+// - loops reading one or two fields only pull those columns through the cache
+// - a record is pushed whole, every column grows together, so columns always
+//   have the same size and capacity
+// - columns are exposed as spans, records through a proxy reference (a tuple
+//   of references to the fields) and a random access proxy iterator
+// no thread protection, protect the owner if shared
+template <typename... Fields> class soa_darray {
+  static_assert(sizeof...(Fields) > 0, "a record holds at least one field");
+
+public:
+  using value_type = std::tuple<Fields...>;
+  using reference = std::tuple<Fields &...>;
+  template <size_t I> using field_type = std::tuple_element_t<I, value_type>;
+
+private:
+  template <typename Field>
+  using column_type = darray<Field, ThreadProtectionDisabled<Field>,
+                             GrowthPolicyDouble<Field>>;
+  std::tuple<column_type<Fields>...> m_columns;
+
+  constinit static const size_t DEFAULT_RESERVE_SIZE = 8;
+
+  static constexpr auto s_field_indices =
+      std::make_index_sequence<sizeof...(Fields)>{};
+
+  explicit soa_darray(const size_t capacity)
+      : m_columns{
+            typename column_type<Fields>::builder{}.capacity(capacity).build()...} {
+  }
+
+  [[nodiscard]] auto size_of_columns() const noexcept -> size_t {
+    return std::get<0>(m_columns).pod().size();
+  }
+
+  // pop the first count columns, undoing a partially stored record
+  template <size_t... I>
+  auto pop_columns(const size_t count, std::index_sequence<I...>) noexcept
+      -> void {
+    (((I < count) ? static_cast<void>(std::get<I>(m_columns).pop_back())
+                  : static_cast<void>(0)),
+     ...);
+  }
+
+  // store one field per column, stopping at the first failure and undoing
+  // the columns already stored so every column keeps the same size
+  template <typename... Us, size_t... I>
+  auto store(std::index_sequence<I...> indices, Us &&...fields) noexcept
+      -> expected<size_t, error> {
+    expected<size_t, error> result{size_of_columns()};
+    size_t stored = 0;
+    (static_cast<void>(
+         result.has_value() &&
+         (result = std::get<I>(m_columns).push_back(forward<Us>(fields)))
+             .has_value() &&
+         ++stored),
+     ...);
+    if (!result.has_value()) {
+      pop_columns(stored, indices);
+    }
+    return result;
+  }
+
+  template <size_t... I>
+  auto extract_columns(const size_t index, std::index_sequence<I...>) noexcept
+      -> expected<value_type, error> {
+    [[unlikely]] if (index >= size_of_columns()) {
+      return unexpected{error{format("Cannot extract, index too large")}};
+    }
+    // extract from a column of a single element never fails, once the index
+    // is valid, shrinking is best effort
+    return {value_type{std::move(std::get<I>(m_columns).extract(index).value())...}};
+  }
+
+  template <size_t... I>
+  auto record_at(const size_t idx, std::index_sequence<I...>) const noexcept
+      -> reference {
+    return reference{std::get<I>(m_columns)[idx]...};
+  }
+
+public:
+  //
+  // special member functions
+  //
+  soa_darray() = default;
+  soa_darray(const soa_darray &other) = default;
+  auto operator=(const soa_darray &other) -> soa_darray & = default;
+  soa_darray(soa_darray &&other) noexcept = default;
+  auto operator=(soa_darray &&other) noexcept -> soa_darray & = default;
+  ~soa_darray() = default;
+
+  //
+  // soa_darray builder helper
+  //
+  class builder {
+    size_t m_initial_capacity = DEFAULT_RESERVE_SIZE;
+
+  public:
+    // capacity of every column
+    constexpr auto capacity(size_t capacity) noexcept -> builder & {
+      m_initial_capacity = capacity;
+      return *this;
+    };
+    [[nodiscard]] auto build() const noexcept -> soa_darray {
+      return soa_darray{m_initial_capacity};
+    };
+  };
+  friend builder;
+
+  //
+  // store
+  //
+
+  // store a record given field by field, returns the new size
+  template <typename... Us>
+    requires(sizeof...(Us) == sizeof...(Fields)) &&
+            (std::constructible_from<Fields, Us &&> && ...)
+  auto push_back(Us &&...fields) noexcept -> expected<size_t, error> {
+    return store(s_field_indices, forward<Us>(fields)...);
+  }
+
+  // store a whole record
+  auto push_back(const value_type &record) noexcept
+      -> expected<size_t, error> {
+    return std::apply(
+        [&](const Fields &...fields) {
+          return store(s_field_indices, fields...);
+        },
+        record);
+  }
+  auto push_back(value_type &&record) noexcept -> expected<size_t, error> {
+    return std::apply(
+        [&](Fields &...fields) {
+          return store(s_field_indices, std::move(fields)...);
+        },
+        record);
+  }
+
+  //
+  // extract
+  //
+  auto pop_back() noexcept -> expected<value_type, error> {
+    [[unlikely]] if (0 == size_of_columns()) {
+      return unexpected{error{format("No elements to pop")}};
+    }
+    return extract_columns(size_of_columns() - 1, s_field_indices);
+  }
+
+  auto extract(const size_t index) noexcept -> expected<value_type, error> {
+    return extract_columns(index, s_field_indices);
+  }
+
+  auto clear() noexcept -> expected<void, error> {
+    std::apply([](auto &...columns) { (columns.clear(), ...); }, m_columns);
+    return {};
+  }
+
+  //
+  // access - column
+  //
+
+  // contiguous column of field I, valid until the next store or extract
+  template <size_t I>
+  [[nodiscard]] auto column() const noexcept -> span<field_type<I>> {
+    return std::get<I>(m_columns).as_span();
+  }
+
+  //
+  // access - iterator (random access, proxy reference)
+  //
+  struct iterator {
+    // dereferencing yields a reference proxy (prvalue), so a legacy input
+    // iterator but a C++20 random access iterator, as std::views::zip
+    using iterator_concept = std::random_access_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = soa_darray::value_type;
+    using reference = soa_darray::reference;
+
+    iterator() = default;
+    iterator(const soa_darray *p_soa, size_t idx)
+        : m_p_soa{p_soa}, m_idx{idx} {}
+
+    reference operator*() const { return (*m_p_soa)[m_idx]; }
+    reference operator[](difference_type idx) const {
+      return (*m_p_soa)[m_idx + static_cast<size_t>(idx)];
+    }
+
+    iterator &operator++() {
+      m_idx++;
+      return *this;
+    }
+    iterator operator++(int) {
+      iterator tmp = *this;
+      ++(*this);
+      return tmp;
+    }
+    iterator &operator--() {
+      m_idx--;
+      return *this;
+    }
+    iterator operator--(int) {
+      iterator tmp = *this;
+      --(*this);
+      return tmp;
+    }
+    iterator &operator+=(difference_type idx) {
+      m_idx += static_cast<size_t>(idx);
+      return *this;
+    }
+    iterator &operator-=(difference_type idx) {
+      m_idx -= static_cast<size_t>(idx);
+      return *this;
+    }
+    iterator operator+(difference_type idx) const {
+      return iterator{m_p_soa, m_idx + static_cast<size_t>(idx)};
+    }
+    friend iterator operator+(difference_type idx, const iterator &other) {
+      return other + idx;
+    }
+    iterator operator-(difference_type idx) const {
+      return iterator{m_p_soa, m_idx - static_cast<size_t>(idx)};
+    }
+    difference_type operator-(const iterator &other) const {
+      return static_cast<difference_type>(m_idx) -
+             static_cast<difference_type>(other.m_idx);
+    }
+
+    bool operator==(const iterator &other) const {
+      return m_idx == other.m_idx;
+    }
+    auto operator<=>(const iterator &other) const {
+      return m_idx <=> other.m_idx;
+    }
+
+  private:
+    const soa_darray *m_p_soa = nullptr;
+    size_t m_idx = 0;
+  };
+  auto begin() const noexcept -> iterator { return iterator{this, 0}; }
+  auto end() const noexcept -> iterator {
+    return iterator{this, size_of_columns()};
+  }
+
+  //
+  // access - random
+  //
+  [[nodiscard]] auto at(const size_t idx) const noexcept
+      -> expected<reference, error> {
+    [[unlikely]] if (idx >= size_of_columns()) {
+      return unexpected{error{format(
+          "Requested index {} beyond array end (size={})", idx,
+          size_of_columns())}};
+    }
+    return {record_at(idx, s_field_indices)};
+  }
+  auto operator[](const size_t idx) const -> reference {
+    return record_at(idx, s_field_indices);
+  }
+
+  //
+  // metadata
+  //
+  [[nodiscard]] auto capacity() const noexcept -> expected<size_t, error> {
+    return std::get<0>(m_columns).capacity();
+  }
+  [[nodiscard]] auto size() const noexcept -> expected<size_t, error> {
+    return {size_of_columns()};
+  }
+  [[nodiscard]] auto is_empty() const noexcept -> expected<bool, error> {
+    return {(0 == size_of_columns())};
+  }
+
+  // non-monadic (plain-old-data return value) metadata accessors
+  class pod_metadata_accessor {
+    const soa_darray &m_darray;
+    constexpr explicit pod_metadata_accessor(const soa_darray &darray_obj)
+        : m_darray{darray_obj} {}
+    friend soa_darray;
+
+  public:
+    [[nodiscard]] auto capacity() const noexcept -> size_t {
+      return std::get<0>(m_darray.m_columns).pod().capacity();
+    }
+    [[nodiscard]] auto size() const noexcept -> size_t {
+      return m_darray.size_of_columns();
+    }
+    [[nodiscard]] auto is_empty() const noexcept -> bool {
+      return (0 == m_darray.size_of_columns());
+    }
+  };
+  // get plain-old-data metadata accessor
+  [[nodiscard]] constexpr auto pod() const noexcept
+      -> const pod_metadata_accessor {
+    return pod_metadata_accessor{*this};
+  }
+};
+
+} // namespace CppPlay
@@ -0,0 +1,299 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#pragma once
+
+#include "darray.hpp"
+
+#include <cstddef> // size_t & byte
+#include <cstring>
+#include <expected>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace CppPlay {
+
+// fixed capacity darray, elements live inside the object
+// - never allocates, storing beyond CAPACITY returns an error instead of
+//   growing and removing never reallocates, so safe for real-time threads
+// - every operation is constexpr, usable in constant evaluation (e.g. build a
+//   lookup table at compile time) for literal element types
+// same expected<..., error> store/extract/iterator API as darray, without
+// thread protection
+template <typename T, size_t CAPACITY> class static_darray {
+  static_assert(CAPACITY > 0, "capacity must hold at least one element");
+
+public:
+  using value_type = T;
+  using iterator = typename darray<T>::iterator;
+
+private:
+  // raw storage, only live elements are constructed
+  // a union member array is the storage constant evaluation accepts, the
+  // empty constructor and destructor leave element lifetimes to the darray
+  // trivial elements are value initialized in constant evaluation only, a
+  // constexpr variable may not hold uninitialized storage (e.g. a partially
+  // filled lookup table), at run time the storage is left uninitialized
+  // rather than zeroing all CAPACITY elements
+  union storage {
+    constexpr storage() noexcept {
+      if constexpr (std::is_trivially_default_constructible_v<T> &&
+                    std::is_trivially_copy_assignable_v<T>) {
+        if consteval {
+          for (size_t idx = 0; idx < CAPACITY; idx++) {
+            m_elements[idx] = T{};
+          }
+        }
+      }
+    }
+    constexpr ~storage() noexcept {}
+    T m_elements[CAPACITY];
+  };
+  storage m_storage;
+  size_t m_size = 0;
+
+  [[nodiscard]] constexpr auto data() const noexcept -> T * {
+    return const_cast<T *>(m_storage.m_elements);
+  }
+
+  // valid for moveable and "copy only" objects, preferring move
+  // dest is raw storage, source is left as raw storage, dest is on the left
+  // of (or the same buffer as) source when they overlap
+  static constexpr auto relocate_left(T *const p_source, const size_t count,
+                                      T *const p_dest) noexcept -> void {
+    if constexpr (is_trivially_relocatable_v<T>) {
+      if !consteval {
+        [[unlikely]] if (0 == count) { return; }
+        std::memmove(static_cast<void *>(p_dest),
+                     static_cast<const void *>(p_source), count * sizeof(T));
+        return;
+      }
+    }
+    for (size_t idx = 0; idx < count; idx++) {
+      if constexpr (is_move_constructible_v<T>) {
+        std::construct_at(&p_dest[idx], move(p_source[idx]));
+      } else {
+        std::construct_at(&p_dest[idx], p_source[idx]);
+      }
+      std::destroy_at(&p_source[idx]);
+    }
+  }
+  // as relocate_left, dest is on the right when they overlap
+  static constexpr auto relocate_right(T *const p_source, const size_t count,
+                                       T *const p_dest) noexcept -> void {
+    if constexpr (is_trivially_relocatable_v<T>) {
+      if !consteval {
+        [[unlikely]] if (0 == count) { return; }
+        std::memmove(static_cast<void *>(p_dest),
+                     static_cast<const void *>(p_source), count * sizeof(T));
+        return;
+      }
+    }
+    for (size_t idx = count; idx-- > 0;) {
+      if constexpr (is_move_constructible_v<T>) {
+        std::construct_at(&p_dest[idx], move(p_source[idx]));
+      } else {
+        std::construct_at(&p_dest[idx], p_source[idx]);
+      }
+      std::destroy_at(&p_source[idx]);
+    }
+  }
+
+  // std::uninitialized_copy_n is not constexpr, elements copied one by one
+  // and counted as they are, so a throwing copy leaves only live elements
+  constexpr auto copy_from(const static_darray &other) -> void {
+    for (; m_size < other.m_size; m_size++) {
+      std::construct_at(&data()[m_size], other.data()[m_size]);
+    }
+  }
+
+  // error messages are literals, format is not usable in constant evaluation
+  [[nodiscard]] static constexpr auto capacity_exceeded() noexcept
+      -> unexpected<error> {
+    return unexpected{error{"Cannot store, static capacity exceeded"}};
+  }
+
+public:
+  //
+  // special member functions
+  //
+
+  // user provided, so static_darray{} does not zero the whole object first
+  constexpr static_darray() noexcept {}
+
+  constexpr ~static_darray() { std::destroy_n(data(), m_size); }
+
+  constexpr static_darray(const static_darray &other) { copy_from(other); }
+
+  constexpr auto operator=(const static_darray &other) -> static_darray & {
+    [[unlikely]] if (this == &other) { return *this; }
+    std::destroy_n(data(), m_size);
+    m_size = 0;
+    copy_from(other);
+    return *this;
+  }
+
+  // elements are relocated, moved from darray is left empty
+  constexpr static_darray(static_darray &&other) noexcept {
+    relocate_left(other.data(), other.m_size, data());
+    m_size = other.m_size;
+    other.m_size = 0;
+  }
+
+  constexpr auto operator=(static_darray &&other) noexcept -> static_darray & {
+    [[unlikely]] if (this == &other) { return *this; }
+    std::destroy_n(data(), m_size);
+    relocate_left(other.data(), other.m_size, data());
+    m_size = other.m_size;
+    other.m_size = 0;
+    return *this;
+  }
+
+  //
+  // store
+  //
+  template <typename U>
+  constexpr auto push_back(U &&new_element) noexcept
+      -> expected<size_t, error> {
+    [[unlikely]] if (m_size == CAPACITY) { return capacity_exceeded(); }
+    std::construct_at(&data()[m_size], forward<U>(new_element));
+    return {++m_size};
+  }
+
+  template <typename U>
+  constexpr auto insert(U &&new_element, const size_t index) noexcept
+      -> expected<size_t, error> {
+    [[unlikely]] if (index > m_size) {
+      return unexpected{error{"Invalid insert criteria. Index beyond length "
+                              "of contiguous elements"}};
+    }
+    [[unlikely]] if (m_size == CAPACITY) { return capacity_exceeded(); }
+    relocate_right(&data()[index], m_size - index, &data()[index + 1]);
+    std::construct_at(&data()[index], forward<U>(new_element));
+    return {++m_size};
+  }
+
+  //
+  // extract
+  //
+  constexpr auto pop_back() noexcept -> expected<T, error> {
+    [[unlikely]] if (0 == m_size) {
+      return unexpected{error{"No elements to pop"}};
+    }
+    return extract(m_size - 1);
+  }
+
+  constexpr auto extract(const size_t index) noexcept -> expected<T, error> {
+    [[unlikely]] if (index >= m_size) {
+      return unexpected{error{"Cannot extract, index too large"}};
+    }
+    // pull element directly into return type so can be used for RVO, minimize
+    // copy/move
+    expected<T, error> ret = [&]() -> expected<T, error> {
+      if constexpr (is_move_constructible_v<T>) {
+        return {std::move(data()[index])};
+      } else {
+        return {data()[index]};
+      }
+    }();
+    std::destroy_at(&data()[index]);
+    relocate_left(&data()[index + 1], m_size - (index + 1), &data()[index]);
+    m_size--;
+    return ret;
+  }
+
+  constexpr auto clear() noexcept -> expected<void, error> {
+    std::destroy_n(data(), m_size);
+    m_size = 0;
+    return {};
+  }
+
+  //
+  // access - iterator (random access)
+  //
+  constexpr auto begin() const noexcept -> iterator { return iterator{data()}; }
+  constexpr auto end() const noexcept -> iterator {
+    return iterator{&data()[m_size]};
+  }
+
+  //
+  // access - random
+  //
+  [[nodiscard]] constexpr auto at(const size_t idx) const noexcept
+      -> expected<iterator, error> {
+    [[unlikely]] if (idx >= m_size) {
+      return unexpected{error{"Requested index beyond array end"}};
+    }
+    return {iterator{&data()[idx]}};
+  }
+  constexpr auto operator[](const size_t idx) const -> T & {
+    return data()[idx];
+  }
+
+  //
+  // metadata
+  //
+  [[nodiscard]] constexpr auto capacity() const noexcept
+      -> expected<size_t, error> {
+    return {CAPACITY};
+  }
+  [[nodiscard]] constexpr auto size() const noexcept
+      -> expected<size_t, error> {
+    return {m_size};
+  }
+  [[nodiscard]] constexpr auto is_empty() const noexcept
+      -> expected<bool, error> {
+    return {(0 == m_size)};
+  }
+
+  // non-monadic (plain-old-data return value) metadata accessors
+  class pod_metadata_accessor {
+    const static_darray &m_darray;
+    constexpr explicit pod_metadata_accessor(const static_darray &darray_obj)
+        : m_darray{darray_obj} {}
+    friend static_darray;
+
+  public:
+    [[nodiscard]] constexpr auto capacity() const noexcept -> size_t {
+      return CAPACITY;
+    }
+    [[nodiscard]] constexpr auto size() const noexcept -> size_t {
+      return m_darray.m_size;
+    }
+    [[nodiscard]] constexpr auto is_empty() const noexcept -> bool {
+      return (0 == m_darray.m_size);
+    }
+  };
+  // get plain-old-data metadata accessor
+  [[nodiscard]] constexpr auto pod() const noexcept
+      -> const pod_metadata_accessor {
+    return pod_metadata_accessor{*this};
+  }
+};
+
+} // namespace CppPlay
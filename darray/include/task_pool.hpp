@@ -0,0 +1,248 @@
+/******************************************************************************
+ *  This is free and unencumbered software released into the public domain.
+ *
+ *  Anyone is free to copy, modify, publish, use, compile, sell, or
+ *  distribute this software, either in source code form or as a compiled
+ *  binary, for any purpose, commercial or non-commercial, and by any
+ *  means.
+ *
+ *  In jurisdictions that recognize copyright laws, the author or authors
+ *  of this software dedicate any and all copyright interest in the
+ *  software to the public domain. We make this dedication for the benefit
+ *  of the public at large and to the detriment of our heirs and
+ *  successors. We intend this dedication to be an overt act of
+ *  relinquishment in perpetuity of all present and future rights to this
+ *  software under copyright law.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ *  OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ *  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *  OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *  For more information, please refer to <https://unlicense.org>
+ */
+
+#pragma once
+
+#include "darray.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef> // size_t & byte
+#include <deque>
+#include <exception>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace CppPlay {
+
+// work-stealing task pool for fork-join algorithms (e.g. parallel_sort)
+// - every participant owns a task deque, it pushes and pops its own tasks at
+//   the back (most recent, cache warm), idle participants steal from the
+//   front of the others (oldest, usually the largest pieces of work)
+// - a pool of N threads runs N - 1 workers, the thread waiting on a group is
+//   the Nth participant and runs tasks until the group completes, so nested
+//   fork-join never blocks a worker
+// - exceptions thrown by a task are caught and returned by wait() as an error
+// the pool must outlive its groups, tasks not waited for are discarded on
+// destruction
+class task_pool {
+public:
+  using task = std::function<void()>;
+
+  // tasks submitted together and waited for together
+  class group {
+    std::atomic<size_t> m_pending{0};
+    std::mutex m_error_mutex;
+    std::optional<error> m_error;
+    friend task_pool;
+
+    auto fail(error err) noexcept -> void {
+      const std::lock_guard<std::mutex> lock{m_error_mutex};
+      if (!m_error.has_value()) {
+        m_error = std::move(err);
+      }
+    }
+  };
+
+private:
+  struct alignas(64) task_queue {
+    std::mutex m_mutex;
+    std::deque<task> m_tasks;
+  };
+
+  // one queue per worker, the last is shared by threads outside the pool
+  std::vector<std::unique_ptr<task_queue>> m_queues;
+  std::atomic<size_t> m_queued{0};
+  std::atomic<bool> m_stop{false};
+  std::mutex m_sleep_mutex;
+  std::condition_variable m_sleep;
+  std::vector<std::jthread> m_workers;
+
+  static inline thread_local const task_pool *s_p_pool = nullptr;
+  static inline thread_local size_t s_queue_index = 0;
+
+  [[nodiscard]] auto own_queue_index() const noexcept -> size_t {
+    return (this == s_p_pool) ? s_queue_index : (m_queues.size() - 1);
+  }
+
+  auto push(task new_task) -> void {
+    task_queue &queue = *m_queues[own_queue_index()];
+    {
+      const std::lock_guard<std::mutex> lock{queue.m_mutex};
+      queue.m_tasks.push_back(std::move(new_task));
+    }
+    m_queued.fetch_add(1);
+    // sleeping workers check m_queued under the sleep mutex, taking it here
+    // orders the increment before their check, no wakeup is lost
+    { const std::lock_guard<std::mutex> lock{m_sleep_mutex}; }
+    m_sleep.notify_one();
+  }
+
+  // own tasks from the back, then steal from the front of the others
+  auto take(const size_t own_index) noexcept -> std::optional<task> {
+    const size_t queue_count = m_queues.size();
+    for (size_t offset = 0; offset < queue_count; offset++) {
+      const size_t index = (own_index + offset) % queue_count;
+      task_queue &queue = *m_queues[index];
+      const std::lock_guard<std::mutex> lock{queue.m_mutex};
+      if (queue.m_tasks.empty()) {
+        continue;
+      }
+      task taken = [&]() {
+        if (0 == offset) {
+          task back = std::move(queue.m_tasks.back());
+          queue.m_tasks.pop_back();
+          return back;
+        }
+        task front = std::move(queue.m_tasks.front());
+        queue.m_tasks.pop_front();
+        return front;
+      }();
+      m_queued.fetch_sub(1);
+      return {std::move(taken)};
+    }
+    return std::nullopt;
+  }
+
+  auto run_one(const size_t own_index) noexcept -> bool {
+    std::optional<task> taken = take(own_index);
+    if (!taken.has_value()) {
+      return false;
+    }
+    (*taken)();
+    return true;
+  }
+
+  auto work(const std::stop_token &stop, const size_t queue_index) noexcept
+      -> void {
+    s_p_pool = this;
+    s_queue_index = queue_index;
+    while (!stop.stop_requested()) {
+      if (run_one(queue_index)) {
+        continue;
+      }
+      std::unique_lock<std::mutex> lock{m_sleep_mutex};
+      m_sleep.wait(lock, [&]() {
+        return (m_queued.load() > 0) || m_stop.load();
+      });
+      if (m_stop.load()) {
+        return;
+      }
+    }
+  }
+
+public:
+  // threads participating, including the one waiting, 0 for one per core
+  explicit task_pool(const size_t threads = 0) {
+    const size_t participants =
+        (0 == threads)
+            ? std::max<size_t>(1, std::thread::hardware_concurrency())
+            : threads;
+    for (size_t idx = 0; idx < participants; idx++) {
+      m_queues.push_back(std::make_unique<task_queue>());
+    }
+    m_workers.reserve(participants - 1);
+    for (size_t idx = 0; idx < (participants - 1); idx++) {
+      m_workers.emplace_back(
+          [this, idx](const std::stop_token &stop) { work(stop, idx); });
+    }
+  }
+
+  ~task_pool() {
+    {
+      const std::lock_guard<std::mutex> lock{m_sleep_mutex};
+      m_stop.store(true);
+    }
+    m_sleep.notify_all();
+    for (std::jthread &worker : m_workers) {
+      worker.request_stop();
+    }
+    m_workers.clear();
+  }
+
+  task_pool(const task_pool &) = delete;
+  auto operator=(const task_pool &) -> task_pool & = delete;
+  task_pool(task_pool &&) = delete;
+  auto operator=(task_pool &&) -> task_pool & = delete;
+
+  [[nodiscard]] auto thread_count() const noexcept -> size_t {
+    return m_queues.size();
+  }
+
+  // queue function as a task of group_obj, run by the first idle participant
+  template <typename F>
+    requires std::invocable<F &> && std::copy_constructible<std::decay_t<F>>
+  auto submit(group &group_obj, F &&function) noexcept
+      -> expected<void, error> {
+    group_obj.m_pending.fetch_add(1);
+    try {
+      push([&group_obj, function = std::forward<F>(function)]() mutable {
+        try {
+          function();
+        } catch (const error &err) {
+          group_obj.fail(err);
+        } catch (const std::exception &err) {
+          group_obj.fail(error{format("{}", err.what())});
+        } catch (...) {
+          group_obj.fail(error{format("Unknown exception thrown by task")});
+        }
+        group_obj.m_pending.fetch_sub(1, std::memory_order_release);
+      });
+    } catch (const std::exception &err) {
+      group_obj.m_pending.fetch_sub(1);
+      return unexpected{error{format("Cannot submit task, {}", err.what())}};
+    }
+    return {};
+  }
+
+  // run tasks, of any group, until every task of group_obj has completed
+  // returns the first error a task of the group threw
+  auto wait(group &group_obj) noexcept -> expected<void, error> {
+    const size_t own_index = own_queue_index();
+    while (group_obj.m_pending.load(std::memory_order_acquire) > 0) {
+      if (!run_one(own_index)) {
+        std::this_thread::yield();
+      }
+    }
+    const std::lock_guard<std::mutex> lock{group_obj.m_error_mutex};
+    if (group_obj.m_error.has_value()) {
+      return unexpected{group_obj.m_error.value()};
+    }
+    return {};
+  }
+};
+
+} // namespace CppPlay